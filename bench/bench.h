@@ -0,0 +1,158 @@
+#pragma once
+#include "core/common.h"
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "utils/data_generator.h"
+#include "benchmark/benchmark.h"
+#include <chrono>
+#include <cstdlib>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace infini {
+
+/**
+ * @brief Peak compute and memory bandwidth of this machine, measured once with
+ * an FMA loop and a STREAM-like triad on all threads. Override with the
+ * INFINI_PEAK_GFLOPS and INFINI_PEAK_GBPS environment variables.
+ */
+struct Roofline {
+    double flops; // FLOP/s
+    double bytes; // B/s
+
+    static const Roofline &get();
+};
+
+inline int maxThreads() { return ThreadPool::global().size(); }
+
+/**
+ * @brief CPU runtime whose kernels use `threads` threads, created once per
+ * thread count. maxThreads() gives the default runtime.
+ */
+inline Ref<NativeCpuRuntimeObj> runtimeWith(int threads) {
+    static std::map<int, Ref<NativeCpuRuntimeObj>> runtimes;
+    if (threads == maxThreads())
+        return NativeCpuRuntimeObj::getInstance();
+    auto &runtime = runtimes[threads];
+    if (!runtime)
+        runtime = make_ref<NativeCpuRuntimeObj>(CpuConfig{threads});
+    return runtime;
+}
+
+/**
+ * @brief Thread counts to sweep: powers of two up to the available cores.
+ */
+inline vector<int64_t> threadCounts() {
+    vector<int64_t> ret;
+    for (int n = 1; n < maxThreads(); n *= 2)
+        ret.emplace_back(n);
+    ret.emplace_back(maxThreads());
+    return ret;
+}
+
+inline const Roofline &Roofline::get() {
+    static const Roofline roof = [] {
+        using Clock = std::chrono::steady_clock;
+        auto seconds = [](Clock::time_point t0) {
+            return std::chrono::duration<double>(Clock::now() - t0).count();
+        };
+        Roofline r{0, 0};
+        // Compute: independent multiply-add chains, enough to fill the pipes.
+        constexpr int lanes = 64;
+        constexpr long steps = 1 << 20;
+        volatile float sink = 0;
+        for (int rep = 0; rep < 3; ++rep) {
+            auto t0 = Clock::now();
+            int threads = 1;
+#pragma omp parallel
+            {
+                float acc[lanes];
+                for (int j = 0; j < lanes; ++j)
+                    acc[j] = j;
+                for (long i = 0; i < steps; ++i)
+#pragma omp simd
+                    for (int j = 0; j < lanes; ++j)
+                        acc[j] = acc[j] * 0.999999f + 1e-6f;
+                float sum = 0;
+                for (int j = 0; j < lanes; ++j)
+                    sum += acc[j];
+#pragma omp critical
+                sink = sink + sum;
+#ifdef _OPENMP
+                threads = omp_get_num_threads();
+#endif
+            }
+            r.flops = std::max(r.flops, 2.0 * lanes * steps * threads / seconds(t0));
+        }
+        // Memory: STREAM triad on arrays well beyond the last level cache.
+        const size_t n = 1 << 23;
+        vector<float> a(n), b(n, 1.f), c(n, 2.f);
+        for (int rep = 0; rep < 5; ++rep) {
+            auto t0 = Clock::now();
+#pragma omp parallel for
+            for (size_t i = 0; i < n; ++i)
+                a[i] = b[i] + 3.f * c[i];
+            r.bytes = std::max(r.bytes, 3.0 * n * sizeof(float) / seconds(t0));
+        }
+        sink = sink + a[n / 2];
+        if (auto env = std::getenv("INFINI_PEAK_GFLOPS"))
+            r.flops = std::atof(env) * 1e9;
+        if (auto env = std::getenv("INFINI_PEAK_GBPS"))
+            r.bytes = std::atof(env) * 1e9;
+        return r;
+    }();
+    return roof;
+}
+
+/**
+ * @brief Reports FLOP/s, B/s and the fraction of the roofline reached: the
+ * bound max(flops / peak FLOP/s, bytes / peak B/s) per iteration over the
+ * measured `seconds` of all iterations.
+ */
+inline void reportThroughput(benchmark::State &state, double flops,
+                             double bytes, double seconds) {
+    using benchmark::Counter;
+    const auto &roof = Roofline::get();
+    state.counters["FLOP/s"] =
+        Counter(flops, Counter::kIsIterationInvariantRate, Counter::kIs1000);
+    state.counters["B/s"] =
+        Counter(bytes, Counter::kIsIterationInvariantRate, Counter::kIs1024);
+    double bound = std::max(flops / roof.flops, bytes / roof.bytes);
+    state.counters["roofline"] = bound * state.iterations() / seconds;
+}
+
+/**
+ * @brief Runs `body` for every benchmark iteration and returns the wall time.
+ */
+template <typename F> double timedLoop(benchmark::State &state, F &&body) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (auto _ : state)
+        body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+        .count();
+}
+
+} // namespace infini
+
+/**
+ * @brief main() of a benchmark executable. Records the measured roofline in
+ * the report context so that JSON results from different hosts compare.
+ */
+#define INFINI_BENCHMARK_MAIN()                                                \
+    int main(int argc, char **argv) {                                          \
+        benchmark::Initialize(&argc, argv);                                    \
+        if (benchmark::ReportUnrecognizedArguments(argc, argv))                \
+            return 1;                                                          \
+        const auto &roof = infini::Roofline::get();                            \
+        benchmark::AddCustomContext("peak_gflops",                             \
+                                    std::to_string(roof.flops / 1e9));         \
+        benchmark::AddCustomContext("peak_gbps",                               \
+                                    std::to_string(roof.bytes / 1e9));         \
+        benchmark::AddCustomContext("max_threads",                             \
+                                    std::to_string(infini::maxThreads()));     \
+        benchmark::RunSpecifiedBenchmarks();                                   \
+        benchmark::Shutdown();                                                 \
+        return 0;                                                              \
+    }
@@ -0,0 +1,191 @@
+#include "bench.h"
+#include "core/pipeline.h"
+#include "operators/element_wise.h"
+#include "operators/layer_norm.h"
+#include "operators/matmul.h"
+#include "operators/softmax.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+namespace infini {
+
+static Tensor addWeight(const Graph &g, const Shape &shape) {
+    auto t = g->addTensor(shape, DataType::Float32);
+    t->setWeight();
+    return t;
+}
+
+/**
+ * @brief `layers` x (Transpose(W) -> MatMul -> Add bias -> Relu) on a
+ * [batch, hidden] input, with weights stored as [out, in] like exported
+ * Linear layers, so that optimize() folds every transpose into the matmul.
+ */
+static Graph buildMlp(int batch, int hidden, int layers) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    auto x = g->addTensor({batch, hidden}, DataType::Float32);
+    for (int i = 0; i < layers; ++i) {
+        auto wt = g->addOp<TransposeObj>(addWeight(g, {hidden, hidden}),
+                                         nullptr, vector<int>{1, 0})
+                      ->getOutput();
+        auto y = g->addOp<MatmulObj>(x, wt, nullptr)->getOutput();
+        y = g->addOp<AddObj>(y, addWeight(g, {hidden}), nullptr)->getOutput();
+        x = g->addOp<ReluObj>(y, nullptr)->getOutput();
+    }
+    return g;
+}
+
+/**
+ * @brief Single-head self-attention block with output projection and
+ * residual followed by LayerNorm on a [seq, dim] input.
+ */
+static Graph buildAttention(int seq, int dim) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    auto x = g->addTensor({seq, dim}, DataType::Float32);
+    auto proj = [&](const Tensor &in) {
+        return g->addOp<MatmulObj>(in, addWeight(g, {dim, dim}), nullptr)
+            ->getOutput();
+    };
+    auto q = proj(x), k = proj(x), v = proj(x);
+    auto kt = g->addOp<TransposeObj>(k, nullptr, vector<int>{1, 0})->getOutput();
+    auto s = g->addOp<MatmulObj>(q, kt, nullptr)->getOutput();
+    s = g->addOp<DivObj>(s, addWeight(g, {1}), nullptr)->getOutput();
+    auto p = g->addOp<SoftmaxObj>(s, nullptr)->getOutput();
+    auto o = proj(g->addOp<MatmulObj>(p, v, nullptr)->getOutput());
+    auto r = g->addOp<AddObj>(o, x, nullptr)->getOutput();
+    g->addOp<LayerNormObj>(r, addWeight(g, {dim}), addWeight(g, {dim}),
+                           nullptr);
+    return g;
+}
+
+using Builder = std::function<Graph(benchmark::State &)>;
+
+static void benchOptimize(benchmark::State &state, const Builder &build) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto g = build(state);
+        state.ResumeTiming();
+        g->optimize();
+    }
+}
+
+static void benchDataMalloc(benchmark::State &state, const Builder &build) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto g = build(state);
+        g->optimize();
+        state.ResumeTiming();
+        g->dataMalloc();
+    }
+}
+
+static void benchRun(benchmark::State &state, const Builder &build,
+                     double flops) {
+    auto g = build(state);
+    g->optimize();
+    g->dataMalloc();
+    for (auto &input : g->getInputs())
+        input->setData(OneGenerator());
+    auto runtime = runtimeWith(state.range(2));
+    auto seconds = timedLoop(state, [&] { runtime->run(g); });
+    size_t bytes = 0;
+    for (auto &t : g->getTensors())
+        bytes += t->getBytes();
+    reportThroughput(state, flops, bytes, seconds);
+}
+
+static Graph mlp(benchmark::State &state) {
+    return buildMlp(state.range(0), state.range(1), 4);
+}
+static double mlpFlops(benchmark::State &state) {
+    double b = state.range(0), h = state.range(1);
+    return 4 * (2 * b * h * h + 2 * b * h);
+}
+static Graph attention(benchmark::State &state) {
+    return buildAttention(state.range(0), state.range(1));
+}
+static double attentionFlops(benchmark::State &state) {
+    double s = state.range(0), d = state.range(1);
+    // Softmax and LayerNorm count as 5 and 8 flops per element.
+    return 4 * 2 * s * d * d + 2 * 2 * s * s * d + 6 * s * s + 9 * s * d;
+}
+
+static void BM_MlpOptimize(benchmark::State &state) {
+    benchOptimize(state, mlp);
+}
+static void BM_MlpDataMalloc(benchmark::State &state) {
+    benchDataMalloc(state, mlp);
+}
+static void BM_MlpRun(benchmark::State &state) {
+    benchRun(state, mlp, mlpFlops(state));
+}
+static void BM_AttentionOptimize(benchmark::State &state) {
+    benchOptimize(state, attention);
+}
+static void BM_AttentionDataMalloc(benchmark::State &state) {
+    benchDataMalloc(state, attention);
+}
+static void BM_AttentionRun(benchmark::State &state) {
+    benchRun(state, attention, attentionFlops(state));
+}
+
+/**
+ * @brief Throughput of a 16-layer MLP streamed as micro-batches of `batch`
+ * rows through `stages` pipeline stages on disjoint groups of cores; compare
+ * with BM_MlpRun on all threads.
+ */
+static void BM_MlpPipeline(benchmark::State &state) {
+    const int layers = 16, stages = state.range(2);
+    auto g = buildMlp(state.range(0), state.range(1), layers);
+    g->optimize();
+    Pipeline pipeline(g, Pipeline::threadGroups(stages));
+    vector<float> x(pipeline.getInputs()[0]->size(), 1.f);
+    // One output per micro-batch in flight.
+    vector<vector<float>> ys(stages + 1,
+                             vector<float>(pipeline.getOutputs()[0]->size()));
+    size_t i = 0;
+    auto seconds = timedLoop(state, [&] {
+        pipeline.submit({x.data()}, {ys[i++ % ys.size()].data()}, nullptr);
+    });
+    auto t0 = std::chrono::steady_clock::now();
+    pipeline.wait();
+    seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                             t0)
+                   .count();
+    double b = state.range(0), h = state.range(1);
+    reportThroughput(state, layers * (2 * b * h * h + 2 * b * h),
+                     layers * h * h * sizeof(float), seconds);
+}
+
+static void mlpArgs(benchmark::internal::Benchmark *b) {
+    b->ArgNames({"batch", "hidden"})->ArgsProduct({{1, 32}, {256, 1024}});
+}
+static void attentionArgs(benchmark::internal::Benchmark *b) {
+    b->ArgNames({"seq", "dim"})->ArgsProduct({{64, 256}, {256}});
+}
+static void withThreads(benchmark::internal::Benchmark *b,
+                        const vector<vector<int64_t>> &args) {
+    auto product = args;
+    product.emplace_back(threadCounts());
+    b->ArgsProduct(product)->UseRealTime();
+}
+
+BENCHMARK(BM_MlpOptimize)->Apply(mlpArgs);
+BENCHMARK(BM_MlpDataMalloc)->Apply(mlpArgs);
+BENCHMARK(BM_MlpRun)->Apply([](benchmark::internal::Benchmark *b) {
+    b->ArgNames({"batch", "hidden", "threads"});
+    withThreads(b, {{1, 32}, {256, 1024}});
+});
+BENCHMARK(BM_MlpPipeline)->Apply([](benchmark::internal::Benchmark *b) {
+    b->ArgNames({"batch", "hidden", "stages"});
+    withThreads(b, {{32}, {256, 1024}});
+});
+BENCHMARK(BM_AttentionOptimize)->Apply(attentionArgs);
+BENCHMARK(BM_AttentionDataMalloc)->Apply(attentionArgs);
+BENCHMARK(BM_AttentionRun)->Apply([](benchmark::internal::Benchmark *b) {
+    b->ArgNames({"seq", "dim", "threads"});
+    withThreads(b, {{64, 256}, {256}});
+});
+
+} // namespace infini
+
+INFINI_BENCHMARK_MAIN();
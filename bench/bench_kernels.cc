@@ -0,0 +1,429 @@
+#include "bench.h"
+#include "operators/concat.h"
+#include "operators/conv.h"
+#include "operators/element_wise.h"
+#include "operators/fused_elementwise.h"
+#include "operators/gather.h"
+#include "operators/layer_norm.h"
+#include "operators/matmul.h"
+#include "operators/pooling.h"
+#include "operators/reduce.h"
+#include "operators/reorder.h"
+#include "operators/softmax.h"
+#include "operators/sparse_matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+namespace infini {
+
+// Every benchmark takes (size, dtype index, threads) as arguments.
+static void sweep(benchmark::internal::Benchmark *b,
+                  const vector<int64_t> &sizes,
+                  const vector<int64_t> &dtypes = {
+                      DataType::Float32.getIndex(),
+                      DataType::UInt32.getIndex()}) {
+    b->ArgNames({"size", "dtype", "threads"})
+        ->ArgsProduct({sizes, dtypes, threadCounts()})
+        ->UseRealTime();
+}
+
+/**
+ * @brief Times the CPU kernel chosen for `op` alone, without graph
+ * traversal or registry lookups. Float32 and UInt32 inputs are filled with
+ * ones; `init` fills any others, such as indices.
+ */
+static void benchKernel(benchmark::State &state, const Graph &g,
+                        const Operator &op, double flops, double bytes,
+                        const std::function<void()> &init = {}) {
+    ThreadPool::Scope scope(runtimeWith(state.range(2))->getThreadPool());
+    g->dataMalloc();
+    // Ones keep integer division well defined.
+    for (auto &input : g->getInputs())
+        if (input->getDType() == DataType::Float32 ||
+            input->getDType() == DataType::UInt32)
+            input->setData(OneGenerator());
+    if (init)
+        init();
+    auto kernel = KernelRegistry::getInstance().getKernel(
+        KernelAttrs{Device::CPU, op->getOpType().underlying()}, *op);
+    auto runtime = g->getRuntime().get();
+    auto seconds = timedLoop(state, [&] { kernel->compute(op, runtime); });
+    reportThroughput(state, flops, bytes, seconds);
+}
+
+template <typename T> static void BM_ElementWise(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    auto n = state.range(0);
+    auto a = g->addTensor({(int)n}, dtype), b = g->addTensor({(int)n}, dtype);
+    auto op = g->addOp<T>(a, b, nullptr);
+    benchKernel(state, g, op, n, 3.0 * n * dtype.getSize());
+}
+
+template <typename T>
+static void BM_ElementWiseBroadcast(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    int n = state.range(0);
+    auto a = g->addTensor({n / 256, 256}, dtype), b = g->addTensor({256}, dtype);
+    auto op = g->addOp<T>(a, b, nullptr);
+    benchKernel(state, g, op, n, (2.0 * n + 256) * dtype.getSize());
+}
+
+template <typename T> static void BM_Unary(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    auto n = state.range(0);
+    auto op = g->addOp<T>(g->addTensor({(int)n}, dtype), nullptr);
+    benchKernel(state, g, op, n, 2.0 * n * dtype.getSize());
+}
+
+// Casts from Float32 or Int32, the size of both.
+template <CastType Type> static void BM_Cast(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    auto n = state.range(0);
+    auto op = g->addOp<CastObj>(g->addTensor({(int)n}, dtype), nullptr, Type);
+    benchKernel(state, g, op, 0, 2.0 * n * dtype.getSize());
+}
+
+// relu(a * b + c), one pass instead of three ops' worth of traffic.
+static void BM_FusedElementwise(benchmark::State &state) {
+    using Code = ElementwiseExpr::Code;
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    auto n = state.range(0);
+    ElementwiseExpr expr;
+    int mul = expr.add({Code::Mul, expr.add({Code::Input, 0}),
+                        expr.add({Code::Input, 1})});
+    int add = expr.add({Code::Add, mul, expr.add({Code::Input, 2})});
+    expr.add({Code::Relu, add});
+    TensorVec inputs;
+    for (int i = 0; i < 3; ++i)
+        inputs.emplace_back(g->addTensor({(int)n}, DataType::Float32));
+    auto op = g->addOp<FusedElementwiseObj>(inputs, nullptr, expr);
+    benchKernel(state, g, op, 3.0 * n, 4.0 * n * sizeof(float));
+}
+
+static void BM_Clip(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    auto n = state.range(0);
+    auto op = g->addOp<ClipObj>(g->addTensor({(int)n}, dtype), nullptr, 0.f,
+                                6.f);
+    benchKernel(state, g, op, 2.0 * n, 2.0 * n * dtype.getSize());
+}
+
+static void BM_Transpose(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    int s = state.range(0);
+    auto op = g->addOp<TransposeObj>(g->addTensor({s, s}, dtype), nullptr,
+                                     vector<int>{1, 0});
+    benchKernel(state, g, op, 0, 2.0 * s * s * dtype.getSize());
+}
+
+static void BM_Transpose4D(benchmark::State &state) {
+    // [batch, seq, heads, dim] -> [batch, heads, seq, dim]
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    int seq = state.range(0);
+    auto op = g->addOp<TransposeObj>(g->addTensor({1, seq, 8, 64}, dtype),
+                                     nullptr, vector<int>{0, 2, 1, 3});
+    benchKernel(state, g, op, 0, 2.0 * seq * 8 * 64 * dtype.getSize());
+}
+
+static void BM_Concat(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    int s = state.range(0);
+    auto op = g->addOp<ConcatObj>(
+        TensorVec{g->addTensor({s, s}, dtype), g->addTensor({s, s}, dtype)},
+        nullptr, 1);
+    benchKernel(state, g, op, 0, 4.0 * s * s * dtype.getSize());
+}
+
+static void BM_Matmul(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    int s = state.range(0);
+    auto op = g->addOp<MatmulObj>(g->addTensor({s, s}, dtype),
+                                  g->addTensor({s, s}, dtype), nullptr);
+    benchKernel(state, g, op, 2.0 * s * s * s, 3.0 * s * s * dtype.getSize());
+}
+
+// A row of size times a size x size matrix, the single-row GEMV kernel.
+static void BM_Gemv(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    int s = state.range(0);
+    auto op = g->addOp<MatmulObj>(g->addTensor({1, s}, dtype),
+                                  g->addTensor({s, s}, dtype), nullptr);
+    benchKernel(state, g, op, 2.0 * s * s, (1.0 * s * s + 2 * s) *
+                                               dtype.getSize());
+}
+
+// Reduces the rows of a square matrix (axis 1, contiguous runs) or its
+// columns (axis 0, strided accumulation).
+template <int Axis> static void BM_ReduceSum(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    int s = state.range(0);
+    auto op = g->addOp<ReduceSumObj>(g->addTensor({s, s}, dtype), nullptr,
+                                     vector<int>{Axis});
+    benchKernel(state, g, op, 1.0 * s * s, (1.0 * s * s + s) * dtype.getSize());
+}
+
+// [rows, 1024] rows normalized along the last axis.
+static void BM_Softmax(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    int rows = state.range(0) / 1024;
+    auto op = g->addOp<SoftmaxObj>(
+        g->addTensor({rows, 1024}, DataType::Float32), nullptr);
+    benchKernel(state, g, op, 5.0 * rows * 1024, 8.0 * rows * 1024);
+}
+
+static void BM_LayerNorm(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    int rows = state.range(0) / 1024;
+    auto op = g->addOp<LayerNormObj>(
+        g->addTensor({rows, 1024}, DataType::Float32),
+        g->addTensor({1024}, DataType::Float32),
+        g->addTensor({1024}, DataType::Float32), nullptr);
+    benchKernel(state, g, op, 8.0 * rows * 1024, 8.0 * rows * 1024);
+}
+
+static void BM_RMSNorm(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    int rows = state.range(0) / 1024;
+    auto op = g->addOp<RMSNormObj>(
+        g->addTensor({rows, 1024}, DataType::Float32),
+        g->addTensor({1024}, DataType::Float32), nullptr);
+    benchKernel(state, g, op, 5.0 * rows * 1024, 8.0 * rows * 1024);
+}
+
+// NCHW to NCHWc (or back) of size channels over 28x28 pixels.
+template <bool ToBlocked> static void BM_Reorder(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    int c = state.range(0), hw = 28;
+    auto x = ToBlocked ? g->addTensor({1, c, hw, hw}, dtype)
+                       : g->addTensor({1, c / kChannelBlock, hw, hw,
+                                       kChannelBlock},
+                                      dtype);
+    auto op = g->addOp<ReorderObj>(x, nullptr, ToBlocked);
+    benchKernel(state, g, op, 0, 2.0 * c * hw * hw * dtype.getSize());
+}
+
+// 3x3 convolution of size channels over 28x28 pixels, NCHW (im2col and
+// GEMM) or NCHWc (direct kernel).
+template <bool Blocked> static void BM_Conv(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    int c = state.range(0), hw = 28;
+    auto x = Blocked ? g->addTensor({1, c / kChannelBlock, hw, hw,
+                                     kChannelBlock},
+                                    dtype)
+                     : g->addTensor({1, c, hw, hw}, dtype);
+    auto op = g->addOp<ConvObj>(x, g->addTensor({c, c, 3, 3}, dtype),
+                                g->addTensor({c}, dtype), nullptr,
+                                vector<int>{1, 1, 1, 1}, vector<int>{1, 1},
+                                vector<int>{1, 1}, 1, Blocked);
+    benchKernel(state, g, op, 2.0 * c * c * 9 * hw * hw,
+                (2.0 * c * hw * hw + 9.0 * c * c) * dtype.getSize());
+}
+
+// 3x3 max pooling with stride 2 of size channels over 56x56 pixels.
+template <bool Blocked> static void BM_MaxPool(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    int c = state.range(0), hw = 56;
+    auto x = Blocked ? g->addTensor({1, c / kChannelBlock, hw, hw,
+                                     kChannelBlock},
+                                    dtype)
+                     : g->addTensor({1, c, hw, hw}, dtype);
+    auto op = g->addOp<MaxPoolObj>(x, nullptr, vector<int>{3, 3},
+                                   vector<int>{1, 1, 1, 1}, vector<int>{2, 2},
+                                   Blocked);
+    benchKernel(state, g, op, 9.0 * op->getOutput()->size(),
+                (1.25 * c * hw * hw) * dtype.getSize());
+}
+
+// Random rows of a [size, 64] table, 16384 lookups.
+static void randomRows(const Tensor &indices, int rows) {
+    auto p = indices->getRawDataPtr<int32_t *>();
+    uint32_t x = 12345;
+    for (size_t i = 0; i < indices->size(); ++i)
+        p[i] = (x = x * 1664525u + 1013904223u) % rows;
+}
+
+static void BM_Gather(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    int rows = state.range(0), lookups = 16384;
+    auto indices = g->addTensor({lookups}, DataType::Int32);
+    auto op = g->addOp<GatherObj>(g->addTensor({rows, 64}, dtype), indices,
+                                  nullptr);
+    benchKernel(state, g, op, 0, 2.0 * lookups * 64 * dtype.getSize(),
+                [&] { randomRows(indices, rows); });
+}
+
+// 1024 bags of 16 rows.
+static void BM_EmbeddingBag(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    DataType dtype(state.range(1));
+    int rows = state.range(0);
+    auto indices = g->addTensor({1024, 16}, DataType::Int32);
+    auto op = g->addOp<EmbeddingBagObj>(g->addTensor({rows, 64}, dtype),
+                                        indices, nullptr);
+    benchKernel(state, g, op, 16384.0 * 64, 16384.0 * 64 * dtype.getSize(),
+                [&] { randomRows(indices, rows); });
+}
+
+// 512 x 512 times a 512 x 512 weight with `zeros` percent of its blocks of
+// 1x1, 4x4 or 1x8 (block 1, 4 or 8) zero, against BM_Matmul at size 512.
+static void BM_SparseMatmul(benchmark::State &state) {
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    const int s = 512, zeros = state.range(0);
+    const int cols = state.range(1), rows = cols == 4 ? 4 : 1;
+    vector<float> w(s * s, 0.f);
+    uint32_t x = 12345;
+    for (int i = 0; i < s; i += rows)
+        for (int j = 0; j < s; j += cols)
+            if (((x = x * 1664525u + 1013904223u) >> 8) % 100 >=
+                (uint32_t)zeros)
+                for (int r = i; r < i + rows; ++r)
+                    std::fill_n(&w[r * s + j], cols, 1.f);
+    auto sparse = BlockSparse::encode(w.data(), s, s, false, rows, cols);
+    const int blocks = sparse.blocks();
+    auto values = g->addTensor({blocks, rows, cols}, DataType::Float32);
+    auto index = g->addTensor({blocks}, DataType::Int32);
+    auto offsets = g->addTensor({s / cols + 1}, DataType::Int32);
+    auto op = g->addOp<SparseMatmulObj>(
+        g->addTensor({s, s}, DataType::Float32), values, index, offsets,
+        nullptr, rows, cols);
+    const double nonzeros = sparse.values.size();
+    benchKernel(state, g, op, 2.0 * s * nonzeros,
+                (2.0 * s * s + nonzeros + blocks) * sizeof(float), [&] {
+                    std::copy(sparse.values.begin(), sparse.values.end(),
+                              values->getRawDataPtr<float *>());
+                    std::copy(sparse.index.begin(), sparse.index.end(),
+                              index->getRawDataPtr<int32_t *>());
+                    std::copy(sparse.offsets.begin(), sparse.offsets.end(),
+                              offsets->getRawDataPtr<int32_t *>());
+                });
+}
+
+/**
+ * @brief Fork/join cost of one parallel loop with a trivial body, on the
+ * runtime thread pool or with an OpenMP parallel region.
+ */
+template <bool pool> static void BM_ParallelDispatch(benchmark::State &state) {
+    const int threads = state.range(0);
+    auto &threadPool = runtimeWith(threads)->getThreadPool();
+    vector<int> hits(threads * 16);
+    for (auto _ : state) {
+        if (pool)
+            threadPool.parallel(threads, [&](int t, int) { ++hits[t * 16]; });
+        else {
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads)
+            ++hits[omp_get_thread_num() * 16];
+#endif
+        }
+    }
+    benchmark::DoNotOptimize(hits.data());
+}
+
+static void elementArgs(benchmark::internal::Benchmark *b) {
+    sweep(b, {1 << 10, 1 << 16, 1 << 20});
+}
+static void squareArgs(benchmark::internal::Benchmark *b) {
+    sweep(b, {64, 256, 1024});
+}
+
+BENCHMARK(BM_ElementWise<AddObj>)->Apply(elementArgs);
+BENCHMARK(BM_ElementWise<SubObj>)->Apply(elementArgs);
+BENCHMARK(BM_ElementWise<MulObj>)->Apply(elementArgs);
+BENCHMARK(BM_ElementWise<DivObj>)->Apply(elementArgs);
+BENCHMARK(BM_ElementWiseBroadcast<AddObj>)->Apply(elementArgs);
+BENCHMARK(BM_Unary<ReluObj>)->Apply(elementArgs);
+BENCHMARK(BM_Unary<ExpObj>)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {1 << 10, 1 << 16, 1 << 20}, {DataType::Float32.getIndex()});
+});
+BENCHMARK(BM_Unary<SqrtObj>)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {1 << 10, 1 << 16, 1 << 20}, {DataType::Float32.getIndex()});
+});
+BENCHMARK(BM_Cast<CastType::Float2Int32>)
+    ->Apply([](benchmark::internal::Benchmark *b) {
+        sweep(b, {1 << 10, 1 << 16, 1 << 20}, {DataType::Float32.getIndex()});
+    });
+BENCHMARK(BM_Cast<CastType::Int322Float>)
+    ->Apply([](benchmark::internal::Benchmark *b) {
+        sweep(b, {1 << 10, 1 << 16, 1 << 20}, {DataType::Int32.getIndex()});
+    });
+BENCHMARK(BM_FusedElementwise)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {1 << 10, 1 << 16, 1 << 20}, {DataType::Float32.getIndex()});
+});
+BENCHMARK(BM_Clip)->Apply(elementArgs);
+BENCHMARK(BM_Transpose)->Apply(squareArgs);
+BENCHMARK(BM_Transpose4D)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {16, 128, 512});
+});
+BENCHMARK(BM_Concat)->Apply(squareArgs);
+BENCHMARK(BM_ReduceSum<0>)->Apply(squareArgs);
+BENCHMARK(BM_ReduceSum<1>)->Apply(squareArgs);
+BENCHMARK(BM_Softmax)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {1 << 16, 1 << 20}, {DataType::Float32.getIndex()});
+});
+BENCHMARK(BM_LayerNorm)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {1 << 16, 1 << 20}, {DataType::Float32.getIndex()});
+});
+BENCHMARK(BM_RMSNorm)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {1 << 16, 1 << 20}, {DataType::Float32.getIndex()});
+});
+BENCHMARK(BM_Reorder<true>)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {16, 64, 256});
+});
+BENCHMARK(BM_Reorder<false>)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {16, 64, 256});
+});
+BENCHMARK(BM_Conv<false>)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {16, 64, 256}, {DataType::Float32.getIndex()});
+});
+BENCHMARK(BM_Conv<true>)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {16, 64, 256}, {DataType::Float32.getIndex()});
+});
+BENCHMARK(BM_MaxPool<false>)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {64, 256});
+});
+BENCHMARK(BM_MaxPool<true>)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {64, 256});
+});
+BENCHMARK(BM_Gather)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {1 << 12, 1 << 18}, {DataType::Float32.getIndex()});
+});
+BENCHMARK(BM_EmbeddingBag)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {1 << 12, 1 << 18}, {DataType::Float32.getIndex()});
+});
+BENCHMARK(BM_SparseMatmul)
+    ->ArgNames({"zeros", "block", "threads"})
+    ->ArgsProduct({{70, 90, 97}, {1, 4, 8}, threadCounts()})
+    ->UseRealTime();
+BENCHMARK(BM_ParallelDispatch<true>)
+    ->ArgName("threads")
+    ->ArgsProduct({threadCounts()})
+    ->UseRealTime();
+BENCHMARK(BM_ParallelDispatch<false>)
+    ->ArgName("threads")
+    ->ArgsProduct({threadCounts()})
+    ->UseRealTime();
+BENCHMARK(BM_Matmul)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {64, 128, 256, 512});
+});
+BENCHMARK(BM_Gemv)->Apply([](benchmark::internal::Benchmark *b) {
+    sweep(b, {256, 1024, 4096});
+});
+
+} // namespace infini
+
+INFINI_BENCHMARK_MAIN();
@@ -1,4 +1,5 @@
 #pragma once
+#include "core/memory_plan.h"
 #include "core/runtime.h"
 #include "core/tensor.h"
 #ifdef BUILD_TEST
@@ -29,6 +30,8 @@ namespace infini {
     // =================================== 作业 ===================================
     map<size_t, size_t> free_blocks; // addr - size
 
+    AllocatorStats stats;
+
   public:
     Allocator(Runtime runtime);
 
@@ -50,6 +53,10 @@ namespace infini {
     // return: pointer to the head address of the allocated memory
     void *getPtr();
 
+    size_t getPeak() const { return peak; }
+
+    const AllocatorStats &getStats() const { return stats; }
+
     void info();
 
   private:
@@ -0,0 +1,40 @@
+#pragma once
+#include "core/graph.h"
+
+namespace infini
+{
+    /**
+     * @brief Emits `graph` as a standalone C++17 source file for fixed-shape
+     * deployments, without the runtime, the kernel registry or any other
+     * dependency than the standard library.
+     *
+     * The graph must have been planned by dataMalloc, after optimize if
+     * wanted. Shapes, strides and attributes become template arguments and
+     * constants of the kernel calls, weights become constant arrays and the
+     * other tensors live in a static arena at the offsets dataMalloc planned
+     * (see GraphObj::getMemoryPlan). Views cost nothing, as in the runtime.
+     * The file defines, with C linkage:
+     *
+     *   int <name>_run(const void *const *inputs, void *const *outputs);
+     *   extern const int <name>_num_inputs, <name>_num_outputs;
+     *   extern const size_t <name>_input_bytes[], <name>_output_bytes[];
+     *
+     * Inputs are the graph inputs other than weights in graph order, as
+     * Session::getInputs, and outputs are as GraphObj::getOutputs. run
+     * returns 0, or 1 if a gather index is out of range. It runs on the
+     * calling thread and is not reentrant, the arena being shared.
+     *
+     * Float32 graphs of elementwise, unary, clip, fused elementwise, matmul,
+     * softmax, layer and RMS norm, transpose, shape-only, concat, gather and
+     * reduce ops are supported; gather indices may be Int32 or Int64.
+     */
+    string generateCpp(const Graph &graph, const string &name = "model");
+
+    /**
+     * @brief Writes generateCpp(graph, name) to `path`, to be compiled e.g.
+     * with SharedLibrary::compile or into a static library.
+     */
+    void saveCpp(const Graph &graph, const string &path,
+                 const string &name = "model");
+
+} // namespace infini
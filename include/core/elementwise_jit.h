@@ -0,0 +1,104 @@
+#pragma once
+#include "operators/fused_elementwise.h"
+#include "utils/shared_library.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace infini
+{
+    /**
+     * @brief Compiles the expressions of FusedElementwise ops to native code.
+     *
+     * Each (expression, input steps) pair gets a C++ kernel over one row of
+     * the output, built with the host compiler (SharedLibrary::compile) for
+     * the host's instruction set and loaded once per process. Rows are
+     * processed in blocks of 16 elements with every node of the expression
+     * kept in vector registers; the last partial block is padded to a full
+     * one instead of falling back to scalar code. Libraries are cached in a
+     * directory under a hash of their key, so that later processes skip the
+     * compiler. The directory is taken from the INFINI_JIT_CACHE environment
+     * variable, $XDG_CACHE_HOME/infini-jit or ~/.cache/infini-jit by default,
+     * and is only used if no other user can write to it.
+     *
+     * The JIT is opt-in, as it needs a host compiler and compiles on first
+     * use: enable it with setEnabled or the INFINI_JIT=1 environment
+     * variable.
+     *
+     * When compiling is disabled or fails, get() returns nullptr and the
+     * kernel interprets the expression (ElementwiseExpr::evaluate).
+     */
+    class ElementwiseJit
+    {
+    public:
+        // Writes the expression at n elements to `output`, input k being
+        // read at inputs[k][i * step_k] with the steps it was compiled for.
+        using Kernel = void (*)(const float *const *inputs, float *output,
+                                size_t n);
+
+    private:
+        struct Entry
+        {
+            std::unique_ptr<SharedLibrary> library;
+            Kernel kernel = nullptr; // nullptr if compiling failed
+            // Being compiled by a thread, without holding the lock.
+            bool building = false;
+        };
+        std::unordered_map<string, Entry> entries;
+        // Per-operator memo, so that steady-state runs skip building keys.
+        std::unordered_map<UidBaseType, pair<vector<int>, Kernel>> opKernels;
+        string cacheDir, error;
+        bool enabled = false;
+        size_t compiles = 0;
+        mutable std::mutex mutex;
+        // Signalled whenever an entry is built.
+        std::condition_variable built;
+
+        ElementwiseJit();
+
+    public:
+        static ElementwiseJit &getInstance()
+        {
+            static ElementwiseJit instance;
+            return instance;
+        }
+
+        /**
+         * @brief Kernel of `op` over the rows of FusedElementwiseObj::getRows,
+         * compiling it if new. nullptr if some input is read with a step
+         * other than 0 or 1 along rows, or if no kernel could be built.
+         */
+        Kernel get(const FusedElementwiseObj &op);
+        /**
+         * @brief Kernel for `expr` with input k read with steps[k], 0 or 1.
+         */
+        Kernel get(const ElementwiseExpr &expr, const vector<int> &steps);
+
+        static string getKey(const ElementwiseExpr &expr,
+                             const vector<int> &steps);
+        // Source of the kernel, exporting it as `infini_fused`.
+        static string generate(const ElementwiseExpr &expr,
+                               const vector<int> &steps);
+
+        void setCacheDir(const string &dir);
+        string getCacheDir() const;
+        void setEnabled(bool enabled);
+        bool isEnabled() const;
+        // The compiler's output for the last failed kernel, if any.
+        string getError() const;
+        // Kernels built by the compiler rather than found in the cache.
+        size_t getCompiles() const;
+        // Kernels loaded in this process, failures included.
+        size_t size() const;
+        // Unloads every kernel; the ones returned before must not be used.
+        void clear();
+
+    private:
+        // Loads or compiles the kernel of `key` in `dir`, setting `error` on
+        // failure and counting compiles. Called without the lock.
+        static Entry load(const string &key, const ElementwiseExpr &expr,
+                          const vector<int> &steps, const string &dir,
+                          string &error, size_t &compiles);
+    };
+
+} // namespace infini
@@ -15,6 +15,7 @@ namespace infini
         TensorVec tensors;
         OpVec ops;
         Allocator allocator;
+        MemoryPlan memoryPlan;
 
     public:
         explicit GraphObj(Runtime runtime)
@@ -55,8 +56,49 @@ namespace infini
 
         void shape_infer();
 
+        /**
+         * @brief Allocates the arena and binds every tensor to it. Tensors bound
+         * to external buffers are left out of the plan.
+         *
+         * Buffers are planned in execution order and reused once their tensor
+         * has no later consumers. Outputs of ops declaring in-place inputs
+         * (OperatorObj::getInplaceInputs) share the buffer of such an input
+         * when it dies at that op. Graph inputs, weights and graph outputs are
+         * never overwritten or reused.
+         *
+         * Ops that only rearrange data (OperatorObj::inferView) become
+         * zero-copy views of their input when every consumer accepts strided
+         * input. Otherwise their kernel runs and materializes a dense copy.
+         * Every other op gets the best registered kernel that applies to its
+         * final shapes and layouts (KernelRegistry::select).
+         */
         void dataMalloc();
 
+        /**
+         * @brief The arena layout decided by the last dataMalloc.
+         */
+        const MemoryPlan &getMemoryPlan() const { return memoryPlan; }
+
+        /**
+         * @brief Binds a caller-owned buffer as the data of a graph input (or
+         * output) tensor so that requests are read from and results written to
+         * it in place. May be called before dataMalloc, which then excludes the
+         * tensor from the arena, and again before every run to rebind. `owner`,
+         * if any, is kept alive until the tensor is rebound or destroyed.
+         */
+        void bindInput(const Tensor &tensor, void *ptr, size_t bytes,
+                       Ref<void> owner = nullptr);
+        void bindOutput(const Tensor &tensor, void *ptr, size_t bytes,
+                        Ref<void> owner = nullptr);
+
+        /**
+         * @brief A new graph on `runtime` with clones of `ops`, some ops of
+         * this graph in topological order, and of the tensors they use. Clones
+         * keep the fuid of their original (see getTensor). Tensors produced
+         * outside of `ops` become inputs, and weights share their data.
+         */
+        Graph extract(const OpVec &ops, Runtime runtime) const;
+
         /**
          * @brief Add an operator and create its outputs. Output tensor arguments
          * should be empty Refs (e.g., nullptr).
@@ -112,24 +154,54 @@ namespace infini
          */
         void addOperatorAndConnect(const Operator &op);
 
+        /**
+         * @brief Decides which ops run as views and sets tensor layouts.
+         */
+        void planViews();
+
+        /**
+         * @brief Chooses the kernel of every op that is not a view.
+         */
+        void planKernels();
+
         /**
          * @brief If the nodes is sorted in topological order.
          */
         bool sorted;
-        std::vector<Operator> remove_ops;
-        std::vector<Tensor> remove_tensors;
-        std::vector<Tensor> wait_for_cut;
-        void removeConnections(const Operator &op, const Operator &upstream_op);
-        void reconnectDownstream(const Operator &op, const Tensor &upstream_tensor);
-        void markForRemoval(const Operator &op,
-                                std::vector<Operator> &remove_ops,
-                                std::vector<Tensor> &remove_tensors,
-                                std::vector<Tensor> &wait_for_cut);
-        void cleanIsolatedTensors(std::vector<Tensor> &wait_for_cut,
-                                  std::vector<Operator> &remove_ops,
-                                  std::vector<Tensor> &remove_tensors);
-        void finalizeRemoval(const std::vector<Operator> &remove_ops,
-                                   const std::vector<Tensor> &remove_tensors);
+        /**
+         * @brief Makes `op` read `to` instead of `from`, keeping tensor targets
+         * and operator predecessors/successors consistent.
+         */
+        void replaceOperatorInput(const Operator &op, const Tensor &from,
+                                  const Tensor &to);
+        /**
+         * @brief Removes `op` and its outputs if none of them has a consumer.
+         */
+        void removeIfUnused(const Operator &op);
+        /**
+         * @brief Replaces `pattern`, ops in topological order whose last op
+         * produces the output of `fused`, with `fused`.
+         */
+        void replaceWithFused(const OpVec &pattern, const Operator &fused);
+        /**
+         * @brief Runs convolutions with a direct kernel in the NCHWc layout.
+         * Reorders between layouts are moved past elementwise ops and
+         * poolings and cancelled between consecutive convolutions, so chains
+         * of them stay blocked.
+         */
+        void blockConvolutions();
+        /**
+         * @brief Replaces Matmul ops whose constant weight is mostly zeros
+         * by SparseMatmul, storing the weight in the block shape with the
+         * cheapest estimated product.
+         */
+        void sparsifyMatmuls();
+        /**
+         * @brief Replaces trees of float elementwise ops of the same output
+         * shape, whose intermediate results have no other consumer, by
+         * FusedElementwise ops.
+         */
+        void fuseElementwise();
     };
 
 } // namespace infini
@@ -2,6 +2,7 @@
 #include "core/common.h"
 #include "core/operator.h"
 #include "core/tensor.h"
+#include "core/thread_pool.h"
 #include "utils/operator_utils.h"
 #include <functional>
 
@@ -23,45 +24,115 @@ namespace infini
                              const RuntimeObj *context) const = 0;
     };
 
+    /**
+     * @brief Kernels by (Device, OpType). A key may have several candidates,
+     * e.g. a GEMV next to a blocked GEMM, each with a priority and an
+     * optional predicate on the operator (dtype, shapes, strides, host ISA).
+     * An operator runs the candidate of highest priority that applies to it,
+     * chosen once by GraphObj::dataMalloc rather than at every run.
+     */
     class KernelRegistry
     {
     public:
-        using KernelRecord =
-            tuple<Kernel *const, const string, const int>; // Kernel, name, ID
+        // Whether a kernel applies to an operator.
+        using Predicate = std::function<bool(const OperatorObj &)>;
+
+        struct KernelRecord
+        {
+            Kernel *kernel;
+            string name;
+            int id;
+            int priority;
+            Predicate predicate; // Empty if the kernel applies to every op.
+        };
 
     private:
-        std::map<KernelAttrs, KernelRecord> kernels;
+        // Candidates of every key by decreasing priority.
+        std::map<KernelAttrs, vector<KernelRecord>> kernels;
         int nKernels = 0;
 
     public:
         ~KernelRegistry()
         {
-            for (auto &[k, v] : kernels)
-                delete std::get<0>(v);
+            for (auto &[k, records] : kernels)
+                for (auto &record : records)
+                    delete record.kernel;
         }
         static KernelRegistry &getInstance()
         {
             static KernelRegistry instance;
             return instance;
         }
-        bool registerKernel(const KernelAttrs &key, Kernel *kernel, string name)
+        /**
+         * @brief Adds a candidate for `key`. Priorities must be unique per key,
+         * so that the choice does not depend on the order of registration.
+         */
+        bool registerKernel(const KernelAttrs &key, Kernel *kernel, string name,
+                            int priority = 0, Predicate predicate = nullptr)
         {
-            IT_ASSERT(kernels.find(key) == kernels.end(),
-                      "Kernel already registered");
-            kernels.emplace(key, KernelRecord{kernel, name, ++nKernels});
+            auto &records = kernels[key];
+            for (auto &record : records)
+                IT_ASSERT(record.name != name && record.priority != priority,
+                          "Kernel already registered");
+            auto it = std::find_if(records.begin(), records.end(),
+                                   [&](const KernelRecord &record)
+                                   { return record.priority < priority; });
+            records.insert(it, KernelRecord{kernel, std::move(name),
+                                            ++nKernels, priority,
+                                            std::move(predicate)});
             return true;
         }
-        Kernel *getKernel(const KernelAttrs &kernelAttrs) const
+        /**
+         * @brief The candidate of highest priority that applies to `op`,
+         * nullptr if none does or the key has no kernel.
+         */
+        const KernelRecord *select(const KernelAttrs &kernelAttrs,
+                                   const OperatorObj &op) const
         {
             auto it = kernels.find(kernelAttrs);
-            IT_ASSERT(it != kernels.end(), "Kernel not found for key {" +
+            if (it == kernels.end())
+                return nullptr;
+            for (auto &record : it->second)
+                if (!record.predicate || record.predicate(op))
+                    return &record;
+            return nullptr;
+        }
+        Kernel *getKernel(const KernelAttrs &kernelAttrs,
+                          const OperatorObj &op) const
+        {
+            auto record = select(kernelAttrs, op);
+            IT_ASSERT(record, "No kernel for key {" +
+                                  get_kernel_attrs_str(kernelAttrs) +
+                                  "} applies to " + op.toString());
+            return record->kernel;
+        }
+        /**
+         * @brief The general kernel of a key: the one of highest priority
+         * without a predicate.
+         */
+        Kernel *getKernel(const KernelAttrs &kernelAttrs) const
+        {
+            return getKernelItem(kernelAttrs).kernel;
+        }
+        const KernelRecord &getKernelItem(const KernelAttrs &kernelAttrs) const
+        {
+            auto &records = getCandidates(kernelAttrs);
+            auto it = std::find_if(records.begin(), records.end(),
+                                   [](const KernelRecord &record)
+                                   { return !record.predicate; });
+            IT_ASSERT(it != records.end(), "No general kernel for key {" +
                                                get_kernel_attrs_str(kernelAttrs) +
                                                "}");
-            return std::get<0>(it->second);
+            return *it;
         }
-        const KernelRecord &getKernelItem(const KernelAttrs &kernelAttrs) const
+        const vector<KernelRecord> &
+        getCandidates(const KernelAttrs &kernelAttrs) const
         {
-            return kernels.at(kernelAttrs);
+            auto it = kernels.find(kernelAttrs);
+            IT_ASSERT(it != kernels.end(), "Kernel not found for key {" +
+                                               get_kernel_attrs_str(kernelAttrs) +
+                                               "}");
+            return it->second;
         }
     };
 
@@ -72,6 +143,38 @@ namespace infini
                              const RuntimeObj *context) const = 0;
     };
 
+    /**
+     * @brief Tunable parameters of a kernel, e.g. tile sizes or grain size.
+     */
+    using KernelConfig = vector<int>;
+
+    /**
+     * @brief A kernel with a search space of configurations. compute() runs
+     * the configuration picked by the Tuner for the operator.
+     */
+    class CpuKernelWithConfig : public Kernel
+    {
+    public:
+        /**
+         * @brief Candidate configurations for `op`, never empty. The first one
+         * is the default used when tuning is disabled.
+         */
+        virtual vector<KernelConfig> getSearchSpace(const Operator &op) const = 0;
+
+        /**
+         * @brief Operator attributes that change the best configuration
+         * besides op type, dtype, shapes and thread count.
+         */
+        virtual string getTuningAttrs(const Operator &op) const { return ""; }
+
+        virtual void computeWithConfig(const Operator &op,
+                                       const KernelConfig &config,
+                                       const RuntimeObj *context) const = 0;
+
+        void compute(const Operator &op,
+                     const RuntimeObj *context) const override;
+    };
+
 } // namespace infini
 
 #define _REGISTER_KERNEL_1(device, opType, kernel, name, cnt)                 \
@@ -85,3 +188,19 @@ namespace infini
 
 #define REGISTER_KERNEL(device, opType, kernel, name) \
     _REGISTER_KERNEL_1(device, opType, kernel, name, __COUNTER__)
+
+#define _REGISTER_KERNEL_IF_1(device, opType, kernel, name, priority,          \
+                              predicate, cnt)                                 \
+    namespace infini                                                          \
+    {                                                                         \
+        static const bool _CAT(_register_kernel_, cnt) =                      \
+            KernelRegistry::getInstance().registerKernel(                     \
+                KernelAttrs{device, opType}, new kernel(), name, priority,    \
+                predicate);                                                   \
+    }
+
+// Registers a candidate that runs the ops satisfying `predicate` in
+// preference to the kernels of lower priority, REGISTER_KERNEL's being 0.
+#define REGISTER_KERNEL_IF(device, opType, kernel, name, priority, predicate) \
+    _REGISTER_KERNEL_IF_1(device, opType, kernel, name, priority, predicate,  \
+                          __COUNTER__)
@@ -0,0 +1,73 @@
+#pragma once
+#include "core/common.h"
+#include "core/object.h"
+
+namespace infini
+{
+    /**
+     * @brief Counters of the decisions of an Allocator.
+     */
+    struct AllocatorStats
+    {
+        size_t allocs = 0;
+        size_t frees = 0;
+        // Allocations served from a free block rather than the arena end.
+        size_t reused = 0;
+        // Allocations that extended a free block at the arena end.
+        size_t grownTail = 0;
+        // Freed blocks coalesced with a neighbour.
+        size_t merges = 0;
+    };
+
+    /**
+     * @brief The arena layout decided by GraphObj::dataMalloc, for finding
+     * out why an arena is as large as it is.
+     *
+     * Steps are the indices of ops in execution order. A buffer is live from
+     * the step of the op producing it (-1 for graph inputs and weights) to
+     * the step of its last consumer, both included; buffers that must outlive
+     * runs end at the number of steps. Export with toJson() for a timeline
+     * plot or toCsv() for a spreadsheet, or set INFINI_MEMORY_PLAN to a path
+     * (.csv for CSV) to have dataMalloc write it.
+     */
+    struct MemoryPlan
+    {
+        struct Buffer
+        {
+            // Fuid of every tensor sharing the buffer, views and in-place
+            // outputs after the first.
+            vector<UidBaseType> tensors;
+            size_t offset, bytes;
+            int allocStep, freeStep;
+        };
+
+        // The op run at each step, e.g. "Matmul[12]".
+        vector<string> steps;
+        vector<Buffer> buffers;
+        size_t peak = 0;
+        AllocatorStats allocator;
+
+        // Sum of the sizes of all buffers.
+        size_t tensorBytes() const;
+        // Bytes live at `step`, and the step where that is largest.
+        size_t liveBytes(int step) const;
+        int maxLiveStep() const;
+        // Share of the arena not needed at its fullest step.
+        double fragmentation() const;
+        // Bytes of buffers per byte of arena.
+        double reuseRatio() const;
+
+        string toJson() const;
+        string toCsv() const;
+        /**
+         * @brief Human-readable statistics, with the largest buffers live at
+         * the fullest step and the ops producing them.
+         */
+        string summary() const;
+        /**
+         * @brief Writes toCsv() if `path` ends in .csv, toJson() otherwise.
+         */
+        void save(const string &path) const;
+    };
+
+} // namespace infini
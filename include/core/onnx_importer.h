@@ -0,0 +1,29 @@
+#pragma once
+#include "core/graph.h"
+
+namespace infini
+{
+    /**
+     * @brief Builds a graph from a local ONNX model file.
+     *
+     * Supported nodes are Add, Sub, Mul, Div, Relu, Exp, Sqrt, Clip, Cast,
+     * Concat, Transpose, Reshape, Flatten, Squeeze, Unsqueeze, Gather,
+     * ReduceSum, ReduceMean, ReduceMax, ReduceMin, ReduceProd, Softmax,
+     * LayerNormalization, RMSNormalization, MatMul, Gemm, Conv, MaxPool,
+     * AveragePool, GlobalAveragePool (all 2D) and Constant. Shapes and axes
+     * passed as inputs must be constants. Graph inputs are added first in
+     * declaration order, followed by initializers, which become weight tensors
+     * (TensorObj::isWeight) with their data already bound, so dataMalloc only
+     * plans activations. Output shapes are inferred while the nodes are added.
+     *
+     * The file is memory-mapped and parsed in a single pass; each initializer
+     * is copied once into its own buffer and the consumed file pages are
+     * released right away, so import never holds two copies of the weights.
+     *
+     * @param inputShapes Overrides the shape of graph inputs by name, required
+     * for inputs with symbolic dimensions.
+     */
+    Graph importOnnx(Runtime runtime, const string &path,
+                     const std::map<string, Shape> &inputShapes = {});
+
+} // namespace infini
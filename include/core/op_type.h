@@ -24,6 +24,30 @@ namespace infini
             Relu,
             Sub,
             Transpose,
+            // Appended to keep the values of serialized models.
+            Reshape,
+            Flatten,
+            Squeeze,
+            Unsqueeze,
+            ReduceSum,
+            ReduceMean,
+            ReduceMax,
+            ReduceMin,
+            ReduceProd,
+            Exp,
+            Sqrt,
+            Softmax,
+            LayerNorm,
+            RMSNorm,
+            Conv,
+            Reorder,
+            MaxPool,
+            AveragePool,
+            GlobalAveragePool,
+            Gather,
+            EmbeddingBag,
+            SparseMatmul,
+            FusedElementwise,
 
         } type;
 
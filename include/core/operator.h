@@ -8,6 +8,7 @@ namespace infini
     using KernelAttrs = std::tuple<Device, OpType::underlying_t>;
 
     class GraphObj;
+    class Kernel;
     class OperatorObj : public Object
     {
         friend class GraphObj;
@@ -18,6 +19,8 @@ namespace infini
         TensorVec outputs;
         vector<WRef<OperatorObj>> predecessors;
         vector<WRef<OperatorObj>> successors;
+        bool view = false; // Planned as a view by GraphObj::dataMalloc.
+        Kernel *plannedKernel = nullptr; // Chosen by GraphObj::dataMalloc.
 
     public:
         OperatorObj(OpType opType, TensorVec inputs, TensorVec outputs);
@@ -55,6 +58,44 @@ namespace infini
         virtual int numInputs() const = 0;
         virtual int numOutputs() const = 0;
 
+        /**
+         * @brief Indices of the inputs whose buffer the first output may reuse,
+         * in order of preference. The kernel must read element i of such an
+         * input before writing element i of the output, and nothing else.
+         * The memory planner aliases the output onto one of them when it has
+         * no later consumers.
+         */
+        virtual vector<int> getInplaceInputs() const { return {}; }
+
+        /**
+         * @brief For ops that only rearrange data, the element strides and byte
+         * offset of the output as a view of input 0 in its current layout.
+         * nullopt if the op cannot run as a view.
+         */
+        virtual optional<pair<Shape, size_t>> inferView() const
+        {
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Whether the kernel reads input `i` through its strides and
+         * offset, so that the input may be a view.
+         */
+        virtual bool acceptsStridedInput(int i) const { return false; }
+
+        /**
+         * @brief Whether the op was planned as a view. Its output then aliases
+         * input 0 and the runtime only refreshes the output's layout instead
+         * of running a kernel.
+         */
+        bool isView() const { return view; }
+
+        /**
+         * @brief The kernel chosen for the op among the registered candidates
+         * (KernelRegistry::select) by the last dataMalloc, nullptr before.
+         */
+        Kernel *getKernel() const { return plannedKernel; }
+
         /**
          * @brief Clone this operator and replace its inputs and outputs.
          *
@@ -86,6 +127,7 @@ namespace infini
         op->outputs = newOutputs;                                      \
         op->predecessors.clear();                                      \
         op->successors.clear();                                        \
+        op->plannedKernel = nullptr;                                   \
         IT_ASSERT(op->checkValid(nullptr));                            \
         return op;                                                     \
     }
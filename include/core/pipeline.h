@@ -0,0 +1,121 @@
+#pragma once
+#include "core/graph.h"
+#include "core/session.h"
+#include "utils/spsc_queue.h"
+
+namespace infini
+{
+    /**
+     * @brief Runs a graph as a pipeline of stages, each on its own runtime
+     * and thread, streaming micro-batches through them.
+     *
+     * The topologically sorted ops are cut into contiguous stages of about
+     * equal estimated cost (see partition). Every stage is a graph of its
+     * own, extracted from the original, whose thread hands each micro-batch
+     * on to the next stage through a lock-free single-producer queue. Tensors
+     * crossing a cut get one buffer per micro-batch in flight, so stages never
+     * wait for each other's buffers and nothing is copied between them.
+     *
+     * Requests are submitted like with Session, one micro-batch at a time:
+     * the graph is built for the micro-batch size.
+     */
+    class Pipeline
+    {
+    public:
+        using Callback = Session::Callback;
+
+    private:
+        // State of one micro-batch in flight, reused for the next one.
+        struct Batch
+        {
+            int slot;
+            vector<void *> results;
+            Callback done;
+            std::exception_ptr error;
+        };
+
+        struct Stage
+        {
+            Graph graph;
+            // Clones reading or writing a tensor crossing a cut, with its
+            // index in `transfers`.
+            vector<pair<Tensor, int>> reads, writes;
+            // Clones of graph outputs, with their index in `outputs`.
+            vector<pair<Tensor, int>> results;
+            SpscQueue<Batch *> queue;
+            std::thread thread;
+
+            explicit Stage(size_t capacity) : queue(capacity) {}
+        };
+
+        Graph graph;
+        TensorVec inputs, outputs;
+        // Graph inputs (first) and tensors produced by one stage and read by
+        // a later one.
+        TensorVec transfers;
+        // buffers[slot][i]: data of transfers[i] for the micro-batch in slot.
+        vector<vector<Ref<void>>> buffers;
+        vector<Batch> batches;
+        vector<std::unique_ptr<Stage>> stages;
+        SpscQueue<int> freeSlots;
+        std::mutex submitLock;
+        size_t running = 0;
+        std::mutex doneLock;
+        std::condition_variable doneChanged;
+
+        void work(size_t stage);
+
+    public:
+        /**
+         * @param graph The graph to run; its data need not be allocated.
+         * @param runtimes The runtime of every stage, e.g. threadGroups().
+         * @param depth Micro-batches in flight before submit() blocks, 0 for
+         * one more than the number of stages.
+         */
+        Pipeline(Graph graph, const vector<Runtime> &runtimes, int depth = 0);
+        // Finishes the micro-batches already submitted.
+        ~Pipeline();
+        Pipeline(const Pipeline &) = delete;
+        Pipeline &operator=(const Pipeline &) = delete;
+
+        /**
+         * @brief Splits `ops`, topologically sorted, into at most `stages`
+         * contiguous non-empty parts minimizing the estimated cost of the most
+         * expensive one.
+         */
+        static vector<OpVec> partition(const OpVec &ops, int stages);
+
+        /**
+         * @brief Rough cost of an op: multiply-adds for matmuls and
+         * convolutions, elements touched for the others.
+         */
+        static double estimateCost(const Operator &op);
+
+        /**
+         * @brief `stages` runtimes over disjoint groups of the CPUs this
+         * process may run on, threads pinned. Groups share CPUs if there are
+         * more stages than CPUs.
+         */
+        static vector<Runtime> threadGroups(int stages);
+
+        vector<Graph> getStages() const;
+        // Graph inputs except weights, in the order submit() takes them.
+        const TensorVec &getInputs() const { return inputs; }
+        const TensorVec &getOutputs() const { return outputs; }
+
+        /**
+         * @brief As Session::submit: copies `data` into the buffers of a free
+         * micro-batch slot and queues it, writing the outputs to `results`.
+         */
+        void submit(const vector<const void *> &data,
+                    const vector<void *> &results, Callback done);
+        std::future<void> submit(const vector<const void *> &data,
+                                 const vector<void *> &results);
+
+        /**
+         * @brief Blocks until every submitted micro-batch has completed.
+         */
+        void wait();
+    };
+
+} // namespace infini
@@ -0,0 +1,73 @@
+#pragma once
+#include "core/object.h"
+#include "core/runtime.h"
+#include "utils/perf_counters.h"
+#include <chrono>
+
+namespace infini
+{
+    /**
+     * @brief Wall time and perf_event counters of every kernel a runtime
+     * runs, attributed to the op guid and op type, to tell compute-bound
+     * kernels from memory-bound ones.
+     *
+     * Counters are opened on the workers of the runtime's thread pool and on
+     * every thread calling run(), and read around each kernel. Worker counts
+     * include the spinning of idle workers and the work of any other graph
+     * running on the same pool at the same time. Where the host does not
+     * permit counters only times are recorded, see isAvailable().
+     */
+    class Profiler
+    {
+    public:
+        struct Entry
+        {
+            UidBaseType guid;
+            OpType type;
+            size_t calls = 0;
+            double seconds = 0;
+            PerfCounters::Values counters{};
+        };
+
+        // Taken before a kernel runs.
+        struct Sample
+        {
+            std::chrono::steady_clock::time_point time;
+            PerfCounters::Values counters;
+            PerfCounters *caller;
+        };
+
+    private:
+        PerfCounters workers;
+        bool hasWorkers;
+        mutable std::mutex lock;
+        // Counters of the threads calling run(), by thread id.
+        std::unordered_map<int, std::unique_ptr<PerfCounters>> callers;
+        // In the order the ops first ran.
+        vector<Entry> entries;
+        std::unordered_map<UidBaseType, size_t> index;
+        uint32_t available;
+        string error;
+
+    public:
+        explicit Profiler(const ThreadPool &pool);
+
+        Sample start();
+        void stop(const Operator &op, const Sample &sample);
+
+        vector<Entry> getEntries() const;
+        // Whether PerfCounters::Event `event` is counted on every thread.
+        bool isAvailable(int event) const;
+        // Why some events are not counted, empty if all of them are.
+        string getError() const;
+        void reset();
+
+        /**
+         * @brief Table of the totals per op type, slowest first, with the
+         * instructions per cycle and the misses per thousand instructions
+         * where the counters are available.
+         */
+        string summary() const;
+    };
+
+} // namespace infini
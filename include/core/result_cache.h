@@ -0,0 +1,82 @@
+#pragma once
+#include "core/common.h"
+#include "core/ref.h"
+#include <list>
+#include <mutex>
+
+namespace infini
+{
+    /**
+     * @brief Outputs of past runs keyed by their inputs' contents, so that
+     * repeated requests are answered without running the graph.
+     *
+     * Entries keep a copy of their inputs, compared byte for byte on lookup,
+     * so that hash collisions never return another request's outputs. The
+     * inputs and outputs of every entry count towards a byte budget, beyond
+     * which the least recently used entries are evicted. Thread-safe.
+     */
+    class ResultCache
+    {
+    public:
+        struct Entry
+        {
+            uint64_t hash;
+            vector<vector<char>> inputs, outputs;
+
+            size_t bytes() const;
+        };
+
+        struct Stats
+        {
+            size_t hits = 0, misses = 0, evictions = 0;
+            size_t entries = 0, bytes = 0;
+        };
+
+    private:
+        size_t capacity;
+        // Most recently used first.
+        std::list<Ref<const Entry>> lru;
+        std::unordered_multimap<uint64_t,
+                                std::list<Ref<const Entry>>::iterator>
+            index;
+        Stats stats;
+        mutable std::mutex mutex;
+
+        void evict();
+
+    public:
+        // `capacity` is the byte budget of inputs and outputs together.
+        explicit ResultCache(size_t capacity);
+
+        /**
+         * @brief Hash of the buffers `data` of `bytes` bytes each (see
+         * hashBytes).
+         */
+        static uint64_t hash(const vector<const void *> &data,
+                             const vector<size_t> &bytes);
+
+        /**
+         * @brief The entry for inputs `data` of `bytes` bytes each, whose
+         * hash is `hash`, or nullptr. Counts a hit or a miss, and makes the
+         * entry the most recently used. The entry stays valid once evicted.
+         */
+        Ref<const Entry> find(uint64_t hash, const vector<const void *> &data,
+                              const vector<size_t> &bytes);
+
+        /**
+         * @brief Stores copies of inputs `data` and of the outputs computed
+         * from them, evicting the least recently used entries beyond the
+         * budget. Entries larger than the whole budget are not stored.
+         */
+        void insert(uint64_t hash, const vector<const void *> &data,
+                    const vector<size_t> &bytes,
+                    const vector<const void *> &outputs,
+                    const vector<size_t> &outputBytes);
+
+        Stats getStats() const;
+        size_t getCapacity() const { return capacity; }
+        // Drops every entry and resets the counters.
+        void clear();
+    };
+
+} // namespace infini
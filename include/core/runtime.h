@@ -2,6 +2,8 @@
 #include "core/common.h"
 #include "core/op_type.h"
 #include "core/ref.h"
+#include "core/thread_pool.h"
+#include <mutex>
 
 namespace infini
 {
@@ -10,6 +12,7 @@ namespace infini
   class GraphObj;
   class RuntimeObj;
   class BlobObj;
+  class Profiler;
 
   using Tensor = Ref<TensorObj>;
   using Operator = Ref<OperatorObj>;
@@ -45,14 +48,45 @@ namespace infini
     {
       return true;
     }
+    Device getDevice() const { return device; }
 
     virtual string toString() const = 0;
   };
 
+  /**
+   * @brief Placement of a CPU runtime. The defaults share ThreadPool::global(),
+   * sized to the CPUs the process may run on, and leave memory to the OS.
+   */
+  struct CpuConfig
+  {
+    // Size of the runtime's ThreadPool, including the thread calling run(),
+    // 0 for one thread per CPU in `cpus` or, without `cpus`, per CPU the
+    // process may run on.
+    int threads = 0;
+    // CPUs that threads are pinned to, round-robin by thread number. Empty
+    // for no pinning, or all CPUs of `numaNode` if that is set.
+    vector<int> cpus;
+    // NUMA node whose memory backs allocations, -1 for first-touch by the
+    // threads of the runtime.
+    int numaNode = -1;
+    // Elements per thread below which kernels use fewer threads.
+    size_t minWork = ThreadPool::kDefaultMinWork;
+  };
+
   class NativeCpuRuntimeObj : public RuntimeObj
   {
+    CpuConfig config;
+    // ThreadPool::global() for a default config.
+    std::unique_ptr<ThreadPool> ownPool;
+    ThreadPool *pool;
+    // Sizes of mapped allocations, for dealloc.
+    std::mutex mappedLock;
+    std::unordered_map<void *, size_t> mapped;
+    std::unique_ptr<Profiler> profiler;
+
   public:
-    NativeCpuRuntimeObj() : RuntimeObj(Device::CPU) {}
+    explicit NativeCpuRuntimeObj(CpuConfig config = {});
+    ~NativeCpuRuntimeObj() override;
 
     static Ref<NativeCpuRuntimeObj> &getInstance()
     {
@@ -60,9 +94,42 @@ namespace infini
           make_ref<NativeCpuRuntimeObj>();
       return instance;
     }
-    void dealloc(void *ptr) override;
+
+    /**
+     * @brief One runtime per NUMA node, each pinned to the CPUs of its node
+     * and allocating from its memory, so that model instances on different
+     * runtimes never cross the interconnect. A single default runtime if the
+     * host does not report NUMA nodes.
+     */
+    static vector<Ref<NativeCpuRuntimeObj>> perNumaNode();
+
+    const CpuConfig &getConfig() const { return config; }
+    ThreadPool &getThreadPool() const { return *pool; }
+
+    /**
+     * @brief Times every kernel run from now on and counts its hardware
+     * events (see Profiler), or stops doing so and drops the profile. Not
+     * to be called while a graph runs.
+     */
+    void setProfiling(bool enabled);
+    // The profile since profiling was enabled, null if it is not.
+    Profiler *getProfiler() const { return profiler.get(); }
+
+    /**
+     * @brief Runs the graph with the thread pool of this runtime as
+     * ThreadPool::current(). If `config.cpus` is set, the calling thread,
+     * which takes part in every parallel loop, is pinned to its first CPU
+     * for the duration of the run, then given back its previous CPUs.
+     */
     void run(const Graph &graph) const override;
+
+    /**
+     * @brief Zeroed memory. Large blocks are mapped and either bound to
+     * `config.numaNode` or first-touched in parallel by the threads of this
+     * runtime, so pages land on the nodes of the threads that use them.
+     */
     void *alloc(size_t size) override;
+    void dealloc(void *ptr) override;
     string toString() const override;
   };
 
@@ -0,0 +1,35 @@
+#pragma once
+#include "core/graph.h"
+
+namespace infini
+{
+    /**
+     * @brief Binary model file layout (all integers little-endian):
+     *
+     *   header    magic "ITMODEL\0", version, #tensors, #operators,
+     *             offset and size of the weight section
+     *   tensors   per tensor: dtype, flags, rank, dims and, for weights, the
+     *             offset and size of its data inside the weight section
+     *   operators per operator: op type, input and output tensor indices and
+     *             an op-specific attribute payload
+     *   weights   raw tensor data, every weight aligned to kModelAlignment
+     *             bytes from the beginning of the file
+     */
+    constexpr size_t kModelAlignment = 64;
+
+    /**
+     * @brief Writes `graph` to `path`. Weight tensors (TensorObj::isWeight)
+     * must have their data bound.
+     */
+    void saveGraph(const Graph &graph, const string &path);
+
+    /**
+     * @brief Loads a graph written by saveGraph. The file is memory-mapped
+     * read-only and weight tensors point directly into the mapping, so pages
+     * are read on first touch and shared between processes through the page
+     * cache. The mapping lives as long as any weight tensor does. Weights are
+     * external, dataMalloc only plans activations.
+     */
+    Graph loadGraph(Runtime runtime, const string &path);
+
+} // namespace infini
@@ -0,0 +1,119 @@
+#pragma once
+#include "core/graph.h"
+#include "core/result_cache.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace infini
+{
+    /**
+     * @brief Runs requests on a graph in the background, one at a time and
+     * in submission order.
+     *
+     * Requests are copied into one of `depth` sets of input buffers owned by
+     * the session, so with the default of two the next request is copied in
+     * while the current one computes, and submit() only blocks when every set
+     * is in flight. Outputs are written directly to the caller's buffers.
+     * The caller thread is free for pre- and post-processing between
+     * submit() and the completion of a request.
+     *
+     * With a result cache (setResultCache), requests whose inputs match an
+     * earlier request's byte for byte get its outputs copied without running
+     * the graph, still completing in submission order.
+     *
+     * The session owns the graph while it lives: the graph must not be run
+     * or rebound by anyone else. Afterwards, it reads the session's last
+     * inputs and writes its outputs to their buffers from before the session.
+     */
+    class Session
+    {
+    public:
+        // Called on the session thread with nullptr on success or the
+        // exception thrown by the run.
+        using Callback = std::function<void(std::exception_ptr)>;
+
+    private:
+        struct Request
+        {
+            int slot; // -1 if answered by `cached`
+            vector<void *> outputs;
+            Callback done;
+            uint64_t hash = 0;
+            Ref<const ResultCache::Entry> cached;
+        };
+
+        Graph graph;
+        // Graph inputs other than weights, and graph outputs.
+        TensorVec inputs, outputs;
+        // Input buffers of every slot, one per input.
+        vector<vector<Ref<void>>> slots;
+        vector<int> freeSlots;
+        std::deque<Request> queue;
+        size_t running = 0;
+        bool stopping = false;
+        std::mutex lock;
+        std::condition_variable changed;
+        std::thread thread;
+        Ref<ResultCache> cache;
+        vector<size_t> inputBytes, outputBytes;
+        // Buffers of the outputs before the session, restored after runs.
+        vector<Blob> outputBlobs;
+
+        void work();
+
+    public:
+        /**
+         * @param graph A graph whose data is allocated (GraphObj::dataMalloc).
+         * @param depth Sets of input buffers, i.e. requests that may be
+         * submitted and not yet finished before submit() blocks.
+         */
+        explicit Session(Graph graph, int depth = 2);
+        // Finishes the requests already submitted.
+        ~Session();
+        Session(const Session &) = delete;
+        Session &operator=(const Session &) = delete;
+
+        /**
+         * @brief Inputs in the order submit() takes their data: graph inputs
+         * except weights.
+         */
+        const TensorVec &getInputs() const { return inputs; }
+        const TensorVec &getOutputs() const { return outputs; }
+
+        /**
+         * @brief Caches the outputs of successful runs in at most `bytes`
+         * bytes of inputs and outputs, or disables caching with 0. Drops the
+         * previous cache; must not be called while requests are in flight.
+         */
+        void setResultCache(size_t bytes);
+        // nullptr unless enabled.
+        Ref<ResultCache> getResultCache() const { return cache; }
+
+        /**
+         * @brief Copies `data`, getBytes() bytes per input, into a free set of
+         * input buffers and queues a run writing the outputs to `results`,
+         * which must stay valid until the request completes. `done` is called
+         * once they are written or the run failed.
+         */
+        void submit(const vector<const void *> &data,
+                    const vector<void *> &results, Callback done);
+
+        /**
+         * @brief submit() with a future, which rethrows the error of a failed
+         * run.
+         */
+        std::future<void> submit(const vector<const void *> &data,
+                                 const vector<void *> &results);
+
+        /**
+         * @brief Blocks until every submitted request has completed.
+         */
+        void wait();
+    };
+
+} // namespace infini
@@ -28,8 +28,14 @@ namespace infini
     private:
         Shape shape;
         size_t _size; // Cache of Π(shape).
+        // Element strides and byte offset into `data`. Dense row-major unless
+        // the tensor is a view planned by GraphObj::dataMalloc.
+        Shape stride;
+        size_t offset = 0;
         Fuid fuid;    // Cloned tensors share the same id. Tensors constructed from
                       // scratch have a new id.
+        bool external = false; // Data is bound to a caller-owned buffer.
+        bool weight = false;   // Constant data that belongs to the model.
 
     public:
         TensorObj(Shape shape, DataType dtype, Runtime runtime);
@@ -42,12 +48,41 @@ namespace infini
         Shape getDims() const { return shape; }
         void setShape(Shape shape_);
         size_t getRank() const { return shape.size(); }
+
+        const Shape &getStride() const { return stride; }
+        size_t getOffset() const { return offset; }
+        /**
+         * @brief Makes this tensor a view of its data blob with the given
+         * element strides and byte offset. Only kernels of ops accepting
+         * strided input (OperatorObj::acceptsStridedInput) may read views.
+         */
+        void setLayout(Shape stride, size_t offset);
+        void resetLayout();
+        bool isContiguous() const;
         UidBaseType getFuid() const { return fuid; }
 
         void setData(
             std::function<void(void *, size_t, DataType)> const &generator) const;
 
         void setDataBlob(const Blob &blob);
+        Blob getDataBlob() const { return data; }
+
+        /**
+         * @brief Binds a caller-owned buffer as the data of this tensor without
+         * copying. The buffer must be aligned to the element size and hold at
+         * least getBytes() bytes. It is never freed by the runtime and must
+         * outlive every use of the tensor, or be kept alive by `owner`.
+         * External tensors are skipped by GraphObj::dataMalloc.
+         */
+        void setExternalData(void *ptr, size_t bytes, Ref<void> owner = nullptr);
+        bool isExternal() const { return external; }
+
+        /**
+         * @brief Marks this tensor as a constant weight whose data is part of
+         * the model, e.g. written out by saveGraph.
+         */
+        void setWeight() { weight = true; }
+        bool isWeight() const { return weight; }
 
         void printData() const;
         bool equalData(const Tensor &rhs, double relativeError = 1e-6) const;
@@ -56,6 +91,7 @@ namespace infini
         bool equalData(const vector<T> &dataVector)
         {
             IT_ASSERT(size() == dataVector.size());
+            IT_ASSERT(isContiguous());
             IT_ASSERT(DataType::get<T>() == dtype.cpuTypeInt());
             return equalDataImpl(getRawDataPtr<T *>(), dataVector.data(), size());
         }
@@ -66,7 +102,7 @@ namespace infini
             static_assert(std::is_pointer_v<T>,
                           "Raw data pointer has a type of pointer");
             IT_ASSERT(data != nullptr);
-            return data->getPtr<T>();
+            return reinterpret_cast<T>(data->getPtr<char *>() + offset);
         }
 
         DataType getDType() const { return dtype; }
@@ -84,7 +120,7 @@ namespace infini
 
             auto numDims = shape.size();
             auto dimSzVec = vector<int>(numDims, 1);
-            auto ptr = data->getPtr<T *>();
+            auto ptr = getRawDataPtr<T *>();
             dimSzVec[numDims - 1] = shape[numDims - 1];
 
             for (int i = numDims - 1; i != 0; --i)
@@ -0,0 +1,195 @@
+#pragma once
+#include "core/common.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace infini
+{
+    /**
+     * @brief Hint to the CPU that the calling thread is busy-waiting.
+     */
+    inline void spinPause()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    /**
+     * @brief Persistent workers for the parallel loops of CPU kernels.
+     *
+     * Workers stay alive between jobs and spin for a short while after each
+     * one before parking on a condition variable, so back-to-back ops of a
+     * graph are dispatched without waking threads or creating teams. The
+     * calling thread runs share 0 of every job. A job is run inline by the
+     * caller when it asks for one thread, when it is started from inside
+     * another job, or when the pool is busy with a job of another caller.
+     *
+     * Kernels do not hold pools: they use current(), which is the pool of the
+     * runtime running the graph (see ThreadPool::Scope) or global().
+     */
+    class ThreadPool
+    {
+        using Invoke = void (*)(void *ctx, int thread, int threads);
+
+        struct alignas(64) Worker
+        {
+            std::atomic<uint64_t> ticket{0};
+            // Kernel thread id, set once the worker has started.
+            std::atomic<int> tid{0};
+            std::thread thread;
+        };
+
+        // Parallel loops give each thread at least this many elements.
+        size_t minWork;
+        vector<int> cpus;
+        std::unique_ptr<Worker[]> workers;
+        int nWorkers;
+
+        // The current job, written before tickets are handed out.
+        Invoke invoke = nullptr;
+        void *ctx = nullptr;
+        int jobThreads = 0;
+        uint64_t generation = 0;
+        std::atomic<int> pending{0};
+        std::atomic<bool> busy{false}, stopping{false};
+        std::exception_ptr error;
+        std::mutex errorLock;
+
+        std::mutex parkLock;
+        std::condition_variable parked;
+        std::atomic<int> sleeping{0};
+
+        void work(int index);
+        void dispatch(int threads, Invoke invoke, void *ctx);
+
+    public:
+        static constexpr size_t kDefaultMinWork = 1 << 14;
+
+        /**
+         * @param threads Pool size including the calling thread, 0 for the
+         * number of CPUs the process may run on.
+         * @param cpus CPUs that workers are pinned to, worker i (the caller
+         * being 0) to cpus[i % cpus.size()]. Empty for no pinning.
+         * @param minWork Elements per thread below which parallel loops use
+         * fewer threads, down to running serially.
+         */
+        explicit ThreadPool(int threads = 0, vector<int> cpus = {},
+                            size_t minWork = kDefaultMinWork);
+        ~ThreadPool();
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        int size() const { return nWorkers + 1; }
+        size_t getMinWork() const { return minWork; }
+        const vector<int> &getCpus() const { return cpus; }
+        // Kernel thread ids of the workers, the caller not included.
+        vector<int> getThreadIds() const;
+
+        /**
+         * @brief Runs body(thread, threads) on min(threads, size()) threads
+         * and returns once all of them are done. Exceptions thrown by the
+         * body are rethrown to the caller.
+         */
+        template <typename F>
+        void parallel(int threads, F &&body)
+        {
+            threads = std::max(1, std::min(threads, size()));
+            if (threads == 1)
+                return body(0, 1);
+            dispatch(
+                threads,
+                [](void *ctx, int thread, int threads)
+                { (*static_cast<std::remove_reference_t<F> *>(ctx))(thread,
+                                                                     threads); },
+                &body);
+        }
+
+        /**
+         * @brief Threads worth using for `n` iterations touching `cost`
+         * elements each.
+         */
+        int threadsFor(size_t n, size_t cost) const
+        {
+            size_t byWork = n * std::max<size_t>(cost, 1) / minWork;
+            return std::max<size_t>(1, std::min<size_t>({byWork, n,
+                                                         (size_t)size()}));
+        }
+
+        /**
+         * @brief The pool of the runtime whose run() is on the stack of the
+         * calling thread, otherwise global().
+         */
+        static ThreadPool &current();
+
+        /**
+         * @brief Process-wide pool with the default size, shared by runtimes
+         * with a default CpuConfig.
+         */
+        static ThreadPool &global();
+
+        /**
+         * @brief Makes a pool current() for the calling thread within a scope.
+         */
+        class Scope
+        {
+            ThreadPool *saved;
+
+        public:
+            explicit Scope(ThreadPool &pool);
+            ~Scope();
+        };
+    };
+
+    /**
+     * @brief Part `part` of `parts` contiguous, near-equal parts of [0, n).
+     */
+    inline pair<size_t, size_t> splitRange(size_t n, int part, int parts)
+    {
+        size_t base = n / parts, extra = n % parts;
+        size_t begin = part * base + std::min<size_t>(part, extra);
+        return {begin, begin + base + ((size_t)part < extra)};
+    }
+
+    /**
+     * @brief Static schedule of [0, n) on the current pool: each thread calls
+     * body(begin, end) once for a contiguous range, so that per-thread scratch
+     * can live in the body. `cost` is the number of elements an iteration
+     * touches and decides how many threads are worth waking.
+     */
+    template <typename F>
+    void parallelRange(size_t n, size_t cost, F &&body)
+    {
+        if (n == 0)
+            return;
+        auto &pool = ThreadPool::current();
+        pool.parallel(pool.threadsFor(n, cost),
+                      [&](int thread, int threads)
+                      {
+                          auto [begin, end] = splitRange(n, thread, threads);
+                          if (begin < end)
+                              body(begin, end);
+                      });
+    }
+
+    /**
+     * @brief parallelRange calling body(i) for every iteration.
+     */
+    template <typename F>
+    void parallelFor(size_t n, size_t cost, F &&body)
+    {
+        parallelRange(n, cost,
+                      [&](size_t begin, size_t end)
+                      {
+                          for (size_t i = begin; i < end; ++i)
+                              body(i);
+                      });
+    }
+
+} // namespace infini
@@ -0,0 +1,71 @@
+#pragma once
+#include "core/kernel.h"
+#include <mutex>
+
+namespace infini
+{
+    /**
+     * @brief Chooses the fastest configuration of CpuKernelWithConfig kernels.
+     *
+     * The first time an (op type, dtype, shapes, attributes, thread count) key
+     * is seen, every candidate of the kernel's search space is timed on the
+     * operator's inputs, writing to scratch outputs, and the winner is kept.
+     * With a cache file set, tuned entries are appended to it and read back at
+     * startup, so hosts sharing the file never tune twice. The cache file is
+     * taken from the INFINI_TUNING_CACHE environment variable or set with
+     * load(); INFINI_TUNING=0 disables timing and uses default configurations
+     * for keys not in the cache.
+     */
+    class Tuner
+    {
+    public:
+        struct Record
+        {
+            KernelConfig config;
+            double time; // seconds
+        };
+
+    private:
+        std::unordered_map<string, Record> records;
+        string cacheFile;
+        bool enabled = true;
+        mutable std::mutex mutex;
+
+        Tuner();
+
+    public:
+        static Tuner &getInstance()
+        {
+            static Tuner instance;
+            return instance;
+        }
+
+        /**
+         * @brief Configuration for `op`, tuning it if its key is new. Tuning
+         * runs without holding the tuner's lock.
+         */
+        KernelConfig getConfig(const CpuKernelWithConfig &kernel,
+                               const Operator &op, const RuntimeObj *context);
+
+        static string getKey(const CpuKernelWithConfig &kernel,
+                             const Operator &op);
+        optional<Record> lookup(const string &key) const;
+
+        /**
+         * @brief Merges the entries of `path` (if it exists) and appends
+         * newly tuned entries to it from now on.
+         */
+        void load(const string &path);
+        void save(const string &path) const;
+        void clear();
+        size_t size() const;
+        void setEnabled(bool enabled);
+        bool isEnabled() const;
+
+    private:
+        Record tune(const CpuKernelWithConfig &kernel, const Operator &op,
+                    const RuntimeObj *context) const;
+        void append(const string &key, const Record &record) const;
+    };
+
+} // namespace infini
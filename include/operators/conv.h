@@ -0,0 +1,65 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+    /**
+     * @brief 2D convolution, as ONNX Conv, of an NCHW input with an OIHW
+     * weight and an optional bias of the output channels.
+     *
+     * A blocked convolution reads and writes the NCHWc layout of ReorderObj
+     * instead, with the weight still OIHW. GraphObj::optimize() blocks
+     * convolutions that have a direct kernel (hasBlockedKernel).
+     *
+     */
+    class ConvObj : public OperatorObj
+    {
+    private:
+        vector<int> pads;      // top, left, bottom, right
+        vector<int> strides;   // h, w
+        vector<int> dilations; // h, w
+        int group;
+        bool blocked;
+
+    public:
+        /**
+         * @brief Construct a new Conv object.
+         *
+         * @param graph The computation graph that this operator belongs to.
+         * @param input The input tensor, [N, C, H, W].
+         * @param weight The weight tensor, [M, C / group, kH, kW].
+         * @param bias Optional bias tensor, [M].
+         * @param output The output tensor, [N, M, oH, oW].
+         * @param pads Padding of the top, left, bottom and right borders.
+         * @param strides Strides along H and W.
+         * @param dilations Dilations along H and W.
+         * @param group Number of channel groups.
+         * @param blocked Whether input and output are in the NCHWc layout.
+         */
+        ConvObj(GraphObj *graph, Tensor input, Tensor weight, Tensor bias,
+                Tensor output, vector<int> pads = {0, 0, 0, 0},
+                vector<int> strides = {1, 1}, vector<int> dilations = {1, 1},
+                int group = 1, bool blocked = false);
+        OP_CLONE(ConvObj);
+
+        std::string toString() const override;
+        optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+        int numInputs() const override { return inputs.size(); }
+        int numOutputs() const override { return 1; }
+
+        const vector<int> &getPads() const { return pads; }
+        const vector<int> &getStrides() const { return strides; }
+        const vector<int> &getDilations() const { return dilations; }
+        int getGroup() const { return group; }
+        bool isBlocked() const { return blocked; }
+        Tensor getBias() const { return inputs.size() > 2 ? inputs[2] : nullptr; }
+        /**
+         * @brief Whether the direct kernel on the NCHWc layout handles this
+         * convolution: Float32, one group, 1x1 or 3x3 filters with strides up
+         * to 2 and no dilation, and channel counts multiple of the block.
+         */
+        bool hasBlockedKernel() const;
+    };
+
+} // namespace infini
@@ -28,7 +28,10 @@ namespace infini
     std::string toString() const override;
     int numInputs() const override { return 2; }
     int numOutputs() const override { return 1; }
-    };
+    // Inputs with the output's shape, i.e. not broadcast.
+    vector<int> getInplaceInputs() const override;
+    bool acceptsStridedInput(int i) const override { return true; }
+  };
 
 #define DEFINE_ELEMENT_WISE_OBJ(prefix, type)                    \
   class prefix##Obj : public ElementWiseObj                      \
@@ -0,0 +1,128 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+    /**
+     * @brief A tree of float elementwise ops as a list of nodes, each reading
+     * only earlier ones, the last being the result.
+     */
+    struct ElementwiseExpr
+    {
+        enum class Code : uint8_t
+        {
+            Input, // Operator input `a`
+            Const, // `value`
+            Add,
+            Sub,
+            Mul,
+            Div,
+            Max, // Nodes `a` and `b`, `a` when either is NaN
+            Min,
+            Relu, // Node `a`
+            Exp,
+            Sqrt,
+        };
+
+        struct Node
+        {
+            Code code;
+            int a = 0, b = 0;
+            float value = 0;
+
+            bool operator==(const Node &other) const
+            {
+                return code == other.code && a == other.a && b == other.b &&
+                       (code != Code::Const || value == other.value);
+            }
+        };
+
+        vector<Node> nodes;
+
+        // Appends `node`, reusing an identical existing one. Returns its index.
+        int add(const Node &node);
+        // One more than the largest input index.
+        int numInputs() const;
+        /**
+         * @brief Whether nodes only read inputs below `inputs` and earlier
+         * nodes, and the expression is not empty.
+         */
+        bool isValid(int inputs) const;
+
+        /**
+         * @brief Canonical text of the expression, such as
+         * "i0 i1 add(0,1) relu(2)": equal signatures compute the same.
+         */
+        string signature() const;
+
+        /**
+         * @brief C++ statements declaring `float v<i>` for every node i, the
+         * result being the last one. Input k is read as `inputs[k]` and exp
+         * is computed by the function named `exp`.
+         */
+        string toCpp(const vector<string> &inputs,
+                     const string &exp = "std::exp") const;
+
+        /**
+         * @brief exp of fused ops, interpreted or compiled (the JIT's source
+         * repeats it): vectorizable, within 3e-7 of std::exp, with the same
+         * NaN and infinities. Results below FLT_MIN are flushed to zero.
+         */
+        static float fastExp(float x);
+
+        /**
+         * @brief Evaluates the expression at `n` elements, input k being read
+         * at inputs[k][i * steps[k]].
+         */
+        void evaluate(const float *const *inputs, const ptrdiff_t *steps,
+                      float *output, size_t n) const;
+    };
+
+    /**
+     * @brief Float elementwise ops fused into one pass over the output, the
+     * inputs being broadcast to it. GraphObj::optimize() replaces trees of
+     * Add, Sub, Mul, Div, Relu, Exp, Sqrt and Clip ops of the output's shape
+     * by this op. The CPU kernel interprets the expression in blocks, or runs
+     * code compiled for it by ElementwiseJit if enabled.
+     */
+    class FusedElementwiseObj : public OperatorObj
+    {
+        ElementwiseExpr expr;
+
+    public:
+        /**
+         * @brief Construct a new FusedElementwise object.
+         *
+         * @param graph The computation graph that this operator belongs to.
+         * @param inputs The Float32 input tensors, mutually broadcastable.
+         * @param output The output tensor.
+         * @param expr The expression over the inputs.
+         */
+        FusedElementwiseObj(GraphObj *graph, TensorVec inputs, Tensor output,
+                            ElementwiseExpr expr);
+        OP_CLONE(FusedElementwiseObj);
+
+        optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+        std::string toString() const override;
+        int numInputs() const override { return inputs.size(); }
+        int numOutputs() const override { return 1; }
+        // Inputs with the output's shape, i.e. not broadcast.
+        vector<int> getInplaceInputs() const override;
+        bool acceptsStridedInput(int i) const override { return true; }
+        const ElementwiseExpr &getExpr() const { return expr; }
+
+        /**
+         * @brief The output as rows, its dims of size 1 dropped and the
+         * others merged from the innermost wherever every input's strides
+         * allow: `dims` ends with the row length, and `strides[k]` are the
+         * element strides of input k along them, 0 where broadcast.
+         */
+        struct Rows
+        {
+            Shape dims;
+            vector<Shape> strides;
+        };
+        Rows getRows() const;
+    };
+
+} // namespace infini
@@ -0,0 +1,72 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+    /**
+     * @brief Gathers slices of `data` along `axis` at Int32 or Int64
+     * `indices`, as ONNX Gather. Negative indices count from the end.
+     *
+     */
+    class GatherObj : public OperatorObj
+    {
+        int axis;
+
+    public:
+        /**
+         * @brief Construct a new Gather object.
+         *
+         * @param graph The computation graph that this operator belongs to.
+         * @param data The input tensor.
+         * @param indices Indices into the axis of data.
+         * @param output The output tensor, data.shape[:axis] + indices.shape
+         * + data.shape[axis + 1:].
+         * @param axis The axis to gather along, may be negative.
+         */
+        GatherObj(GraphObj *graph, Tensor data, Tensor indices, Tensor output,
+                  int axis = 0);
+        OP_CLONE(GatherObj);
+
+        std::string toString() const override;
+        optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+        int numInputs() const override { return 2; }
+        int numOutputs() const override { return 1; }
+        int getAxis() const { return axis; }
+    };
+
+    /**
+     * @brief Sums the rows of a [V, D] table at Int32 or Int64 indices of
+     * shape [..., L] into [..., D], that is ReduceSum over the last index axis
+     * of Gather(table, indices). GraphObj::optimize() fuses that pattern, so
+     * the gathered rows are never materialized.
+     *
+     */
+    class EmbeddingBagObj : public OperatorObj
+    {
+        bool keepDims;
+
+    public:
+        /**
+         * @brief Construct a new EmbeddingBag object.
+         *
+         * @param graph The computation graph that this operator belongs to.
+         * @param table The embedding table, [V, D].
+         * @param indices Row indices, [..., L].
+         * @param output The output tensor, [..., D], or [..., 1, D] with
+         * keepDims.
+         * @param keepDims Whether the bag axis is kept with size 1.
+         */
+        EmbeddingBagObj(GraphObj *graph, Tensor table, Tensor indices,
+                        Tensor output, bool keepDims = false);
+        OP_CLONE(EmbeddingBagObj);
+
+        std::string toString() const override;
+        optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+        int numInputs() const override { return 2; }
+        int numOutputs() const override { return 1; }
+        bool getKeepDims() const { return keepDims; }
+    };
+
+} // namespace infini
@@ -0,0 +1,65 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+  /**
+   * @brief Base class of normalizations over the trailing axes [axis, rank),
+   * followed by an elementwise scale shaped as those axes.
+   *
+   */
+  class NormObj : public OperatorObj
+  {
+  protected:
+    int axis;
+    float eps;
+
+    NormObj(OpType type, TensorVec inputs, Tensor output, int axis, float eps);
+
+  public:
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return inputs.size(); }
+    int numOutputs() const override { return 1; }
+    int getAxis() const { return axis; }
+    float getEps() const { return eps; }
+    vector<int> getInplaceInputs() const override { return {0}; }
+  };
+
+  /**
+   * @brief (x - mean) / sqrt(var + eps) * scale + bias, as ONNX
+   * LayerNormalization.
+   *
+   */
+  class LayerNormObj : public NormObj
+  {
+  public:
+    /**
+     * @brief Construct a new LayerNorm object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param input The input tensor.
+     * @param scale Scale shaped as the normalized axes.
+     * @param bias Optional bias shaped as the normalized axes.
+     * @param output The output tensor.
+     * @param axis First normalized axis, may be negative.
+     * @param eps Added to the variance.
+     */
+    LayerNormObj(GraphObj *graph, Tensor input, Tensor scale, Tensor bias,
+                 Tensor output, int axis = -1, float eps = 1e-5f);
+    OP_CLONE(LayerNormObj);
+  };
+
+  /**
+   * @brief x / sqrt(mean(x^2) + eps) * scale, as ONNX RMSNormalization.
+   *
+   */
+  class RMSNormObj : public NormObj
+  {
+  public:
+    RMSNormObj(GraphObj *graph, Tensor input, Tensor scale, Tensor output,
+               int axis = -1, float eps = 1e-5f);
+    OP_CLONE(RMSNormObj);
+  };
+}; // namespace infini
@@ -47,6 +47,7 @@ namespace infini
 
         int numInputs() const override { return inputs.size(); }
         int numOutputs() const override { return 1; }
+        bool acceptsStridedInput(int i) const override { return true; }
 
         bool getTransA() const { return transA; }
         bool getTransB() const { return transB; }
@@ -0,0 +1,91 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+    /**
+     * @brief 2D pooling over the spatial axes of an NCHW input, as ONNX
+     * MaxPool, AveragePool and GlobalAveragePool. Padded positions are never
+     * part of a max; averages count them only with countIncludePad.
+     *
+     * A blocked pooling reads and writes the NCHWc layout of ReorderObj.
+     * GraphObj::optimize() blocks poolings of blocked convolution outputs.
+     *
+     */
+    class PoolingObj : public OperatorObj
+    {
+    private:
+        vector<int> kernel;  // h, w; empty for global pooling
+        vector<int> pads;    // top, left, bottom, right
+        vector<int> strides; // h, w
+        bool countIncludePad;
+        bool blocked;
+
+    public:
+        /**
+         * @brief Construct a new Pooling object.
+         *
+         * @param type MaxPool, AveragePool or GlobalAveragePool.
+         * @param graph The computation graph that this operator belongs to.
+         * @param input The input tensor, [N, C, H, W].
+         * @param output The output tensor, [N, C, oH, oW].
+         * @param kernel Window size along H and W, empty for global pooling.
+         * @param pads Padding of the top, left, bottom and right borders.
+         * @param strides Strides along H and W.
+         * @param countIncludePad Whether averages divide by the full window.
+         * @param blocked Whether input and output are in the NCHWc layout.
+         */
+        PoolingObj(OpType type, GraphObj *graph, Tensor input, Tensor output,
+                   vector<int> kernel, vector<int> pads, vector<int> strides,
+                   bool countIncludePad, bool blocked);
+        OP_CLONE(PoolingObj);
+
+        std::string toString() const override;
+        optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+        int numInputs() const override { return 1; }
+        int numOutputs() const override { return 1; }
+
+        bool isGlobal() const { return kernel.empty(); }
+        // The window, the whole image for global pooling.
+        vector<int> getKernel() const;
+        const vector<int> &getPads() const { return pads; }
+        const vector<int> &getStrides() const { return strides; }
+        bool getCountIncludePad() const { return countIncludePad; }
+        bool isBlocked() const { return blocked; }
+    };
+
+    class MaxPoolObj : public PoolingObj
+    {
+    public:
+        MaxPoolObj(GraphObj *graph, Tensor input, Tensor output,
+                   vector<int> kernel, vector<int> pads = {0, 0, 0, 0},
+                   vector<int> strides = {1, 1}, bool blocked = false)
+            : PoolingObj(OpType::MaxPool, graph, input, output, kernel, pads,
+                         strides, false, blocked) {}
+        OP_CLONE(MaxPoolObj);
+    };
+
+    class AvgPoolObj : public PoolingObj
+    {
+    public:
+        AvgPoolObj(GraphObj *graph, Tensor input, Tensor output,
+                   vector<int> kernel, vector<int> pads = {0, 0, 0, 0},
+                   vector<int> strides = {1, 1}, bool countIncludePad = false,
+                   bool blocked = false)
+            : PoolingObj(OpType::AveragePool, graph, input, output, kernel,
+                         pads, strides, countIncludePad, blocked) {}
+        OP_CLONE(AvgPoolObj);
+    };
+
+    class GlobalAvgPoolObj : public PoolingObj
+    {
+    public:
+        GlobalAvgPoolObj(GraphObj *graph, Tensor input, Tensor output,
+                         bool blocked = false)
+            : PoolingObj(OpType::GlobalAveragePool, graph, input, output, {},
+                         {0, 0, 0, 0}, {1, 1}, false, blocked) {}
+        OP_CLONE(GlobalAvgPoolObj);
+    };
+
+} // namespace infini
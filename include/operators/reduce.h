@@ -0,0 +1,54 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+  /**
+   * @brief Base class of reductions over a set of axes, as ONNX ReduceXxx.
+   *
+   */
+  class ReduceObj : public OperatorObj
+  {
+  protected:
+    vector<int> axes; // Sorted, non-negative.
+    bool keepDims;
+
+  public:
+    /**
+     * @brief Construct a new Reduce object.
+     *
+     * @param type Operator type.
+     * @param graph The computation graph that this operator belongs to.
+     * @param input The input tensor.
+     * @param output The output tensor.
+     * @param axes Axes to reduce, may be negative. Empty means all axes.
+     * @param keepDims Whether reduced axes are kept with size 1.
+     */
+    ReduceObj(OpType type, GraphObj *graph, Tensor input, Tensor output,
+              vector<int> axes, bool keepDims);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return 1; }
+    int numOutputs() const override { return 1; }
+    const vector<int> &getAxes() const { return axes; }
+    bool getKeepDims() const { return keepDims; }
+    bool isReduced(int axis) const;
+  };
+
+#define DEFINE_REDUCE_OBJ(prefix, type)                                \
+  class prefix##Obj : public ReduceObj                                 \
+  {                                                                    \
+  public:                                                              \
+    prefix##Obj(GraphObj *graph, Tensor input, Tensor output,          \
+                vector<int> axes = {}, bool keepDims = true)           \
+        : ReduceObj(type, graph, input, output, axes, keepDims) {}     \
+    OP_CLONE(prefix##Obj);                                             \
+  };
+
+  DEFINE_REDUCE_OBJ(ReduceSum, OpType::ReduceSum)
+  DEFINE_REDUCE_OBJ(ReduceMean, OpType::ReduceMean)
+  DEFINE_REDUCE_OBJ(ReduceMax, OpType::ReduceMax)
+  DEFINE_REDUCE_OBJ(ReduceMin, OpType::ReduceMin)
+  DEFINE_REDUCE_OBJ(ReduceProd, OpType::ReduceProd)
+}; // namespace infini
@@ -0,0 +1,39 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+    // Channels per block of the NCHWc layout, [N, C / c, H, W, c].
+    constexpr int kChannelBlock = 8;
+
+    /**
+     * @brief Converts between the NCHW layout and the channel-blocked NCHWc
+     * layout used by blocked convolutions. Inserted by GraphObj::optimize().
+     *
+     */
+    class ReorderObj : public OperatorObj
+    {
+        bool toBlocked;
+
+    public:
+        /**
+         * @brief Construct a new Reorder object.
+         *
+         * @param graph The computation graph that this operator belongs to.
+         * @param input The input tensor.
+         * @param output The output tensor.
+         * @param toBlocked True for NCHW to NCHWc, false for the inverse.
+         */
+        ReorderObj(GraphObj *graph, Tensor input, Tensor output,
+                   bool toBlocked);
+        OP_CLONE(ReorderObj);
+
+        std::string toString() const override;
+        optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+        int numInputs() const override { return 1; }
+        int numOutputs() const override { return 1; }
+        bool isToBlocked() const { return toBlocked; }
+    };
+
+} // namespace infini
@@ -0,0 +1,85 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+  /**
+   * @brief Base class of operators that only change the shape of a tensor.
+   * The output is planned as a view of the input, sharing its blob, so these
+   * operators run no kernel. A copy kernel only runs when the output has to be
+   * materialized, e.g. for graph outputs or strides a view cannot express.
+   */
+  class ShapeOnlyObj : public OperatorObj
+  {
+  public:
+    ShapeOnlyObj(OpType type, Tensor input, Tensor output)
+        : OperatorObj(type, {input}, {output}) {}
+
+    std::string toString() const override;
+    int numInputs() const override { return 1; }
+    int numOutputs() const override { return 1; }
+    optional<pair<Shape, size_t>> inferView() const override;
+    bool acceptsStridedInput(int i) const override { return true; }
+  };
+
+  /**
+   * @brief Reshape as in ONNX: a 0 in `dims` copies the input dimension and a
+   * single -1 is inferred from the element count.
+   */
+  class ReshapeObj : public ShapeOnlyObj
+  {
+    Shape dims;
+
+  public:
+    ReshapeObj(GraphObj *graph, Tensor input, Tensor output, Shape dims);
+    OP_CLONE(ReshapeObj);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+    const Shape &getShape() const { return dims; }
+  };
+
+  /**
+   * @brief Flattens the input into a matrix, dims [0, axis) becoming the rows
+   * and [axis, rank) the columns. `axis` may be negative.
+   */
+  class FlattenObj : public ShapeOnlyObj
+  {
+    int axis;
+
+  public:
+    FlattenObj(GraphObj *graph, Tensor input, Tensor output, int axis = 1);
+    OP_CLONE(FlattenObj);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+    int getAxis() const { return axis; }
+  };
+
+  /**
+   * @brief Removes the dims listed in `axes`, which must have size 1, or every
+   * dim of size 1 if `axes` is empty.
+   */
+  class SqueezeObj : public ShapeOnlyObj
+  {
+    vector<int> axes;
+
+  public:
+    SqueezeObj(GraphObj *graph, Tensor input, Tensor output,
+               vector<int> axes = {});
+    OP_CLONE(SqueezeObj);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+    const vector<int> &getAxes() const { return axes; }
+  };
+
+  /**
+   * @brief Inserts dims of size 1 at `axes`, which index the output.
+   */
+  class UnsqueezeObj : public ShapeOnlyObj
+  {
+    vector<int> axes;
+
+  public:
+    UnsqueezeObj(GraphObj *graph, Tensor input, Tensor output,
+                 vector<int> axes);
+    OP_CLONE(UnsqueezeObj);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+    const vector<int> &getAxes() const { return axes; }
+  };
+} // namespace infini
@@ -0,0 +1,33 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+  /**
+   * @brief Softmax along one axis, as ONNX Softmax (opset 13).
+   *
+   */
+  class SoftmaxObj : public OperatorObj
+  {
+    int axis;
+
+  public:
+    /**
+     * @brief Construct a new Softmax object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param input The input tensor.
+     * @param output The output tensor.
+     * @param axis The axis to normalize along, may be negative.
+     */
+    SoftmaxObj(GraphObj *graph, Tensor input, Tensor output, int axis = -1);
+    OP_CLONE(SoftmaxObj);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return 1; }
+    int numOutputs() const override { return 1; }
+    int getAxis() const { return axis; }
+    vector<int> getInplaceInputs() const override { return {0}; }
+  };
+}; // namespace infini
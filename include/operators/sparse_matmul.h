@@ -0,0 +1,87 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+    /**
+     * @brief A constant [K, N] matrix keeping only its nonzero blocks of
+     * blockRows x blockCols, grouped by block column: the blocks of block
+     * column j are offsets[j] to offsets[j + 1], block p being rows
+     * index[p] * blockRows onwards with its elements row-major at
+     * values[p * blockRows * blockCols]. 1 x 1 blocks are plain CSR of the
+     * transposed matrix.
+     */
+    struct BlockSparse
+    {
+        int blockRows, blockCols;
+        vector<float> values;
+        vector<int32_t> index, offsets;
+
+        /**
+         * @brief Encodes row-major `w`, [K, N], or [N, K] if `transposed`.
+         * blockRows must divide K and blockCols must divide N.
+         */
+        static BlockSparse encode(const float *w, int k, int n,
+                                  bool transposed, int blockRows,
+                                  int blockCols);
+
+        size_t blocks() const { return index.size(); }
+
+        /**
+         * @brief Relative time of a product with this matrix. Each block row
+         * costs a broadcast of A per row of the kernel's tile besides its
+         * 4-wide multiply-adds, which is what makes 4x4 blocks slower than
+         * 1x8 ones holding as many nonzeros.
+         */
+        double cost() const;
+    };
+
+    /**
+     * @brief C = A * W for a constant W stored as BlockSparse, so that the
+     * kernel only touches the nonzero blocks. GraphObj::optimize() replaces
+     * Matmul ops with mostly zero constant weights by this op.
+     *
+     */
+    class SparseMatmulObj : public OperatorObj
+    {
+        int blockRows, blockCols;
+
+        // Auxiliary attributes which are not a part of operator attributes.
+        int m, n, k;
+
+    public:
+        /**
+         * @brief Construct a new SparseMatmul object.
+         *
+         * @param graph The computation graph that this operator belongs to.
+         * @param A The dense input, [..., M, K].
+         * @param values The nonzero blocks, [blocks, blockRows, blockCols].
+         * @param index Int32 block row of each block, [blocks].
+         * @param offsets Int32 first block of each block column, [N /
+         * blockCols + 1].
+         * @param C The output tensor, [..., M, N].
+         * @param blockRows Rows of a block, 1 or 4.
+         * @param blockCols Columns of a block, 1, 4 or 8.
+         */
+        SparseMatmulObj(GraphObj *graph, Tensor A, Tensor values, Tensor index,
+                        Tensor offsets, Tensor C, int blockRows, int blockCols);
+        OP_CLONE(SparseMatmulObj);
+
+        std::string toString() const override;
+        optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+        int numInputs() const override { return 4; }
+        int numOutputs() const override { return 1; }
+        int getBlockRows() const { return blockRows; }
+        int getBlockCols() const { return blockCols; }
+        int getM() const { return m; }
+        int getN() const { return n; }
+        int getK() const { return k; }
+
+        /**
+         * @brief Whether a kernel exists for blocks of this shape.
+         */
+        static bool isSupported(int blockRows, int blockCols);
+    };
+
+} // namespace infini
@@ -27,6 +27,8 @@ namespace infini
     int numInputs() const override { return 1; }
     int numOutputs() const override { return 1; }
     std::vector<int> getPermute() const { return transposePermute; }
+    optional<pair<Shape, size_t>> inferView() const override;
+    bool acceptsStridedInput(int i) const override { return true; }
 
   private:
     vector<int> transposePermute;
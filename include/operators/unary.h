@@ -24,6 +24,7 @@ namespace infini
     std::string toString() const override;
     int numInputs() const override { return 1; }
     int numOutputs() const override { return 1; }
+    vector<int> getInplaceInputs() const override { return {0}; }
   };
 
   class ClipObj : public OperatorObj
@@ -39,6 +40,7 @@ namespace infini
     std::optional<float> getMax() const { return maxValue; };
     int numInputs() const override { return 1; }
     int numOutputs() const override { return 1; }
+    vector<int> getInplaceInputs() const override { return {0}; }
 
   private:
     std::optional<float> minValue, maxValue;
@@ -86,6 +88,8 @@ namespace infini
     DataType getOutputDataType() const;
     int numInputs() const override { return 1; }
     int numOutputs() const override { return 1; }
+    // Only casts between types of the same width.
+    vector<int> getInplaceInputs() const override;
 
   private:
     CastType castType;
@@ -101,4 +105,6 @@ namespace infini
   };
 
   DEFINE_UNARY_OBJ(Relu, OpType::Relu)
+  DEFINE_UNARY_OBJ(Exp, OpType::Exp)
+  DEFINE_UNARY_OBJ(Sqrt, OpType::Sqrt)
 }; // namespace infini
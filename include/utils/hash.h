@@ -0,0 +1,14 @@
+#pragma once
+#include "core/common.h"
+
+namespace infini {
+
+/**
+ * @brief Fast non-cryptographic 64-bit hash of `bytes` bytes, for content
+ * keyed caches. 64-byte stripes are folded into eight accumulators with
+ * 32x32->64-bit multiplies, a loop compilers vectorize, so that large
+ * buffers hash at memory bandwidth. Not suited to untrusted keys.
+ */
+uint64_t hashBytes(const void *data, size_t bytes, uint64_t seed = 0);
+
+} // namespace infini
@@ -0,0 +1,27 @@
+#pragma once
+#include "core/common.h"
+
+namespace infini {
+
+/**
+ * @brief Read-only memory mapping of a whole file, unmapped on destruction.
+ */
+class MappedFile {
+    void *addr;
+    size_t length = 0;
+
+  public:
+    explicit MappedFile(const string &path);
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    const char *data() const { return static_cast<const char *>(addr); }
+    size_t size() const { return length; }
+
+    // Drops the resident pages fully covered by [offset, offset + len), they
+    // are read again from the file if touched later.
+    void release(size_t offset, size_t len) const;
+};
+
+} // namespace infini
@@ -18,6 +18,10 @@ Shape locate_index(size_t inputN, const Shape &shape);
 // Delocate the ShapeIndex from Shape with broadcast
 size_t delocate_index(const Shape &shapeIndex, const Shape &shape,
                       const Shape &stride);
+// Strides viewing a tensor of `dims` and `stride` with `newDims` of the same
+// size, or nullopt if the elements cannot be reached with strides
+optional<Shape> reshape_strides(const Shape &dims, const Shape &stride,
+                                const Shape &newDims);
 // Convert KernelAttrs to a string representation
 std::string get_kernel_attrs_str(const KernelAttrs &kernelAttrs);
 
@@ -0,0 +1,67 @@
+#pragma once
+#include "core/common.h"
+#include <array>
+
+namespace infini {
+
+/**
+ * @brief Counting perf_event counters on a set of threads, read as totals
+ * over all of them.
+ *
+ * Counters only count user-space events and run from construction on, so
+ * callers read them before and after the code they measure. Events that the
+ * kernel or the host does not provide on every thread, e.g. hardware events
+ * in most containers and VMs or with a high perf_event_paranoid, are left
+ * out: isAvailable() tells which ones were opened and getError() why others
+ * were not.
+ */
+class PerfCounters {
+  public:
+    enum Event {
+        Cycles,
+        Instructions,
+        LLCMisses,
+        DTLBMisses,
+        BranchMisses,
+        // CPU time in nanoseconds, a software event available everywhere.
+        TaskClock,
+        kEvents
+    };
+    using Values = std::array<uint64_t, kEvents>;
+
+    static const char *eventName(int event);
+
+  private:
+    // Counters of one thread read together. Hardware events form one group,
+    // so that ratios such as IPC cover the same intervals when the kernel
+    // multiplexes counters.
+    struct Group {
+        vector<int> fds, events;
+    };
+    vector<Group> groups;
+    uint32_t available = 0;
+    string error;
+
+  public:
+    /**
+     * @param threads Thread ids as returned by gettid(), 0 for the calling
+     * thread.
+     */
+    explicit PerfCounters(const vector<int> &threads);
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+    ~PerfCounters();
+
+    bool isAvailable(int event) const { return available >> event & 1; }
+    uint32_t getAvailable() const { return available; }
+    const string &getError() const { return error; }
+
+    /**
+     * @brief Totals since construction, summed over the threads and scaled
+     * up for the time an event was multiplexed out. Zero for events that
+     * are not available.
+     */
+    Values read() const;
+};
+
+} // namespace infini
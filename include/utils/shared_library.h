@@ -0,0 +1,35 @@
+#pragma once
+#include "core/common.h"
+
+namespace infini {
+
+/**
+ * @brief A shared library loaded with dlopen, unloaded on destruction.
+ */
+class SharedLibrary {
+    void *handle;
+
+  public:
+    explicit SharedLibrary(const string &path);
+    SharedLibrary(const SharedLibrary &) = delete;
+    SharedLibrary &operator=(const SharedLibrary &) = delete;
+    ~SharedLibrary();
+
+    // Address of the symbol `name`, which must exist.
+    void *symbol(const string &name) const;
+
+    template <typename T> T *get(const string &name) const {
+        return reinterpret_cast<T *>(symbol(name));
+    }
+
+    /**
+     * @brief Compiles the C++ file `source` with the host compiler into the
+     * shared library `library`. The compiler is taken from the INFINI_CXX
+     * environment variable, c++ by default. Throws with the compiler's
+     * output if it fails.
+     */
+    static void compile(const string &source, const string &library,
+                        const string &flags = "-O2");
+};
+
+} // namespace infini
@@ -0,0 +1,98 @@
+#pragma once
+#include "core/thread_pool.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace infini
+{
+    /**
+     * @brief Bounded queue between one producer and one consumer thread.
+     *
+     * push and pop only touch the two indices, each written by one side.
+     * A consumer finding the queue empty spins for a while and then parks,
+     * and the producer only takes the lock to wake a parked consumer, so
+     * busy streams never block on it.
+     */
+    template <typename T>
+    class SpscQueue
+    {
+        static constexpr int kSpins = 1 << 12;
+
+        vector<T> items;
+        const size_t mask;
+        alignas(64) std::atomic<size_t> head{0}; // Next to pop.
+        alignas(64) std::atomic<size_t> tail{0}; // Next to push.
+        alignas(64) std::atomic<bool> sleeping{false};
+        std::mutex parkLock;
+        std::condition_variable parked;
+
+        static size_t roundUp(size_t n)
+        {
+            size_t ret = 1;
+            while (ret < n)
+                ret *= 2;
+            return ret;
+        }
+
+    public:
+        // Holds at least `capacity` items.
+        explicit SpscQueue(size_t capacity)
+            : items(roundUp(capacity)), mask(items.size() - 1)
+        {
+        }
+
+        bool tryPush(const T &item)
+        {
+            size_t t = tail.load(std::memory_order_relaxed);
+            if (t - head.load(std::memory_order_acquire) == items.size())
+                return false;
+            items[t & mask] = item;
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool tryPop(T &item)
+        {
+            size_t h = head.load(std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire))
+                return false;
+            item = std::move(items[h & mask]);
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Spins while the queue is full.
+        void push(const T &item)
+        {
+            while (!tryPush(item))
+                spinPause();
+            // Pairs with the fence in pop: either the consumer sees the item
+            // before parking or it is seen sleeping here.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleeping.load(std::memory_order_relaxed))
+            {
+                std::lock_guard<std::mutex> guard(parkLock);
+                parked.notify_one();
+            }
+        }
+
+        T pop()
+        {
+            T item;
+            for (int i = 0; i < kSpins; ++i)
+            {
+                if (tryPop(item))
+                    return item;
+                spinPause();
+            }
+            std::unique_lock<std::mutex> lock(parkLock);
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            parked.wait(lock, [&] { return tryPop(item); });
+            sleeping.store(false, std::memory_order_relaxed);
+            return item;
+        }
+    };
+
+} // namespace infini
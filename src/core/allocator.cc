@@ -1,4 +1,5 @@
 #include "core/allocator.h"
+#include <algorithm>
 #include <utility>
 
 namespace infini
@@ -28,43 +29,47 @@ namespace infini
         IT_ASSERT(this->ptr == nullptr);
         // pad the size to the multiple of alignment
         size = this->getAlignedSize(size);
+        ++stats.allocs;
 
         // =================================== 作业 ===================================
         // TODO: 设计一个算法来分配内存，返回起始地址偏移量
         // =================================== 作业 ===================================
+        // First fit among the free blocks.
         for (auto it = free_blocks.begin(); it != free_blocks.end(); it++)
         {
             size_t startAddr = it->first;
             size_t blockSize = it->second;
-            if (startAddr >= size)
+            if (blockSize >= size)
             {
                 free_blocks.erase(it);
-                // 检查剩余部分是否还有内存
                 if (blockSize > size)
-                {
-                    // 将剩余的内存添加回空闲块列表
-                    size_t remainingAddr = startAddr + size; // 剩余块的起始地址
-                    size_t remainingSize = blockSize - size; // 剩余块的大小
-                    free_blocks[remainingAddr] = remainingSize;
-                }
+                    free_blocks[startAddr + size] = blockSize - size;
+                ++stats.reused;
                 return startAddr;
             }
         }
-        // cout << "here!!!" << endl;
-        // this->ptr = this->runtime->alloc(size);
-        // cout << "ptr::::" << ptr << endl;
-        this->used += size;
-        if (this->used > this->peak)
+        // A free block at the end of the arena is grown instead of left behind.
+        size_t addr = this->used;
+        if (!free_blocks.empty())
         {
-            this->peak = size;
+            auto last = std::prev(free_blocks.end());
+            if (last->first + last->second == this->used)
+            {
+                addr = last->first;
+                free_blocks.erase(last);
+                ++stats.grownTail;
+            }
         }
-        return this->used - size;
+        this->used = addr + size;
+        this->peak = std::max(this->peak, this->used);
+        return addr;
     }
 
     void Allocator::free(size_t addr, size_t size)
     {
         IT_ASSERT(this->ptr == nullptr);
         size = getAlignedSize(size);
+        ++stats.frees;
 
         // =================================== 作业 ===================================
         // TODO: 设计一个算法来回收内存
@@ -82,6 +87,7 @@ namespace infini
         {
             current->second += next->second; // 扩展当前块的大小
             free_blocks.erase(next);         // 删除后面的块
+            ++stats.merges;
         }
 
         // 检查是否与前面相邻
@@ -89,6 +95,7 @@ namespace infini
         {
             prev->second += current->second; // 扩展前一个块的大小
             free_blocks.erase(current);      // 删除当前块
+            ++stats.merges;
         }
     }
 
@@ -97,19 +104,24 @@ namespace infini
         if (this->ptr == nullptr)
         {
             this->ptr = runtime->alloc(this->peak);
-            printf("Allocator really alloc: %p %lu bytes\n", this->ptr, peak);
         }
         return this->ptr;
     }
 
     size_t Allocator::getAlignedSize(size_t size)
     {
-        return ((size - 1) / this->alignment + 1) * this->alignment;
+        // Empty tensors still get a distinct block.
+        return (std::max<size_t>(size, 1) - 1) / this->alignment * this->alignment +
+               this->alignment;
     }
 
     void Allocator::info()
     {
         std::cout << "Used memory: " << this->used
                   << ", peak memory: " << this->peak << std::endl;
+        std::cout << "Allocs: " << stats.allocs << " (" << stats.reused
+                  << " reused, " << stats.grownTail << " grown at the end)"
+                  << ", frees: " << stats.frees << " (" << stats.merges
+                  << " merges)" << std::endl;
     }
 }
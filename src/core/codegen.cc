@@ -0,0 +1,798 @@
+#include "core/codegen.h"
+#include "operators/concat.h"
+#include "operators/fused_elementwise.h"
+#include "operators/gather.h"
+#include "operators/layer_norm.h"
+#include "operators/matmul.h"
+#include "operators/reduce.h"
+#include "operators/softmax.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+namespace infini
+{
+    namespace
+    {
+        // Kernels of the generated file. Sizes, strides and attributes are
+        // compile-time constants at every call, so that the compiler unrolls
+        // and vectorizes for the actual shapes.
+        const char *kPrelude = R"(#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+using Index = std::ptrdiff_t;
+
+template <int R>
+constexpr Index product(const Index (&dims)[R])
+{
+    Index n = 1;
+    for (int d = 0; d < R; ++d)
+        n *= dims[d];
+    return n;
+}
+
+// Offset of the row-major element `i` of `dims` laid out with `stride`.
+template <int R>
+inline Index stridedOffset(Index i, const Index (&dims)[R],
+                           const Index (&stride)[R])
+{
+    Index offset = 0;
+    for (int d = R - 1; d >= 0; --d)
+    {
+        offset += i % dims[d] * stride[d];
+        i /= dims[d];
+    }
+    return offset;
+}
+
+template <Index N, typename F>
+inline void unary(const float *x, float *y, F f)
+{
+    for (Index i = 0; i < N; ++i)
+        y[i] = f(x[i]);
+}
+
+template <Index N, typename F>
+inline void binary(const float *a, const float *b, float *c, F f)
+{
+    for (Index i = 0; i < N; ++i)
+        c[i] = f(a[i], b[i]);
+}
+
+// Inputs read through strides along the output dims, 0 where broadcast.
+template <int R, typename F>
+inline void binaryStrided(const float *a, const float *b, float *c, F f,
+                          const Index (&dims)[R], const Index (&sa)[R],
+                          const Index (&sb)[R])
+{
+    const Index inner = dims[R - 1], outer = product(dims) / inner;
+    for (Index o = 0; o < outer; ++o)
+    {
+        const float *pa = a + stridedOffset(o * inner, dims, sa);
+        const float *pb = b + stridedOffset(o * inner, dims, sb);
+        float *pc = c + o * inner;
+        for (Index i = 0; i < inner; ++i)
+            pc[i] = f(pa[i * sa[R - 1]], pb[i * sb[R - 1]]);
+    }
+}
+
+// f maps the values of an element's inputs, read as in binaryStrided, to
+// the output.
+template <int R, int NI, typename F>
+inline void elementwise(const float *const (&x)[NI], float *y, F f,
+                        const Index (&dims)[R], const Index (&stride)[NI][R])
+{
+    const Index inner = dims[R - 1], outer = product(dims) / inner;
+    for (Index o = 0; o < outer; ++o)
+    {
+        const float *p[NI];
+        for (int k = 0; k < NI; ++k)
+            p[k] = x[k] + stridedOffset(o * inner, dims, stride[k]);
+        float *py = y + o * inner;
+        for (Index i = 0; i < inner; ++i)
+        {
+            float v[NI];
+            for (int k = 0; k < NI; ++k)
+                v[k] = p[k][i * stride[k][R - 1]];
+            py[i] = f(v);
+        }
+    }
+}
+
+// C[b] = A[b] B[b] with (row, column) strides of A and B as transposed.
+template <Index M, Index N, Index K, Index AR, Index AC, Index BR, Index BC,
+          int R>
+inline void matmul(const float *a, const float *b, float *c,
+                   const Index (&batch)[R], const Index (&sa)[R],
+                   const Index (&sb)[R])
+{
+    for (Index t = 0, nBatch = product(batch); t < nBatch; ++t)
+    {
+        const float *pa = a + stridedOffset(t, batch, sa);
+        const float *pb = b + stridedOffset(t, batch, sb);
+        for (Index i = 0; i < M; ++i)
+        {
+            float *row = c + (t * M + i) * N;
+            for (Index j = 0; j < N; ++j)
+                row[j] = 0;
+            for (Index p = 0; p < K; ++p)
+            {
+                const float v = pa[i * AR + p * AC];
+                const float *col = pb + p * BR;
+                for (Index j = 0; j < N; ++j)
+                    row[j] += v * col[j * BC];
+            }
+        }
+    }
+}
+
+template <Index Outer, Index Axis, Index Inner>
+inline void softmax(const float *x, float *y)
+{
+    for (Index o = 0; o < Outer; ++o)
+        for (Index in = 0; in < Inner; ++in)
+        {
+            const float *px = x + o * Axis * Inner + in;
+            float *py = y + o * Axis * Inner + in;
+            float max = px[0];
+            for (Index k = 1; k < Axis; ++k)
+                max = std::max(max, px[k * Inner]);
+            float sum = 0;
+            for (Index k = 0; k < Axis; ++k)
+                sum += py[k * Inner] = std::exp(px[k * Inner] - max);
+            const float inv = 1 / sum;
+            for (Index k = 0; k < Axis; ++k)
+                py[k * Inner] *= inv;
+        }
+}
+
+template <Index Rows, Index Cols, bool Rms>
+inline void norm(const float *x, const float *scale, const float *bias,
+                 float *y, float eps)
+{
+    for (Index r = 0; r < Rows; ++r)
+    {
+        const float *in = x + r * Cols;
+        float *out = y + r * Cols;
+        float mean = 0, var = 0;
+        if (!Rms)
+        {
+            for (Index j = 0; j < Cols; ++j)
+                mean += in[j];
+            mean /= Cols;
+        }
+        for (Index j = 0; j < Cols; ++j)
+            var += (in[j] - mean) * (in[j] - mean);
+        const float rstd = 1 / std::sqrt(var / Cols + eps);
+        for (Index j = 0; j < Cols; ++j)
+            out[j] = (in[j] - mean) * rstd * scale[j] + (bias ? bias[j] : 0);
+    }
+}
+
+template <Index N, typename T>
+inline void copy(const T *x, T *y)
+{
+    if (x != y)
+        std::memcpy(y, x, N * sizeof(T));
+}
+
+template <int R, typename T>
+inline void copyStrided(const T *x, T *y, const Index (&dims)[R],
+                        const Index (&stride)[R])
+{
+    const Index inner = dims[R - 1], outer = product(dims) / inner;
+    for (Index o = 0; o < outer; ++o)
+    {
+        const T *px = x + stridedOffset(o * inner, dims, stride);
+        for (Index i = 0; i < inner; ++i)
+            y[o * inner + i] = px[i * stride[R - 1]];
+    }
+}
+
+// One input of a concat, `y` pointing at its first column in the output.
+template <Index Outer, Index Block, Index OutBlock, typename T>
+inline void concatPart(const T *x, T *y)
+{
+    for (Index o = 0; o < Outer; ++o)
+        std::memcpy(y + o * OutBlock, x + o * Block, Block * sizeof(T));
+}
+
+template <Index Outer, Index Axis, Index N, Index Inner, typename T,
+          typename I>
+inline bool gather(const T *data, const I *indices, T *y)
+{
+    for (Index i = 0; i < N; ++i)
+        if (indices[i] < -Axis || indices[i] >= Axis)
+            return false;
+    for (Index o = 0; o < Outer; ++o)
+        for (Index i = 0; i < N; ++i)
+        {
+            const Index row = indices[i] < 0 ? indices[i] + Axis : indices[i];
+            std::memcpy(y + (o * N + i) * Inner,
+                        data + (o * Axis + row) * Inner, Inner * sizeof(T));
+        }
+    return true;
+}
+
+// `ostride` maps input coordinates to the output, 0 along reduced axes.
+template <Index OutSize, int R, typename F>
+inline void reduce(const float *x, float *y, const Index (&dims)[R],
+                   const Index (&ostride)[R], float init, F f, float scale)
+{
+    for (Index o = 0; o < OutSize; ++o)
+        y[o] = init;
+    for (Index i = 0, n = product(dims); i < n; ++i)
+    {
+        float &acc = y[stridedOffset(i, dims, ostride)];
+        acc = f(acc, x[i]);
+    }
+    if (scale != 1)
+        for (Index o = 0; o < OutSize; ++o)
+            y[o] *= scale;
+}
+} // namespace
+)";
+
+        string floatLiteral(float value)
+        {
+            if (std::isnan(value))
+                return "std::numeric_limits<float>::quiet_NaN()";
+            if (std::isinf(value))
+                return string(value < 0 ? "-" : "") +
+                       "std::numeric_limits<float>::infinity()";
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%af", value);
+            return buffer;
+        }
+
+        // "{a, b}", with a single `pad` if `values` is empty so that kernels
+        // always see arrays of at least one element.
+        template <typename T>
+        string list(const vector<T> &values, T pad = 0)
+        {
+            if (values.empty())
+                return "{" + std::to_string(pad) + "}";
+            string ret = "{";
+            for (size_t i = 0; i < values.size(); ++i)
+                ret += (i ? ", " : "") + std::to_string(values[i]);
+            return ret + "}";
+        }
+
+        string cType(DataType dtype)
+        {
+            if (dtype == DataType::Float32)
+                return "float";
+            if (dtype == DataType::Int32)
+                return "int32_t";
+            IT_ASSERT(dtype == DataType::Int64,
+                      "Cannot generate code for " + dtype.toString() +
+                          " tensors");
+            return "int64_t";
+        }
+
+        string describe(const Tensor &tensor)
+        {
+            return tensor->getDType().toString() + " " +
+                   vecToString(tensor->getDims());
+        }
+
+        class Emitter
+        {
+            string name;
+            TensorVec inputs, outputs;
+            size_t arenaBytes;
+            std::unordered_map<UidBaseType, size_t> arenaOffset;
+            std::unordered_map<TensorObj *, string> names;
+            std::ostringstream constants, pointers, body;
+
+            // Name of a pointer to the data of `tensor`, declared at the
+            // start of run() on first use.
+            string use(const Tensor &tensor)
+            {
+                auto it = names.find(tensor.get());
+                if (it != names.end())
+                    return it->second;
+                auto root = tensor;
+                while (root->getSource() && root->getSource()->isView())
+                    root = root->getSource()->getInputs(0);
+                const string type = cType(tensor->getDType()),
+                             var = "t" + std::to_string(tensor->getFuid());
+                string base;
+                if (!root->getSource() && root->isWeight())
+                    base = weight(root);
+                else if (!root->getSource())
+                {
+                    auto k = std::find(inputs.begin(), inputs.end(), root) -
+                             inputs.begin();
+                    base = "static_cast<const " + type + " *>(inputs[" +
+                           std::to_string(k) + "])";
+                }
+                else if (root->getTargets().empty())
+                {
+                    auto k = std::find(outputs.begin(), outputs.end(), root) -
+                             outputs.begin();
+                    base = "static_cast<" + type + " *>(outputs[" +
+                           std::to_string(k) + "])";
+                }
+                else
+                {
+                    auto offset = arenaOffset.find(root->getFuid());
+                    IT_ASSERT(offset != arenaOffset.end(),
+                              "Cannot generate code for tensors bound to "
+                              "external buffers");
+                    base = "reinterpret_cast<" + type + " *>(arena + " +
+                           std::to_string(offset->second) + ")";
+                }
+                bool readOnly = !root->getSource();
+                pointers << "    " << (readOnly ? "const " : "") << type
+                         << " *" << var << " = " << base;
+                if (tensor->getOffset())
+                    pointers << " + "
+                             << tensor->getOffset() /
+                                    tensor->getDType().getSize();
+                pointers << ";\n";
+                return names[tensor.get()] = var;
+            }
+
+            string weight(const Tensor &tensor)
+            {
+                const auto dtype = tensor->getDType();
+                const string var = "w" + std::to_string(tensor->getFuid());
+                constants << "alignas(64) const " << cType(dtype) << " " << var
+                          << "[" << std::max<size_t>(tensor->size(), 1)
+                          << "] = {";
+                for (size_t i = 0; i < tensor->size(); ++i)
+                {
+                    constants << (i % 8 ? " " : "\n    ");
+                    if (dtype == DataType::Float32)
+                        constants << floatLiteral(
+                            tensor->getRawDataPtr<float *>()[i]);
+                    else if (dtype == DataType::Int32)
+                        constants << tensor->getRawDataPtr<int32_t *>()[i];
+                    else
+                    {
+                        int64_t value = tensor->getRawDataPtr<int64_t *>()[i];
+                        if (value == std::numeric_limits<int64_t>::min())
+                            constants << "INT64_MIN";
+                        else
+                            constants << value;
+                    }
+                    constants << ",";
+                }
+                constants << "};\n\n";
+                return var;
+            }
+
+            void requireFloat(const Operator &op, size_t inputs)
+            {
+                for (size_t i = 0; i < inputs; ++i)
+                    IT_ASSERT(op->getInputs(i)->getDType() ==
+                                  DataType::Float32,
+                              "Cannot generate code for " + op->toString() +
+                                  ": only Float32 is supported");
+            }
+
+            // Element strides of `t` along the trailing dims of `dims`, 0 where
+            // broadcast.
+            static vector<int> broadcastStrides(const Tensor &t,
+                                                const Shape &dims)
+            {
+                const auto tDims = t->getDims();
+                const auto &stride = t->getStride();
+                vector<int> ret(dims.size(), 0);
+                size_t shift = dims.size() - tDims.size();
+                for (size_t i = 0; i < tDims.size(); ++i)
+                    if (tDims[i] != 1)
+                        ret[i + shift] = stride[i];
+                return ret;
+            }
+
+            void emitBinary(const Operator &op, const char *expr)
+            {
+                requireFloat(op, 2);
+                auto a = op->getInputs(0), b = op->getInputs(1);
+                auto c = op->getOutput();
+                const auto dims = c->getDims();
+                const string f =
+                    string("[](float a, float b) { return ") + expr + "; }";
+                string args = use(a) + ", " + use(b) + ", " + use(c) + ", " + f;
+                if (a->getDims() == dims && b->getDims() == dims &&
+                    a->isContiguous() && b->isContiguous())
+                    body << "    binary<" << c->size() << ">(" << args
+                         << ");\n";
+                else
+                    body << "    binaryStrided(" << args << ", " << list(dims, 1)
+                         << ", " << list(broadcastStrides(a, dims)) << ", "
+                         << list(broadcastStrides(b, dims)) << ");\n";
+            }
+
+            void emitUnary(const Operator &op, const string &expr)
+            {
+                requireFloat(op, 1);
+                auto x = op->getInputs(0), y = op->getOutput();
+                body << "    unary<" << y->size() << ">(" << use(x) << ", "
+                     << use(y) << ", [](float x) { return " << expr
+                     << "; });\n";
+            }
+
+            void emitFused(const Ref<FusedElementwiseObj> &op)
+            {
+                const auto &expr = op->getExpr();
+                auto y = op->getOutput();
+                auto rows = op->getRows();
+                vector<string> values;
+                string x, strides;
+                for (int k = 0; k < op->numInputs(); ++k)
+                {
+                    values.emplace_back("v[" + std::to_string(k) + "]");
+                    x += (k ? ", " : "") + use(op->getInputs(k));
+                    strides += (k ? ", " : "") + list(rows.strides[k]);
+                }
+                body << "    elementwise({" << x << "}, " << use(y)
+                     << ", [](const float *v) { " << expr.toCpp(values)
+                     << "return v" << expr.nodes.size() - 1 << "; }, "
+                     << list(rows.dims) << ", {" << strides << "});\n";
+            }
+
+            void emitMatmul(const Ref<MatmulObj> &op)
+            {
+                IT_ASSERT(op->numInputs() == 2,
+                          "Cannot generate code for a matmul with bias");
+                requireFloat(op, 2);
+                auto a = op->getInputs(0), b = op->getInputs(1);
+                auto c = op->getOutput();
+                auto matStrides = [](const Tensor &t, bool trans)
+                {
+                    const auto &stride = t->getStride();
+                    int row = stride[stride.size() - 2],
+                        col = stride[stride.size() - 1];
+                    return trans ? std::to_string(col) + ", " +
+                                       std::to_string(row)
+                                 : std::to_string(row) + ", " +
+                                       std::to_string(col);
+                };
+                auto cDims = c->getDims();
+                Shape batch(cDims.begin(), cDims.end() - 2);
+                auto batchStrides = [&](const Tensor &t)
+                {
+                    auto dims = t->getDims();
+                    auto strides = broadcastStrides(t, dims);
+                    vector<int> ret(batch.size(), 0);
+                    size_t shift = batch.size() - (dims.size() - 2);
+                    for (size_t i = 0; i + 2 < dims.size(); ++i)
+                        ret[i + shift] = strides[i];
+                    return ret;
+                };
+                body << "    matmul<" << op->getM() << ", " << op->getN()
+                     << ", " << op->getK() << ", "
+                     << matStrides(a, op->getTransA()) << ", "
+                     << matStrides(b, op->getTransB()) << ">(" << use(a)
+                     << ", " << use(b) << ", " << use(c) << ", "
+                     << list(batch, 1) << ", " << list(batchStrides(a)) << ", "
+                     << list(batchStrides(b)) << ");\n";
+            }
+
+            void emitSoftmax(const Ref<SoftmaxObj> &op)
+            {
+                requireFloat(op, 1);
+                auto x = op->getInputs(0), y = op->getOutput();
+                const auto dims = x->getDims();
+                const int rank = dims.size(),
+                          axis = (op->getAxis() + rank) % rank;
+                size_t outer = 1, inner = 1;
+                for (int i = 0; i < axis; ++i)
+                    outer *= dims[i];
+                for (int i = axis + 1; i < rank; ++i)
+                    inner *= dims[i];
+                body << "    softmax<" << outer << ", " << dims[axis] << ", "
+                     << inner << ">(" << use(x) << ", " << use(y) << ");\n";
+            }
+
+            void emitNorm(const Ref<NormObj> &op)
+            {
+                requireFloat(op, op->numInputs());
+                auto x = op->getInputs(0), y = op->getOutput();
+                const size_t cols = op->getInputs(1)->size(),
+                             rows = x->size() / cols;
+                body << "    norm<" << rows << ", " << cols << ", "
+                     << (op->getOpType() == OpType::RMSNorm ? "true" : "false")
+                     << ">(" << use(x) << ", " << use(op->getInputs(1)) << ", "
+                     << (op->numInputs() > 2 ? use(op->getInputs(2))
+                                             : "nullptr")
+                     << ", " << use(y) << ", " << floatLiteral(op->getEps())
+                     << ");\n";
+            }
+
+            void emitCopy(const Operator &op)
+            {
+                auto x = op->getInputs(0), y = op->getOutput();
+                if (x->isContiguous())
+                {
+                    body << "    copy<" << y->size() << ">(" << use(x) << ", "
+                         << use(y) << ");\n";
+                    return;
+                }
+                const auto &stride = x->getStride();
+                body << "    copyStrided(" << use(x) << ", " << use(y) << ", "
+                     << list(x->getDims(), 1) << ", "
+                     << list(vector<int>(stride.begin(), stride.end()))
+                     << ");\n";
+            }
+
+            void emitTranspose(const Ref<TransposeObj> &op)
+            {
+                auto x = op->getInputs(0), y = op->getOutput();
+                const auto perm = op->getPermute();
+                const auto &stride = x->getStride();
+                vector<int> permuted;
+                for (int axis : perm)
+                    permuted.emplace_back(stride[axis]);
+                body << "    copyStrided(" << use(x) << ", " << use(y) << ", "
+                     << list(y->getDims(), 1) << ", " << list(permuted)
+                     << ");\n";
+            }
+
+            void emitConcat(const Ref<ConcatObj> &op)
+            {
+                auto y = op->getOutput();
+                const auto outDims = y->getDims();
+                const int axis = op->getDim();
+                size_t outer = 1, outBlock = 1, column = 0;
+                for (int i = 0; i < axis; ++i)
+                    outer *= outDims[i];
+                for (size_t i = axis; i < outDims.size(); ++i)
+                    outBlock *= outDims[i];
+                for (const auto &x : op->getInputs())
+                {
+                    size_t block = x->size() / std::max<size_t>(outer, 1);
+                    body << "    concatPart<" << outer << ", " << block << ", "
+                         << outBlock << ">(" << use(x) << ", " << use(y)
+                         << " + " << column << ");\n";
+                    column += block;
+                }
+            }
+
+            void emitGather(const Ref<GatherObj> &op)
+            {
+                auto data = op->getInputs(0), indices = op->getInputs(1);
+                auto y = op->getOutput();
+                const auto dims = data->getDims();
+                const int axis = op->getAxis();
+                size_t outer = 1, inner = 1;
+                for (int i = 0; i < axis; ++i)
+                    outer *= dims[i];
+                for (size_t i = axis + 1; i < dims.size(); ++i)
+                    inner *= dims[i];
+                body << "    if (!gather<" << outer << ", " << dims[axis]
+                     << ", " << indices->size() << ", " << inner << ">("
+                     << use(data) << ", " << use(indices) << ", " << use(y)
+                     << "))\n        return 1;\n";
+            }
+
+            void emitReduce(const Ref<ReduceObj> &op)
+            {
+                requireFloat(op, 1);
+                auto x = op->getInputs(0), y = op->getOutput();
+                const auto dims = x->getDims();
+                const auto &axes = op->getAxes();
+                vector<int> ostride(dims.size(), 0);
+                size_t stride = 1, count = 1;
+                for (size_t i = dims.size(); i > 0; --i)
+                    if (std::binary_search(axes.begin(), axes.end(), i - 1))
+                        count *= dims[i - 1];
+                    else
+                    {
+                        ostride[i - 1] = stride;
+                        stride *= dims[i - 1];
+                    }
+                string init = "0", f = "a + b";
+                float scale = 1;
+                switch (op->getOpType().underlying())
+                {
+                case OpType::ReduceMean:
+                    scale = 1.f / count;
+                    break;
+                case OpType::ReduceMax:
+                    init = floatLiteral(-INFINITY);
+                    f = "std::max(a, b)";
+                    break;
+                case OpType::ReduceMin:
+                    init = floatLiteral(INFINITY);
+                    f = "std::min(a, b)";
+                    break;
+                case OpType::ReduceProd:
+                    init = "1";
+                    f = "a * b";
+                    break;
+                default:
+                    break;
+                }
+                body << "    reduce<" << y->size() << ">(" << use(x) << ", "
+                     << use(y) << ", " << list(dims, 1) << ", "
+                     << list(ostride) << ", " << init
+                     << ", [](float a, float b) { return " << f << "; }, "
+                     << floatLiteral(scale) << ");\n";
+            }
+
+            void emit(const Operator &op)
+            {
+                body << "    // " << op->getOpType().toString() << "["
+                     << op->getGuid() << "]"
+                     << (op->isView() ? ": view" : "") << "\n";
+                if (op->isView())
+                    return;
+                switch (op->getOpType().underlying())
+                {
+                case OpType::Add:
+                    return emitBinary(op, "a + b");
+                case OpType::Sub:
+                    return emitBinary(op, "a - b");
+                case OpType::Mul:
+                    return emitBinary(op, "a * b");
+                case OpType::Div:
+                    return emitBinary(op, "a / b");
+                case OpType::Relu:
+                    return emitUnary(op, "std::max(x, 0.f)");
+                case OpType::Exp:
+                    return emitUnary(op, "std::exp(x)");
+                case OpType::Sqrt:
+                    return emitUnary(op, "std::sqrt(x)");
+                case OpType::Clip:
+                {
+                    auto clip = as<ClipObj>(op);
+                    auto lo = clip->getMin(), hi = clip->getMax();
+                    return emitUnary(
+                        op, "std::min(std::max(x, " +
+                                floatLiteral(lo ? *lo : -INFINITY) + "), " +
+                                floatLiteral(hi ? *hi : INFINITY) + ")");
+                }
+                case OpType::FusedElementwise:
+                    return emitFused(as<FusedElementwiseObj>(op));
+                case OpType::MatMul:
+                    return emitMatmul(as<MatmulObj>(op));
+                case OpType::Softmax:
+                    return emitSoftmax(as<SoftmaxObj>(op));
+                case OpType::LayerNorm:
+                case OpType::RMSNorm:
+                    return emitNorm(as<NormObj>(op));
+                case OpType::Transpose:
+                    return emitTranspose(as<TransposeObj>(op));
+                case OpType::Reshape:
+                case OpType::Flatten:
+                case OpType::Squeeze:
+                case OpType::Unsqueeze:
+                    return emitCopy(op);
+                case OpType::Concat:
+                    return emitConcat(as<ConcatObj>(op));
+                case OpType::Gather:
+                    return emitGather(as<GatherObj>(op));
+                case OpType::ReduceSum:
+                case OpType::ReduceMean:
+                case OpType::ReduceMax:
+                case OpType::ReduceMin:
+                case OpType::ReduceProd:
+                    return emitReduce(as<ReduceObj>(op));
+                default:
+                    IT_TODO_HALT_MSG("Cannot generate code for " +
+                                     op->toString());
+                }
+            }
+
+        public:
+            Emitter(const Graph &graph, const string &name) : name(name)
+            {
+                const auto &plan = graph->getMemoryPlan();
+                const auto &ops = graph->getOperators();
+                IT_ASSERT(plan.steps.size() == ops.size(),
+                          "Generate code from a graph planned by dataMalloc");
+                // Graph inputs and outputs are read and written through the
+                // pointers passed to run, the arena only holds the buffers of
+                // intermediates.
+                std::unordered_map<UidBaseType, Tensor> byFuid;
+                for (const auto &tensor : graph->getTensors())
+                    byFuid[tensor->getFuid()] = tensor;
+                auto intermediate = [&](UidBaseType fuid)
+                {
+                    const auto &t = byFuid.at(fuid);
+                    return t->getSource() && !t->getSource()->isView() &&
+                           !t->getTargets().empty();
+                };
+                size_t begin = plan.peak, end = 0;
+                for (const auto &buffer : plan.buffers)
+                    if (std::any_of(buffer.tensors.begin(),
+                                    buffer.tensors.end(), intermediate))
+                    {
+                        begin = std::min(begin, buffer.offset);
+                        end = std::max(end, buffer.offset + buffer.bytes);
+                    }
+                arenaBytes = end > begin ? end - begin : 0;
+                for (const auto &buffer : plan.buffers)
+                    for (auto fuid : buffer.tensors)
+                        if (buffer.offset >= begin)
+                            arenaOffset[fuid] = buffer.offset - begin;
+                for (const auto &input : graph->getInputs())
+                    if (!input->isWeight())
+                        inputs.emplace_back(input);
+                outputs = graph->getOutputs();
+                for (const auto &op : ops)
+                    emit(op);
+            }
+
+            string str() const
+            {
+                std::ostringstream os;
+                os << "// Generated by InfiniTensor, do not edit.\n//\n";
+                for (size_t i = 0; i < inputs.size(); ++i)
+                    os << "// Input " << i << ": " << describe(inputs[i])
+                       << "\n";
+                for (size_t i = 0; i < outputs.size(); ++i)
+                    os << "// Output " << i << ": " << describe(outputs[i])
+                       << "\n";
+                os << "\n"
+                   << kPrelude << "\nnamespace\n{\n";
+                if (arenaBytes)
+                    os << "alignas(64) unsigned char arena[" << arenaBytes
+                       << "];\n\n";
+                os << constants.str() << "} // namespace\n\n";
+
+                auto bytes = [](const TensorVec &tensors)
+                {
+                    vector<size_t> ret;
+                    for (const auto &t : tensors)
+                        ret.emplace_back(t->getBytes());
+                    return list(ret);
+                };
+                os << "extern \"C\"\n{\n"
+                   << "    extern const int " << name << "_num_inputs, "
+                   << name << "_num_outputs;\n"
+                   << "    extern const size_t " << name << "_input_bytes[], "
+                   << name << "_output_bytes[];\n"
+                   << "    int " << name
+                   << "_run(const void *const *inputs, void *const *outputs);\n"
+                   << "}\n\n"
+                   << "const int " << name << "_num_inputs = " << inputs.size()
+                   << ", " << name << "_num_outputs = " << outputs.size()
+                   << ";\n"
+                   << "const size_t " << name << "_input_bytes[] = "
+                   << bytes(inputs) << ", " << name
+                   << "_output_bytes[] = " << bytes(outputs) << ";\n\n"
+                   << "int " << name
+                   << "_run(const void *const *inputs, void *const *outputs)\n"
+                   << "{\n"
+                   << pointers.str() << "\n"
+                   << body.str() << "    return 0;\n}\n";
+                return os.str();
+            }
+        };
+    } // namespace
+
+    string generateCpp(const Graph &graph, const string &name)
+    {
+        IT_ASSERT(!name.empty() && !std::isdigit(name[0]) &&
+                      std::all_of(name.begin(), name.end(),
+                                  [](char c)
+                                  { return std::isalnum(c) || c == '_'; }),
+                  "Not an identifier: " + name);
+        return Emitter(graph, name).str();
+    }
+
+    void saveCpp(const Graph &graph, const string &path, const string &name)
+    {
+        auto source = generateCpp(graph, name);
+        std::ofstream out(path);
+        IT_ASSERT(out, "Cannot write " + path);
+        out << source;
+    }
+
+} // namespace infini
@@ -0,0 +1,359 @@
+#include "core/elementwise_jit.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <pwd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace infini
+{
+    namespace
+    {
+        // Bumped whenever generate() changes, so that stale cached
+        // libraries are not loaded.
+        constexpr const char *kVersion = "fused-v2";
+
+        // Flags of the kernels: the host's vector instructions, and sqrt
+        // without errno so that it vectorizes.
+        constexpr const char *kFlags =
+            "-O2 -march=native -fno-math-errno -fopenmp-simd";
+
+        // ElementwiseExpr::fastExp, so that compiled and interpreted kernels
+        // agree up to contraction into FMAs.
+        const char *kPrelude = R"(#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+inline float fastExp(float x)
+{
+    constexpr float kMax = 88.7228394f, kMin = -87.3365479f;
+    float c = x > kMin ? x : kMin;
+    c = c < kMax ? c : kMax;
+    float n = c * 1.44269504f + 12582912.f;
+    n -= 12582912.f;
+    n = n < 127.f ? n : 127.f;
+    float r = c - n * 0.693359375f + n * 2.12194440e-4f;
+    float p = 1.9875691500e-4f;
+    p = p * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    p = p * r * r + r + 1.f;
+    uint32_t bits = (static_cast<int32_t>(n) + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    float y = p * scale;
+    y = x > kMax ? std::numeric_limits<float>::infinity() : y;
+    y = x < kMin ? 0.f : y;
+    return x != x ? x : y;
+}
+} // namespace
+
+extern "C"
+{
+    extern const char infini_fused_key[];
+    void infini_fused(const float *const *inputs, float *output, size_t n);
+}
+)";
+
+        // FNV-1a, stable across builds unlike std::hash.
+        string hashOf(const string &key)
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (unsigned char c : key)
+                hash = (hash ^ c) * 1099511628211ull;
+            char buffer[17];
+            std::snprintf(buffer, sizeof(buffer), "%016llx",
+                          (unsigned long long)hash);
+            return buffer;
+        }
+
+        // Per-user, so that no one else can plant libraries in it. Empty
+        // without a home directory.
+        string defaultCacheDir()
+        {
+            if (const char *xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg)
+                return string(xdg) + "/infini-jit";
+            const char *home = std::getenv("HOME");
+            if (!home || !*home)
+                if (auto pw = getpwuid(getuid()))
+                    home = pw->pw_dir;
+            return home && *home ? string(home) + "/.cache/infini-jit" : "";
+        }
+
+        bool exists(const string &path)
+        {
+            struct stat info;
+            return stat(path.c_str(), &info) == 0;
+        }
+
+        // Creates `dir` private to the user if missing, and refuses it
+        // unless only the user can write to it: libraries found there are
+        // loaded into the process.
+        void checkCacheDir(const string &dir)
+        {
+            IT_ASSERT(!dir.empty(),
+                      "No JIT cache directory, set INFINI_JIT_CACHE");
+            auto parent = dir.substr(0, dir.find_last_of('/'));
+            if (!parent.empty() && !exists(parent))
+                mkdir(parent.c_str(), 0700);
+            mkdir(dir.c_str(), 0700);
+            struct stat info;
+            IT_ASSERT(lstat(dir.c_str(), &info) == 0 && S_ISDIR(info.st_mode),
+                      "Cannot create JIT cache directory " + dir);
+            IT_ASSERT(info.st_uid == getuid() &&
+                          (info.st_mode & (S_IWGRP | S_IWOTH)) == 0,
+                      "JIT cache directory " + dir +
+                          " must be owned by the user and not writable by "
+                          "others");
+        }
+    } // namespace
+
+    ElementwiseJit::ElementwiseJit() : cacheDir(defaultCacheDir())
+    {
+        if (auto env = std::getenv("INFINI_JIT"))
+            enabled = *env && string(env) != "0";
+        if (auto env = std::getenv("INFINI_JIT_CACHE"); env && *env)
+            cacheDir = env;
+    }
+
+    ElementwiseJit::Kernel ElementwiseJit::get(const FusedElementwiseObj &op)
+    {
+        auto rows = op.getRows();
+        vector<int> steps;
+        for (const auto &stride : rows.strides)
+        {
+            if (stride.back() != 0 && stride.back() != 1)
+                return nullptr;
+            steps.emplace_back(stride.back());
+        }
+        {
+            std::lock_guard lock(mutex);
+            if (!enabled)
+                return nullptr;
+            auto it = opKernels.find(op.getGuid());
+            if (it != opKernels.end() && it->second.first == steps)
+                return it->second.second;
+        }
+        Kernel kernel = get(op.getExpr(), steps);
+        std::lock_guard lock(mutex);
+        opKernels[op.getGuid()] = {steps, kernel};
+        return kernel;
+    }
+
+    ElementwiseJit::Kernel ElementwiseJit::get(const ElementwiseExpr &expr,
+                                               const vector<int> &steps)
+    {
+        auto key = getKey(expr, steps);
+        std::unique_lock lock(mutex);
+        if (!enabled)
+            return nullptr;
+        // Waits for another thread compiling the same kernel; other kernels
+        // are served meanwhile.
+        for (;;)
+        {
+            auto it = entries.find(key);
+            if (it == entries.end())
+                break;
+            if (!it->second.building)
+                return it->second.kernel;
+            built.wait(lock);
+        }
+        entries[key].building = true;
+        const string dir = cacheDir;
+        lock.unlock();
+
+        string loadError;
+        size_t loadCompiles = 0;
+        Entry entry = load(key, expr, steps, dir, loadError, loadCompiles);
+
+        lock.lock();
+        if (!loadError.empty())
+            error = std::move(loadError);
+        compiles += loadCompiles;
+        auto &stored = entries[key];
+        stored = std::move(entry);
+        built.notify_all();
+        return stored.kernel;
+    }
+
+    string ElementwiseJit::getKey(const ElementwiseExpr &expr,
+                                  const vector<int> &steps)
+    {
+        IT_ASSERT((int)steps.size() >= expr.numInputs());
+        std::ostringstream os;
+        os << kVersion << "|" << expr.signature() << "|";
+        for (size_t k = 0; k < steps.size(); ++k)
+            os << (k ? "," : "") << steps[k];
+        return os.str();
+    }
+
+    string ElementwiseJit::generate(const ElementwiseExpr &expr,
+                                    const vector<int> &steps)
+    {
+        const auto key = getKey(expr, steps);
+        // Inputs read with step 0 are loaded once, the others are indexed
+        // in the block loops or copied to a padded block for the tail.
+        std::ostringstream head, tail;
+        vector<string> block, padded;
+        for (size_t k = 0; k < steps.size(); ++k)
+        {
+            const string x = "x" + std::to_string(k);
+            IT_ASSERT(steps[k] == 0 || steps[k] == 1,
+                      "Unsupported step " + std::to_string(steps[k]));
+            if (steps[k] == 0)
+            {
+                head << "    const float " << x << " = inputs[" << k
+                     << "][0];\n";
+                block.emplace_back(x);
+                padded.emplace_back(x);
+                continue;
+            }
+            head << "    const float *" << x << " = inputs[" << k << "];\n";
+            block.emplace_back(x + "[i + l]");
+            padded.emplace_back("p" + std::to_string(k) + "[l]");
+            tail << "        float p" << k << "[kBlock] = {};\n"
+                 << "        std::memcpy(p" << k << ", " << x
+                 << " + i, (n - i) * sizeof(float));\n";
+        }
+        const string result = "v" + std::to_string(expr.nodes.size() - 1);
+
+        std::ostringstream os;
+        os << "// Generated by InfiniTensor for " << key << "\n"
+           << kPrelude << "\n"
+           << "const char infini_fused_key[] = \"" << key << "\";\n\n"
+           << "void infini_fused(const float *const *inputs, float *output, "
+              "size_t n)\n{\n"
+           << "    constexpr size_t kBlock = 16;\n"
+           << head.str() << "    size_t i = 0;\n"
+           << "    for (; i + kBlock <= n; i += kBlock)\n    {\n"
+           << "#pragma omp simd\n"
+           << "        for (size_t l = 0; l < kBlock; ++l)\n        {\n"
+           << "            " << expr.toCpp(block, "fastExp") << "\n"
+           << "            output[i + l] = " << result << ";\n"
+           << "        }\n    }\n"
+           << "    if (i == n)\n        return;\n"
+           << "    {\n" // The partial last block, padded to a full one.
+           << tail.str() << "        float y[kBlock];\n"
+           << "#pragma omp simd\n"
+           << "        for (size_t l = 0; l < kBlock; ++l)\n        {\n"
+           << "            " << expr.toCpp(padded, "fastExp") << "\n"
+           << "            y[l] = " << result << ";\n"
+           << "        }\n"
+           << "        std::memcpy(output + i, y, (n - i) * sizeof(float));\n"
+           << "    }\n}\n";
+        return os.str();
+    }
+
+    ElementwiseJit::Entry ElementwiseJit::load(const string &key,
+                                               const ElementwiseExpr &expr,
+                                               const vector<int> &steps,
+                                               const string &cacheDir,
+                                               string &error, size_t &compiles)
+    {
+        Entry entry;
+        const string base = cacheDir + "/" + hashOf(key),
+                     library = base + ".so",
+                     temp = base + "-" + std::to_string(getpid());
+        try
+        {
+            checkCacheDir(cacheDir);
+            // A cached library is used if it was built for the same key.
+            if (exists(library))
+            {
+                entry.library = std::make_unique<SharedLibrary>(library);
+                if (string(entry.library->get<const char>(
+                        "infini_fused_key")) != key)
+                    entry.library.reset();
+            }
+            if (!entry.library)
+            {
+                // Built under temporary names and renamed, so that
+                // concurrent processes never load a partial file.
+                {
+                    std::ofstream out(temp + ".cc");
+                    IT_ASSERT(out.good(), "Cannot write to " + cacheDir);
+                    out << generate(expr, steps);
+                }
+                SharedLibrary::compile(temp + ".cc", temp + ".so", kFlags);
+                std::rename((temp + ".cc").c_str(), (base + ".cc").c_str());
+                IT_ASSERT(std::rename((temp + ".so").c_str(),
+                                      library.c_str()) == 0,
+                          "Cannot write " + library);
+                ++compiles;
+                entry.library = std::make_unique<SharedLibrary>(library);
+            }
+            entry.kernel = entry.library->get<void(const float *const *,
+                                                   float *, size_t)>(
+                "infini_fused");
+        }
+        catch (const Exception &e)
+        {
+            error = e.what();
+            entry = Entry();
+            std::remove((temp + ".cc").c_str());
+            std::remove((temp + ".so").c_str());
+        }
+        return entry;
+    }
+
+    void ElementwiseJit::setCacheDir(const string &dir)
+    {
+        std::lock_guard lock(mutex);
+        cacheDir = dir;
+    }
+
+    string ElementwiseJit::getCacheDir() const
+    {
+        std::lock_guard lock(mutex);
+        return cacheDir;
+    }
+
+    void ElementwiseJit::setEnabled(bool enabled)
+    {
+        std::lock_guard lock(mutex);
+        this->enabled = enabled;
+    }
+
+    bool ElementwiseJit::isEnabled() const
+    {
+        std::lock_guard lock(mutex);
+        return enabled;
+    }
+
+    string ElementwiseJit::getError() const
+    {
+        std::lock_guard lock(mutex);
+        return error;
+    }
+
+    size_t ElementwiseJit::getCompiles() const
+    {
+        std::lock_guard lock(mutex);
+        return compiles;
+    }
+
+    size_t ElementwiseJit::size() const
+    {
+        std::lock_guard lock(mutex);
+        return entries.size();
+    }
+
+    void ElementwiseJit::clear()
+    {
+        std::lock_guard lock(mutex);
+        opKernels.clear();
+        // Kernels being compiled are stored once built.
+        for (auto it = entries.begin(); it != entries.end();)
+            it = it->second.building ? std::next(it) : entries.erase(it);
+        compiles = 0;
+        error.clear();
+    }
+
+} // namespace infini
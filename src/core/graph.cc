@@ -1,9 +1,25 @@
 #include "core/graph.h"
-#include "operators/transpose.h"
+#include "core/elementwise_jit.h"
+#include "core/kernel.h"
+#include "operators/conv.h"
+#include "operators/element_wise.h"
+#include "operators/fused_elementwise.h"
+#include "operators/gather.h"
+#include "operators/layer_norm.h"
 #include "operators/matmul.h"
+#include "operators/pooling.h"
+#include "operators/reduce.h"
+#include "operators/reorder.h"
+#include "operators/softmax.h"
+#include "operators/sparse_matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
 #include <algorithm>
+#include <cstdlib>
+#include <functional>
 #include <numeric>
 #include <queue>
+#include <unordered_map>
 
 namespace infini
 {
@@ -129,151 +145,596 @@ namespace infini
         return false;
     }
 
-    void GraphObj::optimize()
+    namespace
     {
-        // =================================== 作业 ===================================
-        // TODO: 设计一个算法来实现指定的图优化规则
-        // 图优化规则如下：
-        // 1. 去除冗余的算子（例如，两个相邻的算子都是 transpose 算子，且做的是相反的操作，可以将其全部删除）
-        // 2. 合并算子（例如，矩阵乘算子中含有属性transA、transB，如果其输入存在transpose，且对最后两个维度做交换，就可以将transpose融入到矩阵乘算子的属性中去）
-        // =================================== 作业 ===================================
-        IT_ASSERT(topo_sort());
+        // The op producing `t` if it has type `type`.
+        Operator sourceOf(const Tensor &t, OpType type)
+        {
+            auto op = t ? t->getSource() : nullptr;
+            return op && op->getOpType() == type ? op : nullptr;
+        }
 
-        std::vector<Operator> remove_ops;
-        std::vector<Tensor> remove_tensors;
-        std::vector<Tensor> wait_for_cut;
+        // A constant float scalar such as an epsilon.
+        optional<float> scalarOf(const Tensor &t)
+        {
+            if (!t->isWeight() || t->getSource() || t->size() != 1 ||
+                !(t->getDType() == DataType::Float32) || !t->getDataBlob())
+                return std::nullopt;
+            return *t->getRawDataPtr<float *>();
+        }
 
-        // Step 1: Remove redundant Transpose operators
-        for (const auto &op : ops)
+        // A reduction of `type` keeping dims over the axes [axis, rank).
+        // Returns that axis, or -1.
+        int trailingReduce(const Operator &op, OpType type)
         {
-            if (op->getOpType() == OpType::Transpose && op->getPredecessors().size() == 1)
+            if (!op || op->getOpType() != type)
+                return -1;
+            auto reduce = as<ReduceObj>(op);
+            const auto &axes = reduce->getAxes();
+            int rank = reduce->getInputs(0)->getRank();
+            if (!reduce->getKeepDims() || axes.back() != rank - 1 ||
+                axes.back() - axes.front() + 1 != (int)axes.size())
+                return -1;
+            return axes.front();
+        }
+
+        // Softmax: Div(e, ReduceSum(e)) with e = Exp(x) or
+        // Exp(Sub(x, ReduceMax(x))), all reducing the same single axis.
+        Operator matchSoftmax(const Operator &div, OpVec &pattern)
+        {
+            auto sum = sourceOf(div->getInputs(1), OpType::ReduceSum);
+            auto exp = sourceOf(div->getInputs(0), OpType::Exp);
+            if (!sum || !exp || sum->getInputs(0) != div->getInputs(0))
+                return nullptr;
+            auto reduce = as<ReduceObj>(sum);
+            if (!reduce->getKeepDims() || reduce->getAxes().size() != 1)
+                return nullptr;
+            int axis = reduce->getAxes()[0];
+            auto x = exp->getInputs(0);
+            pattern = {exp, sum, div};
+            auto sub = sourceOf(x, OpType::Sub);
+            auto max = sub ? sourceOf(sub->getInputs(1), OpType::ReduceMax)
+                           : nullptr;
+            if (max && max->getInputs(0) == sub->getInputs(0) &&
+                as<ReduceObj>(max)->getKeepDims() &&
+                as<ReduceObj>(max)->getAxes() == reduce->getAxes())
             {
-                auto upstream_op = op->getPredecessors()[0];
-                if (upstream_op->getOpType() == OpType::Transpose)
-                {
-                    if (InvTranspose(*(dynamic_cast<TransposeObj *>(op.get())),
-                                     *(dynamic_cast<TransposeObj *>(upstream_op.get()))))
-                    {
-                        auto upstream_tensor = upstream_op->getInputs()[0];
-                        // Remove connections from upstream_op and op
-                        removeConnections(op, upstream_op);
-                        // Reconnect downstream operators directly to upstream_op’s input tensor
-                        reconnectDownstream(op, upstream_tensor);
-                        // Mark current op and its outputs for removal
-                        markForRemoval(op, remove_ops, remove_tensors, wait_for_cut);
-                    }
-                }
+                x = sub->getInputs(0);
+                pattern.insert(pattern.begin(), {max, sub});
             }
+            if (!(x->getDType() == DataType::Float32))
+                return nullptr;
+            return make_ref<SoftmaxObj>(nullptr, x, div->getOutput(), axis);
         }
-        // Step 2: Merge Transpose into Matmul
-        for (const auto &op : ops)
+
+        // RMSNorm: Mul(Div(x, Sqrt(Add(ReduceMean(Mul(x, x)), eps))), scale).
+        // LayerNorm: the same applied to x - ReduceMean(x), optionally
+        // followed by Add(_, bias).
+        Operator matchNorm(const Operator &mul, OpVec &pattern)
         {
-            if (op->getOpType() == OpType::MatMul)
+            for (int side = 0; side < 2; ++side)
             {
-                for (size_t i = 0; i < 2; ++i)
+                auto div = sourceOf(mul->getInputs(side), OpType::Div);
+                auto scale = mul->getInputs(1 - side);
+                auto sqrt =
+                    div ? sourceOf(div->getInputs(1), OpType::Sqrt) : nullptr;
+                auto add =
+                    sqrt ? sourceOf(sqrt->getInputs(0), OpType::Add) : nullptr;
+                if (!add)
+                    continue;
+                for (int i = 0; i < 2; ++i)
                 {
-                    auto input = op->getInputs()[i];
-                    if (auto upstream_op = input->getSource())
+                    auto eps = scalarOf(add->getInputs(1 - i));
+                    auto meanSq = add->getInputs(i)->getSource();
+                    int axis = trailingReduce(meanSq, OpType::ReduceMean);
+                    if (!eps || axis < 0)
+                        continue;
+                    auto z = div->getInputs(0);
+                    auto square = sourceOf(meanSq->getInputs(0), OpType::Mul);
+                    if (!square || square->getInputs(0) != z ||
+                        square->getInputs(1) != z ||
+                        !(z->getDType() == DataType::Float32))
+                        continue;
+                    const auto &dims = z->getDims();
+                    Shape normalized(dims.begin() + axis, dims.end());
+                    if (scale->getDims() != normalized)
+                        continue;
+                    pattern = {square, meanSq, add, sqrt, div, mul};
+
+                    auto sub = sourceOf(z, OpType::Sub);
+                    auto mean = sub ? sub->getInputs(1)->getSource() : nullptr;
+                    if (trailingReduce(mean, OpType::ReduceMean) != axis ||
+                        mean->getInputs(0) != sub->getInputs(0))
+                        return make_ref<RMSNormObj>(nullptr, z, scale,
+                                                    mul->getOutput(), axis,
+                                                    *eps);
+                    pattern.insert(pattern.begin(), {mean, sub});
+                    auto x = sub->getInputs(0);
+                    Tensor bias, y = mul->getOutput();
+                    auto targets = y->getTargets();
+                    if (targets.size() == 1 &&
+                        targets[0]->getOpType() == OpType::Add)
                     {
-                        if (upstream_op->getOpType() == OpType::Transpose)
+                        auto biasAdd = targets[0];
+                        int j = biasAdd->getInputs(0) == y ? 1 : 0;
+                        if (biasAdd->getInputs(j)->getDims() == normalized)
                         {
-                            if (bool is_transpose = isTransForMul(*(dynamic_cast<TransposeObj *>(upstream_op.get()))))
-                            {
-                                // Adjust MatMul attributes based on Transpose
-                                auto matmul_op = dynamic_cast<MatmulObj *>(op.get());
-                                if (i == 0)
-                                {
-                                    matmul_op->setTransA(matmul_op->getTransA() != is_transpose);
-                                }
-                                else
-                                {
-                                    matmul_op->setTransB(matmul_op->getTransB() != is_transpose);
-                                }
-
-                                // Remove connections and replace inputs
-                                removeConnections(op, upstream_op);
-                                reconnectDownstream(op, upstream_op->getInputs()[0]);
-                            }
+                            bias = biasAdd->getInputs(j);
+                            y = biasAdd->getOutput();
+                            pattern.emplace_back(biasAdd);
                         }
                     }
+                    return make_ref<LayerNormObj>(nullptr, x, scale, bias, y,
+                                                  axis, *eps);
                 }
             }
+            return nullptr;
         }
-        // Step 3: Clean up isolated tensors
-        cleanIsolatedTensors(wait_for_cut, remove_ops, remove_tensors);
-        // Step 4: Remove marked operators and tensors from graph
-        finalizeRemoval(remove_ops, remove_tensors);
-    }
 
-    void GraphObj::removeConnections(const Operator &op, const Operator &upstream_op)
-    {
-        upstream_op->removeSuccessors(op);
-        op->removePredecessors(upstream_op);
-        if (upstream_op->getPredecessors().size() == 1)
+        // EmbeddingBag: ReduceSum over the last index axis of Gather(table,
+        // indices) along the first axis of a [V, D] table.
+        Operator matchEmbeddingBag(const Operator &sum, OpVec &pattern)
         {
-            auto upstream_parent_op = upstream_op->getPredecessors()[0];
-            upstream_parent_op->removeSuccessors(upstream_op);
-            upstream_op->removePredecessors(upstream_parent_op);
-            upstream_op->addSuccessors(op);
-            op->addPredecessors(upstream_op);
+            auto gather = sourceOf(sum->getInputs(0), OpType::Gather);
+            if (!gather || as<GatherObj>(gather)->getAxis() != 0)
+                return nullptr;
+            auto table = gather->getInputs(0), indices = gather->getInputs(1);
+            auto reduce = as<ReduceObj>(sum);
+            int bagAxis = indices->getRank() - 1;
+            if (table->getRank() != 2 || bagAxis < 0 ||
+                reduce->getAxes() != vector<int>{bagAxis} ||
+                !(table->getDType() == DataType::Float32 ||
+                  table->getDType() == DataType::UInt32))
+                return nullptr;
+            pattern = {gather, sum};
+            return make_ref<EmbeddingBagObj>(nullptr, table, indices,
+                                             sum->getOutput(),
+                                             reduce->getKeepDims());
         }
-    }
 
-    void GraphObj::reconnectDownstream(const Operator &op, const Tensor &upstream_tensor)
+        // Intermediate results must not be consumed outside the pattern.
+        bool isClosed(const OpVec &pattern)
+        {
+            for (size_t i = 0; i + 1 < pattern.size(); ++i)
+                for (const auto &output : pattern[i]->getOutputs())
+                {
+                    auto targets = output->getTargets();
+                    if (targets.empty())
+                        return false;
+                    for (const auto &target : targets)
+                        if (std::find(pattern.begin(), pattern.end(), target) ==
+                            pattern.end())
+                            return false;
+                }
+            return true;
+        }
+
+        // Float Add, Sub, Mul, Div, Relu, Exp, Sqrt and Clip ops.
+        bool isFusable(const Operator &op)
+        {
+            switch (op->getOpType().underlying())
+            {
+            case OpType::Add:
+            case OpType::Sub:
+            case OpType::Mul:
+            case OpType::Div:
+            case OpType::Relu:
+            case OpType::Exp:
+            case OpType::Sqrt:
+            case OpType::Clip:
+                break;
+            default:
+                return false;
+            }
+            for (const auto &input : op->getInputs())
+                if (!(input->getDType() == DataType::Float32))
+                    return false;
+            return op->getOutput()->getDType() == DataType::Float32;
+        }
+
+        // The op computing `t` inside the fused tree of an output of `dims`:
+        // a fusable op of that shape whose result has a single consumer.
+        Operator fusedSource(const Tensor &t, const Shape &dims)
+        {
+            auto source = t->getSource();
+            if (!source || !isFusable(source) || t->getDims() != dims ||
+                t->getTargets().size() != 1)
+                return nullptr;
+            return source;
+        }
+
+        // Fraction of zeros from which constant Matmul weights are stored
+        // sparse, overridden by INFINI_SPARSE_THRESHOLD (above 1 disables).
+        double sparseThreshold()
+        {
+            static const double threshold = []
+            {
+                auto env = std::getenv("INFINI_SPARSE_THRESHOLD");
+                return env ? std::atof(env) : 0.7;
+            }();
+            return threshold;
+        }
+
+        // A new weight owning `data`.
+        template <typename T>
+        Tensor addConstant(GraphObj *g, const Shape &dims, DataType dtype,
+                           vector<T> &&data)
+        {
+            auto t = g->addTensor(dims, dtype);
+            auto owner = make_ref<vector<T>>(std::move(data));
+            t->setWeight();
+            t->setExternalData(owner->data(), owner->size() * sizeof(T), owner);
+            return t;
+        }
+    } // namespace
+
+    void GraphObj::optimize()
     {
-        for (const auto &output : op->getOutputs())
+        // =================================== 作业 ===================================
+        // TODO: 设计一个算法来实现指定的图优化规则
+        // 图优化规则如下：
+        // 1. 去除冗余的算子（例如，两个相邻的算子都是 transpose 算子，且做的是相反的操作，可以将其全部删除）
+        // 2. 合并算子（例如，矩阵乘算子中含有属性transA、transB，如果其输入存在transpose，且对最后两个维度做交换，就可以将transpose融入到矩阵乘算子的属性中去）
+        // =================================== 作业 ===================================
+        IT_ASSERT(topo_sort());
+
+        auto alive = [this](const Operator &op)
+        { return std::find(ops.begin(), ops.end(), op) != ops.end(); };
+
+        // Step 1: Remove pairs of adjacent Transpose operators that cancel out
+        for (const auto &op : OpVec(ops))
         {
+            if (!alive(op) || op->getOpType() != OpType::Transpose)
+                continue;
+            auto upstream_op = op->getInputs(0)->getSource();
+            auto output = op->getOutput();
+            if (!upstream_op || upstream_op->getOpType() != OpType::Transpose ||
+                output->getTargets().empty() ||
+                !InvTranspose(*as<TransposeObj>(op), *as<TransposeObj>(upstream_op)))
+                continue;
+            // Downstream operators read the input of the first transpose
+            auto upstream_tensor = upstream_op->getInputs(0);
             for (const auto &target : output->getTargets())
+                replaceOperatorInput(target, output, upstream_tensor);
+            removeIfUnused(op);
+            removeIfUnused(upstream_op);
+        }
+        // Step 2: Merge Transpose into Matmul
+        for (const auto &op : OpVec(ops))
+        {
+            if (!alive(op) || op->getOpType() != OpType::MatMul)
+                continue;
+            auto matmul_op = as<MatmulObj>(op);
+            for (size_t i = 0; i < 2; ++i)
             {
-                upstream_tensor->addTarget(target);
-                target->replaceInput(output, upstream_tensor);
+                auto input = op->getInputs(i);
+                auto upstream_op = input->getSource();
+                if (!upstream_op || upstream_op->getOpType() != OpType::Transpose ||
+                    !isTransForMul(*as<TransposeObj>(upstream_op)))
+                    continue;
+                // Adjust MatMul attributes based on Transpose
+                if (i == 0)
+                    matmul_op->setTransA(!matmul_op->getTransA());
+                else
+                    matmul_op->setTransB(!matmul_op->getTransB());
+                replaceOperatorInput(op, input, upstream_op->getInputs(0));
+                removeIfUnused(upstream_op);
             }
         }
+        // Step 3: Fuse decomposed Softmax, LayerNorm and RMSNorm, and
+        // embedding bags
+        for (const auto &op : OpVec(ops))
+        {
+            if (!alive(op))
+                continue;
+            OpVec pattern;
+            Operator fused;
+            if (op->getOpType() == OpType::Div)
+                fused = matchSoftmax(op, pattern);
+            else if (op->getOpType() == OpType::Mul)
+                fused = matchNorm(op, pattern);
+            else if (op->getOpType() == OpType::ReduceSum)
+                fused = matchEmbeddingBag(op, pattern);
+            if (fused && isClosed(pattern))
+                replaceWithFused(pattern, fused);
+        }
+        // Step 4: Run convolutions in the NCHWc layout
+        blockConvolutions();
+        // Step 5: Skip the zeros of sparse constant weights
+        sparsifyMatmuls();
+        // Step 6: Fuse the remaining elementwise ops
+        fuseElementwise();
     }
 
-    void GraphObj::markForRemoval(const Operator &op,
-                                  std::vector<Operator> &remove_ops,
-                                  std::vector<Tensor> &remove_tensors,
-                                  std::vector<Tensor> &wait_for_cut)
+    void GraphObj::sparsifyMatmuls()
     {
-        remove_ops.push_back(op);
-        for (const auto &output : op->getOutputs())
+        const double threshold = sparseThreshold();
+        for (const auto &op : OpVec(ops))
         {
-            remove_tensors.push_back(output);
-            for (const auto &target : output->getTargets())
+            if (op->getOpType() != OpType::MatMul)
+                continue;
+            auto matmul = as<MatmulObj>(op);
+            auto a = op->getInputs(0), w = op->getInputs(1);
+            if (matmul->getTransA() || w->getRank() != 2 || !w->isWeight() ||
+                w->getSource() || !w->getDataBlob() ||
+                !(w->getDType() == DataType::Float32) ||
+                !(a->getDType() == DataType::Float32))
+                continue;
+            const float *data = w->getRawDataPtr<float *>();
+            const size_t zeros = std::count(data, data + w->size(), 0.f);
+            if (zeros < threshold * w->size() || zeros == w->size())
+                continue;
+
+            // The cheapest block shape that tiles W; 1x1 always does.
+            const int k = matmul->getK(), n = matmul->getN();
+            optional<BlockSparse> best;
+            for (auto [rows, cols] : {pair{1, 8}, pair{4, 4}, pair{1, 1}})
             {
-                target->replaceInput(output, nullptr);
+                if (k % rows != 0 || n % cols != 0)
+                    continue;
+                auto sparse = BlockSparse::encode(data, k, n,
+                                                  matmul->getTransB(), rows,
+                                                  cols);
+                if (!best || sparse.cost() < best->cost())
+                    best = std::move(sparse);
             }
+            const int blocks = best->blocks(), br = best->blockRows,
+                      bc = best->blockCols;
+            auto values = addConstant(this, {blocks, br, bc},
+                                      DataType::Float32,
+                                      std::move(best->values));
+            auto index = addConstant(this, {blocks}, DataType::Int32,
+                                     std::move(best->index));
+            auto offsets = addConstant(this, {n / bc + 1}, DataType::Int32,
+                                       std::move(best->offsets));
+            replaceWithFused({op}, make_ref<SparseMatmulObj>(
+                                       nullptr, a, values, index, offsets,
+                                       op->getOutput(), br, bc));
+        }
+    }
+
+    void GraphObj::fuseElementwise()
+    {
+        using Code = ElementwiseExpr::Code;
+        for (const auto &op : OpVec(ops))
+        {
+            if (!isFusable(op))
+                continue;
+            // Ops feeding a fusable consumer join the consumer's tree.
+            auto output = op->getOutput();
+            const auto dims = output->getDims();
+            auto targets = output->getTargets();
+            if (targets.size() == 1 &&
+                fusedSource(output, targets[0]->getOutput()->getDims()) &&
+                isFusable(targets[0]))
+                continue;
+
+            ElementwiseExpr expr;
+            TensorVec inputs;
+            OpVec pattern;
+            std::unordered_map<TensorObj *, int> nodes;
+            std::function<int(const Tensor &)> build = [&](const Tensor &t)
+            {
+                if (auto it = nodes.find(t.get()); it != nodes.end())
+                    return it->second;
+                auto source = t == output ? op : fusedSource(t, dims);
+                int node;
+                if (!source)
+                {
+                    auto k = std::find(inputs.begin(), inputs.end(), t) -
+                             inputs.begin();
+                    if (k == (int)inputs.size())
+                        inputs.emplace_back(t);
+                    node = expr.add({Code::Input, int(k)});
+                }
+                else if (source->getOpType() == OpType::Clip)
+                {
+                    auto clip = as<ClipObj>(source);
+                    auto constant = [&](float value)
+                    { return expr.add({Code::Const, 0, 0, value}); };
+                    node = build(source->getInputs(0));
+                    if (auto lo = clip->getMin())
+                        node = expr.add({Code::Max, node, constant(*lo)});
+                    if (auto hi = clip->getMax())
+                        node = expr.add({Code::Min, node, constant(*hi)});
+                }
+                else
+                {
+                    static const std::unordered_map<int, Code> codes = {
+                        {OpType::Add, Code::Add},   {OpType::Sub, Code::Sub},
+                        {OpType::Mul, Code::Mul},   {OpType::Div, Code::Div},
+                        {OpType::Relu, Code::Relu}, {OpType::Exp, Code::Exp},
+                        {OpType::Sqrt, Code::Sqrt}};
+                    int a = build(source->getInputs(0));
+                    int b = source->numInputs() > 1
+                                ? build(source->getInputs(1))
+                                : 0;
+                    node = expr.add(
+                        {codes.at(source->getOpType().underlying()), a, b});
+                }
+                if (source)
+                    pattern.emplace_back(source);
+                return nodes[t.get()] = node;
+            };
+            build(output);
+            if (pattern.size() < 2)
+                continue;
+            replaceWithFused(pattern, make_ref<FusedElementwiseObj>(
+                                          nullptr, inputs, output, expr));
         }
     }
 
-    void GraphObj::cleanIsolatedTensors(std::vector<Tensor> &wait_for_cut,
-                                        std::vector<Operator> &remove_ops,
-                                        std::vector<Tensor> &remove_tensors)
+    void GraphObj::blockConvolutions()
     {
-        while (!wait_for_cut.empty())
+        auto alive = [this](const Operator &op)
+        { return std::find(ops.begin(), ops.end(), op) != ops.end(); };
+        auto toPlain = [](const Tensor &t) -> Operator
         {
-            auto tensor = wait_for_cut.back();
-            wait_for_cut.pop_back();
-            if (auto op = tensor->getSource())
+            auto source = t->getSource();
+            if (source && source->getOpType() == OpType::Reorder &&
+                !as<ReorderObj>(source)->isToBlocked())
+                return source;
+            return nullptr;
+        };
+
+        // Wrap every convolution with a direct kernel in a pair of reorders.
+        for (const auto &op : OpVec(ops))
+        {
+            if (op->getOpType() != OpType::Conv)
+                continue;
+            auto conv = as<ConvObj>(op);
+            if (conv->isBlocked() || !conv->hasBlockedKernel())
+                continue;
+            auto input = addOp<ReorderObj>(conv->getInputs(0), nullptr, true);
+            auto blocked = addOp<ConvObj>(
+                input->getOutput(), conv->getInputs(1), conv->getBias(),
+                nullptr, conv->getPads(), conv->getStrides(),
+                conv->getDilations(), conv->getGroup(), true);
+            replaceWithFused({op}, make_ref<ReorderObj>(
+                                       nullptr, blocked->getOutput(),
+                                       conv->getOutput(), false));
+        }
+
+        // Move reorders back to plain layout past layout-agnostic ops and
+        // poolings, which have blocked kernels too.
+        IT_ASSERT(topo_sort());
+        for (const auto &op : OpVec(ops))
+        {
+            auto type = op->getOpType();
+            bool pooling = type == OpType::MaxPool ||
+                           type == OpType::AveragePool ||
+                           type == OpType::GlobalAveragePool;
+            if (!alive(op) ||
+                (!pooling && type != OpType::Relu && type != OpType::Clip &&
+                 type != OpType::Add && type != OpType::Sub &&
+                 type != OpType::Mul && type != OpType::Div))
+                continue;
+            OpVec sources;
+            TensorVec inputs;
+            for (const auto &input : op->getInputs())
             {
-                removeConnections(op, nullptr);
-                markForRemoval(op, remove_ops, remove_tensors, wait_for_cut);
+                auto source = toPlain(input);
+                if (!source || (!inputs.empty() &&
+                                source->getInputs(0)->getDims() !=
+                                    inputs[0]->getDims()))
+                    break;
+                sources.emplace_back(source);
+                inputs.emplace_back(source->getInputs(0));
             }
+            if (inputs.size() != op->getInputs().size())
+                continue;
+            Tensor output;
+            Operator blocked;
+            if (pooling)
+            {
+                auto pool = as<PoolingObj>(op);
+                auto dims = op->getOutput()->getDims();
+                output = addTensor({dims[0], dims[1] / kChannelBlock, dims[2],
+                                    dims[3], kChannelBlock},
+                                   op->getDType());
+                blocked = make_ref<PoolingObj>(
+                    type, nullptr, inputs[0], output,
+                    pool->isGlobal() ? vector<int>{} : pool->getKernel(),
+                    pool->getPads(), pool->getStrides(),
+                    pool->getCountIncludePad(), true);
+            }
+            else
+            {
+                output = addTensor(inputs[0]->getDims(), op->getDType());
+                blocked = op->clone(inputs, {output});
+            }
+            addOperatorAndConnect(blocked);
+            replaceWithFused({op}, make_ref<ReorderObj>(
+                                       nullptr, output, op->getOutput(), false));
+            for (const auto &source : sources)
+                removeIfUnused(source);
+        }
+
+        // Cancel reorders to plain layout immediately blocked again.
+        for (const auto &op : OpVec(ops))
+        {
+            if (!alive(op) || op->getOpType() != OpType::Reorder ||
+                !as<ReorderObj>(op)->isToBlocked())
+                continue;
+            auto source = toPlain(op->getInputs(0));
+            if (!source)
+                continue;
+            auto output = op->getOutput();
+            for (const auto &target : output->getTargets())
+                replaceOperatorInput(target, output, source->getInputs(0));
+            removeIfUnused(op);
+            removeIfUnused(source);
         }
     }
 
-    void GraphObj::finalizeRemoval(const std::vector<Operator> &remove_ops,
-                                   const std::vector<Tensor> &remove_tensors)
+    void GraphObj::replaceWithFused(const OpVec &pattern,
+                                    const Operator &fused)
     {
-        for (const auto &op : remove_ops)
+        auto tail = pattern.back();
+        for (const auto &input : tail->getInputs())
         {
-            ops.erase(std::remove(ops.begin(), ops.end(), op), ops.end());
+            input->removeTarget(tail);
+            if (auto source = input->getSource())
+                source->removeSuccessors(tail);
         }
-        for (const auto &tensor : remove_tensors)
+        for (const auto &target : tail->getOutput()->getTargets())
+            target->removePredecessors(tail);
+        removeOperator(tail);
+        addOperatorAndConnect(fused);
+
+        TensorVec inputs = tail->getInputs();
+        for (auto it = pattern.rbegin() + 1; it != pattern.rend(); ++it)
         {
-            tensors.erase(std::remove(tensors.begin(), tensors.end(), tensor), tensors.end());
+            removeIfUnused(*it);
+            inputs.insert(inputs.end(), (*it)->getInputs().begin(),
+                          (*it)->getInputs().end());
         }
+        // Constants such as epsilons are left without consumers.
+        for (const auto &input : inputs)
+            if (!input->getSource() && input->getTargets().empty())
+                removeTensor(input);
+    }
+
+    void GraphObj::replaceOperatorInput(const Operator &op, const Tensor &from,
+                                        const Tensor &to)
+    {
+        op->replaceInput(from, to);
+        from->removeTarget(op);
+        to->addTarget(op);
+        if (auto source = from->getSource())
+        {
+            source->removeSuccessors(op);
+            op->removePredecessors(source);
+        }
+        // Restore links to sources still feeding other inputs of `op`
+        for (const auto &input : op->getInputs())
+        {
+            auto source = input->getSource();
+            if (!source)
+                continue;
+            auto preds = op->getPredecessors();
+            if (std::find(preds.begin(), preds.end(), source) == preds.end())
+            {
+                source->addSuccessors(op);
+                op->addPredecessors(source);
+            }
+        }
+    }
+
+    void GraphObj::removeIfUnused(const Operator &op)
+    {
+        for (const auto &output : op->getOutputs())
+            if (!output->getTargets().empty())
+                return;
+        for (const auto &input : op->getInputs())
+        {
+            input->removeTarget(op);
+            if (auto source = input->getSource())
+                source->removeSuccessors(op);
+        }
+        for (const auto &output : op->getOutputs())
+            removeTensor(output);
+        removeOperator(op);
     }
 
     Tensor GraphObj::getTensor(int fuid) const
@@ -315,26 +776,266 @@ namespace infini
     {
         // topological sorting first
         IT_ASSERT(topo_sort() == true);
+        planViews();
+        planKernels();
 
-        // =================================== 作业 ===================================
-        // TODO：利用 allocator 给计算图分配内存
-        // HINT: 获取分配好的内存指针后，可以调用 tensor 的 setDataBlob 函数给 tensor 绑定内存
-        // =================================== 作业 ===================================
-        size_t allocSize = 0;
+        // Tensors that share a buffer form an alias group, identified by the
+        // index of its first tensor. A group lives from the op producing its
+        // first tensor to the last op consuming any of its tensors.
+        const size_t nOps = ops.size(), forever = nOps;
+        std::unordered_map<TensorObj *, size_t> index;
+        for (size_t i = 0; i < tensors.size(); ++i)
+            index[tensors[i].get()] = i;
+        vector<size_t> group(tensors.size()), lastUse(tensors.size(), 0);
+        std::iota(group.begin(), group.end(), 0);
+        auto pinned = [&](const Tensor &t)
+        {
+            // Graph inputs and weights must survive runs, outputs are read
+            // back by the caller.
+            return !t->getSource() || t->getTargets().empty() || t->isWeight();
+        };
+        for (size_t i = 0; i < nOps; ++i)
+            for (auto &input : ops[i]->getInputs())
+                lastUse[index.at(input.get())] = i;
+        for (auto &t : tensors)
+            if (pinned(t))
+                lastUse[index.at(t.get())] = forever;
 
-        for (auto &tensor : tensors)
-            allocSize += tensor->size() * tensor->getDType().getSize();
-        size_t offset = allocator.alloc(allocSize);
+        // Views join the group of their input. In-place outputs join the group
+        // of a dense input dying at their op.
+        for (size_t i = 0; i < nOps; ++i)
+        {
+            auto &op = ops[i];
+            if (op->isView())
+            {
+                size_t g = group[index.at(op->getInputs(0).get())],
+                       o = index.at(op->getOutput().get());
+                group[o] = g;
+                lastUse[g] = std::max(lastUse[g], lastUse[o]);
+                continue;
+            }
+            if (op->getOutputs().empty())
+                continue;
+            auto output = op->getOutput(0);
+            if (output->isExternal())
+                continue;
+            for (int k : op->getInplaceInputs())
+            {
+                auto input = op->getInputs(k);
+                size_t g = group[index.at(input.get())];
+                if (tensors[g]->isExternal() || pinned(tensors[g]) ||
+                    lastUse[g] != i || !input->isContiguous() ||
+                    input->getOffset() != 0 ||
+                    input->getBytes() != output->getBytes())
+                    continue;
+                // Other inputs viewing the buffer differently, such as a
+                // transpose of it, would read elements already overwritten.
+                auto &inputs = op->getInputs();
+                if (std::any_of(inputs.begin(), inputs.end(),
+                                [&](const Tensor &other)
+                                {
+                                    return group[index.at(other.get())] ==
+                                               g &&
+                                           (!other->isContiguous() ||
+                                            other->getOffset() != 0 ||
+                                            other->getDims() !=
+                                                input->getDims());
+                                }))
+                    continue;
+                size_t o = index.at(output.get());
+                group[o] = g;
+                lastUse[g] = lastUse[o];
+                break;
+            }
+        }
+
+        // Plan offsets in execution order, freeing groups after their last use.
+        // Every decision is recorded in memoryPlan.
+        memoryPlan = MemoryPlan();
+        for (auto &op : ops)
+            memoryPlan.steps.emplace_back(
+                string(op->getOpType().toString()) + "[" +
+                std::to_string(op->getGuid()) + "]");
+        vector<size_t> offset(tensors.size());
+        vector<bool> planned(tensors.size(), false);
+        // Groups are identified by their root, so members are listed in one
+        // pass rather than a scan of all tensors per buffer.
+        vector<vector<size_t>> members(tensors.size());
+        for (size_t i = 0; i < tensors.size(); ++i)
+            members[group[i]].emplace_back(i);
+        auto allocGroup = [&](const Tensor &t, int step)
+        {
+            size_t g = group[index.at(t.get())];
+            if (tensors[g]->isExternal() || planned[g])
+                return;
+            offset[g] = allocator.alloc(t->getBytes());
+            planned[g] = true;
+            MemoryPlan::Buffer buffer{{}, offset[g], t->getBytes(), step,
+                                      int(lastUse[g])};
+            for (size_t i : members[g])
+                buffer.tensors.emplace_back(tensors[i]->getFuid());
+            memoryPlan.buffers.emplace_back(std::move(buffer));
+        };
+        for (auto &t : tensors)
+            if (!t->getSource())
+                allocGroup(t, -1);
+        for (size_t i = 0; i < nOps; ++i)
+        {
+            for (auto &output : ops[i]->getOutputs())
+                allocGroup(output, i);
+            for (auto &input : ops[i]->getInputs())
+            {
+                size_t g = group[index.at(input.get())];
+                if (planned[g] && lastUse[g] == i)
+                {
+                    allocator.free(offset[g], tensors[g]->getBytes());
+                    lastUse[g] = forever; // freed once
+                }
+            }
+        }
+        memoryPlan.peak = allocator.getPeak();
+        memoryPlan.allocator = allocator.getStats();
+        if (auto path = std::getenv("INFINI_MEMORY_PLAN"))
+            memoryPlan.save(path);
+        char *base = nullptr;
+        if (std::any_of(planned.begin(), planned.end(), [](bool p)
+                        { return p; }))
+            base = static_cast<char *>(allocator.getPtr());
+        for (size_t i = 0; i < tensors.size(); ++i)
+        {
+            auto &root = tensors[group[i]];
+            if (tensors[i]->isExternal())
+                continue;
+            if (root->isExternal())
+                tensors[i]->setDataBlob(root->getDataBlob());
+            else
+                tensors[i]->setDataBlob(
+                    make_ref<BlobObj>(runtime, base + offset[group[i]]));
+        }
+
+        // Compile the kernels of fused elementwise ops now rather than at
+        // their first run, if the JIT is enabled.
+        if (runtime->isCpu() && ElementwiseJit::getInstance().isEnabled())
+            for (auto &op : ops)
+                if (op->getOpType() == OpType::FusedElementwise)
+                    ElementwiseJit::getInstance().get(
+                        *as<FusedElementwiseObj>(op));
+    }
 
-        // 遍历所有张量，为每个张量绑定
+    void GraphObj::planViews()
+    {
+        for (auto &op : ops)
+            op->view = false;
         for (auto &tensor : tensors)
+            tensor->resetLayout();
+
+        // In topological order, so that input layouts are final when a view
+        // of them is inferred.
+        for (auto &op : ops)
+        {
+            if (op->getOutputs().size() != 1)
+                continue;
+            auto output = op->getOutput();
+            auto targets = output->getTargets();
+            // Graph outputs are handed to the caller and get their own buffer.
+            if (output->isExternal() || targets.empty())
+                continue;
+            auto layout = op->inferView();
+            if (!layout)
+                continue;
+            output->setLayout(std::move(layout->first), layout->second);
+            // Dense views, e.g. of a reshape, can be read by any kernel.
+            bool strided = output->isContiguous() || std::all_of(
+                targets.begin(), targets.end(), [&](const Operator &target)
+                {
+                    const auto &inputs = target->getInputs();
+                    for (size_t i = 0; i < inputs.size(); ++i)
+                        if (inputs[i] == output && !target->acceptsStridedInput(i))
+                            return false;
+                    return true; });
+            if (strided)
+                op->view = true;
+            else
+                output->resetLayout();
+        }
+    }
+
+    void GraphObj::planKernels()
+    {
+        // Ops without an applicable kernel are left to fail when run.
+        const auto &registry = KernelRegistry::getInstance();
+        for (auto &op : ops)
+        {
+            op->plannedKernel = nullptr;
+            if (op->isView())
+                continue;
+            auto record = registry.select(
+                KernelAttrs{runtime->getDevice(), op->getOpType().underlying()},
+                *op);
+            if (record)
+                op->plannedKernel = record->kernel;
+        }
+    }
+
+    void GraphObj::bindInput(const Tensor &tensor, void *ptr, size_t bytes,
+                             Ref<void> owner)
+    {
+        IT_ASSERT(std::find(tensors.begin(), tensors.end(), tensor) !=
+                      tensors.end(),
+                  "Tensor " + std::to_string(tensor->getGuid()) +
+                      " does not belong to this graph");
+        IT_ASSERT(!tensor->getSource(),
+                  "Tensor " + std::to_string(tensor->getGuid()) +
+                      " is not a graph input");
+        tensor->setExternalData(ptr, bytes, std::move(owner));
+    }
+
+    void GraphObj::bindOutput(const Tensor &tensor, void *ptr, size_t bytes,
+                              Ref<void> owner)
+    {
+        IT_ASSERT(std::find(tensors.begin(), tensors.end(), tensor) !=
+                      tensors.end(),
+                  "Tensor " + std::to_string(tensor->getGuid()) +
+                      " does not belong to this graph");
+        IT_ASSERT(tensor->getTargets().empty(),
+                  "Tensor " + std::to_string(tensor->getGuid()) +
+                      " is not a graph output");
+        tensor->setExternalData(ptr, bytes, std::move(owner));
+    }
+
+    Graph GraphObj::extract(const OpVec &ops, Runtime runtime) const
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        std::unordered_map<TensorObj *, Tensor> clones;
+        auto cloneOf = [&](const Tensor &t)
+        {
+            auto &clone = clones[t.get()];
+            if (!clone)
+            {
+                clone = make_ref<TensorObj>(*t);
+                clone->targets.clear();
+                clone->source.reset();
+                clone->runtime = runtime;
+                clone->resetLayout();
+                if (!t->isWeight())
+                {
+                    clone->data = nullptr;
+                    clone->external = false;
+                }
+                g->addTensor(clone);
+            }
+            return clone;
+        };
+        for (const auto &op : ops)
         {
-            // std::cout << allocator.getPtr() << ' ';
-            auto tensorPtr = static_cast<char *>(allocator.getPtr()) + offset; // 计算张量的内存地址
-            tensor->setDataBlob(make_ref<BlobObj>(runtime, tensorPtr));
-            offset += tensor->size() * tensor->getDType().getSize();
+            TensorVec inputs, outputs;
+            for (const auto &input : op->getInputs())
+                inputs.emplace_back(cloneOf(input));
+            for (const auto &output : op->getOutputs())
+                outputs.emplace_back(cloneOf(output));
+            g->addOperatorAndConnect(op->clone(inputs, outputs));
         }
-        allocator.info();
+        return g;
     }
 
     Tensor GraphObj::addTensor(Shape dim, DataType dtype)
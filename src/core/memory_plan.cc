@@ -0,0 +1,132 @@
+#include "core/memory_plan.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace infini
+{
+    size_t MemoryPlan::tensorBytes() const
+    {
+        size_t ret = 0;
+        for (const auto &buffer : buffers)
+            ret += buffer.bytes;
+        return ret;
+    }
+
+    size_t MemoryPlan::liveBytes(int step) const
+    {
+        size_t ret = 0;
+        for (const auto &buffer : buffers)
+            if (buffer.allocStep <= step && step <= buffer.freeStep)
+                ret += buffer.bytes;
+        return ret;
+    }
+
+    int MemoryPlan::maxLiveStep() const
+    {
+        int best = -1;
+        for (int step = 0; step < (int)steps.size(); ++step)
+            if (best < 0 || liveBytes(step) > liveBytes(best))
+                best = step;
+        return best;
+    }
+
+    double MemoryPlan::fragmentation() const
+    {
+        if (peak == 0)
+            return 0;
+        int step = maxLiveStep();
+        size_t live = step < 0 ? tensorBytes() : liveBytes(step);
+        return 1 - double(std::min(live, peak)) / peak;
+    }
+
+    double MemoryPlan::reuseRatio() const
+    {
+        return peak ? double(tensorBytes()) / peak : 0;
+    }
+
+    string MemoryPlan::toJson() const
+    {
+        std::ostringstream os;
+        os << "{\"peak\":" << peak << ",\"tensorBytes\":" << tensorBytes()
+           << ",\"maxLiveStep\":" << maxLiveStep()
+           << ",\"fragmentation\":" << fragmentation()
+           << ",\"reuseRatio\":" << reuseRatio() << ",\"allocator\":{"
+           << "\"allocs\":" << allocator.allocs
+           << ",\"frees\":" << allocator.frees
+           << ",\"reused\":" << allocator.reused
+           << ",\"grownTail\":" << allocator.grownTail
+           << ",\"merges\":" << allocator.merges << "},\"steps\":[";
+        for (size_t i = 0; i < steps.size(); ++i)
+            os << (i ? "," : "") << "\"" << steps[i] << "\"";
+        os << "],\"buffers\":[";
+        for (size_t i = 0; i < buffers.size(); ++i)
+        {
+            const auto &b = buffers[i];
+            os << (i ? "," : "") << "{\"tensors\":[";
+            for (size_t j = 0; j < b.tensors.size(); ++j)
+                os << (j ? "," : "") << b.tensors[j];
+            os << "],\"offset\":" << b.offset << ",\"bytes\":" << b.bytes
+               << ",\"allocStep\":" << b.allocStep
+               << ",\"freeStep\":" << b.freeStep << "}";
+        }
+        os << "]}";
+        return os.str();
+    }
+
+    string MemoryPlan::toCsv() const
+    {
+        std::ostringstream os;
+        os << "tensors,offset,bytes,alloc_step,free_step,producer\n";
+        for (const auto &b : buffers)
+        {
+            for (size_t j = 0; j < b.tensors.size(); ++j)
+                os << (j ? " " : "") << b.tensors[j];
+            os << "," << b.offset << "," << b.bytes << "," << b.allocStep
+               << "," << b.freeStep << ","
+               << (b.allocStep >= 0 ? steps[b.allocStep] : "input") << "\n";
+        }
+        return os.str();
+    }
+
+    string MemoryPlan::summary() const
+    {
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(2);
+        os << "Arena: " << peak << " bytes for " << buffers.size()
+           << " buffers of " << tensorBytes() << " bytes (reuse ratio "
+           << reuseRatio() << ", fragmentation " << fragmentation() << ")\n";
+        os << "Allocator: " << allocator.allocs << " allocs ("
+           << allocator.reused << " reused, " << allocator.grownTail
+           << " grown at the end), " << allocator.frees << " frees, "
+           << allocator.merges << " merges\n";
+        int step = maxLiveStep();
+        if (step < 0)
+            return os.str();
+        os << "Largest live set: " << liveBytes(step) << " bytes at step "
+           << step << " (" << steps[step] << ")\n";
+        vector<const Buffer *> live;
+        for (const auto &b : buffers)
+            if (b.allocStep <= step && step <= b.freeStep)
+                live.emplace_back(&b);
+        std::sort(live.begin(), live.end(),
+                  [](const Buffer *a, const Buffer *b)
+                  { return a->bytes > b->bytes; });
+        for (size_t i = 0; i < live.size() && i < 5; ++i)
+            os << "  " << live[i]->bytes << " bytes from "
+               << (live[i]->allocStep >= 0 ? steps[live[i]->allocStep]
+                                          : string("input"))
+               << ", live for steps " << live[i]->allocStep << " to "
+               << live[i]->freeStep << "\n";
+        return os.str();
+    }
+
+    void MemoryPlan::save(const string &path) const
+    {
+        std::ofstream out(path);
+        IT_ASSERT(out, "Cannot write memory plan to " + path);
+        bool csv = path.size() >= 4 && path.substr(path.size() - 4) == ".csv";
+        out << (csv ? toCsv() : toJson());
+    }
+
+} // namespace infini
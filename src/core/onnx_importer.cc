@@ -0,0 +1,876 @@
+#include "core/onnx_importer.h"
+#include "operators/concat.h"
+#include "operators/conv.h"
+#include "operators/element_wise.h"
+#include "operators/gather.h"
+#include "operators/layer_norm.h"
+#include "operators/matmul.h"
+#include "operators/pooling.h"
+#include "operators/reduce.h"
+#include "operators/reshape.h"
+#include "operators/softmax.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include "utils/mapped_file.h"
+#include <cstring>
+
+namespace infini
+{
+    namespace
+    {
+        // Minimal protobuf wire-format reader over a memory range. Only the
+        // messages and fields of onnx.proto used by the importer are decoded,
+        // everything else is skipped.
+        class ProtoReader
+        {
+            const char *cur, *end;
+
+        public:
+            enum WireType
+            {
+                Varint = 0,
+                Fixed64 = 1,
+                Bytes = 2,
+                Fixed32 = 5,
+            };
+
+            ProtoReader(const char *begin, const char *end)
+                : cur(begin), end(end) {}
+
+            bool done() const { return cur >= end; }
+            const char *pos() const { return cur; }
+
+            uint64_t varint()
+            {
+                uint64_t val = 0;
+                for (int shift = 0; shift < 64; shift += 7)
+                {
+                    IT_ASSERT(cur < end, "Truncated ONNX file");
+                    uint8_t byte = *cur++;
+                    val |= uint64_t(byte & 0x7f) << shift;
+                    if (!(byte & 0x80))
+                        return val;
+                }
+                IT_TODO_HALT_MSG("Malformed varint in ONNX file");
+            }
+
+            // Returns the field number and stores the wire type.
+            uint32_t tag(WireType &wire)
+            {
+                auto key = varint();
+                wire = WireType(key & 7);
+                return key >> 3;
+            }
+
+            ProtoReader bytes()
+            {
+                auto len = varint();
+                IT_ASSERT(len <= uint64_t(end - cur), "Truncated ONNX file");
+                ProtoReader sub(cur, cur + len);
+                cur += len;
+                return sub;
+            }
+
+            string str()
+            {
+                auto sub = bytes();
+                return string(sub.cur, sub.end);
+            }
+
+            template <typename T>
+            T fixed()
+            {
+                IT_ASSERT(sizeof(T) <= size_t(end - cur), "Truncated ONNX file");
+                T val;
+                std::memcpy(&val, cur, sizeof(T));
+                cur += sizeof(T);
+                return val;
+            }
+
+            void skip(WireType wire)
+            {
+                switch (wire)
+                {
+                case Varint:
+                    varint();
+                    break;
+                case Fixed64:
+                    fixed<uint64_t>();
+                    break;
+                case Bytes:
+                    bytes();
+                    break;
+                case Fixed32:
+                    fixed<uint32_t>();
+                    break;
+                default:
+                    IT_TODO_HALT_MSG("Unsupported wire type in ONNX file");
+                }
+            }
+
+            // Repeated scalar fields may be packed or not.
+            void repeatedVarint(WireType wire, vector<int64_t> &out)
+            {
+                if (wire == Bytes)
+                {
+                    auto sub = bytes();
+                    while (!sub.done())
+                        out.emplace_back(sub.varint());
+                }
+                else
+                    out.emplace_back(varint());
+            }
+
+            template <typename T>
+            void repeatedFixed(WireType wire, vector<T> &out)
+            {
+                if (wire == Bytes)
+                {
+                    auto sub = bytes();
+                    while (!sub.done())
+                        out.emplace_back(sub.fixed<T>());
+                }
+                else
+                    out.emplace_back(fixed<T>());
+            }
+        };
+
+        struct OnnxTensor
+        {
+            string name;
+            Shape dims;
+            int dtype = 0;
+            const char *raw = nullptr;
+            size_t rawSize = 0;
+            vector<float> floats;
+            vector<double> doubles;
+            vector<int64_t> ints; // int32_data, int64_data and uint64_data
+        };
+
+        struct OnnxAttribute
+        {
+            float f = 0;
+            int64_t i = 0;
+            vector<int64_t> ints;
+            vector<float> floats;
+            string s;
+            optional<OnnxTensor> t;
+        };
+
+        struct OnnxNode
+        {
+            string opType;
+            vector<string> inputs, outputs;
+            std::unordered_map<string, OnnxAttribute> attrs;
+        };
+
+        OnnxTensor parseTensor(ProtoReader r)
+        {
+            OnnxTensor t;
+            vector<int64_t> dims;
+            ProtoReader::WireType wire;
+            while (!r.done())
+            {
+                switch (r.tag(wire))
+                {
+                case 1:
+                    r.repeatedVarint(wire, dims);
+                    break;
+                case 2:
+                    t.dtype = r.varint();
+                    break;
+                case 4:
+                    r.repeatedFixed<float>(wire, t.floats);
+                    break;
+                case 5:
+                case 7:
+                case 11:
+                    r.repeatedVarint(wire, t.ints);
+                    break;
+                case 8:
+                    t.name = r.str();
+                    break;
+                case 9:
+                {
+                    auto sub = r.bytes();
+                    t.raw = sub.pos();
+                    t.rawSize = r.pos() - sub.pos();
+                    break;
+                }
+                case 10:
+                    r.repeatedFixed<double>(wire, t.doubles);
+                    break;
+                case 14: // data_location
+                    IT_ASSERT(r.varint() == 0,
+                              "External ONNX tensor data is not supported");
+                    break;
+                default:
+                    r.skip(wire);
+                }
+            }
+            for (auto d : dims)
+                t.dims.emplace_back(d);
+            return t;
+        }
+
+        // ValueInfoProto -> name, elem_type and shape (-1 for symbolic dims).
+        tuple<string, int, Shape> parseValueInfo(ProtoReader r)
+        {
+            string name;
+            int dtype = 0;
+            Shape shape;
+            ProtoReader::WireType wire;
+            while (!r.done())
+            {
+                auto field = r.tag(wire);
+                if (field == 1)
+                    name = r.str();
+                else if (field == 2)
+                {
+                    auto type = r.bytes();
+                    while (!type.done())
+                    {
+                        if (type.tag(wire) != 1) // tensor_type
+                        {
+                            type.skip(wire);
+                            continue;
+                        }
+                        auto tensorType = type.bytes();
+                        while (!tensorType.done())
+                        {
+                            auto f = tensorType.tag(wire);
+                            if (f == 1)
+                                dtype = tensorType.varint();
+                            else if (f == 2)
+                            {
+                                auto shapeProto = tensorType.bytes();
+                                while (!shapeProto.done())
+                                {
+                                    if (shapeProto.tag(wire) != 1)
+                                    {
+                                        shapeProto.skip(wire);
+                                        continue;
+                                    }
+                                    auto dim = shapeProto.bytes();
+                                    int value = -1;
+                                    while (!dim.done())
+                                    {
+                                        if (dim.tag(wire) == 1)
+                                            value = dim.varint();
+                                        else
+                                            dim.skip(wire);
+                                    }
+                                    shape.emplace_back(value);
+                                }
+                            }
+                            else
+                                tensorType.skip(wire);
+                        }
+                    }
+                }
+                else
+                    r.skip(wire);
+            }
+            return {name, dtype, shape};
+        }
+
+        OnnxNode parseNode(ProtoReader r)
+        {
+            OnnxNode node;
+            ProtoReader::WireType wire;
+            while (!r.done())
+            {
+                switch (r.tag(wire))
+                {
+                case 1:
+                    node.inputs.emplace_back(r.str());
+                    break;
+                case 2:
+                    node.outputs.emplace_back(r.str());
+                    break;
+                case 4:
+                    node.opType = r.str();
+                    break;
+                case 5:
+                {
+                    auto a = r.bytes();
+                    string name;
+                    OnnxAttribute attr;
+                    while (!a.done())
+                    {
+                        switch (a.tag(wire))
+                        {
+                        case 1:
+                            name = a.str();
+                            break;
+                        case 2:
+                            attr.f = a.fixed<float>();
+                            break;
+                        case 3:
+                            attr.i = a.varint();
+                            break;
+                        case 4:
+                            attr.s = a.str();
+                            break;
+                        case 5:
+                            attr.t = parseTensor(a.bytes());
+                            break;
+                        case 7:
+                            a.repeatedFixed<float>(wire, attr.floats);
+                            break;
+                        case 8:
+                            a.repeatedVarint(wire, attr.ints);
+                            break;
+                        default:
+                            a.skip(wire);
+                        }
+                    }
+                    node.attrs.emplace(name, std::move(attr));
+                    break;
+                }
+                default:
+                    r.skip(wire);
+                }
+            }
+            return node;
+        }
+
+        CastType castTypeOf(DataType from, DataType to)
+        {
+            static const std::map<pair<int, int>, CastType> table = {
+                {{1, 10}, CastType::Float2Float16},
+                {{1, 7}, CastType::Float2Int64},
+                {{1, 6}, CastType::Float2Int32},
+                {{1, 5}, CastType::Float2Int16},
+                {{1, 3}, CastType::Float2Int8},
+                {{1, 16}, CastType::Float2BFloat16},
+                {{1, 1}, CastType::Float2Float},
+                {{6, 1}, CastType::Int322Float},
+                {{6, 3}, CastType::Int322Int8},
+                {{6, 5}, CastType::Int322Int16},
+                {{6, 7}, CastType::Int322Int64},
+                {{5, 1}, CastType::Int162Float},
+                {{5, 6}, CastType::Int162Int32},
+                {{3, 1}, CastType::Int82Float},
+                {{3, 5}, CastType::Int82Int16},
+                {{3, 6}, CastType::Int82Int32},
+                {{2, 1}, CastType::Uint82Float},
+                {{2, 6}, CastType::Uint82Int32},
+                {{2, 7}, CastType::Uint82Int64},
+                {{7, 6}, CastType::Int642Int32},
+                {{7, 12}, CastType::Int642Uint32},
+                {{7, 1}, CastType::Int642Float},
+                {{12, 7}, CastType::Uint322Int64},
+                {{10, 1}, CastType::Float162Float},
+                {{16, 1}, CastType::BFloat162Float},
+            };
+            auto it = table.find({from.getIndex(), to.getIndex()});
+            IT_ASSERT(it != table.end(), "Unsupported Cast from " +
+                                             from.toString() + " to " +
+                                             to.toString());
+            return it->second;
+        }
+
+        class OnnxImporter
+        {
+            Runtime runtime;
+            Ref<MappedFile> file;
+            Graph g;
+            std::unordered_map<string, Tensor> tensors;
+
+        public:
+            OnnxImporter(Runtime runtime, const string &path)
+                : runtime(runtime), file(make_ref<MappedFile>(path)),
+                  g(make_ref<GraphObj>(runtime)) {}
+
+            Graph import(const std::map<string, Shape> &inputShapes)
+            {
+                ProtoReader model(file->data(), file->data() + file->size());
+                optional<ProtoReader> graph;
+                ProtoReader::WireType wire;
+                while (!model.done())
+                {
+                    if (model.tag(wire) == 7)
+                        graph = model.bytes();
+                    else
+                        model.skip(wire);
+                }
+                IT_ASSERT(graph.has_value(), "ONNX model has no graph");
+
+                vector<ProtoReader> nodes, initializers, inputs;
+                for (ProtoReader r = *graph; !r.done();)
+                {
+                    auto field = r.tag(wire);
+                    if (field == 1)
+                        nodes.emplace_back(r.bytes());
+                    else if (field == 5)
+                        initializers.emplace_back(r.bytes());
+                    else if (field == 11)
+                        inputs.emplace_back(r.bytes());
+                    else
+                        r.skip(wire);
+                }
+                // Inputs first, so that they lead GraphObj::getInputs(). Older
+                // exporters also list initializers as inputs.
+                std::unordered_set<string> initializerNames;
+                for (auto &init : initializers)
+                    initializerNames.emplace(tensorName(init));
+                for (auto &info : inputs)
+                {
+                    auto valueInfo = parseValueInfo(info);
+                    if (!initializerNames.count(std::get<0>(valueInfo)))
+                        addInput(valueInfo, inputShapes);
+                }
+                for (auto &init : initializers)
+                    addWeight(parseTensor(init));
+                for (auto &node : nodes)
+                    addNode(parseNode(node));
+                // Constants folded into attributes (e.g. Clip bounds) are
+                // left without consumers.
+                for (auto &tensor : TensorVec(g->getTensors()))
+                    if (tensor->isWeight() && tensor->getTargets().empty())
+                        g->removeTensor(tensor);
+                return g;
+            }
+
+        private:
+            static string tensorName(ProtoReader r)
+            {
+                ProtoReader::WireType wire;
+                while (!r.done())
+                {
+                    if (r.tag(wire) == 8)
+                        return r.str();
+                    r.skip(wire);
+                }
+                return "";
+            }
+
+            void addInput(tuple<string, int, Shape> info,
+                          const std::map<string, Shape> &inputShapes)
+            {
+                auto &[name, dtype, shape] = info;
+                if (auto it = inputShapes.find(name); it != inputShapes.end())
+                    shape = it->second;
+                for (auto d : shape)
+                    IT_ASSERT(d >= 0, "Input " + name +
+                                          " has a symbolic shape, pass it in "
+                                          "inputShapes");
+                tensors[name] = g->addTensor(shape, DataType(dtype));
+            }
+
+            Tensor addWeight(const OnnxTensor &t)
+            {
+                IT_ASSERT(t.dtype > 0 && t.dtype <= DataType::BFloat16.getIndex() &&
+                              t.dtype != DataType::String.getIndex(),
+                          "Unsupported initializer type of " + t.name);
+                auto tensor = g->addTensor(t.dims, DataType(t.dtype));
+                auto bytes = tensor->getBytes();
+                auto rt = runtime;
+                Ref<void> buffer(runtime->alloc(bytes),
+                                 [rt](void *ptr) { rt->dealloc(ptr); });
+                auto dst = static_cast<char *>(buffer.get());
+                auto elemSize = tensor->getDType().getSize();
+                if (t.raw)
+                {
+                    IT_ASSERT(t.rawSize == bytes,
+                              "Wrong raw_data size of " + t.name);
+                    std::memcpy(dst, t.raw, bytes);
+                    file->release(t.raw - file->data(), t.rawSize);
+                }
+                else if (!t.floats.empty())
+                {
+                    IT_ASSERT(t.floats.size() == tensor->size() && elemSize == 4);
+                    std::memcpy(dst, t.floats.data(), bytes);
+                }
+                else if (!t.doubles.empty())
+                {
+                    IT_ASSERT(t.doubles.size() == tensor->size() && elemSize == 8);
+                    std::memcpy(dst, t.doubles.data(), bytes);
+                }
+                else
+                {
+                    // Integers (and float16 bits) are stored widened to varints.
+                    IT_ASSERT(t.ints.size() == tensor->size(),
+                              "Missing data of initializer " + t.name);
+                    for (size_t i = 0; i < t.ints.size(); ++i)
+                        std::memcpy(dst + i * elemSize, &t.ints[i], elemSize);
+                }
+                tensor->setWeight();
+                tensor->setExternalData(dst, bytes, buffer);
+                if (!t.name.empty())
+                    tensors[t.name] = tensor;
+                return tensor;
+            }
+
+            Tensor addScalar(float value)
+            {
+                OnnxTensor t;
+                t.dims = {1};
+                t.dtype = DataType::Float32.getIndex();
+                t.floats = {value};
+                return addWeight(t);
+            }
+
+            Tensor input(const OnnxNode &node, size_t i)
+            {
+                if (i >= node.inputs.size() || node.inputs[i].empty())
+                    return nullptr;
+                auto it = tensors.find(node.inputs[i]);
+                IT_ASSERT(it != tensors.end(),
+                          "Unknown tensor " + node.inputs[i]);
+                return it->second;
+            }
+
+            optional<float> scalarOf(const Tensor &t)
+            {
+                if (!t)
+                    return std::nullopt;
+                IT_ASSERT(t->isWeight() && t->size() == 1 &&
+                              t->getDType() == DataType::Float32,
+                          "Only constant float scalars are supported here");
+                return *t->getRawDataPtr<float *>();
+            }
+
+            // Constant integer tensors such as Reshape shapes or Squeeze axes.
+            optional<vector<int>> intsOf(const Tensor &t)
+            {
+                if (!t)
+                    return std::nullopt;
+                IT_ASSERT(t->isWeight(), "Only constant shapes and axes are "
+                                         "supported");
+                vector<int> ret;
+                if (t->getDType() == DataType::Int64)
+                    ret.assign(t->getRawDataPtr<int64_t *>(),
+                               t->getRawDataPtr<int64_t *>() + t->size());
+                else if (t->getDType() == DataType::Int32)
+                    ret.assign(t->getRawDataPtr<int32_t *>(),
+                               t->getRawDataPtr<int32_t *>() + t->size());
+                else
+                    IT_TODO_HALT_MSG("Shapes and axes must be integers");
+                return ret;
+            }
+
+            const OnnxAttribute *attr(const OnnxNode &node, const string &name)
+            {
+                auto it = node.attrs.find(name);
+                return it == node.attrs.end() ? nullptr : &it->second;
+            }
+
+            void addNode(const OnnxNode &node)
+            {
+                auto &type = node.opType;
+                IT_ASSERT(!node.outputs.empty());
+                Tensor out;
+                if (type == "Constant")
+                {
+                    auto value = attr(node, "value");
+                    IT_ASSERT(value && value->t.has_value(),
+                              "Only tensor Constant nodes are supported");
+                    out = addWeight(*value->t);
+                }
+                else if (type == "Add")
+                    out = g->addOp<AddObj>(input(node, 0), input(node, 1), nullptr)
+                              ->getOutput();
+                else if (type == "Sub")
+                    out = g->addOp<SubObj>(input(node, 0), input(node, 1), nullptr)
+                              ->getOutput();
+                else if (type == "Mul")
+                    out = g->addOp<MulObj>(input(node, 0), input(node, 1), nullptr)
+                              ->getOutput();
+                else if (type == "Div")
+                    out = g->addOp<DivObj>(input(node, 0), input(node, 1), nullptr)
+                              ->getOutput();
+                else if (type == "Relu")
+                    out = g->addOp<ReluObj>(input(node, 0), nullptr)->getOutput();
+                else if (type == "Exp")
+                    out = g->addOp<ExpObj>(input(node, 0), nullptr)->getOutput();
+                else if (type == "Sqrt")
+                    out = g->addOp<SqrtObj>(input(node, 0), nullptr)->getOutput();
+                else if (type == "Softmax")
+                {
+                    // Opset < 13 defaults to axis 1 and flattens the input
+                    // into 2D, which only matches for 2D inputs.
+                    auto axis = attr(node, "axis");
+                    out = g->addOp<SoftmaxObj>(input(node, 0), nullptr,
+                                               axis ? axis->i : -1)
+                              ->getOutput();
+                }
+                else if (type == "LayerNormalization" ||
+                         type == "RMSNormalization")
+                {
+                    // Only the normalized output, not the saved statistics.
+                    auto axis = attr(node, "axis");
+                    auto eps = attr(node, "epsilon");
+                    if (type == "LayerNormalization")
+                        out = g->addOp<LayerNormObj>(
+                                   input(node, 0), input(node, 1),
+                                   input(node, 2), nullptr,
+                                   axis ? axis->i : -1, eps ? eps->f : 1e-5f)
+                                  ->getOutput();
+                    else
+                        out = g->addOp<RMSNormObj>(
+                                   input(node, 0), input(node, 1), nullptr,
+                                   axis ? axis->i : -1, eps ? eps->f : 1e-5f)
+                                  ->getOutput();
+                }
+                else if (type == "Clip")
+                {
+                    // Opset < 11 uses attributes, later versions inputs.
+                    optional<float> min = scalarOf(input(node, 1)),
+                                    max = scalarOf(input(node, 2));
+                    if (auto a = attr(node, "min"))
+                        min = a->f;
+                    if (auto a = attr(node, "max"))
+                        max = a->f;
+                    out = g->addOp<ClipObj>(input(node, 0), nullptr, min, max)
+                              ->getOutput();
+                }
+                else if (type == "Cast")
+                {
+                    auto to = attr(node, "to");
+                    IT_ASSERT(to, "Cast without target type");
+                    auto x = input(node, 0);
+                    out = g->addOp<CastObj>(x, nullptr,
+                                            castTypeOf(x->getDType(),
+                                                       DataType(to->i)))
+                              ->getOutput();
+                }
+                else if (type == "Concat")
+                {
+                    TensorVec inputs;
+                    for (size_t i = 0; i < node.inputs.size(); ++i)
+                        inputs.emplace_back(input(node, i));
+                    auto axis = attr(node, "axis");
+                    IT_ASSERT(axis, "Concat without axis");
+                    out = g->addOp<ConcatObj>(inputs, nullptr, axis->i)
+                              ->getOutput();
+                }
+                else if (type == "Transpose")
+                {
+                    auto x = input(node, 0);
+                    vector<int> perm;
+                    if (auto a = attr(node, "perm"))
+                        perm.assign(a->ints.begin(), a->ints.end());
+                    else
+                        for (int i = x->getRank() - 1; i >= 0; --i)
+                            perm.emplace_back(i);
+                    out = g->addOp<TransposeObj>(x, nullptr, perm)->getOutput();
+                }
+                else if (type == "Reshape")
+                {
+                    auto shape = intsOf(input(node, 1));
+                    IT_ASSERT(shape, "Reshape without shape");
+                    out = g->addOp<ReshapeObj>(input(node, 0), nullptr, *shape)
+                              ->getOutput();
+                }
+                else if (type == "Flatten")
+                {
+                    auto axis = attr(node, "axis");
+                    out = g->addOp<FlattenObj>(input(node, 0), nullptr,
+                                               axis ? axis->i : 1)
+                              ->getOutput();
+                }
+                else if (type == "Squeeze" || type == "Unsqueeze")
+                {
+                    // Opset < 13 uses an attribute, later versions an input.
+                    vector<int> axes = intsOf(input(node, 1)).value_or(vector<int>{});
+                    if (auto a = attr(node, "axes"))
+                        axes.assign(a->ints.begin(), a->ints.end());
+                    if (type == "Squeeze")
+                        out = g->addOp<SqueezeObj>(input(node, 0), nullptr, axes)
+                                  ->getOutput();
+                    else
+                        out = g->addOp<UnsqueezeObj>(input(node, 0), nullptr, axes)
+                                  ->getOutput();
+                }
+                else if (type.rfind("Reduce", 0) == 0)
+                    out = addReduce(node);
+                else if (type == "Gather")
+                {
+                    auto axis = attr(node, "axis");
+                    out = g->addOp<GatherObj>(input(node, 0), input(node, 1),
+                                              nullptr, axis ? axis->i : 0)
+                              ->getOutput();
+                }
+                else if (type == "MatMul")
+                    out = g->addOp<MatmulObj>(input(node, 0), input(node, 1),
+                                              nullptr)
+                              ->getOutput();
+                else if (type == "Gemm")
+                    out = addGemm(node);
+                else if (type == "Conv")
+                    out = addConv(node);
+                else if (type == "MaxPool" || type == "AveragePool" ||
+                         type == "GlobalAveragePool")
+                    out = addPool(node);
+                else
+                    IT_TODO_HALT_MSG("Unsupported ONNX operator " + type);
+                tensors[node.outputs[0]] = out;
+            }
+
+            Tensor addReduce(const OnnxNode &node)
+            {
+                // Opset < 18 (ReduceSum < 13) uses an attribute, later
+                // versions an input.
+                auto x = input(node, 0);
+                vector<int> axes =
+                    intsOf(input(node, 1)).value_or(vector<int>{});
+                if (auto a = attr(node, "axes"))
+                    axes.assign(a->ints.begin(), a->ints.end());
+                auto a = attr(node, "keepdims");
+                bool keepDims = !a || a->i != 0;
+                auto &type = node.opType;
+                if (type == "ReduceSum")
+                    return g->addOp<ReduceSumObj>(x, nullptr, axes, keepDims)
+                        ->getOutput();
+                if (type == "ReduceMean")
+                    return g->addOp<ReduceMeanObj>(x, nullptr, axes, keepDims)
+                        ->getOutput();
+                if (type == "ReduceMax")
+                    return g->addOp<ReduceMaxObj>(x, nullptr, axes, keepDims)
+                        ->getOutput();
+                if (type == "ReduceMin")
+                    return g->addOp<ReduceMinObj>(x, nullptr, axes, keepDims)
+                        ->getOutput();
+                if (type == "ReduceProd")
+                    return g->addOp<ReduceProdObj>(x, nullptr, axes, keepDims)
+                        ->getOutput();
+                IT_TODO_HALT_MSG("Unsupported ONNX operator " + type);
+            }
+
+            // Y = alpha * A' * B' + beta * C
+            Tensor addGemm(const OnnxNode &node)
+            {
+                auto getF = [&](const char *name, float dft)
+                {
+                    auto a = attr(node, name);
+                    return a ? a->f : dft;
+                };
+                auto getI = [&](const char *name)
+                {
+                    auto a = attr(node, name);
+                    return a ? a->i : 0;
+                };
+                float alpha = getF("alpha", 1.f), beta = getF("beta", 1.f);
+                auto y = g->addOp<MatmulObj>(input(node, 0), input(node, 1),
+                                             nullptr, getI("transA") != 0,
+                                             getI("transB") != 0)
+                             ->getOutput();
+                if (alpha != 1.f)
+                    y = g->addOp<MulObj>(y, addScalar(alpha), nullptr)
+                            ->getOutput();
+                auto c = input(node, 2);
+                if (!c || beta == 0.f)
+                    return y;
+                if (beta != 1.f)
+                {
+                    if (c->isWeight() && c->getDType() == DataType::Float32)
+                    {
+                        // Fold beta into a private copy of a constant bias,
+                        // which later nodes may share.
+                        OnnxTensor t;
+                        t.dims = c->getDims();
+                        t.dtype = DataType::Float32.getIndex();
+                        auto ptr = c->getRawDataPtr<float *>();
+                        for (size_t i = 0; i < c->size(); ++i)
+                            t.floats.emplace_back(ptr[i] * beta);
+                        c = addWeight(t);
+                    }
+                    else
+                        c = g->addOp<MulObj>(c, addScalar(beta), nullptr)
+                                ->getOutput();
+                }
+                return g->addOp<AddObj>(y, c, nullptr)->getOutput();
+            }
+
+            vector<int> intsAttr(const OnnxNode &node, const string &name,
+                                 vector<int> dft)
+            {
+                if (auto a = attr(node, name))
+                    return vector<int>(a->ints.begin(), a->ints.end());
+                return dft;
+            }
+
+            // Paddings of a window over the spatial axes of x, resolving
+            // auto_pad.
+            vector<int> padsOf(const OnnxNode &node, const Tensor &x,
+                               const vector<int> &kernel,
+                               const vector<int> &strides,
+                               const vector<int> &dilations)
+            {
+                auto pads = intsAttr(node, "pads", {0, 0, 0, 0});
+                auto autoPad = attr(node, "auto_pad");
+                if (!autoPad || autoPad->s == "NOTSET" ||
+                    autoPad->s == "VALID")
+                    return pads;
+                IT_ASSERT(autoPad->s.rfind("SAME", 0) == 0,
+                          "Unsupported auto_pad " + autoPad->s);
+                for (int d = 0; d < 2; ++d)
+                {
+                    int in = x->getDims()[2 + d];
+                    int out = (in + strides[d] - 1) / strides[d];
+                    int total = std::max((out - 1) * strides[d] +
+                                             (kernel[d] - 1) * dilations[d] +
+                                             1 - in,
+                                         0);
+                    bool upper = autoPad->s == "SAME_UPPER";
+                    pads[d] = upper ? total / 2 : total - total / 2;
+                    pads[d + 2] = total - pads[d];
+                }
+                return pads;
+            }
+
+            Tensor addConv(const OnnxNode &node)
+            {
+                auto x = input(node, 0), w = input(node, 1);
+                IT_ASSERT(x->getRank() == 4 && w->getRank() == 4,
+                          "Only 2D convolutions are supported");
+                auto strides = intsAttr(node, "strides", {1, 1});
+                auto dilations = intsAttr(node, "dilations", {1, 1});
+                auto pads = padsOf(node, x, {w->getDims()[2], w->getDims()[3]},
+                                   strides, dilations);
+                auto group = attr(node, "group");
+                return g->addOp<ConvObj>(x, w, input(node, 2), nullptr, pads,
+                                         strides, dilations,
+                                         group ? group->i : 1)
+                    ->getOutput();
+            }
+
+            Tensor addPool(const OnnxNode &node)
+            {
+                auto x = input(node, 0);
+                IT_ASSERT(x->getRank() == 4, "Only 2D pooling is supported");
+                if (node.opType == "GlobalAveragePool")
+                    return g->addOp<GlobalAvgPoolObj>(x, nullptr)->getOutput();
+                auto kernel = intsAttr(node, "kernel_shape", {});
+                auto strides = intsAttr(node, "strides", {1, 1});
+                auto ceilMode = attr(node, "ceil_mode");
+                IT_ASSERT(kernel.size() == 2, "Pooling without kernel_shape");
+                IT_ASSERT(!ceilMode || ceilMode->i == 0,
+                          "ceil_mode is not supported");
+                IT_ASSERT(intsAttr(node, "dilations", {1, 1}) ==
+                              vector<int>({1, 1}),
+                          "Dilated pooling is not supported");
+                auto pads = padsOf(node, x, kernel, strides, {1, 1});
+                if (node.opType == "MaxPool")
+                    return g->addOp<MaxPoolObj>(x, nullptr, kernel, pads,
+                                                strides)
+                        ->getOutput();
+                auto countIncludePad = attr(node, "count_include_pad");
+                return g->addOp<AvgPoolObj>(x, nullptr, kernel, pads, strides,
+                                            countIncludePad &&
+                                                countIncludePad->i != 0)
+                    ->getOutput();
+            }
+        };
+
+    } // namespace
+
+    Graph importOnnx(Runtime runtime, const string &path,
+                     const std::map<string, Shape> &inputShapes)
+    {
+        return OnnxImporter(runtime, path).import(inputShapes);
+    }
+
+} // namespace infini
@@ -21,6 +21,29 @@ namespace infini
             CASE(Transpose);
             CASE(Concat);
             CASE(MatMul);
+            CASE(Reshape);
+            CASE(Flatten);
+            CASE(Squeeze);
+            CASE(Unsqueeze);
+            CASE(ReduceSum);
+            CASE(ReduceMean);
+            CASE(ReduceMax);
+            CASE(ReduceMin);
+            CASE(ReduceProd);
+            CASE(Exp);
+            CASE(Sqrt);
+            CASE(Softmax);
+            CASE(LayerNorm);
+            CASE(RMSNorm);
+            CASE(Conv);
+            CASE(Reorder);
+            CASE(MaxPool);
+            CASE(AveragePool);
+            CASE(GlobalAveragePool);
+            CASE(Gather);
+            CASE(EmbeddingBag);
+            CASE(SparseMatmul);
+            CASE(FusedElementwise);
 
         default:
             return "Unknown";
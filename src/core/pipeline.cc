@@ -0,0 +1,307 @@
+#include "core/pipeline.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/sparse_matmul.h"
+#include <cstring>
+#include <sched.h>
+#include <unordered_map>
+
+namespace infini
+{
+    Pipeline::Pipeline(Graph graph, const vector<Runtime> &runtimes,
+                       int depth)
+        : graph(std::move(graph)),
+          freeSlots(depth > 0 ? depth : runtimes.size() + 1)
+    {
+        IT_ASSERT(!runtimes.empty(), "A pipeline needs at least one stage");
+        IT_ASSERT(this->graph->topo_sort());
+        IT_ASSERT(!this->graph->getOperators().empty(),
+                  "Cannot pipeline a graph without operators");
+        const int nSlots = depth > 0 ? depth : runtimes.size() + 1;
+        for (const auto &input : this->graph->getInputs())
+            if (!input->isWeight())
+                inputs.emplace_back(input);
+        outputs = this->graph->getOutputs();
+        auto parts = partition(this->graph->getOperators(), runtimes.size());
+
+        // Tensors read by a later stage than the one producing them, graph
+        // inputs being produced before the first.
+        std::unordered_map<TensorObj *, int> producer, transferIndex;
+        for (size_t s = 0; s < parts.size(); ++s)
+            for (const auto &op : parts[s])
+                for (const auto &output : op->getOutputs())
+                    producer[output.get()] = s;
+        transfers = inputs;
+        for (size_t i = 0; i < inputs.size(); ++i)
+            transferIndex[inputs[i].get()] = i;
+        for (size_t s = 0; s < parts.size(); ++s)
+            for (const auto &op : parts[s])
+                for (const auto &input : op->getInputs())
+                {
+                    auto it = producer.find(input.get());
+                    if (it != producer.end() && it->second < (int)s &&
+                        !transferIndex.count(input.get()))
+                    {
+                        transferIndex[input.get()] = transfers.size();
+                        transfers.emplace_back(input);
+                    }
+                }
+
+        buffers.resize(nSlots);
+        for (auto &slot : buffers)
+            for (const auto &tensor : transfers)
+            {
+                auto it = producer.find(tensor.get());
+                auto runtime = runtimes[it == producer.end() ? 0 : it->second];
+                slot.emplace_back(
+                    runtime->alloc(std::max<size_t>(tensor->getBytes(), 1)),
+                    [runtime](void *ptr) { runtime->dealloc(ptr); });
+            }
+
+        std::unordered_map<UidBaseType, Tensor> byFuid;
+        for (const auto &tensor : this->graph->getTensors())
+            byFuid[tensor->getFuid()] = tensor;
+        for (size_t s = 0; s < parts.size(); ++s)
+        {
+            auto stage = std::make_unique<Stage>(nSlots + 1);
+            stage->graph = this->graph->extract(parts[s], runtimes[s]);
+            for (const auto &clone : stage->graph->getTensors())
+            {
+                auto tensor = byFuid.at(clone->getFuid());
+                auto it = transferIndex.find(tensor.get());
+                if (it != transferIndex.end())
+                {
+                    auto p = producer.find(tensor.get());
+                    if (p != producer.end() && p->second == (int)s)
+                        stage->writes.emplace_back(clone, it->second);
+                    else if (!clone->getSource())
+                        stage->reads.emplace_back(clone, it->second);
+                }
+                auto out = std::find(outputs.begin(), outputs.end(), tensor);
+                if (out != outputs.end() && clone->getSource())
+                    stage->results.emplace_back(clone, out - outputs.begin());
+            }
+            // Bound before planning so that the planner leaves them out.
+            for (auto *list : {&stage->reads, &stage->writes})
+                for (const auto &[clone, i] : *list)
+                    clone->setExternalData(buffers[0][i].get(),
+                                           clone->getBytes());
+            stage->graph->dataMalloc();
+            stages.emplace_back(std::move(stage));
+        }
+
+        batches.resize(nSlots);
+        for (int slot = 0; slot < nSlots; ++slot)
+        {
+            batches[slot].slot = slot;
+            freeSlots.push(slot);
+        }
+        for (size_t s = 0; s < stages.size(); ++s)
+            stages[s]->thread = std::thread(&Pipeline::work, this, s);
+    }
+
+    Pipeline::~Pipeline()
+    {
+        // Passed on by every stage after the batches queued before it.
+        stages[0]->queue.push(nullptr);
+        for (auto &stage : stages)
+            stage->thread.join();
+    }
+
+    void Pipeline::work(size_t s)
+    {
+        auto &stage = *stages[s];
+        for (;;)
+        {
+            Batch *batch = stage.queue.pop();
+            // Later stages skip a batch that failed.
+            if (batch && !batch->error)
+            {
+                try
+                {
+                    const auto &slot = buffers[batch->slot];
+                    for (auto *list : {&stage.reads, &stage.writes})
+                        for (const auto &[clone, i] : *list)
+                            clone->setExternalData(slot[i].get(),
+                                                   clone->getBytes());
+                    for (const auto &[clone, i] : stage.results)
+                        stage.graph->bindOutput(clone, batch->results[i],
+                                                clone->getBytes());
+                    stage.graph->getRuntime()->run(stage.graph);
+                }
+                catch (...)
+                {
+                    batch->error = std::current_exception();
+                }
+            }
+            if (s + 1 < stages.size())
+                stages[s + 1]->queue.push(batch);
+            if (!batch)
+                return;
+            if (s + 1 < stages.size())
+                continue;
+
+            auto done = std::move(batch->done);
+            auto error = batch->error;
+            batch->error = nullptr;
+            freeSlots.push(batch->slot);
+            if (done)
+                done(error);
+            {
+                std::lock_guard<std::mutex> guard(doneLock);
+                --running;
+            }
+            doneChanged.notify_all();
+        }
+    }
+
+    void Pipeline::submit(const vector<const void *> &data,
+                          const vector<void *> &results, Callback done)
+    {
+        IT_ASSERT(data.size() == inputs.size(),
+                  "Pipeline takes " + std::to_string(inputs.size()) +
+                      " inputs, got " + std::to_string(data.size()));
+        IT_ASSERT(results.size() == outputs.size(),
+                  "Pipeline has " + std::to_string(outputs.size()) +
+                      " outputs, got " + std::to_string(results.size()));
+        // The free slots and the first queue have a single producer.
+        std::lock_guard<std::mutex> guard(submitLock);
+        int slot = freeSlots.pop();
+        {
+            std::lock_guard<std::mutex> guard(doneLock);
+            ++running;
+        }
+        for (size_t i = 0; i < inputs.size(); ++i)
+            std::memcpy(buffers[slot][i].get(), data[i], inputs[i]->getBytes());
+        auto &batch = batches[slot];
+        batch.results = results;
+        batch.done = std::move(done);
+        stages[0]->queue.push(&batch);
+    }
+
+    std::future<void> Pipeline::submit(const vector<const void *> &data,
+                                       const vector<void *> &results)
+    {
+        auto promise = std::make_shared<std::promise<void>>();
+        auto future = promise->get_future();
+        submit(data, results,
+               [promise](std::exception_ptr error)
+               {
+                   if (error)
+                       promise->set_exception(error);
+                   else
+                       promise->set_value();
+               });
+        return future;
+    }
+
+    void Pipeline::wait()
+    {
+        std::unique_lock<std::mutex> guard(doneLock);
+        doneChanged.wait(guard, [&] { return running == 0; });
+    }
+
+    vector<Graph> Pipeline::getStages() const
+    {
+        vector<Graph> ret;
+        for (const auto &stage : stages)
+            ret.emplace_back(stage->graph);
+        return ret;
+    }
+
+    double Pipeline::estimateCost(const Operator &op)
+    {
+        const double out =
+            op->getOutputs().empty() ? 0 : op->getOutputs()[0]->size();
+        auto type = op->getOpType();
+        if (type == OpType::MatMul)
+            return out * as<MatmulObj>(op)->getK();
+        if (type == OpType::SparseMatmul)
+        {
+            auto matmul = as<SparseMatmulObj>(op);
+            return out / std::max(matmul->getN(), 1) *
+                   op->getInputs(1)->size();
+        }
+        if (type == OpType::Conv)
+        {
+            const auto &weight = op->getInputs(1);
+            return out * (weight->size() / weight->getDims()[0]);
+        }
+        double elements = 0;
+        for (const auto &tensor : op->getInputs())
+            elements += tensor->size();
+        for (const auto &tensor : op->getOutputs())
+            elements += tensor->size();
+        return elements;
+    }
+
+    vector<OpVec> Pipeline::partition(const OpVec &ops, int stages)
+    {
+        if (ops.empty())
+            return {};
+        vector<double> cost;
+        double total = 0, largest = 0;
+        for (const auto &op : ops)
+        {
+            cost.emplace_back(estimateCost(op));
+            total += cost.back();
+            largest = std::max(largest, cost.back());
+        }
+        // The fewest parts, filled greedily, none costing more than `limit`
+        // unless a single op does.
+        auto split = [&](double limit)
+        {
+            vector<OpVec> parts(1);
+            double sum = 0;
+            for (size_t i = 0; i < ops.size(); ++i)
+            {
+                if (!parts.back().empty() && sum + cost[i] > limit)
+                {
+                    parts.emplace_back();
+                    sum = 0;
+                }
+                parts.back().emplace_back(ops[i]);
+                sum += cost[i];
+            }
+            return parts;
+        };
+        stages = std::max(1, std::min<int>(stages, ops.size()));
+        // Bisect the cost of the most expensive part.
+        double lo = std::max(largest, total / stages), hi = total;
+        for (int i = 0; i < 64 && lo < hi; ++i)
+        {
+            double mid = (lo + hi) / 2;
+            if ((int)split(mid).size() <= stages)
+                hi = mid;
+            else
+                lo = mid;
+        }
+        return split(hi);
+    }
+
+    vector<Runtime> Pipeline::threadGroups(int stages)
+    {
+        vector<int> cpus;
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                if (CPU_ISSET(cpu, &set))
+                    cpus.emplace_back(cpu);
+        if (cpus.empty())
+            cpus.emplace_back(0);
+        vector<Runtime> ret;
+        for (int s = 0; s < stages; ++s)
+        {
+            vector<int> group{cpus[s % cpus.size()]};
+            if ((int)cpus.size() >= stages)
+            {
+                auto [begin, end] = splitRange(cpus.size(), s, stages);
+                group.assign(cpus.begin() + begin, cpus.begin() + end);
+            }
+            ret.emplace_back(make_ref<NativeCpuRuntimeObj>(
+                CpuConfig{(int)group.size(), group}));
+        }
+        return ret;
+    }
+
+} // namespace infini
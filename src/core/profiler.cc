@@ -0,0 +1,174 @@
+#include "core/profiler.h"
+#include "core/operator.h"
+#include <algorithm>
+#include <iomanip>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace infini
+{
+    namespace
+    {
+        PerfCounters::Values operator-(PerfCounters::Values a,
+                                       const PerfCounters::Values &b)
+        {
+            for (size_t i = 0; i < a.size(); ++i)
+                a[i] -= b[i];
+            return a;
+        }
+
+        PerfCounters::Values &operator+=(PerfCounters::Values &a,
+                                         const PerfCounters::Values &b)
+        {
+            for (size_t i = 0; i < a.size(); ++i)
+                a[i] += b[i];
+            return a;
+        }
+    } // namespace
+
+    Profiler::Profiler(const ThreadPool &pool)
+        : workers(pool.getThreadIds()), hasWorkers(pool.size() > 1),
+          available(hasWorkers ? workers.getAvailable() : ~0u),
+          error(workers.getError())
+    {
+    }
+
+    Profiler::Sample Profiler::start()
+    {
+        thread_local const int tid = syscall(SYS_gettid);
+        PerfCounters *caller;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            auto &counters = callers[tid];
+            if (!counters)
+            {
+                counters = std::make_unique<PerfCounters>(vector<int>{0});
+                available &= counters->getAvailable();
+                if (error.empty())
+                    error = counters->getError();
+            }
+            caller = counters.get();
+        }
+        Sample sample{{}, caller->read(), caller};
+        if (hasWorkers)
+            sample.counters += workers.read();
+        sample.time = std::chrono::steady_clock::now();
+        return sample;
+    }
+
+    void Profiler::stop(const Operator &op, const Sample &sample)
+    {
+        auto time = std::chrono::steady_clock::now();
+        auto counters = sample.caller->read();
+        if (hasWorkers)
+            counters += workers.read();
+        std::lock_guard<std::mutex> guard(lock);
+        auto [it, added] = index.emplace(op->getGuid(), entries.size());
+        if (added)
+            entries.push_back({op->getGuid(), op->getOpType()});
+        auto &entry = entries[it->second];
+        ++entry.calls;
+        entry.seconds +=
+            std::chrono::duration<double>(time - sample.time).count();
+        entry.counters += counters - sample.counters;
+    }
+
+    vector<Profiler::Entry> Profiler::getEntries() const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto ret = entries;
+        for (auto &entry : ret)
+            for (int event = 0; event < PerfCounters::kEvents; ++event)
+                if (!(available >> event & 1))
+                    entry.counters[event] = 0;
+        return ret;
+    }
+
+    bool Profiler::isAvailable(int event) const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        // Nothing is known to be counted before the first kernel.
+        return !callers.empty() && (available >> event & 1);
+    }
+
+    string Profiler::getError() const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return error;
+    }
+
+    void Profiler::reset()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        entries.clear();
+        index.clear();
+    }
+
+    string Profiler::summary() const
+    {
+        auto all = getEntries();
+        vector<Entry> byType;
+        for (const auto &entry : all)
+        {
+            auto it = std::find_if(byType.begin(), byType.end(),
+                                   [&](const Entry &e)
+                                   { return e.type == entry.type; });
+            if (it == byType.end())
+                it = byType.insert(byType.end(), Entry{0, entry.type});
+            it->calls += entry.calls;
+            it->seconds += entry.seconds;
+            it->counters += entry.counters;
+        }
+        std::sort(byType.begin(), byType.end(),
+                  [](const Entry &a, const Entry &b)
+                  { return a.seconds > b.seconds; });
+
+        using E = PerfCounters;
+        vector<int> events;
+        for (int event = 0; event < E::kEvents; ++event)
+            if (isAvailable(event))
+                events.emplace_back(event);
+        bool ipc = isAvailable(E::Cycles) && isAvailable(E::Instructions);
+        bool mpki = isAvailable(E::Instructions);
+        std::ostringstream os;
+        os << std::left << std::setw(20) << "op" << std::right
+           << std::setw(8) << "calls" << std::setw(12) << "ms";
+        for (int event : events)
+            os << std::setw(16) << E::eventName(event);
+        if (ipc)
+            os << std::setw(8) << "ipc";
+        if (mpki)
+            os << std::setw(12) << "llc_mpki" << std::setw(12) << "dtlb_mpki";
+        os << "\n"
+           << std::fixed;
+        for (const auto &entry : byType)
+        {
+            const auto &c = entry.counters;
+            os << std::left << std::setw(20) << entry.type.toString()
+               << std::right << std::setw(8) << entry.calls
+               << std::setw(12) << std::setprecision(3)
+               << entry.seconds * 1e3;
+            for (int event : events)
+                os << std::setw(16) << c[event];
+            double instructions = std::max<double>(c[E::Instructions], 1);
+            if (ipc)
+                os << std::setw(8) << std::setprecision(2)
+                   << c[E::Instructions] / std::max<double>(c[E::Cycles], 1);
+            for (int event : {E::LLCMisses, E::DTLBMisses})
+            {
+                if (!mpki)
+                    break;
+                if (isAvailable(event))
+                    os << std::setw(12) << std::setprecision(2)
+                       << 1e3 * c[event] / instructions;
+                else
+                    os << std::setw(12) << "-";
+            }
+            os << "\n";
+        }
+        if (!getError().empty())
+            os << getError() << "\n";
+        return os.str();
+    }
+
+} // namespace infini
@@ -0,0 +1,133 @@
+#include "core/result_cache.h"
+#include "utils/hash.h"
+#include <cstring>
+
+namespace infini
+{
+    size_t ResultCache::Entry::bytes() const
+    {
+        size_t total = 0;
+        for (const auto &input : inputs)
+            total += input.size();
+        for (const auto &output : outputs)
+            total += output.size();
+        return total;
+    }
+
+    ResultCache::ResultCache(size_t capacity) : capacity(capacity) {}
+
+    uint64_t ResultCache::hash(const vector<const void *> &data,
+                               const vector<size_t> &bytes)
+    {
+        IT_ASSERT(data.size() == bytes.size());
+        // Chained through the seed, so that moving bytes from one buffer to
+        // the next changes the hash.
+        uint64_t h = data.size();
+        for (size_t i = 0; i < data.size(); ++i)
+            h = hashBytes(data[i], bytes[i], h);
+        return h;
+    }
+
+    Ref<const ResultCache::Entry>
+    ResultCache::find(uint64_t hash, const vector<const void *> &data,
+                      const vector<size_t> &bytes)
+    {
+        IT_ASSERT(data.size() == bytes.size());
+        std::lock_guard<std::mutex> guard(mutex);
+        auto range = index.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            const auto &entry = *it->second;
+            bool same = entry->inputs.size() == data.size();
+            for (size_t i = 0; same && i < data.size(); ++i)
+                same = entry->inputs[i].size() == bytes[i] &&
+                       std::memcmp(entry->inputs[i].data(), data[i],
+                                   bytes[i]) == 0;
+            if (same)
+            {
+                lru.splice(lru.begin(), lru, it->second);
+                ++stats.hits;
+                return entry;
+            }
+        }
+        ++stats.misses;
+        return nullptr;
+    }
+
+    void ResultCache::insert(uint64_t hash, const vector<const void *> &data,
+                             const vector<size_t> &bytes,
+                             const vector<const void *> &outputs,
+                             const vector<size_t> &outputBytes)
+    {
+        IT_ASSERT(data.size() == bytes.size() &&
+                  outputs.size() == outputBytes.size());
+        size_t total = 0;
+        for (auto b : bytes)
+            total += b;
+        for (auto b : outputBytes)
+            total += b;
+        if (total > capacity)
+            return;
+
+        auto copy = [](const vector<const void *> &buffers,
+                       const vector<size_t> &sizes)
+        {
+            vector<vector<char>> result(buffers.size());
+            for (size_t i = 0; i < buffers.size(); ++i)
+            {
+                auto p = static_cast<const char *>(buffers[i]);
+                result[i].assign(p, p + sizes[i]);
+            }
+            return result;
+        };
+        // Copied before locking, so that lookups are not held up.
+        auto entry = make_ref<Entry>(
+            Entry{hash, copy(data, bytes), copy(outputs, outputBytes)});
+
+        std::lock_guard<std::mutex> guard(mutex);
+        // Two runs of the same inputs may finish before either is cached.
+        auto range = index.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+            if ((*it->second)->inputs == entry->inputs)
+                return;
+        lru.emplace_front(entry);
+        index.emplace(hash, lru.begin());
+        ++stats.entries;
+        stats.bytes += total;
+        evict();
+    }
+
+    void ResultCache::evict()
+    {
+        while (stats.bytes > capacity)
+        {
+            auto last = std::prev(lru.end());
+            auto range = index.equal_range((*last)->hash);
+            for (auto it = range.first; it != range.second; ++it)
+                if (it->second == last)
+                {
+                    index.erase(it);
+                    break;
+                }
+            stats.bytes -= (*last)->bytes();
+            --stats.entries;
+            ++stats.evictions;
+            lru.erase(last);
+        }
+    }
+
+    ResultCache::Stats ResultCache::getStats() const
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        return stats;
+    }
+
+    void ResultCache::clear()
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        lru.clear();
+        index.clear();
+        stats = Stats();
+    }
+
+} // namespace infini
@@ -1,36 +1,231 @@
 #include "core/runtime.h"
 #include "core/blob.h"
-#include "core/kernel.h"
 #include "core/graph.h"
 #include "core/kernel.h"
+#include "core/profiler.h"
 #include <chrono>
 #include <cstring>
+#include <fstream>
+#include <linux/mempolicy.h>
 #include <memory>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 namespace infini
 {
+    namespace
+    {
+        // Smaller blocks come from the heap, larger ones are mapped so that
+        // their pages can be placed.
+        constexpr size_t kMapThreshold = 1 << 16;
+
+        const char *kNodeDir = "/sys/devices/system/node/node";
+
+        // Parses a sysfs CPU list such as "0-3,8,10-11".
+        vector<int> parseCpuList(const string &list)
+        {
+            vector<int> cpus;
+            std::istringstream in(list);
+            string range;
+            while (std::getline(in, range, ','))
+            {
+                if (range.empty() || range == "\n")
+                    continue;
+                int first, last;
+                char dash;
+                std::istringstream r(range);
+                r >> first;
+                last = (r >> dash >> last) ? last : first;
+                for (int cpu = first; cpu <= last; ++cpu)
+                    cpus.emplace_back(cpu);
+            }
+            return cpus;
+        }
+
+        // Empty if the node does not exist or has no CPUs.
+        vector<int> cpusOfNode(int node)
+        {
+            std::ifstream in(kNodeDir + std::to_string(node) + "/cpulist");
+            string list;
+            std::getline(in, list);
+            return parseCpuList(list);
+        }
+
+        // Pins the calling thread to `cpu` (none if negative) until
+        // destroyed, which gives the thread back its previous CPUs.
+        class PinScope
+        {
+            cpu_set_t saved;
+            bool pinned = false;
+
+        public:
+            explicit PinScope(int cpu)
+            {
+                if (cpu < 0)
+                    return;
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu, &set);
+                IT_ASSERT(sched_getaffinity(0, sizeof(saved), &saved) == 0,
+                          "Cannot read the CPUs of the calling thread");
+                if (CPU_EQUAL(&set, &saved))
+                    return;
+                IT_ASSERT(sched_setaffinity(0, sizeof(set), &set) == 0,
+                          "Cannot pin thread to CPU " + std::to_string(cpu));
+                pinned = true;
+            }
+            ~PinScope()
+            {
+                if (pinned)
+                    sched_setaffinity(0, sizeof(saved), &saved);
+            }
+            PinScope(const PinScope &) = delete;
+            PinScope &operator=(const PinScope &) = delete;
+        };
+    } // namespace
+
+    NativeCpuRuntimeObj::NativeCpuRuntimeObj(CpuConfig config)
+        : RuntimeObj(Device::CPU), config(std::move(config))
+    {
+        auto &c = this->config;
+        if (c.numaNode >= 0 && c.cpus.empty())
+        {
+            c.cpus = cpusOfNode(c.numaNode);
+            IT_ASSERT(!c.cpus.empty(),
+                      "No CPUs on NUMA node " + std::to_string(c.numaNode));
+        }
+        if (c.threads == 0)
+            c.threads = c.cpus.size();
+        if (c.threads == 0 && c.cpus.empty() &&
+            c.minWork == ThreadPool::kDefaultMinWork)
+            pool = &ThreadPool::global();
+        else
+        {
+            ownPool = std::make_unique<ThreadPool>(c.threads, c.cpus,
+                                                   c.minWork);
+            pool = ownPool.get();
+        }
+        c.threads = pool->size();
+    }
+
+    NativeCpuRuntimeObj::~NativeCpuRuntimeObj() = default;
+
+    void NativeCpuRuntimeObj::setProfiling(bool enabled)
+    {
+        if (!enabled)
+            profiler.reset();
+        else if (!profiler)
+            profiler = std::make_unique<Profiler>(*pool);
+    }
+
+    vector<Ref<NativeCpuRuntimeObj>> NativeCpuRuntimeObj::perNumaNode()
+    {
+        vector<Ref<NativeCpuRuntimeObj>> runtimes;
+        // Node numbers may have holes, e.g. after offlining.
+        std::ifstream online("/sys/devices/system/node/online");
+        string list;
+        std::getline(online, list);
+        for (int node : parseCpuList(list))
+            if (!cpusOfNode(node).empty())
+                runtimes.emplace_back(make_ref<NativeCpuRuntimeObj>(
+                    CpuConfig{0, {}, node}));
+        if (runtimes.empty())
+            runtimes.emplace_back(make_ref<NativeCpuRuntimeObj>());
+        return runtimes;
+    }
+
     void NativeCpuRuntimeObj::run(const Graph &graph) const
     {
         const auto &kernelRegistry = KernelRegistry::getInstance();
+        ThreadPool::Scope scope(*pool);
+        PinScope pin(config.cpus.empty() ? -1 : config.cpus[0]);
 
         for (auto &op : graph->getOperators())
         {
-            auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
-            Kernel *kernel = kernelRegistry.getKernel(kernelAttrs);
+            if (op->isView())
+            {
+                // Follows input rebinding, e.g. GraphObj::bindInput.
+                auto input = op->getInputs(0), output = op->getOutput();
+                auto [stride, offset] = *op->inferView();
+                output->setDataBlob(input->getDataBlob());
+                output->setLayout(std::move(stride), offset);
+                continue;
+            }
+            Kernel *kernel = op->getKernel();
+            // Ops added after dataMalloc are matched at every run.
+            if (!kernel)
+                kernel = kernelRegistry.getKernel(
+                    KernelAttrs{device, op->getOpType().underlying()}, *op);
+            if (!profiler)
+            {
+                kernel->compute(op, this);
+                continue;
+            }
+            auto sample = profiler->start();
             kernel->compute(op, this);
+            profiler->stop(op, sample);
         }
     }
 
-    string NativeCpuRuntimeObj::toString() const { return "CPU Runtime"; }
+    string NativeCpuRuntimeObj::toString() const
+    {
+        if (config.numaNode >= 0)
+            return "CPU Runtime (node " + std::to_string(config.numaNode) + ")";
+        return "CPU Runtime";
+    }
 
     void NativeCpuRuntimeObj::dealloc(void *ptr)
     {
+        {
+            std::lock_guard<std::mutex> guard(mappedLock);
+            auto it = mapped.find(ptr);
+            if (it != mapped.end())
+            {
+                munmap(ptr, it->second);
+                mapped.erase(it);
+                return;
+            }
+        }
         return free(ptr);
     }
 
     void *NativeCpuRuntimeObj::alloc(size_t size)
     {
-        return calloc((size + sizeof(uint64_t) - 1) / sizeof(uint64_t),
-                      sizeof(uint64_t));
+        if (size < kMapThreshold)
+            return calloc((size + sizeof(uint64_t) - 1) / sizeof(uint64_t),
+                          sizeof(uint64_t));
+
+        const size_t page = sysconf(_SC_PAGESIZE);
+        size = (size + page - 1) / page * page;
+        void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        IT_ASSERT(ptr != MAP_FAILED, "Cannot map " + std::to_string(size) +
+                                         " bytes");
+        if (config.numaNode >= 0)
+        {
+            // Best effort: without NUMA support in the kernel the pages are
+            // still placed by the first touch below.
+            unsigned long mask[16] = {};
+            const unsigned long bits = 8 * sizeof(mask[0]);
+            if ((size_t)config.numaNode < bits * 16)
+            {
+                mask[config.numaNode / bits] |= 1ul << config.numaNode % bits;
+                syscall(SYS_mbind, ptr, size, MPOL_BIND, mask, bits * 16, 0);
+            }
+        }
+        // Fault the pages in with the static schedule the kernels use, so
+        // that each lands on the node of the thread that will touch it.
+        {
+            ThreadPool::Scope scope(*pool);
+            char *bytes = static_cast<char *>(ptr);
+            parallelFor(size / page, page / sizeof(float),
+                        [&](size_t i) { bytes[i * page] = 0; });
+        }
+        std::lock_guard<std::mutex> guard(mappedLock);
+        mapped.emplace(ptr, size);
+        return ptr;
     }
 
 } // namespace infini
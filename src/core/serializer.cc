@@ -0,0 +1,616 @@
+#include "core/serializer.h"
+#include "operators/concat.h"
+#include "operators/conv.h"
+#include "operators/element_wise.h"
+#include "operators/fused_elementwise.h"
+#include "operators/gather.h"
+#include "operators/layer_norm.h"
+#include "operators/matmul.h"
+#include "operators/pooling.h"
+#include "operators/reduce.h"
+#include "operators/reorder.h"
+#include "operators/reshape.h"
+#include "operators/softmax.h"
+#include "operators/sparse_matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include "utils/mapped_file.h"
+#include <cstring>
+#include <fstream>
+
+namespace infini
+{
+    namespace
+    {
+        constexpr char kMagic[8] = {'I', 'T', 'M', 'O', 'D', 'E', 'L', '\0'};
+        constexpr uint32_t kVersion = 1;
+        constexpr uint32_t kFlagWeight = 1;
+
+        struct Header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t numTensors;
+            uint32_t numOps;
+            uint32_t reserved;
+            uint64_t weightOffset;
+            uint64_t weightBytes;
+        };
+
+        size_t alignUp(size_t size)
+        {
+            return (size + kModelAlignment - 1) / kModelAlignment *
+                   kModelAlignment;
+        }
+
+        class Writer
+        {
+            std::vector<char> buf;
+
+        public:
+            template <typename T>
+            void put(const T &val)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                auto p = reinterpret_cast<const char *>(&val);
+                buf.insert(buf.end(), p, p + sizeof(T));
+            }
+            template <typename T>
+            void putVec(const vector<T> &vec)
+            {
+                put<uint32_t>(vec.size());
+                for (auto &v : vec)
+                    put<T>(v);
+            }
+            const std::vector<char> &data() const { return buf; }
+        };
+
+        class Reader
+        {
+            const char *cur, *end;
+
+        public:
+            Reader(const char *begin, const char *end) : cur(begin), end(end) {}
+            template <typename T>
+            T get()
+            {
+                IT_ASSERT(cur + sizeof(T) <= end, "Truncated model file");
+                T val;
+                std::memcpy(&val, cur, sizeof(T));
+                cur += sizeof(T);
+                return val;
+            }
+            size_t left() const { return end - cur; }
+            template <typename T>
+            vector<T> getVec()
+            {
+                auto n = get<uint32_t>();
+                // Checked before allocating for a hostile count.
+                IT_ASSERT(n <= left() / sizeof(T), "Truncated model file");
+                vector<T> vec(n);
+                for (auto &v : vec)
+                    v = get<T>();
+                return vec;
+            }
+        };
+
+        void writeAttributes(Writer &w, const Operator &op)
+        {
+            switch (op->getOpType().underlying())
+            {
+            case OpType::Add:
+            case OpType::Sub:
+            case OpType::Mul:
+            case OpType::Div:
+            case OpType::Relu:
+            case OpType::Exp:
+            case OpType::Sqrt:
+                break;
+            case OpType::Clip:
+            {
+                auto clip = as<ClipObj>(op);
+                w.put<uint8_t>(clip->getMin().has_value());
+                w.put<float>(clip->getMin().value_or(0));
+                w.put<uint8_t>(clip->getMax().has_value());
+                w.put<float>(clip->getMax().value_or(0));
+                break;
+            }
+            case OpType::Cast:
+                w.put<int32_t>(enum_to_underlying(as<CastObj>(op)->getType()));
+                break;
+            case OpType::Concat:
+                w.put<int32_t>(as<ConcatObj>(op)->getDim());
+                break;
+            case OpType::Transpose:
+                w.putVec<int32_t>(as<TransposeObj>(op)->getPermute());
+                break;
+            case OpType::MatMul:
+            {
+                auto matmul = as<MatmulObj>(op);
+                w.put<uint8_t>(matmul->getTransA());
+                w.put<uint8_t>(matmul->getTransB());
+                break;
+            }
+            case OpType::Reshape:
+                w.putVec<int32_t>(as<ReshapeObj>(op)->getShape());
+                break;
+            case OpType::Flatten:
+                w.put<int32_t>(as<FlattenObj>(op)->getAxis());
+                break;
+            case OpType::Squeeze:
+                w.putVec<int32_t>(as<SqueezeObj>(op)->getAxes());
+                break;
+            case OpType::Unsqueeze:
+                w.putVec<int32_t>(as<UnsqueezeObj>(op)->getAxes());
+                break;
+            case OpType::ReduceSum:
+            case OpType::ReduceMean:
+            case OpType::ReduceMax:
+            case OpType::ReduceMin:
+            case OpType::ReduceProd:
+            {
+                auto reduce = as<ReduceObj>(op);
+                w.putVec<int32_t>(reduce->getAxes());
+                w.put<uint8_t>(reduce->getKeepDims());
+                break;
+            }
+            case OpType::Softmax:
+                w.put<int32_t>(as<SoftmaxObj>(op)->getAxis());
+                break;
+            case OpType::LayerNorm:
+            case OpType::RMSNorm:
+            {
+                auto norm = as<NormObj>(op);
+                w.put<int32_t>(norm->getAxis());
+                w.put<float>(norm->getEps());
+                break;
+            }
+            case OpType::Conv:
+            {
+                auto conv = as<ConvObj>(op);
+                w.putVec<int32_t>(conv->getPads());
+                w.putVec<int32_t>(conv->getStrides());
+                w.putVec<int32_t>(conv->getDilations());
+                w.put<int32_t>(conv->getGroup());
+                w.put<uint8_t>(conv->isBlocked());
+                break;
+            }
+            case OpType::Reorder:
+                w.put<uint8_t>(as<ReorderObj>(op)->isToBlocked());
+                break;
+            case OpType::MaxPool:
+            case OpType::AveragePool:
+            case OpType::GlobalAveragePool:
+            {
+                auto pool = as<PoolingObj>(op);
+                w.putVec<int32_t>(pool->isGlobal() ? vector<int>{}
+                                                   : pool->getKernel());
+                w.putVec<int32_t>(pool->getPads());
+                w.putVec<int32_t>(pool->getStrides());
+                w.put<uint8_t>(pool->getCountIncludePad());
+                w.put<uint8_t>(pool->isBlocked());
+                break;
+            }
+            case OpType::Gather:
+                w.put<int32_t>(as<GatherObj>(op)->getAxis());
+                break;
+            case OpType::EmbeddingBag:
+                w.put<uint8_t>(as<EmbeddingBagObj>(op)->getKeepDims());
+                break;
+            case OpType::SparseMatmul:
+            {
+                auto matmul = as<SparseMatmulObj>(op);
+                w.put<int32_t>(matmul->getBlockRows());
+                w.put<int32_t>(matmul->getBlockCols());
+                break;
+            }
+            case OpType::FusedElementwise:
+            {
+                auto fused = as<FusedElementwiseObj>(op);
+                const auto &nodes = fused->getExpr().nodes;
+                w.put<uint32_t>(nodes.size());
+                for (const auto &node : nodes)
+                {
+                    w.put<uint8_t>(uint8_t(node.code));
+                    w.put<int32_t>(node.a);
+                    w.put<int32_t>(node.b);
+                    w.put<float>(node.value);
+                }
+                break;
+            }
+            default:
+                IT_TODO_HALT_MSG(string("Cannot serialize operator ") +
+                                 op->getOpType().toString());
+            }
+        }
+
+        void addReduce(GraphObj *g, OpType type, Tensor input, Tensor output,
+                       const vector<int> &axes, bool keepDims)
+        {
+            switch (type.underlying())
+            {
+            case OpType::ReduceSum:
+                g->addOpWithOutputs<ReduceSumObj>(input, output, axes,
+                                                  keepDims);
+                break;
+            case OpType::ReduceMean:
+                g->addOpWithOutputs<ReduceMeanObj>(input, output, axes,
+                                                   keepDims);
+                break;
+            case OpType::ReduceMax:
+                g->addOpWithOutputs<ReduceMaxObj>(input, output, axes,
+                                                  keepDims);
+                break;
+            case OpType::ReduceMin:
+                g->addOpWithOutputs<ReduceMinObj>(input, output, axes,
+                                                  keepDims);
+                break;
+            default:
+                g->addOpWithOutputs<ReduceProdObj>(input, output, axes,
+                                                   keepDims);
+            }
+        }
+
+        // Bounds on the number of inputs of ops of `type`, which all have
+        // one output.
+        pair<size_t, size_t> inputArity(OpType type)
+        {
+            constexpr size_t any = std::numeric_limits<size_t>::max();
+            switch (type.underlying())
+            {
+            case OpType::Add:
+            case OpType::Sub:
+            case OpType::Mul:
+            case OpType::Div:
+            case OpType::MatMul:
+            case OpType::RMSNorm:
+            case OpType::Gather:
+            case OpType::EmbeddingBag:
+                return {2, 2};
+            case OpType::LayerNorm:
+            case OpType::Conv:
+                return {2, 3};
+            case OpType::SparseMatmul:
+                return {4, 4};
+            case OpType::Concat:
+            case OpType::FusedElementwise:
+                return {1, any};
+            default:
+                // Unknown types are rejected by readOperator.
+                return {1, 1};
+            }
+        }
+
+        void readOperator(GraphObj *g, OpType type, const TensorVec &inputs,
+                          const TensorVec &outputs, Reader &r)
+        {
+            auto [minInputs, maxInputs] = inputArity(type);
+            IT_ASSERT(minInputs <= inputs.size() &&
+                          inputs.size() <= maxInputs && outputs.size() == 1,
+                      "Wrong number of tensors for operator " +
+                          type.toString());
+            switch (type.underlying())
+            {
+            case OpType::Add:
+                g->addOpWithOutputs<AddObj>(inputs[0], inputs[1], outputs[0]);
+                break;
+            case OpType::Sub:
+                g->addOpWithOutputs<SubObj>(inputs[0], inputs[1], outputs[0]);
+                break;
+            case OpType::Mul:
+                g->addOpWithOutputs<MulObj>(inputs[0], inputs[1], outputs[0]);
+                break;
+            case OpType::Div:
+                g->addOpWithOutputs<DivObj>(inputs[0], inputs[1], outputs[0]);
+                break;
+            case OpType::Relu:
+                g->addOpWithOutputs<ReluObj>(inputs[0], outputs[0]);
+                break;
+            case OpType::Exp:
+                g->addOpWithOutputs<ExpObj>(inputs[0], outputs[0]);
+                break;
+            case OpType::Sqrt:
+                g->addOpWithOutputs<SqrtObj>(inputs[0], outputs[0]);
+                break;
+            case OpType::Clip:
+            {
+                optional<float> min, max;
+                if (r.get<uint8_t>())
+                    min = r.get<float>();
+                else
+                    r.get<float>();
+                if (r.get<uint8_t>())
+                    max = r.get<float>();
+                else
+                    r.get<float>();
+                g->addOpWithOutputs<ClipObj>(inputs[0], outputs[0], min, max);
+                break;
+            }
+            case OpType::Cast:
+                g->addOpWithOutputs<CastObj>(inputs[0], outputs[0],
+                                             CastType(r.get<int32_t>()));
+                break;
+            case OpType::Concat:
+                g->addOpWithOutputs<ConcatObj>(inputs, outputs[0],
+                                               r.get<int32_t>());
+                break;
+            case OpType::Transpose:
+                g->addOpWithOutputs<TransposeObj>(inputs[0], outputs[0],
+                                                  r.getVec<int32_t>());
+                break;
+            case OpType::MatMul:
+            {
+                bool transA = r.get<uint8_t>();
+                bool transB = r.get<uint8_t>();
+                g->addOpWithOutputs<MatmulObj>(inputs[0], inputs[1],
+                                               outputs[0], transA, transB);
+                break;
+            }
+            case OpType::Reshape:
+                g->addOpWithOutputs<ReshapeObj>(inputs[0], outputs[0],
+                                                r.getVec<int32_t>());
+                break;
+            case OpType::Flatten:
+                g->addOpWithOutputs<FlattenObj>(inputs[0], outputs[0],
+                                                r.get<int32_t>());
+                break;
+            case OpType::Squeeze:
+                g->addOpWithOutputs<SqueezeObj>(inputs[0], outputs[0],
+                                                r.getVec<int32_t>());
+                break;
+            case OpType::Unsqueeze:
+                g->addOpWithOutputs<UnsqueezeObj>(inputs[0], outputs[0],
+                                                  r.getVec<int32_t>());
+                break;
+            case OpType::ReduceSum:
+            case OpType::ReduceMean:
+            case OpType::ReduceMax:
+            case OpType::ReduceMin:
+            case OpType::ReduceProd:
+            {
+                auto axes = r.getVec<int32_t>();
+                bool keepDims = r.get<uint8_t>();
+                addReduce(g, type, inputs[0], outputs[0], axes, keepDims);
+                break;
+            }
+            case OpType::Softmax:
+                g->addOpWithOutputs<SoftmaxObj>(inputs[0], outputs[0],
+                                                r.get<int32_t>());
+                break;
+            case OpType::LayerNorm:
+            {
+                auto axis = r.get<int32_t>();
+                auto eps = r.get<float>();
+                g->addOpWithOutputs<LayerNormObj>(
+                    inputs[0], inputs[1],
+                    inputs.size() > 2 ? inputs[2] : nullptr, outputs[0], axis,
+                    eps);
+                break;
+            }
+            case OpType::RMSNorm:
+            {
+                auto axis = r.get<int32_t>();
+                auto eps = r.get<float>();
+                g->addOpWithOutputs<RMSNormObj>(inputs[0], inputs[1],
+                                                outputs[0], axis, eps);
+                break;
+            }
+            case OpType::Conv:
+            {
+                auto pads = r.getVec<int32_t>();
+                auto strides = r.getVec<int32_t>();
+                auto dilations = r.getVec<int32_t>();
+                auto group = r.get<int32_t>();
+                bool blocked = r.get<uint8_t>();
+                g->addOpWithOutputs<ConvObj>(
+                    inputs[0], inputs[1],
+                    inputs.size() > 2 ? inputs[2] : nullptr, outputs[0], pads,
+                    strides, dilations, group, blocked);
+                break;
+            }
+            case OpType::Reorder:
+                g->addOpWithOutputs<ReorderObj>(inputs[0], outputs[0],
+                                                bool(r.get<uint8_t>()));
+                break;
+            case OpType::MaxPool:
+            case OpType::AveragePool:
+            case OpType::GlobalAveragePool:
+            {
+                auto kernel = r.getVec<int32_t>();
+                auto pads = r.getVec<int32_t>();
+                auto strides = r.getVec<int32_t>();
+                bool countIncludePad = r.get<uint8_t>();
+                bool blocked = r.get<uint8_t>();
+                if (type == OpType::MaxPool)
+                    g->addOpWithOutputs<MaxPoolObj>(inputs[0], outputs[0],
+                                                    kernel, pads, strides,
+                                                    blocked);
+                else if (type == OpType::AveragePool)
+                    g->addOpWithOutputs<AvgPoolObj>(inputs[0], outputs[0],
+                                                    kernel, pads, strides,
+                                                    countIncludePad, blocked);
+                else
+                    g->addOpWithOutputs<GlobalAvgPoolObj>(inputs[0],
+                                                          outputs[0], blocked);
+                break;
+            }
+            case OpType::Gather:
+                g->addOpWithOutputs<GatherObj>(inputs[0], inputs[1], outputs[0],
+                                               r.get<int32_t>());
+                break;
+            case OpType::EmbeddingBag:
+                g->addOpWithOutputs<EmbeddingBagObj>(inputs[0], inputs[1],
+                                                     outputs[0],
+                                                     bool(r.get<uint8_t>()));
+                break;
+            case OpType::SparseMatmul:
+            {
+                int blockRows = r.get<int32_t>();
+                int blockCols = r.get<int32_t>();
+                g->addOpWithOutputs<SparseMatmulObj>(
+                    inputs[0], inputs[1], inputs[2], inputs[3], outputs[0],
+                    blockRows, blockCols);
+                break;
+            }
+            case OpType::FusedElementwise:
+            {
+                ElementwiseExpr expr;
+                auto n = r.get<uint32_t>();
+                IT_ASSERT(n <= r.left() / (sizeof(uint8_t) +
+                                           2 * sizeof(int32_t) + sizeof(float)),
+                          "Truncated model file");
+                expr.nodes.resize(n);
+                for (auto &node : expr.nodes)
+                {
+                    node.code = ElementwiseExpr::Code(r.get<uint8_t>());
+                    node.a = r.get<int32_t>();
+                    node.b = r.get<int32_t>();
+                    node.value = r.get<float>();
+                }
+                g->addOpWithOutputs<FusedElementwiseObj>(inputs, outputs[0],
+                                                         std::move(expr));
+                break;
+            }
+            default:
+                IT_TODO_HALT_MSG(string("Cannot deserialize operator ") +
+                                 type.toString());
+            }
+        }
+
+    } // namespace
+
+    void saveGraph(const Graph &graph, const string &path)
+    {
+        IT_ASSERT(graph->topo_sort());
+        const auto &tensors = graph->getTensors();
+        const auto &ops = graph->getOperators();
+        std::unordered_map<TensorObj *, int32_t> index;
+        for (size_t i = 0; i < tensors.size(); ++i)
+            index[tensors[i].get()] = i;
+
+        Writer tensorTable, opTable;
+        vector<Tensor> weights;
+        uint64_t weightBytes = 0;
+        for (auto &tensor : tensors)
+        {
+            tensorTable.put<int32_t>(tensor->getDType().getIndex());
+            tensorTable.put<uint32_t>(tensor->isWeight() ? kFlagWeight : 0);
+            tensorTable.putVec<int32_t>(tensor->getDims());
+            if (tensor->isWeight())
+            {
+                tensorTable.put<uint64_t>(weightBytes);
+                tensorTable.put<uint64_t>(tensor->getBytes());
+                weightBytes += alignUp(tensor->getBytes());
+                weights.emplace_back(tensor);
+            }
+        }
+        for (auto &op : ops)
+        {
+            opTable.put<uint16_t>(op->getOpType().underlying());
+            for (auto *vec : {&op->getInputs(), &op->getOutputs()})
+            {
+                opTable.put<uint32_t>(vec->size());
+                for (auto &t : *vec)
+                    opTable.put<int32_t>(index.at(t.get()));
+            }
+            Writer attrs;
+            writeAttributes(attrs, op);
+            opTable.putVec<char>(attrs.data());
+        }
+
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.numTensors = tensors.size();
+        header.numOps = ops.size();
+        header.weightOffset = alignUp(sizeof(Header) +
+                                      tensorTable.data().size() +
+                                      opTable.data().size());
+        header.weightBytes = weightBytes;
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        IT_ASSERT(out.good(), "Cannot open model file " + path);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(tensorTable.data().data(), tensorTable.data().size());
+        out.write(opTable.data().data(), opTable.data().size());
+        const char zeros[kModelAlignment] = {};
+        size_t pos = sizeof(Header) + tensorTable.data().size() +
+                     opTable.data().size();
+        out.write(zeros, header.weightOffset - pos);
+        for (auto &weight : weights)
+        {
+            auto bytes = weight->getBytes();
+            out.write(weight->getRawDataPtr<const char *>(), bytes);
+            out.write(zeros, alignUp(bytes) - bytes);
+        }
+        IT_ASSERT(out.good(), "Failed to write model file " + path);
+    }
+
+    Graph loadGraph(Runtime runtime, const string &path)
+    {
+        auto file = make_ref<MappedFile>(path);
+        IT_ASSERT(file->size() >= sizeof(Header), "Truncated model file");
+        Header header;
+        std::memcpy(&header, file->data(), sizeof(header));
+        IT_ASSERT(std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0,
+                  path + " is not a model file");
+        IT_ASSERT(header.version == kVersion,
+                  "Unsupported model file version " +
+                      std::to_string(header.version));
+        // Written so that hostile sizes cannot overflow.
+        IT_ASSERT(header.weightOffset % kModelAlignment == 0 &&
+                      sizeof(Header) <= header.weightOffset &&
+                      header.weightOffset <= file->size() &&
+                      header.weightBytes <= file->size() - header.weightOffset,
+                  "Corrupted weight section");
+
+        Graph g = make_ref<GraphObj>(runtime);
+        Reader r(file->data() + sizeof(Header),
+                 file->data() + header.weightOffset);
+        TensorVec tensors;
+        for (uint32_t i = 0; i < header.numTensors; ++i)
+        {
+            auto dtypeIndex = r.get<int32_t>();
+            IT_ASSERT(0 <= dtypeIndex && dtypeIndex <= DataType::BFloat16.getIndex(),
+                      "Unknown data type " + std::to_string(dtypeIndex));
+            DataType dtype(dtypeIndex);
+            auto flags = r.get<uint32_t>();
+            auto tensor = g->addTensor(r.getVec<int32_t>(), dtype);
+            if (flags & kFlagWeight)
+            {
+                auto offset = r.get<uint64_t>();
+                auto bytes = r.get<uint64_t>();
+                IT_ASSERT(bytes <= header.weightBytes &&
+                              offset <= header.weightBytes - bytes,
+                          "Corrupted weight section");
+                auto ptr = const_cast<char *>(file->data()) +
+                           header.weightOffset + offset;
+                tensor->setWeight();
+                tensor->setExternalData(ptr, bytes, file);
+            }
+            tensors.emplace_back(tensor);
+        }
+        auto lookup = [&](int32_t i)
+        {
+            IT_ASSERT(0 <= i && i < (int32_t)tensors.size(),
+                      "Tensor index out of range");
+            return tensors[i];
+        };
+        for (uint32_t i = 0; i < header.numOps; ++i)
+        {
+            OpType type(r.get<uint16_t>());
+            TensorVec inputs, outputs;
+            for (auto *vec : {&inputs, &outputs})
+            {
+                auto n = r.get<uint32_t>();
+                for (uint32_t j = 0; j < n; ++j)
+                    vec->emplace_back(lookup(r.get<int32_t>()));
+            }
+            auto attrs = r.getVec<char>();
+            Reader attrReader(attrs.data(), attrs.data() + attrs.size());
+            readOperator(g.get(), type, inputs, outputs, attrReader);
+        }
+        return g;
+    }
+
+} // namespace infini
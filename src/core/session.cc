@@ -0,0 +1,195 @@
+#include "core/session.h"
+#include "core/runtime.h"
+#include <cstring>
+
+namespace infini
+{
+    Session::Session(Graph graph, int depth) : graph(std::move(graph))
+    {
+        IT_ASSERT(depth > 0, "Session depth must be positive");
+        for (const auto &tensor : this->graph->getTensors())
+            IT_ASSERT(tensor->getDataBlob(),
+                      "Tensor " + std::to_string(tensor->getGuid()) +
+                          " has no data, call dataMalloc before creating a "
+                          "Session");
+        for (const auto &input : this->graph->getInputs())
+            if (!input->isWeight())
+                inputs.emplace_back(input);
+        outputs = this->graph->getOutputs();
+        for (const auto &input : inputs)
+            inputBytes.emplace_back(input->getBytes());
+        for (const auto &output : outputs)
+        {
+            outputBytes.emplace_back(output->getBytes());
+            outputBlobs.emplace_back(output->getDataBlob());
+        }
+
+        auto runtime = this->graph->getRuntime();
+        slots.resize(depth);
+        for (int slot = 0; slot < depth; ++slot)
+        {
+            for (const auto &input : inputs)
+                slots[slot].emplace_back(
+                    runtime->alloc(std::max<size_t>(input->getBytes(), 1)),
+                    [runtime](void *ptr) { runtime->dealloc(ptr); });
+            freeSlots.emplace_back(depth - 1 - slot);
+        }
+        thread = std::thread(&Session::work, this);
+    }
+
+    Session::~Session()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        changed.notify_all();
+        thread.join();
+    }
+
+    void Session::work()
+    {
+        for (;;)
+        {
+            Request request;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                changed.wait(guard, [&] { return stopping || !queue.empty(); });
+                if (queue.empty())
+                    return;
+                request = std::move(queue.front());
+                queue.pop_front();
+            }
+
+            std::exception_ptr error;
+            if (request.cached)
+            {
+                for (size_t i = 0; i < outputs.size(); ++i)
+                    std::memcpy(request.outputs[i],
+                                request.cached->outputs[i].data(),
+                                outputBytes[i]);
+            }
+            else
+            {
+                try
+                {
+                    // The buffers stay owned by the inputs, so the graph
+                    // remains usable after the session is gone. Outputs are
+                    // rebound to their own buffers after the run.
+                    const auto &buffers = slots[request.slot];
+                    for (size_t i = 0; i < inputs.size(); ++i)
+                        graph->bindInput(
+                            inputs[i], buffers[i].get(),
+                            std::max<size_t>(inputBytes[i], 1), buffers[i]);
+                    for (size_t i = 0; i < outputs.size(); ++i)
+                        graph->bindOutput(outputs[i], request.outputs[i],
+                                          outputBytes[i]);
+                    graph->getRuntime()->run(graph);
+                    if (cache)
+                    {
+                        vector<const void *> data, results;
+                        for (const auto &buffer : buffers)
+                            data.emplace_back(buffer.get());
+                        for (auto output : request.outputs)
+                            results.emplace_back(output);
+                        cache->insert(request.hash, data, inputBytes, results,
+                                      outputBytes);
+                    }
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                // The caller's buffers only live until the request completes.
+                for (size_t i = 0; i < outputs.size(); ++i)
+                    outputs[i]->setDataBlob(outputBlobs[i]);
+
+                // Release the inputs before the callback, which may submit.
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    freeSlots.emplace_back(request.slot);
+                }
+                changed.notify_all();
+            }
+            if (request.done)
+                request.done(error);
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                --running;
+            }
+            changed.notify_all();
+        }
+    }
+
+    void Session::submit(const vector<const void *> &data,
+                         const vector<void *> &results, Callback done)
+    {
+        IT_ASSERT(data.size() == inputs.size(),
+                  "Session takes " + std::to_string(inputs.size()) +
+                      " inputs, got " + std::to_string(data.size()));
+        IT_ASSERT(results.size() == outputs.size(),
+                  "Session has " + std::to_string(outputs.size()) +
+                      " outputs, got " + std::to_string(results.size()));
+        uint64_t hash = 0;
+        if (cache)
+        {
+            // Hashed on the caller's thread, overlapping with earlier runs.
+            hash = ResultCache::hash(data, inputBytes);
+            if (auto entry = cache->find(hash, data, inputBytes))
+            {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    ++running;
+                    queue.push_back({-1, results, std::move(done), hash,
+                                     std::move(entry)});
+                }
+                changed.notify_all();
+                return;
+            }
+        }
+        int slot;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            changed.wait(guard, [&] { return !freeSlots.empty(); });
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+            ++running;
+        }
+        // Overlaps with the run of the previous request.
+        for (size_t i = 0; i < inputs.size(); ++i)
+            std::memcpy(slots[slot][i].get(), data[i], inputBytes[i]);
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            queue.push_back({slot, results, std::move(done), hash, nullptr});
+        }
+        changed.notify_all();
+    }
+
+    void Session::setResultCache(size_t bytes)
+    {
+        cache = bytes ? make_ref<ResultCache>(bytes) : nullptr;
+    }
+
+    std::future<void> Session::submit(const vector<const void *> &data,
+                                      const vector<void *> &results)
+    {
+        auto promise = std::make_shared<std::promise<void>>();
+        auto future = promise->get_future();
+        submit(data, results,
+               [promise](std::exception_ptr error)
+               {
+                   if (error)
+                       promise->set_exception(error);
+                   else
+                       promise->set_value();
+               });
+        return future;
+    }
+
+    void Session::wait()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [&] { return running == 0; });
+    }
+
+} // namespace infini
@@ -9,7 +9,10 @@ namespace infini {
 
     TensorObj::TensorObj(Shape shape_, DataType dtype, Runtime runtime)
         : dim(shape_.size()), dtype(dtype), runtime(runtime), shape(std::move(shape_)),
-          _size(std::accumulate(shape.begin(), shape.end(), 1, std::multiplies{})) {}
+          _size(std::accumulate(shape.begin(), shape.end(), 1, std::multiplies{}))
+    {
+        resetLayout();
+    }
 
     string TensorObj::toString() const
     {
@@ -39,10 +42,38 @@ void TensorObj::setShape(Shape shape_) {
     size_t size = std::accumulate(shape.begin(), shape.end(), 1,
                                   [](auto acc, auto x) { return acc * x; });
     _size = size;
+    resetLayout();
+}
+
+void TensorObj::setLayout(Shape stride_, size_t offset_) {
+    IT_ASSERT(stride_.size() == shape.size());
+    stride = std::move(stride_);
+    offset = offset_;
+}
+
+void TensorObj::resetLayout() {
+    stride.resize(shape.size());
+    int p = 1;
+    for (size_t i = shape.size(); i > 0; --i) {
+        stride[i - 1] = p;
+        p *= shape[i - 1];
+    }
+    offset = 0;
+}
+
+bool TensorObj::isContiguous() const {
+    int p = 1;
+    for (size_t i = shape.size(); i > 0; --i) {
+        if (shape[i - 1] != 1 && stride[i - 1] != p)
+            return false;
+        p *= shape[i - 1];
+    }
+    return true;
 }
 
 void TensorObj::printData() const {
     IT_ASSERT(data != nullptr);
+    IT_ASSERT(isContiguous());
     if (!runtime->isCpu())
         IT_TODO_HALT();
 
@@ -76,6 +107,7 @@ bool TensorObj::equalData(const Tensor &rhs, double relativeError) const {
     IT_ASSERT(getDType() == rhs->getDType());
     IT_ASSERT(runtime->isCpu());
     IT_ASSERT(rhs->getRuntime()->isCpu());
+    IT_ASSERT(isContiguous() && rhs->isContiguous());
     if (size() != rhs->size())
         return false;
 
@@ -108,9 +140,26 @@ bool TensorObj::equalData(const Tensor &rhs, double relativeError) const {
 void TensorObj::setData(
     const std::function<void(void *, size_t, DataType)> &generator) const {
     IT_ASSERT(data != nullptr);
+    IT_ASSERT(isContiguous());
     generator(getRawDataPtr<void *>(), size(), dtype);
 }
 
 void TensorObj::setDataBlob(const Blob &blob) { this->data = blob; }
 
+void TensorObj::setExternalData(void *ptr, size_t bytes, Ref<void> owner) {
+    IT_ASSERT(ptr != nullptr, "External buffer of tensor " +
+                                  std::to_string(guid) + " is null");
+    IT_ASSERT(reinterpret_cast<uintptr_t>(ptr) % dtype.getSize() == 0,
+              "External buffer of tensor " + std::to_string(guid) +
+                  " is not aligned to " + std::to_string(dtype.getSize()) +
+                  " bytes");
+    IT_ASSERT(bytes >= getBytes(),
+              "External buffer of tensor " + std::to_string(guid) + " has " +
+                  std::to_string(bytes) + " bytes, " +
+                  std::to_string(getBytes()) + " required");
+    external = true;
+    data = make_ref<BlobObj>(runtime, ptr, std::move(owner));
+    resetLayout();
+}
+
 }; // namespace infini
@@ -0,0 +1,182 @@
+#include "core/thread_pool.h"
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace infini
+{
+    namespace
+    {
+        // Pause iterations a waiting thread spins before it parks (workers) or
+        // yields (the caller), a few tens of microseconds.
+        constexpr int kSpins = 1 << 14;
+
+        // Set on workers and on callers while they run their share, so that
+        // nested loops run inline.
+        thread_local bool inJob = false;
+        thread_local ThreadPool *currentPool = nullptr;
+
+        int availableCpus()
+        {
+            cpu_set_t set;
+            if (sched_getaffinity(0, sizeof(set), &set) == 0)
+                return CPU_COUNT(&set);
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+    } // namespace
+
+    ThreadPool::ThreadPool(int threads, vector<int> cpus, size_t minWork)
+        : minWork(std::max<size_t>(minWork, 1)), cpus(std::move(cpus))
+    {
+        if (threads <= 0)
+            threads = availableCpus();
+        nWorkers = threads - 1;
+        workers.reset(new Worker[nWorkers]);
+        for (int i = 0; i < nWorkers; ++i)
+            workers[i].thread = std::thread(&ThreadPool::work, this, i + 1);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(parkLock);
+            stopping = true;
+        }
+        parked.notify_all();
+        for (int i = 0; i < nWorkers; ++i)
+            workers[i].thread.join();
+    }
+
+    void ThreadPool::work(int index)
+    {
+        inJob = true;
+        workers[index - 1].tid.store(syscall(SYS_gettid),
+                                     std::memory_order_release);
+        if (!cpus.empty())
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpus[index % cpus.size()], &set);
+            // Best effort: the CPU may be outside the process's cpuset.
+            sched_setaffinity(0, sizeof(set), &set);
+        }
+        auto &ticket = workers[index - 1].ticket;
+        uint64_t seen = 0;
+        for (;;)
+        {
+            uint64_t next = seen;
+            for (int i = 0; i < kSpins && next == seen && !stopping; ++i)
+            {
+                spinPause();
+                next = ticket.load(std::memory_order_acquire);
+            }
+            if (next == seen && !stopping)
+            {
+                std::unique_lock<std::mutex> lock(parkLock);
+                sleeping.fetch_add(1, std::memory_order_relaxed);
+                // Pairs with the fence in dispatch: either the ticket is seen
+                // below or the dispatcher sees this worker sleeping.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                parked.wait(lock,
+                            [&]
+                            {
+                                next = ticket.load(std::memory_order_acquire);
+                                return next != seen || stopping;
+                            });
+                sleeping.fetch_sub(1, std::memory_order_relaxed);
+            }
+            if (next == seen)
+                return; // stopping
+            seen = next;
+            try
+            {
+                invoke(ctx, index, jobThreads);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> guard(errorLock);
+                if (!error)
+                    error = std::current_exception();
+            }
+            pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    void ThreadPool::dispatch(int threads, Invoke invoke, void *ctx)
+    {
+        if (inJob || busy.exchange(true, std::memory_order_acquire))
+            return invoke(ctx, 0, 1);
+
+        this->invoke = invoke;
+        this->ctx = ctx;
+        jobThreads = threads;
+        error = nullptr;
+        pending.store(threads - 1, std::memory_order_relaxed);
+        ++generation;
+        for (int i = 0; i < threads - 1; ++i)
+            workers[i].ticket.store(generation, std::memory_order_release);
+        // Pairs with the fence in work: a worker either sees its ticket
+        // before parking or is seen sleeping and woken here.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> guard(parkLock);
+            parked.notify_all();
+        }
+
+        inJob = true;
+        try
+        {
+            invoke(ctx, 0, threads);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> guard(errorLock);
+            if (!error)
+                error = std::current_exception();
+        }
+        inJob = false;
+        for (int i = 0; pending.load(std::memory_order_acquire) != 0; ++i)
+            if (i < kSpins)
+                spinPause();
+            else
+                std::this_thread::yield();
+
+        auto e = error;
+        busy.store(false, std::memory_order_release);
+        if (e)
+            std::rethrow_exception(e);
+    }
+
+    vector<int> ThreadPool::getThreadIds() const
+    {
+        vector<int> ret;
+        for (int i = 0; i < nWorkers; ++i)
+        {
+            int tid;
+            while ((tid = workers[i].tid.load(std::memory_order_acquire)) == 0)
+                std::this_thread::yield();
+            ret.emplace_back(tid);
+        }
+        return ret;
+    }
+
+    ThreadPool &ThreadPool::current()
+    {
+        return currentPool ? *currentPool : global();
+    }
+
+    ThreadPool &ThreadPool::global()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    ThreadPool::Scope::Scope(ThreadPool &pool) : saved(currentPool)
+    {
+        currentPool = &pool;
+    }
+
+    ThreadPool::Scope::~Scope() { currentPool = saved; }
+
+} // namespace infini
@@ -0,0 +1,205 @@
+#include "core/tuner.h"
+#include "core/blob.h"
+#include "core/runtime.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+
+namespace infini
+{
+    namespace
+    {
+        int threadCount() { return ThreadPool::current().size(); }
+
+        // One cache entry per line: key, time and comma-separated config.
+        string formatRecord(const string &key, const Tuner::Record &record)
+        {
+            std::ostringstream os;
+            os << key << "\t" << record.time << "\t";
+            for (size_t i = 0; i < record.config.size(); ++i)
+                os << (i ? "," : "") << record.config[i];
+            return os.str();
+        }
+
+        optional<pair<string, Tuner::Record>> parseRecord(const string &line)
+        {
+            auto tab1 = line.find('\t');
+            auto tab2 = line.find('\t', tab1 + 1);
+            if (tab1 == string::npos || tab2 == string::npos)
+                return std::nullopt;
+            Tuner::Record record;
+            record.time = std::atof(line.substr(tab1 + 1, tab2 - tab1 - 1).c_str());
+            std::istringstream is(line.substr(tab2 + 1));
+            for (string item; std::getline(is, item, ',');)
+                record.config.emplace_back(std::atoi(item.c_str()));
+            if (record.config.empty())
+                return std::nullopt;
+            return std::make_pair(line.substr(0, tab1), record);
+        }
+    } // namespace
+
+    void CpuKernelWithConfig::compute(const Operator &op,
+                                      const RuntimeObj *context) const
+    {
+        computeWithConfig(op, Tuner::getInstance().getConfig(*this, op, context),
+                          context);
+    }
+
+    Tuner::Tuner()
+    {
+        if (auto env = std::getenv("INFINI_TUNING"))
+            enabled = string(env) != "0";
+        if (auto env = std::getenv("INFINI_TUNING_CACHE"))
+            load(env);
+    }
+
+    string Tuner::getKey(const CpuKernelWithConfig &kernel, const Operator &op)
+    {
+        std::ostringstream os;
+        os << op->getOpType().toString() << "|" << op->getDType().toString()
+           << "|";
+        for (auto &input : op->getInputs())
+        {
+            os << vecToString(input->getDims());
+            if (!input->isContiguous())
+                os << "s" << vecToString(input->getStride());
+        }
+        os << "|" << kernel.getTuningAttrs(op) << "|t" << threadCount();
+        return os.str();
+    }
+
+    KernelConfig Tuner::getConfig(const CpuKernelWithConfig &kernel,
+                                  const Operator &op,
+                                  const RuntimeObj *context)
+    {
+        // Keyed by shapes rather than by op, so that an op whose shapes
+        // change is tuned again and the map only grows with new shapes.
+        auto key = getKey(kernel, op);
+        {
+            std::lock_guard lock(mutex);
+            if (auto it = records.find(key); it != records.end())
+                return it->second.config;
+            if (!enabled)
+                return kernel.getSearchSpace(op).front();
+        }
+        // Timed unlocked, so that threads tuning other keys do not wait.
+        // Threads racing on the same key keep the first record stored.
+        auto record = tune(kernel, op, context);
+        std::lock_guard lock(mutex);
+        auto [it, inserted] = records.emplace(key, std::move(record));
+        if (inserted)
+            append(key, it->second);
+        return it->second.config;
+    }
+
+    Tuner::Record Tuner::tune(const CpuKernelWithConfig &kernel,
+                              const Operator &op,
+                              const RuntimeObj *context) const
+    {
+        using Clock = std::chrono::steady_clock;
+        auto candidates = kernel.getSearchSpace(op);
+        IT_ASSERT(!candidates.empty());
+        if (candidates.size() == 1)
+            return {candidates[0], 0};
+
+        // Candidates write to scratch buffers, so that outputs aliasing
+        // inputs are never read after being overwritten.
+        auto runtime = const_cast<RuntimeObj *>(context);
+        vector<Blob> saved;
+        vector<void *> scratch;
+        for (auto &output : op->getOutputs())
+        {
+            saved.emplace_back(output->getDataBlob());
+            scratch.emplace_back(runtime->alloc(output->getBytes()));
+            output->setDataBlob(make_ref<BlobObj>(runtime->shared_from_this(),
+                                                  scratch.back()));
+        }
+
+        Record best{candidates[0], std::numeric_limits<double>::infinity()};
+        for (auto &config : candidates)
+        {
+            kernel.computeWithConfig(op, config, context); // warm up
+            double time = std::numeric_limits<double>::infinity();
+            for (int rep = 0; rep < 2; ++rep)
+            {
+                auto t0 = Clock::now();
+                kernel.computeWithConfig(op, config, context);
+                time = std::min(
+                    time,
+                    std::chrono::duration<double>(Clock::now() - t0).count());
+            }
+            if (time < best.time)
+                best = {config, time};
+        }
+
+        for (size_t i = 0; i < saved.size(); ++i)
+        {
+            op->getOutput(i)->setDataBlob(saved[i]);
+            runtime->dealloc(scratch[i]);
+        }
+        return best;
+    }
+
+    optional<Tuner::Record> Tuner::lookup(const string &key) const
+    {
+        std::lock_guard lock(mutex);
+        auto it = records.find(key);
+        if (it == records.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    void Tuner::load(const string &path)
+    {
+        std::lock_guard lock(mutex);
+        std::ifstream in(path);
+        for (string line; std::getline(in, line);)
+            if (auto record = parseRecord(line))
+                records[record->first] = record->second;
+        cacheFile = path;
+    }
+
+    void Tuner::save(const string &path) const
+    {
+        std::lock_guard lock(mutex);
+        std::ofstream out(path, std::ios::trunc);
+        IT_ASSERT(out.good(), "Cannot open tuning cache " + path);
+        for (auto &[key, record] : records)
+            out << formatRecord(key, record) << "\n";
+    }
+
+    void Tuner::append(const string &key, const Record &record) const
+    {
+        if (cacheFile.empty())
+            return;
+        std::ofstream out(cacheFile, std::ios::app);
+        if (out.good())
+            out << formatRecord(key, record) << "\n";
+    }
+
+    void Tuner::clear()
+    {
+        std::lock_guard lock(mutex);
+        records.clear();
+        cacheFile.clear();
+    }
+
+    void Tuner::setEnabled(bool enabled)
+    {
+        std::lock_guard lock(mutex);
+        this->enabled = enabled;
+    }
+
+    bool Tuner::isEnabled() const
+    {
+        std::lock_guard lock(mutex);
+        return enabled;
+    }
+
+    size_t Tuner::size() const
+    {
+        std::lock_guard lock(mutex);
+        return records.size();
+    }
+
+} // namespace infini
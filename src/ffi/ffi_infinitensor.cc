@@ -0,0 +1,1069 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "core/graph.h"
+#include "core/onnx_importer.h"
+#include "core/runtime.h"
+#include "core/serializer.h"
+#include "operators/concat.h"
+#include "operators/conv.h"
+#include "operators/element_wise.h"
+#include "operators/gather.h"
+#include "operators/layer_norm.h"
+#include "operators/matmul.h"
+#include "operators/pooling.h"
+#include "operators/reduce.h"
+#include "operators/reshape.h"
+#include "operators/softmax.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include <mutex>
+
+/**
+ * The `infinitensor` Python module, written against the CPython C API.
+ *
+ * Tensor data is exchanged through the buffer protocol without copies: a
+ * Tensor exports its data (memoryview(t), numpy.asarray(t)), and bind()
+ * makes a graph input or output read or write a caller-owned buffer in
+ * place, holding the buffer until it is rebound. Graph.run() releases the
+ * GIL, so threads running different graphs proceed in parallel; runs of
+ * one graph are serialized, and so are changes to it (adding tensors and
+ * ops, bind, optimize, data_malloc), which also release the GIL.
+ */
+
+namespace infini
+{
+    namespace
+    {
+        struct GraphState
+        {
+            Graph graph;
+            std::mutex runLock;
+            // Buffers exported from tensors of the graph, which dataMalloc
+            // would invalidate.
+            Py_ssize_t exports = 0;
+        };
+
+        struct PyGraph
+        {
+            PyObject_HEAD GraphState *state;
+        };
+
+        struct PyTensor
+        {
+            PyObject_HEAD Tensor *tensor;
+            PyGraph *graph; // Keeps the arena of the tensor alive.
+        };
+
+        PyTypeObject *GraphType, *TensorType;
+
+        struct DTypeInfo
+        {
+            DataType dtype;
+            const char *name, *format;
+        };
+
+        const DTypeInfo kDTypes[] = {
+            {DataType::Float32, "float32", "f"},
+            {DataType::Float16, "float16", "e"},
+            {DataType::Double, "float64", "d"},
+            {DataType::Int8, "int8", "b"},
+            {DataType::Int16, "int16", "h"},
+            {DataType::Int32, "int32", "i"},
+            {DataType::Int64, "int64", "q"},
+            {DataType::UInt8, "uint8", "B"},
+            {DataType::UInt16, "uint16", "H"},
+            {DataType::UInt32, "uint32", "I"},
+            {DataType::UInt64, "uint64", "Q"},
+            {DataType::Bool, "bool", "?"},
+        };
+
+        const DTypeInfo *infoOf(DataType dtype)
+        {
+            for (const auto &info : kDTypes)
+                if (info.dtype == dtype)
+                    return &info;
+            PyErr_Format(PyExc_TypeError, "Unsupported data type %s",
+                         dtype.toString().c_str());
+            return nullptr;
+        }
+
+        const DTypeInfo *infoOfName(const char *name)
+        {
+            for (const auto &info : kDTypes)
+                if (strcmp(info.name, name) == 0)
+                    return &info;
+            PyErr_Format(PyExc_TypeError, "Unknown data type %s", name);
+            return nullptr;
+        }
+
+        // A struct module format such as "<f" or "=q", native sizes only.
+        const DTypeInfo *infoOfFormat(const char *format)
+        {
+            if (!format)
+                format = "B";
+            if (*format == '@' || *format == '=' || *format == '<')
+                ++format;
+            // int64 is "l" on LP64 platforms.
+            if (strcmp(format, "l") == 0 && sizeof(long) == 8)
+                format = "q";
+            if (strcmp(format, "L") == 0 && sizeof(long) == 8)
+                format = "Q";
+            for (const auto &info : kDTypes)
+                if (strcmp(info.format, format) == 0)
+                    return &info;
+            PyErr_Format(PyExc_TypeError, "Unsupported buffer format %s",
+                         format);
+            return nullptr;
+        }
+
+#define TRY try {
+#define CATCH                                          \
+    }                                                  \
+    catch (const std::exception &e)                    \
+    {                                                  \
+        PyErr_SetString(PyExc_RuntimeError, e.what()); \
+        return nullptr;                                \
+    }
+
+        /**
+         * Runs `f` on the graph with the GIL released and the run lock held,
+         * so that changes to the graph never overlap a run on another thread.
+         * `f` must not touch Python objects. False with a RuntimeError set if
+         * it threw.
+         */
+        template <typename F> bool withRunLock(PyGraph *self, F &&f)
+        {
+            auto state = self->state;
+            // Copied so that a concurrent dealloc cannot race with `f`.
+            Graph graph = state->graph;
+            bool failed = false;
+            std::string error;
+            Py_BEGIN_ALLOW_THREADS;
+            try
+            {
+                std::lock_guard<std::mutex> guard(state->runLock);
+                f(graph);
+            }
+            catch (const std::exception &e)
+            {
+                failed = true;
+                error = e.what();
+            }
+            Py_END_ALLOW_THREADS;
+            if (failed)
+                PyErr_SetString(PyExc_RuntimeError, error.c_str());
+            return !failed;
+        }
+
+        PyObject *wrapTensor(PyGraph *graph, const Tensor &tensor)
+        {
+            auto self = PyObject_New(PyTensor, TensorType);
+            if (!self)
+                return nullptr;
+            self->tensor = new Tensor(tensor);
+            Py_INCREF(graph);
+            self->graph = graph;
+            return (PyObject *)self;
+        }
+
+        PyObject *wrapTensors(PyGraph *graph, const TensorVec &tensors)
+        {
+            PyObject *list = PyList_New(tensors.size());
+            for (size_t i = 0; list && i < tensors.size(); ++i)
+            {
+                auto t = wrapTensor(graph, tensors[i]);
+                if (!t)
+                {
+                    Py_CLEAR(list);
+                    break;
+                }
+                PyList_SET_ITEM(list, i, t);
+            }
+            return list;
+        }
+
+        PyObject *wrapGraph(Graph graph)
+        {
+            auto self = PyObject_New(PyGraph, GraphType);
+            if (!self)
+                return nullptr;
+            self->state = new GraphState;
+            self->state->graph = std::move(graph);
+            return (PyObject *)self;
+        }
+
+        // Tensor argument of a graph method, None for optional ones.
+        bool toTensor(PyGraph *graph, PyObject *obj, Tensor &out,
+                      bool optional = false)
+        {
+            if (optional && (!obj || obj == Py_None))
+            {
+                out = nullptr;
+                return true;
+            }
+            if (!PyObject_TypeCheck(obj, TensorType))
+            {
+                PyErr_SetString(PyExc_TypeError, "Expected a Tensor");
+                return false;
+            }
+            auto tensor = (PyTensor *)obj;
+            if (tensor->graph != graph)
+            {
+                PyErr_SetString(PyExc_ValueError,
+                                "Tensor belongs to another graph");
+                return false;
+            }
+            out = *tensor->tensor;
+            return true;
+        }
+
+        bool toInts(PyObject *obj, vector<int> &out)
+        {
+            PyObject *seq = PySequence_Fast(obj, "Expected a sequence of ints");
+            if (!seq)
+                return false;
+            out.clear();
+            for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i)
+            {
+                long v = PyLong_AsLong(PySequence_Fast_GET_ITEM(seq, i));
+                if (v == -1 && PyErr_Occurred())
+                {
+                    Py_DECREF(seq);
+                    return false;
+                }
+                out.emplace_back(v);
+            }
+            Py_DECREF(seq);
+            return true;
+        }
+
+        // Exporter buffers bound to tensors, released when the tensor lets go
+        // of them, possibly from a thread not holding the GIL.
+        Ref<void> holdBuffer(Py_buffer *view)
+        {
+            return Ref<void>(view,
+                             [](void *p)
+                             {
+                                 auto view = static_cast<Py_buffer *>(p);
+                                 if (Py_IsInitialized())
+                                 {
+                                     auto gil = PyGILState_Ensure();
+                                     PyBuffer_Release(view);
+                                     PyGILState_Release(gil);
+                                 }
+                                 delete view;
+                             });
+        }
+
+        // ----------------------------------------------------------------
+        // Tensor
+
+        void tensorDealloc(PyObject *obj)
+        {
+            auto self = (PyTensor *)obj;
+            delete self->tensor;
+            Py_XDECREF(self->graph);
+            auto type = Py_TYPE(obj);
+            PyObject_Free(obj);
+            Py_DECREF(type);
+        }
+
+        PyObject *tensorRepr(PyObject *obj)
+        {
+            auto &tensor = *((PyTensor *)obj)->tensor;
+            return PyUnicode_FromFormat("Tensor(%s, %s)",
+                                        vecToString(tensor->getDims()).c_str(),
+                                        tensor->getDType().toString().c_str());
+        }
+
+        PyObject *tensorShape(PyObject *obj, void *)
+        {
+            auto dims = (*((PyTensor *)obj)->tensor)->getDims();
+            PyObject *shape = PyTuple_New(dims.size());
+            for (size_t i = 0; shape && i < dims.size(); ++i)
+                PyTuple_SET_ITEM(shape, i, PyLong_FromLong(dims[i]));
+            return shape;
+        }
+
+        PyObject *tensorDType(PyObject *obj, void *)
+        {
+            auto info = infoOf((*((PyTensor *)obj)->tensor)->getDType());
+            return info ? PyUnicode_FromString(info->name) : nullptr;
+        }
+
+        PyObject *tensorBind(PyObject *obj, PyObject *buffer)
+        {
+            auto self = (PyTensor *)obj;
+            auto &tensor = *self->tensor;
+            bool output = bool(tensor->getSource());
+            auto view = new Py_buffer;
+            int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT |
+                        (output ? PyBUF_WRITABLE : 0);
+            if (PyObject_GetBuffer(buffer, view, flags) < 0)
+            {
+                delete view;
+                return nullptr;
+            }
+            auto owner = holdBuffer(view);
+            auto info = infoOfFormat(view->format);
+            if (!info)
+                return nullptr;
+            if (!(info->dtype == tensor->getDType()))
+                return PyErr_Format(PyExc_TypeError,
+                                    "Buffer of %s bound to a %s tensor",
+                                    info->name,
+                                    tensor->getDType().toString().c_str());
+            if (!withRunLock(self->graph,
+                             [&](const Graph &graph)
+                             {
+                                 if (output)
+                                     graph->bindOutput(tensor, view->buf,
+                                                       view->len, owner);
+                                 else
+                                     graph->bindInput(tensor, view->buf,
+                                                      view->len, owner);
+                             }))
+                return nullptr;
+            Py_RETURN_NONE;
+        }
+
+        int tensorGetBuffer(PyObject *obj, Py_buffer *view, int flags)
+        {
+            auto self = (PyTensor *)obj;
+            auto &tensor = *self->tensor;
+            if (!tensor->getDataBlob())
+            {
+                PyErr_SetString(PyExc_BufferError,
+                                "Tensor has no data, call data_malloc first");
+                return -1;
+            }
+            auto info = infoOf(tensor->getDType());
+            if (!info)
+                return -1;
+            if ((flags & PyBUF_WRITABLE) && tensor->isWeight())
+            {
+                PyErr_SetString(PyExc_BufferError, "Weights are read-only");
+                return -1;
+            }
+            // Views are exported to consumers handling strides and not
+            // requiring contiguity; Fortran order only holds for vectors.
+            auto requests = [&](int request)
+            { return (flags & request) == request; };
+            if (!tensor->isContiguous() &&
+                (!requests(PyBUF_STRIDES) || requests(PyBUF_C_CONTIGUOUS) ||
+                 requests(PyBUF_ANY_CONTIGUOUS)))
+            {
+                PyErr_SetString(PyExc_BufferError,
+                                "Tensor is a strided view");
+                return -1;
+            }
+            if (requests(PyBUF_F_CONTIGUOUS) &&
+                (!tensor->isContiguous() || tensor->getRank() > 1))
+            {
+                PyErr_SetString(PyExc_BufferError,
+                                "Tensor is not Fortran contiguous");
+                return -1;
+            }
+            // shape and strides, in bytes, live in view->internal.
+            const size_t rank = tensor->getRank(),
+                         itemsize = tensor->getDType().getSize();
+            auto dims = new Py_ssize_t[2 * rank + 1];
+            const auto &shape = tensor->getDims();
+            const auto &stride = tensor->getStride();
+            for (size_t i = 0; i < rank; ++i)
+            {
+                dims[i] = shape[i];
+                dims[rank + i] = stride[i] * itemsize;
+            }
+            view->buf = tensor->getRawDataPtr<void *>();
+            view->obj = obj;
+            Py_INCREF(obj);
+            view->len = tensor->getBytes();
+            view->readonly = tensor->isWeight();
+            view->itemsize = itemsize;
+            view->format = (flags & PyBUF_FORMAT)
+                               ? const_cast<char *>(info->format)
+                               : nullptr;
+            view->ndim = rank;
+            view->shape = (flags & PyBUF_ND) == PyBUF_ND ? dims : nullptr;
+            view->strides =
+                (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? dims + rank : nullptr;
+            view->suboffsets = nullptr;
+            view->internal = dims;
+            ++self->graph->state->exports;
+            return 0;
+        }
+
+        void tensorReleaseBuffer(PyObject *obj, Py_buffer *view)
+        {
+            delete[] static_cast<Py_ssize_t *>(view->internal);
+            --((PyTensor *)obj)->graph->state->exports;
+        }
+
+        PyMethodDef tensorMethods[] = {
+            {"bind", tensorBind, METH_O,
+             "bind(buffer)\n--\n\nReads (graph input) or writes (graph "
+             "output) this tensor in place in a C-contiguous buffer of the "
+             "same dtype, such as a NumPy array, which is held until the "
+             "tensor is bound again."},
+            {nullptr, nullptr, 0, nullptr},
+        };
+
+        PyGetSetDef tensorGetSet[] = {
+            {"shape", tensorShape, nullptr, "Dimensions as a tuple.", nullptr},
+            {"dtype", tensorDType, nullptr, "Data type name, e.g. float32.",
+             nullptr},
+            {nullptr, nullptr, nullptr, nullptr, nullptr},
+        };
+
+        PyType_Slot tensorSlots[] = {
+            {Py_tp_dealloc, (void *)tensorDealloc},
+            {Py_tp_repr, (void *)tensorRepr},
+            {Py_tp_methods, tensorMethods},
+            {Py_tp_getset, tensorGetSet},
+            {Py_bf_getbuffer, (void *)tensorGetBuffer},
+            {Py_bf_releasebuffer, (void *)tensorReleaseBuffer},
+            {Py_tp_doc,
+             (void *)"A tensor of a Graph. Supports the buffer protocol: "
+                     "memoryview(t) and numpy.asarray(t) view its data "
+                     "without copying."},
+            {0, nullptr},
+        };
+
+        PyType_Spec tensorSpec = {"infinitensor.Tensor", sizeof(PyTensor), 0,
+                                  Py_TPFLAGS_DEFAULT, tensorSlots};
+
+        // ----------------------------------------------------------------
+        // Graph
+
+        PyObject *graphNew(PyTypeObject *, PyObject *args, PyObject *kwargs)
+        {
+            if (!PyArg_ParseTuple(args, ":Graph"))
+                return nullptr;
+            TRY
+            return wrapGraph(
+                make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance()));
+            CATCH
+        }
+
+        void graphDealloc(PyObject *obj)
+        {
+            delete ((PyGraph *)obj)->state;
+            auto type = Py_TYPE(obj);
+            PyObject_Free(obj);
+            Py_DECREF(type);
+        }
+
+        GraphObj *graphOf(PyObject *self)
+        {
+            return ((PyGraph *)self)->state->graph.get();
+        }
+
+        PyObject *graphTensor(PyObject *self, PyObject *args, PyObject *kwargs)
+        {
+            static const char *kwlist[] = {"shape", "dtype", nullptr};
+            PyObject *shapeObj;
+            const char *dtypeName = "float32";
+            if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|s:tensor",
+                                             const_cast<char **>(kwlist),
+                                             &shapeObj, &dtypeName))
+                return nullptr;
+            vector<int> shape;
+            auto info = infoOfName(dtypeName);
+            if (!info || !toInts(shapeObj, shape))
+                return nullptr;
+            Tensor tensor;
+            if (!withRunLock((PyGraph *)self, [&](const Graph &g)
+                             { tensor = g->addTensor(shape, info->dtype); }))
+                return nullptr;
+            return wrapTensor((PyGraph *)self, tensor);
+        }
+
+        PyObject *graphWeight(PyObject *self, PyObject *buffer)
+        {
+            auto view = new Py_buffer;
+            if (PyObject_GetBuffer(buffer, view,
+                                   PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0)
+            {
+                delete view;
+                return nullptr;
+            }
+            auto owner = holdBuffer(view);
+            auto info = infoOfFormat(view->format);
+            if (!info)
+                return nullptr;
+            Shape shape(view->shape, view->shape + view->ndim);
+            Tensor tensor;
+            if (!withRunLock((PyGraph *)self,
+                             [&](const Graph &g)
+                             {
+                                 tensor = g->addTensor(shape, info->dtype);
+                                 tensor->setWeight();
+                                 tensor->setExternalData(view->buf, view->len,
+                                                         owner);
+                             }))
+                return nullptr;
+            return wrapTensor((PyGraph *)self, tensor);
+        }
+
+        // Runs `build` on the graph and wraps the output tensor it returns.
+        template <typename F>
+        PyObject *buildOp(PyObject *self, F &&build)
+        {
+            Tensor output;
+            if (!withRunLock((PyGraph *)self,
+                             [&](const Graph &g) { output = build(g.get()); }))
+                return nullptr;
+            return wrapTensor((PyGraph *)self, output);
+        }
+
+        template <typename T>
+        PyObject *graphBinary(PyObject *self, PyObject *args)
+        {
+            PyObject *a, *b;
+            Tensor x, y;
+            if (!PyArg_ParseTuple(args, "OO", &a, &b) ||
+                !toTensor((PyGraph *)self, a, x) ||
+                !toTensor((PyGraph *)self, b, y))
+                return nullptr;
+            return buildOp(self, [&](GraphObj *g)
+                           { return g->addOp<T>(x, y, nullptr)->getOutput(); });
+        }
+
+        template <typename T>
+        PyObject *graphUnary(PyObject *self, PyObject *obj)
+        {
+            Tensor x;
+            if (!toTensor((PyGraph *)self, obj, x))
+                return nullptr;
+            return buildOp(self, [&](GraphObj *g)
+                           { return g->addOp<T>(x, nullptr)->getOutput(); });
+        }
+
+        PyObject *graphClip(PyObject *self, PyObject *args, PyObject *kwargs)
+        {
+            static const char *kwlist[] = {"x", "min", "max", nullptr};
+            PyObject *xObj, *minObj = Py_None, *maxObj = Py_None;
+            Tensor x;
+            if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|OO:clip",
+                                             const_cast<char **>(kwlist),
+                                             &xObj, &minObj, &maxObj) ||
+                !toTensor((PyGraph *)self, xObj, x))
+                return nullptr;
+            optional<float> min, max;
+            if (minObj != Py_None)
+                min = PyFloat_AsDouble(minObj);
+            if (maxObj != Py_None)
+                max = PyFloat_AsDouble(maxObj);
+            if (PyErr_Occurred())
+                return nullptr;
+            return buildOp(self,
+                           [&](GraphObj *g)
+                           {
+                               return g->addOp<ClipObj>(x, nullptr, min, max)
+                                   ->getOutput();
+                           });
+        }
+
+        PyObject *graphMatmul(PyObject *self, PyObject *args, PyObject *kwargs)
+        {
+            static const char *kwlist[] = {"a", "b", "trans_a", "trans_b",
+                                           nullptr};
+            PyObject *aObj, *bObj;
+            int transA = 0, transB = 0;
+            Tensor a, b;
+            if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|pp:matmul",
+                                             const_cast<char **>(kwlist),
+                                             &aObj, &bObj, &transA, &transB) ||
+                !toTensor((PyGraph *)self, aObj, a) ||
+                !toTensor((PyGraph *)self, bObj, b))
+                return nullptr;
+            return buildOp(self,
+                           [&](GraphObj *g)
+                           {
+                               return g->addOp<MatmulObj>(a, b, nullptr, transA,
+                                                          transB)
+                                   ->getOutput();
+                           });
+        }
+
+        PyObject *graphTranspose(PyObject *self, PyObject *args)
+        {
+            PyObject *xObj, *permObj;
+            Tensor x;
+            vector<int> perm;
+            if (!PyArg_ParseTuple(args, "OO:transpose", &xObj, &permObj) ||
+                !toTensor((PyGraph *)self, xObj, x) || !toInts(permObj, perm))
+                return nullptr;
+            return buildOp(self, [&](GraphObj *g)
+                           { return g->addOp<TransposeObj>(x, nullptr, perm)
+                                 ->getOutput(); });
+        }
+
+        PyObject *graphReshape(PyObject *self, PyObject *args)
+        {
+            PyObject *xObj, *shapeObj;
+            Tensor x;
+            vector<int> shape;
+            if (!PyArg_ParseTuple(args, "OO:reshape", &xObj, &shapeObj) ||
+                !toTensor((PyGraph *)self, xObj, x) ||
+                !toInts(shapeObj, shape))
+                return nullptr;
+            return buildOp(self, [&](GraphObj *g)
+                           { return g->addOp<ReshapeObj>(x, nullptr, shape)
+                                 ->getOutput(); });
+        }
+
+        PyObject *graphFlatten(PyObject *self, PyObject *args)
+        {
+            PyObject *xObj;
+            int axis = 1;
+            Tensor x;
+            if (!PyArg_ParseTuple(args, "O|i:flatten", &xObj, &axis) ||
+                !toTensor((PyGraph *)self, xObj, x))
+                return nullptr;
+            return buildOp(self, [&](GraphObj *g)
+                           { return g->addOp<FlattenObj>(x, nullptr, axis)
+                                 ->getOutput(); });
+        }
+
+        PyObject *graphConcat(PyObject *self, PyObject *args)
+        {
+            PyObject *listObj;
+            int axis;
+            if (!PyArg_ParseTuple(args, "Oi:concat", &listObj, &axis))
+                return nullptr;
+            PyObject *seq = PySequence_Fast(listObj, "Expected tensors");
+            if (!seq)
+                return nullptr;
+            TensorVec inputs(PySequence_Fast_GET_SIZE(seq));
+            for (size_t i = 0; i < inputs.size(); ++i)
+                if (!toTensor((PyGraph *)self,
+                              PySequence_Fast_GET_ITEM(seq, i), inputs[i]))
+                {
+                    Py_DECREF(seq);
+                    return nullptr;
+                }
+            Py_DECREF(seq);
+            return buildOp(self, [&](GraphObj *g)
+                           { return g->addOp<ConcatObj>(inputs, nullptr, axis)
+                                 ->getOutput(); });
+        }
+
+        PyObject *graphSoftmax(PyObject *self, PyObject *args)
+        {
+            PyObject *xObj;
+            int axis = -1;
+            Tensor x;
+            if (!PyArg_ParseTuple(args, "O|i:softmax", &xObj, &axis) ||
+                !toTensor((PyGraph *)self, xObj, x))
+                return nullptr;
+            return buildOp(self, [&](GraphObj *g)
+                           { return g->addOp<SoftmaxObj>(x, nullptr, axis)
+                                 ->getOutput(); });
+        }
+
+        PyObject *graphLayerNorm(PyObject *self, PyObject *args,
+                                 PyObject *kwargs)
+        {
+            static const char *kwlist[] = {"x", "scale", "bias", "axis", "eps",
+                                           nullptr};
+            PyObject *xObj, *scaleObj, *biasObj = Py_None;
+            int axis = -1;
+            float eps = 1e-5f;
+            Tensor x, scale, bias;
+            if (!PyArg_ParseTupleAndKeywords(
+                    args, kwargs, "OO|Oif:layer_norm",
+                    const_cast<char **>(kwlist), &xObj, &scaleObj, &biasObj,
+                    &axis, &eps) ||
+                !toTensor((PyGraph *)self, xObj, x) ||
+                !toTensor((PyGraph *)self, scaleObj, scale) ||
+                !toTensor((PyGraph *)self, biasObj, bias, true))
+                return nullptr;
+            return buildOp(self,
+                           [&](GraphObj *g)
+                           {
+                               return g->addOp<LayerNormObj>(x, scale, bias,
+                                                             nullptr, axis, eps)
+                                   ->getOutput();
+                           });
+        }
+
+        PyObject *graphRMSNorm(PyObject *self, PyObject *args,
+                               PyObject *kwargs)
+        {
+            static const char *kwlist[] = {"x", "scale", "axis", "eps",
+                                           nullptr};
+            PyObject *xObj, *scaleObj;
+            int axis = -1;
+            float eps = 1e-5f;
+            Tensor x, scale;
+            if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|if:rms_norm",
+                                             const_cast<char **>(kwlist),
+                                             &xObj, &scaleObj, &axis, &eps) ||
+                !toTensor((PyGraph *)self, xObj, x) ||
+                !toTensor((PyGraph *)self, scaleObj, scale))
+                return nullptr;
+            return buildOp(self,
+                           [&](GraphObj *g)
+                           {
+                               return g->addOp<RMSNormObj>(x, scale, nullptr,
+                                                           axis, eps)
+                                   ->getOutput();
+                           });
+        }
+
+        template <typename T>
+        PyObject *graphReduce(PyObject *self, PyObject *args, PyObject *kwargs)
+        {
+            static const char *kwlist[] = {"x", "axes", "keepdims", nullptr};
+            PyObject *xObj, *axesObj = Py_None;
+            int keepDims = 1;
+            Tensor x;
+            vector<int> axes;
+            if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|Op",
+                                             const_cast<char **>(kwlist),
+                                             &xObj, &axesObj, &keepDims) ||
+                !toTensor((PyGraph *)self, xObj, x) ||
+                (axesObj != Py_None && !toInts(axesObj, axes)))
+                return nullptr;
+            return buildOp(self, [&](GraphObj *g)
+                           { return g->addOp<T>(x, nullptr, axes, keepDims)
+                                 ->getOutput(); });
+        }
+
+        PyObject *graphConv(PyObject *self, PyObject *args, PyObject *kwargs)
+        {
+            static const char *kwlist[] = {"x",         "w",     "bias",
+                                           "pads",      "strides",
+                                           "dilations", "group", nullptr};
+            PyObject *xObj, *wObj, *biasObj = Py_None, *padsObj = nullptr,
+                                   *stridesObj = nullptr,
+                                   *dilationsObj = nullptr;
+            int group = 1;
+            Tensor x, w, bias;
+            vector<int> pads{0, 0, 0, 0}, strides{1, 1}, dilations{1, 1};
+            if (!PyArg_ParseTupleAndKeywords(
+                    args, kwargs, "OO|OOOOi:conv", const_cast<char **>(kwlist),
+                    &xObj, &wObj, &biasObj, &padsObj, &stridesObj,
+                    &dilationsObj, &group) ||
+                !toTensor((PyGraph *)self, xObj, x) ||
+                !toTensor((PyGraph *)self, wObj, w) ||
+                !toTensor((PyGraph *)self, biasObj, bias, true) ||
+                (padsObj && !toInts(padsObj, pads)) ||
+                (stridesObj && !toInts(stridesObj, strides)) ||
+                (dilationsObj && !toInts(dilationsObj, dilations)))
+                return nullptr;
+            return buildOp(self,
+                           [&](GraphObj *g)
+                           {
+                               return g->addOp<ConvObj>(x, w, bias, nullptr,
+                                                        pads, strides,
+                                                        dilations, group)
+                                   ->getOutput();
+                           });
+        }
+
+        template <OpType::underlying_t type>
+        PyObject *graphPool(PyObject *self, PyObject *args, PyObject *kwargs)
+        {
+            static const char *kwlist[] = {"x", "kernel", "pads", "strides",
+                                           "count_include_pad", nullptr};
+            PyObject *xObj, *kernelObj, *padsObj = nullptr,
+                                        *stridesObj = nullptr;
+            int countIncludePad = 0;
+            Tensor x;
+            vector<int> kernel, pads{0, 0, 0, 0}, strides{1, 1};
+            if (!PyArg_ParseTupleAndKeywords(
+                    args, kwargs,
+                    type == OpType::MaxPool ? "OO|OO:max_pool"
+                                            : "OO|OOp:avg_pool",
+                    const_cast<char **>(kwlist), &xObj, &kernelObj, &padsObj,
+                    &stridesObj, &countIncludePad) ||
+                !toTensor((PyGraph *)self, xObj, x) ||
+                !toInts(kernelObj, kernel) ||
+                (padsObj && !toInts(padsObj, pads)) ||
+                (stridesObj && !toInts(stridesObj, strides)))
+                return nullptr;
+            return buildOp(
+                self,
+                [&](GraphObj *g) -> Tensor
+                {
+                    if (type == OpType::MaxPool)
+                        return g->addOp<MaxPoolObj>(x, nullptr, kernel, pads,
+                                                    strides)
+                            ->getOutput();
+                    return g->addOp<AvgPoolObj>(x, nullptr, kernel, pads,
+                                                strides, countIncludePad)
+                        ->getOutput();
+                });
+        }
+
+        PyObject *graphGather(PyObject *self, PyObject *args)
+        {
+            PyObject *dataObj, *indicesObj;
+            int axis = 0;
+            Tensor data, indices;
+            if (!PyArg_ParseTuple(args, "OO|i:gather", &dataObj, &indicesObj,
+                                  &axis) ||
+                !toTensor((PyGraph *)self, dataObj, data) ||
+                !toTensor((PyGraph *)self, indicesObj, indices))
+                return nullptr;
+            return buildOp(self,
+                           [&](GraphObj *g)
+                           {
+                               return g->addOp<GatherObj>(data, indices,
+                                                          nullptr, axis)
+                                   ->getOutput();
+                           });
+        }
+
+        PyObject *graphOptimize(PyObject *self, PyObject *)
+        {
+            if (!withRunLock((PyGraph *)self,
+                             [](const Graph &g) { g->optimize(); }))
+                return nullptr;
+            Py_RETURN_NONE;
+        }
+
+        PyObject *graphDataMalloc(PyObject *self, PyObject *)
+        {
+            if (((PyGraph *)self)->state->exports)
+            {
+                PyErr_SetString(PyExc_BufferError,
+                                "Views of tensor data are still alive");
+                return nullptr;
+            }
+            if (!withRunLock((PyGraph *)self,
+                             [](const Graph &g) { g->dataMalloc(); }))
+                return nullptr;
+            Py_RETURN_NONE;
+        }
+
+        PyObject *graphRun(PyObject *self, PyObject *)
+        {
+            if (!withRunLock((PyGraph *)self, [](const Graph &g)
+                             { g->getRuntime()->run(g); }))
+                return nullptr;
+            Py_RETURN_NONE;
+        }
+
+        PyObject *graphSave(PyObject *self, PyObject *args)
+        {
+            const char *path;
+            if (!PyArg_ParseTuple(args, "s:save", &path))
+                return nullptr;
+            TRY
+            saveGraph(((PyGraph *)self)->state->graph, path);
+            CATCH
+            Py_RETURN_NONE;
+        }
+
+        PyObject *graphMemoryPlan(PyObject *self, PyObject *)
+        {
+            TRY
+            return PyUnicode_FromString(
+                graphOf(self)->getMemoryPlan().toJson().c_str());
+            CATCH
+        }
+
+        PyObject *graphInputs(PyObject *self, void *)
+        {
+            TRY
+            return wrapTensors((PyGraph *)self, graphOf(self)->getInputs());
+            CATCH
+        }
+
+        PyObject *graphOutputs(PyObject *self, void *)
+        {
+            TRY
+            return wrapTensors((PyGraph *)self, graphOf(self)->getOutputs());
+            CATCH
+        }
+
+        PyObject *graphRepr(PyObject *self)
+        {
+            TRY
+            return PyUnicode_FromString(graphOf(self)->toString().c_str());
+            CATCH
+        }
+
+#define METHOD(name, fn, flags, doc) \
+    {name, (PyCFunction)(void (*)(void))(fn), flags, doc}
+
+        PyMethodDef graphMethods[] = {
+            METHOD("tensor", graphTensor, METH_VARARGS | METH_KEYWORDS,
+                   "tensor(shape, dtype='float32')\n--\n\nAdds a tensor."),
+            METHOD("weight", graphWeight, METH_O,
+                   "weight(buffer)\n--\n\nAdds a constant tensor that reads "
+                   "the C-contiguous buffer in place, with its shape and "
+                   "dtype."),
+            METHOD("add", graphBinary<AddObj>, METH_VARARGS, "add(a, b)"),
+            METHOD("sub", graphBinary<SubObj>, METH_VARARGS, "sub(a, b)"),
+            METHOD("mul", graphBinary<MulObj>, METH_VARARGS, "mul(a, b)"),
+            METHOD("div", graphBinary<DivObj>, METH_VARARGS, "div(a, b)"),
+            METHOD("relu", graphUnary<ReluObj>, METH_O, "relu(x)"),
+            METHOD("exp", graphUnary<ExpObj>, METH_O, "exp(x)"),
+            METHOD("sqrt", graphUnary<SqrtObj>, METH_O, "sqrt(x)"),
+            METHOD("clip", graphClip, METH_VARARGS | METH_KEYWORDS,
+                   "clip(x, min=None, max=None)"),
+            METHOD("matmul", graphMatmul, METH_VARARGS | METH_KEYWORDS,
+                   "matmul(a, b, trans_a=False, trans_b=False)"),
+            METHOD("transpose", graphTranspose, METH_VARARGS,
+                   "transpose(x, perm)"),
+            METHOD("reshape", graphReshape, METH_VARARGS, "reshape(x, shape)"),
+            METHOD("flatten", graphFlatten, METH_VARARGS, "flatten(x, axis=1)"),
+            METHOD("concat", graphConcat, METH_VARARGS, "concat(xs, axis)"),
+            METHOD("softmax", graphSoftmax, METH_VARARGS,
+                   "softmax(x, axis=-1)"),
+            METHOD("layer_norm", graphLayerNorm, METH_VARARGS | METH_KEYWORDS,
+                   "layer_norm(x, scale, bias=None, axis=-1, eps=1e-5)"),
+            METHOD("rms_norm", graphRMSNorm, METH_VARARGS | METH_KEYWORDS,
+                   "rms_norm(x, scale, axis=-1, eps=1e-5)"),
+            METHOD("reduce_sum", graphReduce<ReduceSumObj>,
+                   METH_VARARGS | METH_KEYWORDS,
+                   "reduce_sum(x, axes=None, keepdims=True)"),
+            METHOD("reduce_mean", graphReduce<ReduceMeanObj>,
+                   METH_VARARGS | METH_KEYWORDS,
+                   "reduce_mean(x, axes=None, keepdims=True)"),
+            METHOD("reduce_max", graphReduce<ReduceMaxObj>,
+                   METH_VARARGS | METH_KEYWORDS,
+                   "reduce_max(x, axes=None, keepdims=True)"),
+            METHOD("reduce_min", graphReduce<ReduceMinObj>,
+                   METH_VARARGS | METH_KEYWORDS,
+                   "reduce_min(x, axes=None, keepdims=True)"),
+            METHOD("reduce_prod", graphReduce<ReduceProdObj>,
+                   METH_VARARGS | METH_KEYWORDS,
+                   "reduce_prod(x, axes=None, keepdims=True)"),
+            METHOD("conv", graphConv, METH_VARARGS | METH_KEYWORDS,
+                   "conv(x, w, bias=None, pads=(0, 0, 0, 0), strides=(1, 1), "
+                   "dilations=(1, 1), group=1)"),
+            METHOD("max_pool", graphPool<OpType::MaxPool>,
+                   METH_VARARGS | METH_KEYWORDS,
+                   "max_pool(x, kernel, pads=(0, 0, 0, 0), strides=(1, 1))"),
+            METHOD("avg_pool", graphPool<OpType::AveragePool>,
+                   METH_VARARGS | METH_KEYWORDS,
+                   "avg_pool(x, kernel, pads=(0, 0, 0, 0), strides=(1, 1), "
+                   "count_include_pad=False)"),
+            METHOD("global_avg_pool", graphUnary<GlobalAvgPoolObj>, METH_O,
+                   "global_avg_pool(x)"),
+            METHOD("gather", graphGather, METH_VARARGS,
+                   "gather(data, indices, axis=0)"),
+            METHOD("optimize", graphOptimize, METH_NOARGS,
+                   "Applies graph optimizations."),
+            METHOD("data_malloc", graphDataMalloc, METH_NOARGS,
+                   "Allocates tensor data. Fails while views of tensor data "
+                   "exported through the buffer protocol are alive."),
+            METHOD("run", graphRun, METH_NOARGS,
+                   "Runs the graph with the GIL released."),
+            METHOD("save", graphSave, METH_VARARGS,
+                   "save(path)\n--\n\nWrites the graph and its weights."),
+            METHOD("memory_plan", graphMemoryPlan, METH_NOARGS,
+                   "memory_plan()\n--\n\nThe arena layout decided by "
+                   "data_malloc, as JSON."),
+            {nullptr, nullptr, 0, nullptr},
+        };
+
+        PyGetSetDef graphGetSet[] = {
+            {"inputs", graphInputs, nullptr, "Tensors without a source.",
+             nullptr},
+            {"outputs", graphOutputs, nullptr, "Tensors without consumers.",
+             nullptr},
+            {nullptr, nullptr, nullptr, nullptr, nullptr},
+        };
+
+        PyType_Slot graphSlots[] = {
+            {Py_tp_new, (void *)graphNew},
+            {Py_tp_dealloc, (void *)graphDealloc},
+            {Py_tp_repr, (void *)graphRepr},
+            {Py_tp_methods, graphMethods},
+            {Py_tp_getset, graphGetSet},
+            {Py_tp_doc, (void *)"A computation graph on the native CPU "
+                                "runtime."},
+            {0, nullptr},
+        };
+
+        PyType_Spec graphSpec = {"infinitensor.Graph", sizeof(PyGraph), 0,
+                                 Py_TPFLAGS_DEFAULT, graphSlots};
+
+        // ----------------------------------------------------------------
+        // Module
+
+        PyObject *moduleImportOnnx(PyObject *, PyObject *args,
+                                   PyObject *kwargs)
+        {
+            static const char *kwlist[] = {"path", "input_shapes", nullptr};
+            const char *path;
+            PyObject *shapesObj = nullptr;
+            if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|O!:import_onnx",
+                                             const_cast<char **>(kwlist),
+                                             &path, &PyDict_Type, &shapesObj))
+                return nullptr;
+            std::map<string, Shape> shapes;
+            PyObject *key, *value;
+            Py_ssize_t pos = 0;
+            while (shapesObj && PyDict_Next(shapesObj, &pos, &key, &value))
+            {
+                const char *name = PyUnicode_AsUTF8(key);
+                if (!name || !toInts(value, shapes[name]))
+                    return nullptr;
+            }
+            TRY
+            return wrapGraph(
+                importOnnx(NativeCpuRuntimeObj::getInstance(), path, shapes));
+            CATCH
+        }
+
+        PyObject *moduleLoad(PyObject *, PyObject *args)
+        {
+            const char *path;
+            if (!PyArg_ParseTuple(args, "s:load", &path))
+                return nullptr;
+            TRY
+            return wrapGraph(
+                loadGraph(NativeCpuRuntimeObj::getInstance(), path));
+            CATCH
+        }
+
+        PyMethodDef moduleMethods[] = {
+            METHOD("import_onnx", moduleImportOnnx,
+                   METH_VARARGS | METH_KEYWORDS,
+                   "import_onnx(path, input_shapes=None)\n--\n\nBuilds a "
+                   "Graph from an ONNX model, see infini::importOnnx."),
+            METHOD("load", moduleLoad, METH_VARARGS,
+                   "load(path)\n--\n\nLoads a Graph written by Graph.save."),
+            {nullptr, nullptr, 0, nullptr},
+        };
+
+        PyModuleDef moduleDef = {PyModuleDef_HEAD_INIT,
+                                 "infinitensor",
+                                 "Graph building and execution on the native "
+                                 "CPU runtime.",
+                                 -1,
+                                 moduleMethods,
+                                 nullptr,
+                                 nullptr,
+                                 nullptr,
+                                 nullptr};
+
+    } // namespace
+} // namespace infini
+
+PyMODINIT_FUNC PyInit_infinitensor()
+{
+    using namespace infini;
+    PyObject *module = PyModule_Create(&moduleDef);
+    if (!module)
+        return nullptr;
+    GraphType = (PyTypeObject *)PyType_FromSpec(&graphSpec);
+    TensorType = (PyTypeObject *)PyType_FromSpec(&tensorSpec);
+    if (!GraphType || !TensorType ||
+        PyModule_AddObjectRef(module, "Graph", (PyObject *)GraphType) < 0 ||
+        PyModule_AddObjectRef(module, "Tensor", (PyObject *)TensorType) < 0)
+    {
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
@@ -0,0 +1,231 @@
+#include "operators/conv.h"
+#include "core/kernel.h"
+#include "gemm.h"
+#include "operators/reorder.h"
+
+namespace infini
+{
+    /**
+     * @brief 2D convolution with two strategies.
+     *
+     * NCHW convolutions lower every image and group to a GEMM of the weight
+     * [M / group, C / group * kH * kW] with the im2col matrix of the input,
+     * [C / group * kH * kW, oH * oW]. Unpadded 1x1 convolutions with unit
+     * strides use the input as that matrix directly.
+     *
+     * Blocked convolutions run directly on the NCHWc layout. Each task
+     * computes one output row of a block of output channels, a few pixels at
+     * a time, each pixel accumulating all kChannelBlock output channels as
+     * one vector. The weight is repacked to [M / c][C / c][kH][kW][c][c] so
+     * that the inner loops read it contiguously.
+     */
+    class NativeConv : public CpuKernelWithoutConfig
+    {
+        // GEMM tile sizes, see BlockedMatmul.
+        static constexpr size_t kMC = 64, kNC = 256, kKC = 256;
+        // Output pixels per register block of the direct kernel.
+        static constexpr int kPixels = 4;
+
+        template <typename T>
+        static void im2colConv(const Ref<ConvObj> &op)
+        {
+            auto x = op->getInputs(0)->getDims();
+            auto w = op->getInputs(1)->getDims();
+            auto y = op->getOutput()->getDims();
+            const T *in = op->getInputs(0)->getRawDataPtr<T *>();
+            const T *weight = op->getInputs(1)->getRawDataPtr<T *>();
+            T *out = op->getOutput()->getRawDataPtr<T *>();
+            const auto &pads = op->getPads(), &strides = op->getStrides(),
+                       &dilations = op->getDilations();
+            const int group = op->getGroup();
+            const size_t c = x[1], h = x[2], wd = x[3], m = w[0];
+            const size_t cg = c / group, mg = m / group, kh = w[2], kw = w[3];
+            const size_t k = cg * kh * kw, oh = y[2], ow = y[3], p = oh * ow;
+            const bool direct = kh == 1 && kw == 1 && strides[0] == 1 &&
+                                strides[1] == 1 &&
+                                pads == vector<int>{0, 0, 0, 0};
+            vector<T> col(direct ? 0 : k * p);
+            const size_t mTiles = (mg + kMC - 1) / kMC,
+                         nTiles = (p + kNC - 1) / kNC;
+
+            for (int n = 0; n < x[0]; ++n)
+                for (int g = 0; g < group; ++g)
+                {
+                    const T *image = in + (n * c + g * cg) * h * wd;
+                    if (!direct)
+                    {
+                        auto lowerRow = [&](size_t r)
+                        {
+                            const int ci = r / (kh * kw), i = r / kw % kh,
+                                      j = r % kw;
+                            T *dst = col.data() + r * p;
+                            for (size_t py = 0; py < oh; ++py)
+                            {
+                                int iy = py * strides[0] - pads[0] +
+                                         i * dilations[0];
+                                for (size_t px = 0; px < ow; ++px)
+                                {
+                                    int ix = px * strides[1] - pads[1] +
+                                             j * dilations[1];
+                                    dst[py * ow + px] =
+                                        iy >= 0 && iy < (int)h && ix >= 0 &&
+                                                ix < (int)wd
+                                            ? image[(ci * h + iy) * wd + ix]
+                                            : T(0);
+                                }
+                            }
+                        };
+                        parallelFor(k, p, lowerRow);
+                    }
+                    const T *b = direct ? image : col.data();
+                    T *dst = out + (n * m + g * mg) * p;
+                    auto gemmTiles = [&](size_t begin, size_t end)
+                    {
+                        vector<T> packed(kKC * kNC);
+                        for (size_t task = begin; task < end; ++task)
+                        {
+                            size_t i0 = task / nTiles * kMC,
+                                   j0 = task % nTiles * kNC;
+                            gemmTile(i0, std::min(i0 + kMC, mg), j0,
+                                     std::min(j0 + kNC, p) - j0, k, kKC,
+                                     weight + g * mg * k, k, size_t(1), b, p,
+                                     size_t(1), dst, p, packed.data());
+                        }
+                    };
+                    parallelRange(mTiles * nTiles, kMC * kNC * k, gemmTiles);
+                }
+
+            if (auto bias = op->getBias())
+            {
+                const T *bp = bias->getRawDataPtr<T *>();
+                parallelFor(x[0] * m, p,
+                            [&](size_t r)
+                            {
+                                T *row = out + r * p;
+                                for (size_t i = 0; i < p; ++i)
+                                    row[i] += bp[r % m];
+                            });
+            }
+        }
+
+        static void blockedConv(const Ref<ConvObj> &op)
+        {
+            constexpr int cb = kChannelBlock;
+            auto x = op->getInputs(0)->getDims();
+            auto w = op->getInputs(1)->getDims();
+            auto y = op->getOutput()->getDims();
+            const float *in = op->getInputs(0)->getRawDataPtr<float *>();
+            const float *weight = op->getInputs(1)->getRawDataPtr<float *>();
+            float *out = op->getOutput()->getRawDataPtr<float *>();
+            const auto &pads = op->getPads(), &strides = op->getStrides();
+            const int cBlocks = x[1], h = x[2], wd = x[3];
+            const int mBlocks = y[1], oh = y[2], ow = y[3];
+            const int kh = w[2], kw = w[3], c = cBlocks * cb;
+            const int sh = strides[0], sw = strides[1];
+
+            vector<float> packed(op->getInputs(1)->size());
+            auto packBlock = [&](int mb)
+            {
+                for (int ic = 0; ic < cBlocks; ++ic)
+                    for (int i = 0; i < kh; ++i)
+                        for (int j = 0; j < kw; ++j)
+                        {
+                            float *dst = packed.data() +
+                                         (((mb * cBlocks + ic) * kh + i) * kw +
+                                          j) *
+                                             cb * cb;
+                            for (int ci = 0; ci < cb; ++ci)
+                                for (int co = 0; co < cb; ++co)
+                                    dst[ci * cb + co] =
+                                        weight[(((mb * cb + co) * c +
+                                                 ic * cb + ci) *
+                                                    kh +
+                                                i) *
+                                                   kw +
+                                               j];
+                        }
+            };
+            parallelFor(mBlocks, c * kh * kw * cb, packBlock);
+            const float *bias = op->getBias()
+                                    ? op->getBias()->getRawDataPtr<float *>()
+                                    : nullptr;
+
+            auto outputRow = [&](int task)
+            {
+                const int n = task / (mBlocks * oh), mb = task / oh % mBlocks,
+                          py = task % oh;
+                float *dst = out + (((n * mBlocks + mb) * oh + py) * ow) * cb;
+                for (int px0 = 0; px0 < ow; px0 += kPixels)
+                {
+                    const int np = std::min(kPixels, ow - px0);
+                    float acc[kPixels][cb];
+                    for (int t = 0; t < kPixels; ++t)
+                        for (int co = 0; co < cb; ++co)
+                            acc[t][co] = bias ? bias[mb * cb + co] : 0.f;
+                    for (int ic = 0; ic < cBlocks; ++ic)
+                        for (int i = 0; i < kh; ++i)
+                        {
+                            const int iy = py * sh - pads[0] + i;
+                            if (iy < 0 || iy >= h)
+                                continue;
+                            const float *row =
+                                in + (((n * cBlocks + ic) * h + iy) * wd) * cb;
+                            for (int j = 0; j < kw; ++j)
+                            {
+                                const float *wb =
+                                    packed.data() +
+                                    (((mb * cBlocks + ic) * kh + i) * kw + j) *
+                                        cb * cb;
+                                for (int t = 0; t < np; ++t)
+                                {
+                                    const int ix = (px0 + t) * sw - pads[1] + j;
+                                    if (ix < 0 || ix >= wd)
+                                        continue;
+                                    const float *pix = row + ix * cb;
+                                    for (int ci = 0; ci < cb; ++ci)
+                                    {
+                                        const float v = pix[ci];
+#pragma omp simd
+                                        for (int co = 0; co < cb; ++co)
+                                            acc[t][co] += v * wb[ci * cb + co];
+                                    }
+                                }
+                            }
+                        }
+                    for (int t = 0; t < np; ++t)
+                        std::copy(acc[t], acc[t] + cb, dst + (px0 + t) * cb);
+                }
+            };
+            // An output row costs ow * cb * c * kh * kw multiply-adds.
+            parallelFor(x[0] * mBlocks * oh, ow * cb * c * kh * kw, outputRow);
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<ConvObj>(_op);
+            if (op->isBlocked())
+            {
+                IT_ASSERT(op->hasBlockedKernel());
+                return blockedConv(op);
+            }
+#define CASE(N) \
+    case N:     \
+        im2colConv<DT<N>::t>(op)
+
+            int dataTypeIdx = _op->getDType().getIndex();
+            switch (dataTypeIdx)
+            {
+                CASE(1); // DataType::Float32
+                break;
+                CASE(12); // DataType::UInt32
+                break;
+            default:
+                IT_TODO_HALT();
+            }
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::Conv, NativeConv, "Conv_CPU");
+
+}; // namespace infini
@@ -4,7 +4,7 @@
 
 namespace infini
 {
-    class NativeElementWise : public CpuKernelWithoutConfig
+    class NativeElementWise : public CpuKernelWithConfig
     {
         template <typename T>
         static T addCompute(T val0, T val1)
@@ -30,8 +30,8 @@ namespace infini
             return (T)(val0 / val1);
         }
 
-        template <typename T>
-        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        template <typename T, T (*F)(T, T)>
+        static void binary(const Operator &_op, size_t grain)
         {
             auto op = as<ElementWiseObj>(_op);
             T *inptr0 = op->getInputs(0)->getRawDataPtr<T *>();
@@ -41,63 +41,99 @@ namespace infini
             auto shapeA = op->getInputs(0)->getDims();
             auto shapeB = op->getInputs(1)->getDims();
             auto shapeC = op->getOutput()->getDims();
+            const size_t n = op->getOutput()->size();
+            const size_t nChunks = (n + grain - 1) / grain;
+
+            if (shapeA == shapeC && shapeB == shapeC &&
+                op->getInputs(0)->isContiguous() &&
+                op->getInputs(1)->isContiguous())
+            {
+                parallelFor(nChunks, grain,
+                            [&](size_t chunk)
+                            {
+                                size_t end = std::min((chunk + 1) * grain, n);
+                                for (size_t i = chunk * grain; i < end; ++i)
+                                    outptr[i] = F(inptr0[i], inptr1[i]);
+                            });
+                return;
+            }
+
+            // Element strides of the inputs along the output dims, 0 where
+            // broadcast. Inputs may be views.
             auto rank = op->getOutput()->getRank();
-            Shape a(rank, 1);
-            Shape b(rank, 1);
-            std::copy(shapeA.begin(), shapeA.end(),
-                      a.begin() + (rank - shapeA.size()));
-            std::copy(shapeB.begin(), shapeB.end(),
-                      b.begin() + (rank - shapeB.size()));
-            auto getStride = [&](const Shape &shape)
+            auto getStride = [&](const Tensor &t)
             {
-                int p = 1;
-                Shape stride(rank);
-                for (auto i = rank; i > 0; --i)
-                {
-                    stride[i - 1] = p;
-                    p = p * shape[i - 1];
-                }
-                return stride;
+                auto dims = t->getDims();
+                const auto &stride = t->getStride();
+                Shape ret(rank, 0);
+                size_t shift = rank - dims.size();
+                for (size_t i = 0; i < dims.size(); ++i)
+                    if (dims[i] != 1)
+                        ret[i + shift] = stride[i];
+                return ret;
             };
-            Shape strideA = getStride(a);
-            Shape strideB = getStride(b);
+            Shape strideA = getStride(op->getInputs(0));
+            Shape strideB = getStride(op->getInputs(1));
+
+            parallelFor(nChunks, grain,
+                        [&](size_t chunk)
+                        {
+                            size_t end = std::min((chunk + 1) * grain, n);
+                            for (size_t i = chunk * grain; i < end; ++i)
+                            {
+                                size_t indexA = 0, indexB = 0;
+                                for (size_t d = rank, rest = i; d > 0; --d)
+                                {
+                                    size_t pos = rest % shapeC[d - 1];
+                                    rest /= shapeC[d - 1];
+                                    indexA += pos * strideA[d - 1];
+                                    indexB += pos * strideB[d - 1];
+                                }
+                                outptr[i] = F(inptr0[indexA], inptr1[indexB]);
+                            }
+                        });
+        }
 
-            auto n = op->getOutput()->size();
-            T (*_doCompute)
-            (T val0, T val1);
+        template <typename T>
+        void doCompute(const Operator &op, const KernelConfig &config) const
+        {
+            size_t grain = config[0];
             switch (op->getOpType().underlying())
             {
             case OpType::Add:
-                _doCompute = addCompute<T>;
-                break;
+                return binary<T, addCompute<T>>(op, grain);
             case OpType::Sub:
-                _doCompute = subCompute<T>;
-                break;
+                return binary<T, subCompute<T>>(op, grain);
             case OpType::Mul:
-                _doCompute = mulCompute<T>;
-                break;
+                return binary<T, mulCompute<T>>(op, grain);
             case OpType::Div:
-                _doCompute = divCompute<T>;
-                break;
+                return binary<T, divCompute<T>>(op, grain);
             default:
                 IT_TODO_HALT();
             }
+        }
 
-            for (size_t i = 0; i < n; ++i)
+    public:
+        // Config {grain}: elements per parallel chunk.
+        vector<KernelConfig> getSearchSpace(const Operator &op) const override
+        {
+            const int n = std::max<int>(op->getOutput()->size(), 1);
+            vector<KernelConfig> space;
+            for (int grain : {4096, 1024, 16384, 65536})
             {
-                auto shapeIndexC = locate_index(i, shapeC);
-                auto indexA = delocate_index(shapeIndexC, a, strideA);
-                auto indexB = delocate_index(shapeIndexC, b, strideB);
-                outptr[i] = _doCompute(inptr0[indexA], inptr1[indexB]);
+                KernelConfig config = {std::min(grain, n)};
+                if (std::find(space.begin(), space.end(), config) == space.end())
+                    space.emplace_back(config);
             }
+            return space;
         }
 
-        void compute(const Operator &_op,
-                     const RuntimeObj *context) const override
+        void computeWithConfig(const Operator &_op, const KernelConfig &config,
+                               const RuntimeObj *context) const override
         {
 #define CASE(N) \
     case N:     \
-        doCompute<DT<N>::t>(_op, context)
+        doCompute<DT<N>::t>(_op, config)
 
             int dataTypeIdx = _op->getDType().getIndex();
             switch (dataTypeIdx)
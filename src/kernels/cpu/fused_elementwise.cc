@@ -0,0 +1,74 @@
+#include "operators/fused_elementwise.h"
+#include "core/elementwise_jit.h"
+#include "core/kernel.h"
+
+namespace infini
+{
+    class NativeFusedElementwise : public CpuKernelWithoutConfig
+    {
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<FusedElementwiseObj>(_op);
+            if (op->getOutput()->size() == 0)
+                return;
+            const auto &expr = op->getExpr();
+            const auto rows = op->getRows();
+            const size_t nInputs = op->numInputs(), rank = rows.dims.size();
+            const size_t inner = rows.dims.back();
+            const size_t outer = op->getOutput()->size() / inner;
+            float *outptr = op->getOutput()->getRawDataPtr<float *>();
+            vector<const float *> inptrs;
+            vector<ptrdiff_t> steps;
+            for (size_t k = 0; k < nInputs; ++k)
+            {
+                inptrs.emplace_back(op->getInputs(k)->getRawDataPtr<float *>());
+                steps.emplace_back(rows.strides[k].back());
+            }
+            // Interpreted if no compiled kernel is available.
+            auto kernel = ElementwiseJit::getInstance().get(*op);
+
+            // Elements [begin, end) of row r.
+            auto run = [&](size_t r, size_t begin, size_t end,
+                           const float **x)
+            {
+                for (size_t k = 0; k < nInputs; ++k)
+                {
+                    size_t offset = begin * steps[k];
+                    const auto &stride = rows.strides[k];
+                    for (size_t d = rank - 1, rest = r; d > 0; --d)
+                    {
+                        offset += rest % rows.dims[d - 1] * stride[d - 1];
+                        rest /= rows.dims[d - 1];
+                    }
+                    x[k] = inptrs[k] + offset;
+                }
+                float *y = outptr + r * inner + begin;
+                if (kernel)
+                    kernel(x, y, end - begin);
+                else
+                    expr.evaluate(x, steps.data(), y, end - begin);
+            };
+            const size_t cost = expr.nodes.size();
+            if (outer == 1)
+                parallelRange(inner, cost,
+                              [&](size_t begin, size_t end)
+                              {
+                                  vector<const float *> x(nInputs);
+                                  run(0, begin, end, x.data());
+                              });
+            else
+                parallelRange(outer, inner * cost,
+                              [&](size_t begin, size_t end)
+                              {
+                                  vector<const float *> x(nInputs);
+                                  for (size_t r = begin; r < end; ++r)
+                                      run(r, 0, inner, x.data());
+                              });
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::FusedElementwise,
+                    NativeFusedElementwise, "FusedElementwise_CPU");
+
+} // namespace infini
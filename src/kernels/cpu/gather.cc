@@ -0,0 +1,149 @@
+#include "operators/gather.h"
+#include "core/kernel.h"
+#include <cstring>
+
+namespace infini
+{
+    namespace
+    {
+        // Rows are prefetched this many indices ahead of the copy, which is
+        // about the number of misses a core keeps in flight.
+        constexpr size_t kPrefetchDistance = 8;
+        // Long rows are only partly prefetched; the hardware prefetcher
+        // follows the rest.
+        constexpr size_t kPrefetchBytes = 512;
+
+        inline void prefetchRow(const char *row, size_t bytes)
+        {
+            for (size_t off = 0; off < std::min(bytes, kPrefetchBytes);
+                 off += 64)
+                __builtin_prefetch(row + off);
+        }
+
+        // Indices into an axis of `size`, negative ones wrapped.
+        template <typename I>
+        vector<size_t> rowsOf(const Tensor &indices, size_t size)
+        {
+            const I *p = indices->getRawDataPtr<I *>();
+            vector<size_t> rows(indices->size());
+            for (size_t i = 0; i < rows.size(); ++i)
+            {
+                int64_t index = p[i] < 0 ? p[i] + int64_t(size) : p[i];
+                IT_ASSERT(index >= 0 && index < int64_t(size),
+                          "Index " + std::to_string(p[i]) + " out of range");
+                rows[i] = index;
+            }
+            return rows;
+        }
+
+        vector<size_t> rowsOf(const Tensor &indices, size_t size)
+        {
+            if (indices->getDType() == DataType::Int32)
+                return rowsOf<int32_t>(indices, size);
+            return rowsOf<int64_t>(indices, size);
+        }
+    } // namespace
+
+    /**
+     * @brief Copies whole slices [data.shape[axis + 1:]] with memcpy, one per
+     * task, parallel over outer slices and indices. Upcoming source rows are
+     * prefetched since random rows of large tables miss the cache.
+     */
+    class NativeGather : public CpuKernelWithoutConfig
+    {
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<GatherObj>(_op);
+            const auto &dims = op->getInputs(0)->getDims();
+            const int axis = op->getAxis();
+            size_t outer = 1, inner = op->getDType().getSize();
+            for (int i = 0; i < axis; ++i)
+                outer *= dims[i];
+            for (size_t i = axis + 1; i < dims.size(); ++i)
+                inner *= dims[i];
+            const size_t axisSize = dims[axis];
+            auto rows = rowsOf(op->getInputs(1), axisSize);
+            const size_t n = rows.size();
+            const char *in = op->getInputs(0)->getRawDataPtr<char *>();
+            char *out = op->getOutput()->getRawDataPtr<char *>();
+
+            auto copyRow = [&](size_t task)
+            {
+                const size_t o = task / n, i = task % n;
+                if (i + kPrefetchDistance < n)
+                    prefetchRow(in + (o * axisSize +
+                                      rows[i + kPrefetchDistance]) *
+                                         inner,
+                                inner);
+                std::memcpy(out + task * inner,
+                            in + (o * axisSize + rows[i]) * inner, inner);
+            };
+            parallelFor(outer * n, inner, copyRow);
+        }
+    };
+
+    /**
+     * @brief Sums table rows into each bag directly, parallel over bags,
+     * prefetching rows ahead like NativeGather.
+     */
+    class NativeEmbeddingBag : public CpuKernelWithoutConfig
+    {
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<EmbeddingBagObj>(_op);
+            const auto &table = op->getInputs(0)->getDims();
+            const size_t d = table[1];
+            auto rows = rowsOf(op->getInputs(1), table[0]);
+            const size_t len = op->getInputs(1)->getDims().back();
+            const size_t bags = len ? rows.size() / len : 0;
+            const T *in = op->getInputs(0)->getRawDataPtr<T *>();
+            T *out = op->getOutput()->getRawDataPtr<T *>();
+            if (!len)
+                std::fill(out, out + op->getOutput()->size(), T(0));
+
+            auto sumBag = [&](size_t b)
+            {
+                T *dst = out + b * d;
+                std::fill(dst, dst + d, T(0));
+                for (size_t l = b * len; l < (b + 1) * len; ++l)
+                {
+                    if (l + kPrefetchDistance < rows.size())
+                        prefetchRow(reinterpret_cast<const char *>(
+                                        in + rows[l + kPrefetchDistance] * d),
+                                    d * sizeof(T));
+                    const T *src = in + rows[l] * d;
+#pragma omp simd
+                    for (size_t j = 0; j < d; ++j)
+                        dst[j] += src[j];
+                }
+            };
+            parallelFor(bags, len * d, sumBag);
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+#define CASE(N) \
+    case N:     \
+        doCompute<DT<N>::t>(_op, context)
+
+            int dataTypeIdx = _op->getDType().getIndex();
+            switch (dataTypeIdx)
+            {
+                CASE(1); // DataType::Float32
+                break;
+                CASE(12); // DataType::UInt32
+                break;
+            default:
+                IT_TODO_HALT();
+            }
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::Gather, NativeGather, "Gather_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::EmbeddingBag, NativeEmbeddingBag,
+                    "EmbeddingBag_CPU");
+
+}; // namespace infini
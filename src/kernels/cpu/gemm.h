@@ -0,0 +1,46 @@
+#pragma once
+#include "core/common.h"
+#include <algorithm>
+
+namespace infini
+{
+    /**
+     * @brief Computes the tile of C = A * B spanning rows [i0, iEnd) and
+     * columns [j0, j0 + nb). A(i, k) is at a[i * aRow + k * aCol], B(k, j) at
+     * b[k * bRow + j * bCol] and C(i, j) at c[i * ldc + j]. The tile
+     * accumulates over panels of B at most kc deep, each packed into
+     * contiguous rows of `packed`, which holds kc * nb elements.
+     */
+    template <typename T>
+    void gemmTile(size_t i0, size_t iEnd, size_t j0, size_t nb, size_t k,
+                  size_t kc, const T *a, size_t aRow, size_t aCol, const T *b,
+                  size_t bRow, size_t bCol, T *c, size_t ldc, T *packed)
+    {
+        for (size_t i = i0; i < iEnd; ++i)
+            std::fill(c + i * ldc + j0, c + i * ldc + j0 + nb, T(0));
+        for (size_t k0 = 0; k0 < k; k0 += kc)
+        {
+            size_t kb = std::min(k0 + kc, k) - k0;
+            for (size_t kk = 0; kk < kb; ++kk)
+            {
+                const T *src = b + (k0 + kk) * bRow + j0 * bCol;
+                T *dst = packed + kk * nb;
+                for (size_t j = 0; j < nb; ++j)
+                    dst[j] = src[j * bCol];
+            }
+            for (size_t i = i0; i < iEnd; ++i)
+            {
+                const T *ai = a + i * aRow + k0 * aCol;
+                T *ci = c + i * ldc + j0;
+                for (size_t kk = 0; kk < kb; ++kk)
+                {
+                    const T av = ai[kk * aCol];
+                    const T *bp = packed + kk * nb;
+                    for (size_t j = 0; j < nb; ++j)
+                        ci[j] += av * bp[j];
+                }
+            }
+        }
+    }
+
+} // namespace infini
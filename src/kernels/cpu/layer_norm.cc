@@ -0,0 +1,124 @@
+#include "operators/layer_norm.h"
+#include "core/kernel.h"
+#include <cmath>
+
+namespace infini
+{
+    namespace
+    {
+        constexpr int kLanes = 8;
+
+        // Welford's mean and variance with one running state per lane, merged
+        // pairwise at the end (Chan et al.). The row is read once.
+        void meanVar(const float *x, size_t n, float &mean, float &var)
+        {
+            float count[kLanes] = {}, mu[kLanes] = {}, m2[kLanes] = {};
+            size_t i = 0;
+            for (size_t c = 1; i + kLanes <= n; i += kLanes, ++c)
+            {
+                const float inv = 1.f / c;
+#pragma omp simd
+                for (int k = 0; k < kLanes; ++k)
+                {
+                    float delta = x[i + k] - mu[k];
+                    mu[k] += delta * inv;
+                    m2[k] += delta * (x[i + k] - mu[k]);
+                }
+            }
+            for (int k = 0; k < kLanes; ++k)
+                count[k] = i / kLanes;
+            for (; i < n; ++i)
+            {
+                count[0] += 1;
+                float delta = x[i] - mu[0];
+                mu[0] += delta / count[0];
+                m2[0] += delta * (x[i] - mu[0]);
+            }
+            for (int w = kLanes / 2; w > 0; w /= 2)
+                for (int k = 0; k < w; ++k)
+                {
+                    float total = count[k] + count[k + w];
+                    if (total == 0)
+                        continue;
+                    float delta = mu[k + w] - mu[k];
+                    float ratio = count[k + w] / total;
+                    mu[k] += delta * ratio;
+                    m2[k] += m2[k + w] + delta * delta * count[k] * ratio;
+                    count[k] = total;
+                }
+            mean = mu[0];
+            var = m2[0] / n;
+        }
+
+        float meanSquare(const float *x, size_t n)
+        {
+            float acc[kLanes] = {};
+            size_t i = 0;
+            for (; i + kLanes <= n; i += kLanes)
+#pragma omp simd
+                for (int k = 0; k < kLanes; ++k)
+                    acc[k] += x[i + k] * x[i + k];
+            for (; i < n; ++i)
+                acc[0] += x[i] * x[i];
+            for (int w = kLanes / 2; w > 0; w /= 2)
+                for (int k = 0; k < w; ++k)
+                    acc[k] += acc[k + w];
+            return acc[0] / n;
+        }
+    } // namespace
+
+    /**
+     * @brief LayerNorm and RMSNorm with rows processed in parallel. Each row
+     * is read once for its statistics and once more to write the output.
+     */
+    class NativeNorm : public CpuKernelWithoutConfig
+    {
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<NormObj>(_op);
+            IT_ASSERT(op->getDType() == DataType::Float32,
+                      "Normalization only supports Float32");
+            // Rows would divide by zero columns.
+            if (op->getOutput()->size() == 0)
+                return;
+            const float *x = op->getInputs(0)->getRawDataPtr<float *>();
+            const float *scale = op->getInputs(1)->getRawDataPtr<float *>();
+            const float *bias = op->numInputs() > 2
+                                    ? op->getInputs(2)->getRawDataPtr<float *>()
+                                    : nullptr;
+            float *y = op->getOutput()->getRawDataPtr<float *>();
+            const size_t cols = op->getInputs(1)->size(),
+                         rows = op->getInputs(0)->size() / cols;
+            const bool rms = op->getOpType() == OpType::RMSNorm;
+            const float eps = op->getEps();
+
+            auto normalizeRow = [&](size_t r)
+            {
+                const float *in = x + r * cols;
+                float *out = y + r * cols;
+                float mean = 0, var;
+                if (rms)
+                    var = meanSquare(in, cols);
+                else
+                    meanVar(in, cols, mean, var);
+                const float rstd = 1.f / std::sqrt(var + eps);
+                // in may alias out, each element is read before it is written.
+                if (bias)
+#pragma omp simd
+                    for (size_t j = 0; j < cols; ++j)
+                        out[j] = (in[j] - mean) * rstd * scale[j] + bias[j];
+                else
+#pragma omp simd
+                    for (size_t j = 0; j < cols; ++j)
+                        out[j] = (in[j] - mean) * rstd * scale[j];
+            };
+            parallelFor(rows, cols, normalizeRow);
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::LayerNorm, NativeNorm,
+                    "LayerNorm_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::RMSNorm, NativeNorm, "RMSNorm_CPU");
+
+}; // namespace infini
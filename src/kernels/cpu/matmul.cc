@@ -0,0 +1,214 @@
+#include "operators/matmul.h"
+#include "core/kernel.h"
+#include "gemm.h"
+#include "utils/operator_utils.h"
+
+namespace infini
+{
+    // Element strides of A(i, kk) or B(kk, j) in the last two dims, read from
+    // the tensor so that transposed views need no copy.
+    static pair<size_t, size_t> matStrides(const Tensor &t, bool trans)
+    {
+        const auto &stride = t->getStride();
+        size_t row = stride[stride.size() - 2], col = stride[stride.size() - 1];
+        return trans ? std::make_pair(col, row) : std::make_pair(row, col);
+    }
+
+    /**
+     * @brief Blocked GEMM. Config {MC, NC, KC}: the output is split into
+     * MC x NC tiles computed in parallel, and each tile accumulates over KC
+     * deep panels of B packed into contiguous rows. A and B are read through
+     * their strides and may be views.
+     */
+    class BlockedMatmul : public CpuKernelWithConfig
+    {
+        template <typename T>
+        void doCompute(const Operator &_op, const KernelConfig &config) const
+        {
+            auto op = as<MatmulObj>(_op);
+            auto A = op->getInputs(0), B = op->getInputs(1);
+            auto C = op->getOutput();
+            // The batch count divides by M x N.
+            if (C->size() == 0)
+                return;
+            T *aPtr = A->getRawDataPtr<T *>();
+            T *bPtr = B->getRawDataPtr<T *>();
+            T *cPtr = C->getRawDataPtr<T *>();
+            const size_t m = op->getM(), n = op->getN(), k = op->getK();
+            const size_t mc = config[0], nc = config[1], kc = config[2];
+
+            const auto [aRow, aCol] = matStrides(A, op->getTransA());
+            const auto [bRow, bCol] = matStrides(B, op->getTransB());
+
+            // Strides of A and B along the output batch dims, 0 if broadcast.
+            auto cDims = C->getDims();
+            Shape batch(cDims.begin(), cDims.end() - 2);
+            auto batchStrides = [&](const Tensor &t)
+            {
+                auto dims = t->getDims();
+                const auto &stride = t->getStride();
+                Shape ret(batch.size(), 0);
+                size_t shift = batch.size() - (dims.size() - 2);
+                for (size_t i = 0; i + 2 < dims.size(); ++i)
+                    if (dims[i] != 1)
+                        ret[i + shift] = stride[i];
+                return ret;
+            };
+            const Shape aStride = batchStrides(A), bStride = batchStrides(B);
+            const size_t nBatch = C->size() / (m * n);
+            const size_t mTiles = (m + mc - 1) / mc, nTiles = (n + nc - 1) / nc;
+            const size_t nTasks = nBatch * mTiles * nTiles;
+
+            auto gemmTiles = [&](size_t begin, size_t end)
+            {
+                vector<T> packed(kc * nc);
+                for (size_t task = begin; task < end; ++task)
+                {
+                    size_t b = task / (mTiles * nTiles);
+                    size_t i0 = (task / nTiles) % mTiles * mc,
+                           j0 = task % nTiles * nc;
+                    size_t iEnd = std::min(i0 + mc, m),
+                           nb = std::min(j0 + nc, n) - j0;
+                    size_t aOffset = 0, bOffset = 0;
+                    for (size_t d = batch.size(), rest = b; d > 0; --d)
+                    {
+                        size_t pos = rest % batch[d - 1];
+                        rest /= batch[d - 1];
+                        aOffset += pos * aStride[d - 1];
+                        bOffset += pos * bStride[d - 1];
+                    }
+                    gemmTile(i0, iEnd, j0, nb, k, kc, aPtr + aOffset, aRow,
+                             aCol, bPtr + bOffset, bRow, bCol,
+                             cPtr + b * m * n, n, packed.data());
+                }
+            };
+            parallelRange(nTasks, mc * nc * k, gemmTiles);
+        }
+
+    public:
+        vector<KernelConfig> getSearchSpace(const Operator &_op) const override
+        {
+            auto op = as<MatmulObj>(_op);
+            const int m = op->getM(), n = op->getN(), k = op->getK();
+            const vector<KernelConfig> candidates = {
+                {64, 256, 256}, {32, 128, 128}, {64, 64, 256},
+                {128, 256, 128}, {32, 512, 256}, {128, 128, 512},
+                {16, 1024, 128}, {256, 64, 64}};
+            vector<KernelConfig> space;
+            for (auto &c : candidates)
+            {
+                KernelConfig clamped = {std::max(std::min(c[0], m), 1),
+                                        std::max(std::min(c[1], n), 1),
+                                        std::max(std::min(c[2], k), 1)};
+                if (std::find(space.begin(), space.end(), clamped) == space.end())
+                    space.emplace_back(clamped);
+            }
+            return space;
+        }
+
+        string getTuningAttrs(const Operator &_op) const override
+        {
+            auto op = as<MatmulObj>(_op);
+            return std::to_string(op->getTransA()) +
+                   std::to_string(op->getTransB());
+        }
+
+        void computeWithConfig(const Operator &_op, const KernelConfig &config,
+                               const RuntimeObj *context) const override
+        {
+#define CASE(N) \
+    case N:     \
+        doCompute<DT<N>::t>(_op, config)
+
+            int dataTypeIdx = _op->getDType().getIndex();
+            switch (dataTypeIdx)
+            {
+                CASE(1); // DataType::Float32
+                break;
+                CASE(12); // DataType::UInt32
+                break;
+            default:
+                IT_TODO_HALT();
+            }
+        }
+    };
+
+    /**
+     * @brief Matrix-vector product for a single row of A, e.g. a decoding
+     * step. Streams B once without packing it: rows of B scaled and summed
+     * if they are contiguous, dot products with its columns otherwise.
+     */
+    class Gemv : public CpuKernelWithoutConfig
+    {
+        template <typename T> void doCompute(const Operator &_op) const
+        {
+            auto op = as<MatmulObj>(_op);
+            auto A = op->getInputs(0), B = op->getInputs(1);
+            const T *a = A->getRawDataPtr<T *>();
+            const T *b = B->getRawDataPtr<T *>();
+            T *c = op->getOutput()->getRawDataPtr<T *>();
+            const size_t n = op->getN(), k = op->getK();
+            const size_t aCol = matStrides(A, op->getTransA()).second;
+            const auto [bRow, bCol] = matStrides(B, op->getTransB());
+
+            if (bCol == 1)
+                parallelRange(n, k,
+                              [&](size_t j0, size_t j1)
+                              {
+                                  std::fill(c + j0, c + j1, T(0));
+                                  for (size_t kk = 0; kk < k; ++kk)
+                                  {
+                                      const T av = a[kk * aCol];
+                                      const T *bk = b + kk * bRow;
+#pragma omp simd
+                                      for (size_t j = j0; j < j1; ++j)
+                                          c[j] += av * bk[j];
+                                  }
+                              });
+            else
+                parallelRange(n, k,
+                              [&](size_t j0, size_t j1)
+                              {
+                                  for (size_t j = j0; j < j1; ++j)
+                                  {
+                                      const T *bj = b + j * bCol;
+                                      T sum = 0;
+#pragma omp simd reduction(+ : sum)
+                                      for (size_t kk = 0; kk < k; ++kk)
+                                          sum += a[kk * aCol] * bj[kk];
+                                      c[j] = sum;
+                                  }
+                              });
+        }
+
+    public:
+        // One output row, i.e. no batch, and B contiguous along n or k.
+        static bool applies(const OperatorObj &_op)
+        {
+            auto &op = static_cast<const MatmulObj &>(_op);
+            if (op.getM() != 1 ||
+                op.getOutput()->size() != size_t(op.getN()))
+                return false;
+            auto [bRow, bCol] = matStrides(op.getInputs(1), op.getTransB());
+            return bRow == 1 || bCol == 1;
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            int dataTypeIdx = _op->getDType().getIndex();
+            if (dataTypeIdx == 1) // DataType::Float32
+                doCompute<float>(_op);
+            else if (dataTypeIdx == 12) // DataType::UInt32
+                doCompute<uint32_t>(_op);
+            else
+                IT_TODO_HALT();
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::MatMul, BlockedMatmul,
+                    "MatmulBlocked_CPU");
+    REGISTER_KERNEL_IF(Device::CPU, OpType::MatMul, Gemv, "MatmulGemv_CPU", 1,
+                       Gemv::applies);
+
+}; // namespace infini
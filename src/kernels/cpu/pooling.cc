@@ -0,0 +1,203 @@
+#include "operators/pooling.h"
+#include "core/kernel.h"
+#include "operators/reorder.h"
+
+namespace infini
+{
+    namespace
+    {
+        template <typename T>
+        struct MaxOp
+        {
+            static T identity() { return std::numeric_limits<T>::lowest(); }
+            static T combine(T a, T b) { return a > b ? a : b; }
+        };
+
+        template <typename T>
+        struct SumOp
+        {
+            static T identity() { return T(0); }
+            static T combine(T a, T b) { return a + b; }
+        };
+
+        int ceilDiv(int a, int b) { return a >= 0 ? (a + b - 1) / b : -(-a / b); }
+
+        // Window positions [lo, hi) of output `o` that fall inside [0, size).
+        pair<int, int> clipWindow(int o, int stride, int pad, int k, int size)
+        {
+            int start = o * stride - pad;
+            return {std::max(0, -start), std::min(k, size - start)};
+        }
+    } // namespace
+
+    /**
+     * @brief Max and average pooling. Window bounds are clipped to the image
+     * once per output row or column, so padding costs no per-element
+     * branches.
+     *
+     * In NCHW every task pools one row of an image plane, vectorized across
+     * the output columns of each window column. In NCHWc every task pools
+     * one row of a channel block, vectorized across the channels of a block.
+     * Global average pooling of NCHW reduces each plane contiguously.
+     */
+    class NativePooling : public CpuKernelWithoutConfig
+    {
+        struct Geometry
+        {
+            int h, w, oh, ow, kh, kw, sh, sw, pt, pl;
+            bool countIncludePad;
+
+            // Divisor of averages at output (py, px).
+            int count(int py, int px) const
+            {
+                if (countIncludePad)
+                    return kh * kw;
+                auto rows = clipWindow(py, sh, pt, kh, h);
+                auto cols = clipWindow(px, sw, pl, kw, w);
+                return (rows.second - rows.first) * (cols.second - cols.first);
+            }
+        };
+
+        template <typename T, typename Op>
+        static void poolPlain(const T *in, T *out, size_t planes,
+                              const Geometry &g, bool average)
+        {
+            auto poolRow = [&](size_t task)
+            {
+                const int py = task % g.oh;
+                const T *plane = in + task / g.oh * g.h * g.w;
+                T *dst = out + task * g.ow;
+                std::fill(dst, dst + g.ow, Op::identity());
+                auto rows = clipWindow(py, g.sh, g.pt, g.kh, g.h);
+                for (int i = rows.first; i < rows.second; ++i)
+                {
+                    const T *row = plane + (py * g.sh - g.pt + i) * g.w;
+                    for (int j = 0; j < g.kw; ++j)
+                    {
+                        // Columns px with 0 <= px * sw - pl + j < w.
+                        const int lo = std::max(0, ceilDiv(g.pl - j, g.sw));
+                        const int hi =
+                            std::min(g.ow, ceilDiv(g.w + g.pl - j, g.sw));
+                        const T *src = row - g.pl + j;
+                        const int sw = g.sw;
+#pragma omp simd
+                        for (int px = lo; px < hi; ++px)
+                            dst[px] = Op::combine(dst[px], src[px * sw]);
+                    }
+                }
+                if (average)
+                    for (int px = 0; px < g.ow; ++px)
+                        dst[px] /= T(g.count(py, px));
+            };
+            parallelFor(planes * g.oh, g.ow * g.kh * g.kw, poolRow);
+        }
+
+        template <typename T, typename Op>
+        static void poolBlocked(const T *in, T *out, size_t blocks,
+                                const Geometry &g, bool average)
+        {
+            constexpr int cb = kChannelBlock;
+            auto poolRow = [&](size_t task)
+            {
+                const int py = task % g.oh;
+                const T *image = in + task / g.oh * g.h * g.w * cb;
+                auto rows = clipWindow(py, g.sh, g.pt, g.kh, g.h);
+                for (int px = 0; px < g.ow; ++px)
+                {
+                    auto cols = clipWindow(px, g.sw, g.pl, g.kw, g.w);
+                    T acc[cb];
+                    std::fill(acc, acc + cb, Op::identity());
+                    for (int i = rows.first; i < rows.second; ++i)
+                    {
+                        const T *row = image + (py * g.sh - g.pt + i) * g.w * cb;
+                        for (int j = cols.first; j < cols.second; ++j)
+                        {
+                            const T *pix = row + (px * g.sw - g.pl + j) * cb;
+#pragma omp simd
+                            for (int c = 0; c < cb; ++c)
+                                acc[c] = Op::combine(acc[c], pix[c]);
+                        }
+                    }
+                    T *dst = out + (task * g.ow + px) * cb;
+                    const T count = average ? T(g.count(py, px)) : T(1);
+                    for (int c = 0; c < cb; ++c)
+                        dst[c] = average ? acc[c] / count : acc[c];
+                }
+            };
+            parallelFor(blocks * g.oh, g.ow * cb * g.kh * g.kw, poolRow);
+        }
+
+        template <typename T>
+        static void globalAveragePlain(const T *in, T *out, size_t planes,
+                                       size_t size)
+        {
+            auto averagePlane = [&](size_t p)
+            {
+                const T *src = in + p * size;
+                T sum = 0;
+#pragma omp simd reduction(+ : sum)
+                for (size_t i = 0; i < size; ++i)
+                    sum += src[i];
+                out[p] = sum / T(size);
+            };
+            parallelFor(planes, size, averagePlane);
+        }
+
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<PoolingObj>(_op);
+            const T *in = op->getInputs(0)->getRawDataPtr<T *>();
+            T *out = op->getOutput()->getRawDataPtr<T *>();
+            const auto &x = op->getInputs(0)->getDims();
+            const auto &y = op->getOutput()->getDims();
+            auto kernel = op->getKernel();
+            const auto &pads = op->getPads(), &strides = op->getStrides();
+            Geometry g{x[2], x[3], y[2], y[3], kernel[0], kernel[1],
+                       strides[0], strides[1], pads[0], pads[1],
+                       op->getCountIncludePad()};
+            const size_t planes = x[0] * x[1];
+            const bool average = op->getOpType() != OpType::MaxPool;
+            if (op->isBlocked())
+            {
+                if (average)
+                    poolBlocked<T, SumOp<T>>(in, out, planes, g, true);
+                else
+                    poolBlocked<T, MaxOp<T>>(in, out, planes, g, false);
+            }
+            else if (op->isGlobal())
+                globalAveragePlain<T>(in, out, planes, g.h * g.w);
+            else if (average)
+                poolPlain<T, SumOp<T>>(in, out, planes, g, true);
+            else
+                poolPlain<T, MaxOp<T>>(in, out, planes, g, false);
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+#define CASE(N) \
+    case N:     \
+        doCompute<DT<N>::t>(_op, context)
+
+            int dataTypeIdx = _op->getDType().getIndex();
+            switch (dataTypeIdx)
+            {
+                CASE(1); // DataType::Float32
+                break;
+                CASE(12); // DataType::UInt32
+                break;
+            default:
+                IT_TODO_HALT();
+            }
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::MaxPool, NativePooling,
+                    "MaxPool_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::AveragePool, NativePooling,
+                    "AveragePool_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::GlobalAveragePool, NativePooling,
+                    "GlobalAveragePool_CPU");
+
+}; // namespace infini
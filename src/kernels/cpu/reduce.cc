@@ -0,0 +1,304 @@
+#include "operators/reduce.h"
+#include "core/kernel.h"
+
+namespace infini
+{
+    namespace
+    {
+        template <typename T>
+        struct SumOp
+        {
+            static T identity() { return T(0); }
+            static T combine(T a, T b) { return a + b; }
+        };
+
+        template <typename T>
+        struct ProdOp
+        {
+            static T identity() { return T(1); }
+            static T combine(T a, T b) { return a * b; }
+        };
+
+        template <typename T>
+        struct MaxOp
+        {
+            static T identity() { return std::numeric_limits<T>::lowest(); }
+            static T combine(T a, T b) { return std::max(a, b); }
+        };
+
+        template <typename T>
+        struct MinOp
+        {
+            static T identity() { return std::numeric_limits<T>::max(); }
+            static T combine(T a, T b) { return std::min(a, b); }
+        };
+
+        struct Dim
+        {
+            size_t size, stride;
+        };
+
+        size_t offsetOf(size_t index, const vector<Dim> &dims)
+        {
+            size_t offset = 0;
+            for (auto it = dims.rbegin(); it != dims.rend(); ++it)
+            {
+                offset += index % it->size * it->stride;
+                index /= it->size;
+            }
+            return offset;
+        }
+
+        size_t volume(const vector<Dim> &dims)
+        {
+            size_t ret = 1;
+            for (auto &d : dims)
+                ret *= d.size;
+            return ret;
+        }
+
+        // Independent accumulators let the compiler keep several vector
+        // registers in flight instead of one serial dependency chain.
+        template <typename T, typename Op>
+        T reduceContiguous(const T *p, size_t n)
+        {
+            constexpr int kLanes = 16;
+            T acc[kLanes];
+            std::fill(acc, acc + kLanes, Op::identity());
+            size_t i = 0;
+            for (; i + kLanes <= n; i += kLanes)
+                for (int k = 0; k < kLanes; ++k)
+                    acc[k] = Op::combine(acc[k], p[i + k]);
+            for (; i < n; ++i)
+                acc[0] = Op::combine(acc[0], p[i]);
+            for (int w = kLanes / 2; w > 0; w /= 2)
+                for (int k = 0; k < w; ++k)
+                    acc[k] = Op::combine(acc[k], acc[k + w]);
+            return acc[0];
+        }
+    } // namespace
+
+    /**
+     * @brief Reduction over arbitrary axes. Adjacent axes that are all reduced
+     * or all kept are collapsed, leaving alternating groups. If the innermost
+     * group is reduced, every output reduces contiguous runs; otherwise
+     * contiguous rows are accumulated elementwise into the output. When there
+     * are fewer outputs than threads, the reduced range is split among threads
+     * into per-thread partials that are combined at the end.
+     */
+    class NativeReduce : public CpuKernelWithoutConfig
+    {
+        // Parallel chunk of a contiguous run.
+        static constexpr size_t kChunk = 4096;
+
+        template <typename T, typename Op>
+        static void reduceInner(const T *in, T *out, const vector<Dim> &kept,
+                                const vector<Dim> &reduced, size_t len)
+        {
+            const size_t nOut = volume(kept), nRed = volume(reduced);
+            auto &pool = ThreadPool::current();
+            const int nThreads = pool.size();
+            if (nOut >= (size_t)nThreads || nRed * len <= kChunk)
+            {
+                auto reduceOutput = [&](size_t o)
+                {
+                    const T *base = in + offsetOf(o, kept);
+                    T acc = Op::identity();
+                    for (size_t r = 0; r < nRed; ++r)
+                        acc = Op::combine(acc, reduceContiguous<T, Op>(
+                                                   base + offsetOf(r, reduced),
+                                                   len));
+                    out[o] = acc;
+                };
+                parallelFor(nOut, nRed * len, reduceOutput);
+                return;
+            }
+            const size_t nChunks = (len + kChunk - 1) / kChunk,
+                         nTasks = nRed * nChunks;
+            vector<T> partial(nThreads);
+            for (size_t o = 0; o < nOut; ++o)
+            {
+                const T *base = in + offsetOf(o, kept);
+                std::fill(partial.begin(), partial.end(), Op::identity());
+                auto reduceChunks = [&](int thread, int threads)
+                {
+                    auto [begin, end] = splitRange(nTasks, thread, threads);
+                    T acc = Op::identity();
+                    for (size_t task = begin; task < end; ++task)
+                    {
+                        size_t r = task / nChunks, c = task % nChunks * kChunk;
+                        acc = Op::combine(
+                            acc, reduceContiguous<T, Op>(
+                                     base + offsetOf(r, reduced) + c,
+                                     std::min(kChunk, len - c)));
+                    }
+                    partial[thread] = acc;
+                };
+                pool.parallel(pool.threadsFor(nTasks, kChunk), reduceChunks);
+                out[o] = reduceContiguous<T, Op>(partial.data(), nThreads);
+            }
+        }
+
+        template <typename T, typename Op>
+        static void reduceOuter(const T *in, T *out, const vector<Dim> &kept,
+                                const vector<Dim> &reduced, size_t len)
+        {
+            const size_t nRows = volume(kept), nRed = volume(reduced);
+            const size_t nBlocks = (len + kChunk - 1) / kChunk;
+            auto &pool = ThreadPool::current();
+            const int nThreads = pool.size();
+            if (nRows * nBlocks >= (size_t)nThreads || nRed < (size_t)nThreads)
+            {
+                auto reduceBlock = [&](size_t task)
+                {
+                    size_t row = task / nBlocks, j0 = task % nBlocks * kChunk;
+                    size_t n = std::min(kChunk, len - j0);
+                    T *dst = out + row * len + j0;
+                    const T *base = in + offsetOf(row, kept) + j0;
+                    std::fill(dst, dst + n, Op::identity());
+                    for (size_t r = 0; r < nRed; ++r)
+                    {
+                        const T *src = base + offsetOf(r, reduced);
+                        for (size_t j = 0; j < n; ++j)
+                            dst[j] = Op::combine(dst[j], src[j]);
+                    }
+                };
+                parallelFor(nRows * nBlocks, nRed * kChunk, reduceBlock);
+                return;
+            }
+            const size_t outSize = nRows * len;
+            vector<T> partial(nThreads * outSize, Op::identity());
+            auto reduceSlices = [&](int thread, int threads)
+            {
+                auto [begin, end] = splitRange(nRed, thread, threads);
+                T *acc = partial.data() + thread * outSize;
+                for (size_t r = begin; r < end; ++r)
+                    for (size_t row = 0; row < nRows; ++row)
+                    {
+                        const T *src =
+                            in + offsetOf(row, kept) + offsetOf(r, reduced);
+                        T *dst = acc + row * len;
+                        for (size_t j = 0; j < len; ++j)
+                            dst[j] = Op::combine(dst[j], src[j]);
+                    }
+            };
+            pool.parallel(pool.threadsFor(nRed, outSize), reduceSlices);
+            std::copy(partial.begin(), partial.begin() + outSize, out);
+            for (int t = 1; t < nThreads; ++t)
+                for (size_t i = 0; i < outSize; ++i)
+                    out[i] = Op::combine(out[i], partial[t * outSize + i]);
+        }
+
+        template <typename T, typename Op>
+        static void doReduce(const Ref<ReduceObj> &op)
+        {
+            const T *in = op->getInputs(0)->getRawDataPtr<T *>();
+            T *out = op->getOutput()->getRawDataPtr<T *>();
+            const auto &dims = op->getInputs(0)->getDims();
+
+            // Collapse into alternating groups of kept and reduced axes.
+            vector<pair<size_t, bool>> groups;
+            for (int i = 0; i < (int)dims.size(); ++i)
+            {
+                if (dims[i] == 1)
+                    continue;
+                bool reduced = op->isReduced(i);
+                if (!groups.empty() && groups.back().second == reduced)
+                    groups.back().first *= dims[i];
+                else
+                    groups.emplace_back(dims[i], reduced);
+            }
+            if (groups.empty())
+                groups.emplace_back(1, false);
+
+            vector<Dim> kept, reduced;
+            size_t stride = 1;
+            for (auto it = groups.rbegin(); it != groups.rend(); ++it)
+            {
+                (it->second ? reduced : kept).push_back({it->first, stride});
+                stride *= it->first;
+            }
+            std::reverse(kept.begin(), kept.end());
+            std::reverse(reduced.begin(), reduced.end());
+
+            size_t len = groups.back().first;
+            if (groups.back().second)
+            {
+                reduced.pop_back();
+                reduceInner<T, Op>(in, out, kept, reduced, len);
+            }
+            else
+            {
+                kept.pop_back();
+                reduceOuter<T, Op>(in, out, kept, reduced, len);
+            }
+        }
+
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<ReduceObj>(_op);
+            if (op->getOutput()->size() == 0)
+                return;
+            switch (op->getOpType().underlying())
+            {
+            case OpType::ReduceSum:
+                return doReduce<T, SumOp<T>>(op);
+            case OpType::ReduceMean:
+            {
+                doReduce<T, SumOp<T>>(op);
+                // Zero for an empty reduced extent, giving NaN as in NumPy.
+                const auto &dims = op->getInputs(0)->getDims();
+                size_t extent = 1;
+                for (int i = 0; i < (int)dims.size(); ++i)
+                    if (op->isReduced(i))
+                        extent *= dims[i];
+                T count = extent;
+                T *out = op->getOutput()->getRawDataPtr<T *>();
+                for (size_t i = 0, n = op->getOutput()->size(); i < n; ++i)
+                    out[i] /= count;
+                return;
+            }
+            case OpType::ReduceMax:
+                return doReduce<T, MaxOp<T>>(op);
+            case OpType::ReduceMin:
+                return doReduce<T, MinOp<T>>(op);
+            case OpType::ReduceProd:
+                return doReduce<T, ProdOp<T>>(op);
+            default:
+                IT_TODO_HALT();
+            }
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+#define CASE(N) \
+    case N:     \
+        doCompute<DT<N>::t>(_op, context)
+
+            int dataTypeIdx = _op->getDType().getIndex();
+            switch (dataTypeIdx)
+            {
+                CASE(1); // DataType::Float32
+                break;
+                CASE(12); // DataType::UInt32
+                break;
+            default:
+                IT_TODO_HALT();
+            }
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::ReduceSum, NativeReduce,
+                    "ReduceSum_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::ReduceMean, NativeReduce,
+                    "ReduceMean_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::ReduceMax, NativeReduce,
+                    "ReduceMax_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::ReduceMin, NativeReduce,
+                    "ReduceMin_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::ReduceProd, NativeReduce,
+                    "ReduceProd_CPU");
+
+}; // namespace infini
@@ -0,0 +1,62 @@
+#include "operators/reorder.h"
+#include "core/kernel.h"
+
+namespace infini
+{
+    /**
+     * @brief Converts [N, C, HW] to [N, C / c, HW, c] or back, one channel
+     * block of an image per task.
+     */
+    class NativeReorder : public CpuKernelWithoutConfig
+    {
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<ReorderObj>(_op);
+            const T *in = op->getInputs(0)->getRawDataPtr<T *>();
+            T *out = op->getOutput()->getRawDataPtr<T *>();
+            const auto &dims = op->getInputs(0)->getDims();
+            const size_t blocks = op->getInputs(0)->size() /
+                                  (dims[2] * dims[3] * kChannelBlock),
+                         hw = dims[2] * dims[3];
+            const bool toBlocked = op->isToBlocked();
+            auto reorderBlock = [&](size_t b)
+            {
+                const T *src = in + b * hw * kChannelBlock;
+                T *dst = out + b * hw * kChannelBlock;
+                for (size_t p = 0; p < hw; ++p)
+                    for (int c = 0; c < kChannelBlock; ++c)
+                    {
+                        if (toBlocked)
+                            dst[p * kChannelBlock + c] = src[c * hw + p];
+                        else
+                            dst[c * hw + p] = src[p * kChannelBlock + c];
+                    }
+            };
+            parallelFor(blocks, hw * kChannelBlock, reorderBlock);
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+#define CASE(N) \
+    case N:     \
+        doCompute<DT<N>::t>(_op, context)
+
+            int dataTypeIdx = _op->getDType().getIndex();
+            switch (dataTypeIdx)
+            {
+                CASE(1); // DataType::Float32
+                break;
+                CASE(12); // DataType::UInt32
+                break;
+            default:
+                IT_TODO_HALT();
+            }
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::Reorder, NativeReorder,
+                    "Reorder_CPU");
+
+}; // namespace infini
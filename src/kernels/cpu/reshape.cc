@@ -0,0 +1,51 @@
+#include "operators/reshape.h"
+#include "core/kernel.h"
+#include <cstring>
+
+namespace infini
+{
+    /**
+     * @brief Materializes a shape-only op that could not be planned as a
+     * view: copies the input, possibly strided, densely into the output.
+     */
+    class CopyKernel : public CpuKernelWithoutConfig
+    {
+        void compute(const Operator &op,
+                     const RuntimeObj *context) const override
+        {
+            auto input = op->getInputs(0), output = op->getOutput();
+            auto src = input->getRawDataPtr<char *>();
+            auto dst = output->getRawDataPtr<char *>();
+            if (input->isContiguous())
+            {
+                if (src != dst)
+                    std::memcpy(dst, src, output->getBytes());
+                return;
+            }
+
+            const auto &dims = input->getDims();
+            const auto &stride = input->getStride();
+            const size_t elemSize = input->getDType().getSize(),
+                         n = input->size();
+            auto copyElement = [&](size_t i)
+            {
+                size_t offset = 0;
+                for (size_t d = dims.size(), rest = i; d > 0; --d)
+                {
+                    offset += rest % dims[d - 1] * stride[d - 1];
+                    rest /= dims[d - 1];
+                }
+                std::memcpy(dst + i * elemSize, src + offset * elemSize,
+                            elemSize);
+            };
+            parallelFor(n, 1, copyElement);
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::Reshape, CopyKernel, "Reshape_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Flatten, CopyKernel, "Flatten_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Squeeze, CopyKernel, "Squeeze_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Unsqueeze, CopyKernel,
+                    "Unsqueeze_CPU");
+
+} // namespace infini
@@ -0,0 +1,171 @@
+#include "operators/softmax.h"
+#include "core/kernel.h"
+#include <cmath>
+#include <cstring>
+
+namespace infini
+{
+    namespace
+    {
+        // Cephes-style expf: e^x = 2^n * e^r with |r| <= ln2/2. Branch free so
+        // the loops calling it vectorize. Relative error is below 2e-7.
+        inline float fastExp(float x)
+        {
+            // Clamps x to [-87.3, 88.7] with masks on its bits: selects and
+            // float compares stay branches under -ftrapping-math, which
+            // blocks vectorization.
+            constexpr uint32_t kMaxBits = 0x42b16666; // 88.7f
+            constexpr uint32_t kMinBits = 0xc2ae999a; // -87.3f
+            uint32_t bits;
+            std::memcpy(&bits, &x, sizeof(x));
+            bits -= (bits - kMaxBits) & -uint32_t(int32_t(bits) >
+                                                  int32_t(kMaxBits));
+            bits -= (bits - kMinBits) & -uint32_t(bits > kMinBits);
+            std::memcpy(&x, &bits, sizeof(x));
+            // Adding 1.5 * 2^23 rounds to the nearest integer.
+            float n = x * 1.44269504f + 12582912.f;
+            n -= 12582912.f;
+            float r = x - n * 0.693359375f + n * 2.12194440e-4f;
+            float p = 1.9875691500e-4f;
+            p = p * r + 1.3981999507e-3f;
+            p = p * r + 8.3334519073e-3f;
+            p = p * r + 4.1665795894e-2f;
+            p = p * r + 1.6666665459e-1f;
+            p = p * r + 5.0000001201e-1f;
+            p = p * r * r + r + 1.f;
+            bits = (static_cast<int32_t>(n) + 127) << 23;
+            float scale;
+            std::memcpy(&scale, &bits, sizeof(scale));
+            return p * scale;
+        }
+
+        // Online softmax of a contiguous row: one read computes the running
+        // max and the sum rescaled to it, a second read writes the output.
+        void softmaxRow(const float *x, float *y, size_t n)
+        {
+            constexpr int kLanes = 16;
+            float sum[kLanes] = {};
+            float max = -INFINITY;
+            size_t i = 0;
+            for (; i + kLanes <= n; i += kLanes)
+            {
+                float blockMax = x[i];
+                for (int k = 1; k < kLanes; ++k)
+                    blockMax = std::max(blockMax, x[i + k]);
+                if (blockMax > max)
+                {
+                    float rescale = fastExp(max - blockMax);
+                    for (int k = 0; k < kLanes; ++k)
+                        sum[k] *= rescale;
+                    max = blockMax;
+                }
+#pragma omp simd
+                for (int k = 0; k < kLanes; ++k)
+                    sum[k] += fastExp(x[i + k] - max);
+            }
+            for (; i < n; ++i)
+            {
+                if (x[i] > max)
+                {
+                    float rescale = fastExp(max - x[i]);
+                    for (int k = 0; k < kLanes; ++k)
+                        sum[k] *= rescale;
+                    max = x[i];
+                }
+                sum[0] += fastExp(x[i] - max);
+            }
+            for (int w = kLanes / 2; w > 0; w /= 2)
+                for (int k = 0; k < w; ++k)
+                    sum[k] += sum[k + w];
+            const float inv = 1.f / sum[0];
+            // x may alias y, each element is read before it is written.
+#pragma omp simd
+            for (size_t j = 0; j < n; ++j)
+                y[j] = fastExp(x[j] - max) * inv;
+        }
+
+        // Softmax along a strided axis for `width` adjacent columns. Every
+        // pass walks contiguous rows; the max is found first so that the sum
+        // needs a single exponential per element.
+        void softmaxColumns(const float *x, float *y, size_t len, size_t stride,
+                            size_t width, float *max, float *sum)
+        {
+            std::copy(x, x + width, max);
+            std::fill(sum, sum + width, 0.f);
+            for (size_t a = 1; a < len; ++a)
+            {
+                const float *row = x + a * stride;
+                for (size_t j = 0; j < width; ++j)
+                    max[j] = std::max(max[j], row[j]);
+            }
+            for (size_t a = 0; a < len; ++a)
+            {
+                const float *row = x + a * stride;
+#pragma omp simd
+                for (size_t j = 0; j < width; ++j)
+                    sum[j] += fastExp(row[j] - max[j]);
+            }
+            for (size_t j = 0; j < width; ++j)
+                sum[j] = 1.f / sum[j];
+            for (size_t a = 0; a < len; ++a)
+            {
+                const float *row = x + a * stride;
+                float *out = y + a * stride;
+#pragma omp simd
+                for (size_t j = 0; j < width; ++j)
+                    out[j] = fastExp(row[j] - max[j]) * sum[j];
+            }
+        }
+    } // namespace
+
+    /**
+     * @brief Softmax with rows processed in parallel. The last axis uses the
+     * online single-read reduction per row; other axes sweep blocks of
+     * contiguous columns.
+     */
+    class NativeSoftmax : public CpuKernelWithoutConfig
+    {
+        static constexpr size_t kColumns = 256;
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<SoftmaxObj>(_op);
+            IT_ASSERT(op->getDType() == DataType::Float32,
+                      "Softmax only supports Float32");
+            const float *x = op->getInputs(0)->getRawDataPtr<float *>();
+            float *y = op->getOutput()->getRawDataPtr<float *>();
+            const auto &dims = op->getInputs(0)->getDims();
+            const int axis = op->getAxis();
+            size_t outer = 1, inner = 1, len = dims[axis];
+            for (int i = 0; i < axis; ++i)
+                outer *= dims[i];
+            for (size_t i = axis + 1; i < dims.size(); ++i)
+                inner *= dims[i];
+
+            if (inner == 1)
+            {
+                parallelFor(outer, len, [&](size_t o)
+                            { softmaxRow(x + o * len, y + o * len, len); });
+                return;
+            }
+            const size_t blocks = (inner + kColumns - 1) / kColumns;
+            auto columnBlocks = [&](size_t begin, size_t end)
+            {
+                float max[kColumns], sum[kColumns];
+                for (size_t task = begin; task < end; ++task)
+                {
+                    size_t o = task / blocks, j = task % blocks * kColumns;
+                    size_t offset = o * len * inner + j;
+                    softmaxColumns(x + offset, y + offset, len, inner,
+                                   std::min(kColumns, inner - j), max, sum);
+                }
+            };
+            parallelRange(outer * blocks, len * kColumns, columnBlocks);
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::Softmax, NativeSoftmax,
+                    "Softmax_CPU");
+
+}; // namespace infini
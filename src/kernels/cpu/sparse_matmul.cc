@@ -0,0 +1,90 @@
+#include "operators/sparse_matmul.h"
+#include "core/kernel.h"
+
+namespace infini
+{
+    namespace
+    {
+        // Rows of A sharing each pass over the blocks of a block column.
+        constexpr size_t kRows = 4;
+
+        template <int BR, int BC>
+        void multiply(const float *a, const float *values,
+                      const int32_t *index, const int32_t *offsets, float *c,
+                      size_t m, size_t n, size_t k)
+        {
+            const size_t mTiles = (m + kRows - 1) / kRows, nCols = n / BC;
+            const size_t blocks = offsets[nCols];
+            auto blockColumn = [&](size_t task)
+            {
+                const size_t i0 = task / nCols * kRows, j0 = task % nCols * BC;
+                // Rows past the end repeat the last one and are not stored,
+                // so that the tile loops have constant trip counts.
+                const float *rows[kRows];
+                for (size_t t = 0; t < kRows; ++t)
+                    rows[t] = a + std::min(i0 + t, m - 1) * k;
+                float acc[kRows][BC] = {};
+                for (int32_t p = offsets[j0 / BC]; p < offsets[j0 / BC + 1];
+                     ++p)
+                {
+                    const float *block = values + (size_t)p * BR * BC;
+                    const size_t kk = (size_t)index[p] * BR;
+                    for (int r = 0; r < BR; ++r)
+                        for (size_t t = 0; t < kRows; ++t)
+                        {
+                            const float x = rows[t][kk + r];
+#pragma omp simd
+                            for (int j = 0; j < BC; ++j)
+                                acc[t][j] += x * block[r * BC + j];
+                        }
+                }
+                for (size_t t = 0; t < kRows && i0 + t < m; ++t)
+                    std::copy(acc[t], acc[t] + BC, c + (i0 + t) * n + j0);
+            };
+            // Tasks of a row tile are adjacent, so each thread mostly reuses
+            // the same rows of A.
+            parallelFor(mTiles * nCols,
+                        kRows * BC * (blocks / std::max<size_t>(nCols, 1) + 1),
+                        blockColumn);
+        }
+    } // namespace
+
+    /**
+     * @brief Sparse x dense product over the nonzero blocks of W. Each task
+     * accumulates one block column for a tile of rows in registers, with the
+     * columns of a block as the vector lanes; zero blocks are never read.
+     */
+    class NativeSparseMatmul : public CpuKernelWithoutConfig
+    {
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<SparseMatmulObj>(_op);
+            const float *a = op->getInputs(0)->getRawDataPtr<float *>();
+            const float *values = op->getInputs(1)->getRawDataPtr<float *>();
+            const int32_t *index = op->getInputs(2)->getRawDataPtr<int32_t *>();
+            const int32_t *offsets =
+                op->getInputs(3)->getRawDataPtr<int32_t *>();
+            float *c = op->getOutput()->getRawDataPtr<float *>();
+            const size_t k = op->getK(), n = op->getN();
+            // Leading dims of A are rows too.
+            const size_t m = n ? op->getOutput()->size() / n : 0;
+            if (m == 0)
+                return;
+
+            const int br = op->getBlockRows(), bc = op->getBlockCols();
+            if (br == 1 && bc == 8)
+                multiply<1, 8>(a, values, index, offsets, c, m, n, k);
+            else if (br == 4 && bc == 4)
+                multiply<4, 4>(a, values, index, offsets, c, m, n, k);
+            else if (br == 1 && bc == 1)
+                multiply<1, 1>(a, values, index, offsets, c, m, n, k);
+            else
+                IT_TODO_HALT();
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::SparseMatmul, NativeSparseMatmul,
+                    "SparseMatmul_CPU");
+
+}; // namespace infini
@@ -3,44 +3,115 @@
 
 namespace infini {
 
-inline Shape idx2Pos(const Shape &shape, size_t idx) {
-    Shape pos = Shape(shape.size(), 0);
-    auto rest = idx, curDimId = shape.size() - 1;
-    while (rest > 0) {
-        pos[curDimId] = rest % shape[curDimId];
-        rest /= shape[curDimId];
-        curDimId--;
+/**
+ * @brief Tiled transpose. The output's innermost axis and the output axis that
+ * walks the input's innermost (smallest stride) axis are copied in tile x tile
+ * blocks, so that both reads and writes stay within a few cache lines. The
+ * input is read through its strides and may be a view. Config {tile}.
+ */
+class TiledTranspose : public CpuKernelWithConfig {
+    // Output axis reading the input's innermost axis.
+    static int innerAxis(const Tensor &input, const Shape &perm) {
+        const auto &stride = input->getStride();
+        const auto &dims = input->getDims();
+        int inner = perm.size() - 1;
+        for (int i = perm.size() - 1; i >= 0; --i)
+            if (dims[perm[i]] != 1 && stride[perm[i]] < stride[perm[inner]])
+                inner = i;
+        return inner;
     }
-    return pos;
-}
 
-class NaiveTranspose : public CpuKernelWithoutConfig {
     template <typename T>
-    void doCompute(const Operator &_op, const RuntimeObj *context) const {
+    void doCompute(const Operator &_op, const KernelConfig &config) const {
         auto op = as<TransposeObj>(_op);
-        auto inputs = op->getInputs(), outputs = op->getOutputs();
-        const auto &inDim = inputs[0]->getDims();
+        // Tiles would be empty and tile counts divide by zero.
+        if (op->getOutput()->size() == 0)
+            return;
+        const auto &inDim = op->getInputs(0)->getDims();
         const auto &perm = op->getPermute();
+        auto inPtr = op->getInputs(0)->getRawDataPtr<T *>(),
+             outPtr = op->getOutput()->getRawDataPtr<T *>();
+        const int rank = inDim.size();
 
-        size_t inSize = inputs[0]->size();
-        auto inPtr = inputs[0]->getRawDataPtr<T *>(),
-             outPtr = outputs[0]->getRawDataPtr<T *>();
-        // #pragma omp parallel for
-        for (size_t inIdx = 0; inIdx < inSize; ++inIdx) {
-            auto posInput = idx2Pos(inDim, inIdx);
-            int outIdx = 0;
-            for (size_t j = 0, jEnd = perm.size(); j < jEnd; ++j) {
-                outIdx = outIdx * inDim[perm[j]] + posInput[perm[j]];
-            }
-            outPtr[outIdx] = inPtr[inIdx];
+        const Shape &inStride = op->getInputs(0)->getStride();
+        Shape outDim(rank), outStride(rank);
+        for (int i = 0; i < rank; ++i)
+            outDim[i] = inDim[perm[i]];
+        for (int i = rank - 1, p = 1; i >= 0; --i) {
+            outStride[i] = p;
+            p *= outDim[i];
         }
+
+        const int last = rank - 1, inner = innerAxis(op->getInputs(0), perm);
+        const size_t rows = outDim[inner], cols = outDim[last];
+        const size_t readStride = inStride[perm[last]], // along output cols
+            rowStride = inStride[perm[inner]],          // along output rows
+            writeStride = outStride[inner];
+        const size_t tile = inner == last ? rows : config[0];
+        // Remaining output axes, iterated as one flat index.
+        vector<int> others;
+        for (int i = 0; i < rank; ++i)
+            if (i != inner && i != last)
+                others.emplace_back(i);
+        size_t nOuter = 1;
+        for (auto i : others)
+            nOuter *= outDim[i];
+        const size_t rowTiles = (rows + tile - 1) / tile,
+                     colTiles = inner == last ? 1 : (cols + tile - 1) / tile;
+        const size_t nTasks = nOuter * rowTiles * colTiles;
+
+        auto copyTile = [&](size_t task) {
+            size_t outer = task / (rowTiles * colTiles);
+            size_t r0 = (task / colTiles) % rowTiles * tile,
+                   c0 = task % colTiles * tile;
+            size_t inBase = 0, outBase = 0;
+            for (auto it = others.rbegin(); it != others.rend(); ++it) {
+                size_t pos = outer % outDim[*it];
+                outer /= outDim[*it];
+                inBase += pos * inStride[perm[*it]];
+                outBase += pos * outStride[*it];
+            }
+            if (inner == last) {
+                // The innermost axis is kept, so rows are strided copies.
+                const T *src = inPtr + inBase;
+                T *dst = outPtr + outBase;
+                if (readStride == 1)
+                    std::copy(src, src + rows, dst);
+                else
+                    for (size_t c = 0; c < cols; ++c)
+                        dst[c] = src[c * readStride];
+                return;
+            }
+            size_t rEnd = std::min(r0 + tile, rows),
+                   cEnd = std::min(c0 + tile, cols);
+            for (size_t r = r0; r < rEnd; ++r) {
+                const T *src = inPtr + inBase + r * rowStride;
+                T *dst = outPtr + outBase + r * writeStride;
+                for (size_t c = c0; c < cEnd; ++c)
+                    dst[c] = src[c * readStride];
+            }
+        };
+        parallelFor(nTasks, inner == last ? rows : tile * tile, copyTile);
+    }
+
+  public:
+    vector<KernelConfig> getSearchSpace(const Operator &_op) const override {
+        auto op = as<TransposeObj>(_op);
+        const auto &perm = op->getPermute();
+        if (innerAxis(op->getInputs(0), perm) == (int)perm.size() - 1)
+            return {{0}};
+        return {{32}, {8}, {16}, {64}};
+    }
+
+    string getTuningAttrs(const Operator &_op) const override {
+        return vecToString(as<TransposeObj>(_op)->getPermute());
     }
 
-    void compute(const Operator &_op,
-                 const RuntimeObj *context) const override {
+    void computeWithConfig(const Operator &_op, const KernelConfig &config,
+                           const RuntimeObj *context) const override {
 #define CASE(N)                                                                \
     case N:                                                                    \
-        doCompute<DT<N>::t>(_op, context)
+        doCompute<DT<N>::t>(_op, config)
 
         int dataTypeIdx = _op->getDType().getIndex();
         switch (dataTypeIdx) {
@@ -54,7 +125,7 @@ class NaiveTranspose : public CpuKernelWithoutConfig {
     }
 };
 
-REGISTER_KERNEL(Device::CPU, OpType::Transpose, NaiveTranspose,
-                "TransposeNaive_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::Transpose, TiledTranspose,
+                "TransposeTiled_CPU");
 
 } // namespace infini
@@ -11,6 +11,18 @@ namespace infini
             return std::max(T(0), val);
         }
 
+        template <typename T>
+        static T expCompute(T val)
+        {
+            return std::exp(val);
+        }
+
+        template <typename T>
+        static T sqrtCompute(T val)
+        {
+            return std::sqrt(val);
+        }
+
         template <typename T>
         void doCompute(const Operator &_op, const RuntimeObj *context) const
         {
@@ -28,14 +40,22 @@ namespace infini
             case OpType::Relu:
                 _doCompute = reluCompute<T>;
                 break;
+            case OpType::Exp:
+                _doCompute = expCompute<T>;
+                break;
+            case OpType::Sqrt:
+                _doCompute = sqrtCompute<T>;
+                break;
             default:
                 IT_TODO_HALT();
             }
 
-            for (size_t offset = 0; offset < n; offset++)
-            {
-                outptr[offset] = _doCompute(inptr[offset]);
-            }
+            parallelRange(n, 1,
+                          [&](size_t begin, size_t end)
+                          {
+                              for (size_t offset = begin; offset < end; offset++)
+                                  outptr[offset] = _doCompute(inptr[offset]);
+                          });
         }
 
         void compute(const Operator &_op,
@@ -99,7 +119,78 @@ namespace infini
         }
     };
 
+    class Cast : public CpuKernelWithoutConfig
+    {
+        template <typename TIn, typename TOut>
+        static void doCompute(const Operator &op)
+        {
+            // May run in place for types of the same width, element i is read
+            // before it is written.
+            TIn *inptr = op->getInputs(0)->getRawDataPtr<TIn *>();
+            TOut *outptr = op->getOutput()->getRawDataPtr<TOut *>();
+            auto n = op->getOutput()->size();
+            for (size_t offset = 0; offset < n; offset++)
+                outptr[offset] = static_cast<TOut>(inptr[offset]);
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<CastObj>(_op);
+            switch (op->getType())
+            {
+            case CastType::Float2Int64:
+                return doCompute<float, int64_t>(op);
+            case CastType::Float2Int32:
+                return doCompute<float, int32_t>(op);
+            case CastType::Float2Int16:
+                return doCompute<float, int16_t>(op);
+            case CastType::Float2Int8:
+                return doCompute<float, int8_t>(op);
+            case CastType::Int322Float:
+                return doCompute<int32_t, float>(op);
+            case CastType::Int322Int8:
+                return doCompute<int32_t, int8_t>(op);
+            case CastType::Int322Int16:
+                return doCompute<int32_t, int16_t>(op);
+            case CastType::Int322Int64:
+                return doCompute<int32_t, int64_t>(op);
+            case CastType::Int162Float:
+                return doCompute<int16_t, float>(op);
+            case CastType::Int162Int32:
+                return doCompute<int16_t, int32_t>(op);
+            case CastType::Int82Float:
+                return doCompute<int8_t, float>(op);
+            case CastType::Int82Int16:
+                return doCompute<int8_t, int16_t>(op);
+            case CastType::Int82Int32:
+                return doCompute<int8_t, int32_t>(op);
+            case CastType::Uint82Float:
+                return doCompute<uint8_t, float>(op);
+            case CastType::Uint82Int32:
+                return doCompute<uint8_t, int32_t>(op);
+            case CastType::Uint82Int64:
+                return doCompute<uint8_t, int64_t>(op);
+            case CastType::Int642Int32:
+                return doCompute<int64_t, int32_t>(op);
+            case CastType::Int642Uint32:
+                return doCompute<int64_t, uint32_t>(op);
+            case CastType::Int642Float:
+                return doCompute<int64_t, float>(op);
+            case CastType::Uint322Int64:
+                return doCompute<uint32_t, int64_t>(op);
+            case CastType::Float2Float:
+                return doCompute<float, float>(op);
+            default: // Half precision types
+                IT_TODO_HALT();
+            }
+        }
+    };
+
     REGISTER_KERNEL(Device::CPU, OpType::Relu, NativeUnary, "reluNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Exp, NativeUnary, "expNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Sqrt, NativeUnary, "sqrtNaive_CPU");
     REGISTER_KERNEL(Device::CPU, OpType::Clip, Clip, "Clip_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Cast, Cast, "Cast_CPU");
 
 }; // namespace infini
@@ -0,0 +1,79 @@
+#include "operators/conv.h"
+#include "operators/reorder.h"
+
+namespace infini
+{
+    ConvObj::ConvObj(GraphObj *graph, Tensor input, Tensor weight, Tensor bias,
+                     Tensor output, vector<int> pads, vector<int> strides,
+                     vector<int> dilations, int group, bool blocked)
+        : OperatorObj(OpType::Conv,
+                      bias ? TensorVec{input, weight, bias}
+                           : TensorVec{input, weight},
+                      {output}),
+          pads(std::move(pads)), strides(std::move(strides)),
+          dilations(std::move(dilations)), group(group), blocked(blocked)
+    {
+        IT_ASSERT(this->pads.size() == 4 && this->strides.size() == 2 &&
+                  this->dilations.size() == 2 && group > 0);
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> ConvObj::inferShape(const TensorVec &inputs)
+    {
+        auto x = inputs[0]->getDims(), w = inputs[1]->getDims();
+        if (w.size() != 4 || x.size() != (blocked ? 5u : 4u))
+            return std::nullopt;
+        int n = x[0], c = blocked ? x[1] * x[4] : x[1], m = w[0];
+        if (c != w[1] * group || m % group != 0)
+            return std::nullopt;
+        if (blocked && (group != 1 || x[4] != kChannelBlock ||
+                        m % kChannelBlock != 0))
+            return std::nullopt;
+        if (inputs.size() > 2 && inputs[2]->getDims() != Shape{m})
+            return std::nullopt;
+        int oh = (x[2] + pads[0] + pads[2] - dilations[0] * (w[2] - 1) - 1) /
+                     strides[0] +
+                 1;
+        int ow = (x[3] + pads[1] + pads[3] - dilations[1] * (w[3] - 1) - 1) /
+                     strides[1] +
+                 1;
+        if (oh <= 0 || ow <= 0)
+            return std::nullopt;
+        if (blocked)
+            return {{Shape{n, m / kChannelBlock, oh, ow, kChannelBlock}}};
+        return {{Shape{n, m, oh, ow}}};
+    }
+
+    bool ConvObj::hasBlockedKernel() const
+    {
+        auto w = inputs[1]->getDims();
+        int c = w[1] * group;
+        return getDType() == DataType::Float32 && group == 1 &&
+               w[2] == w[3] && (w[2] == 1 || w[2] == 3) &&
+               dilations == vector<int>{1, 1} && strides[0] <= 2 &&
+               strides[1] <= 2 && c % kChannelBlock == 0 &&
+               w[0] % kChannelBlock == 0;
+    }
+
+    std::string ConvObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << vecToString(inputs[1]->getDims()) << ",";
+        os << "pads=" << vecToString(pads) << ",";
+        os << "strides=" << vecToString(strides) << ",";
+        os << "dilations=" << vecToString(dilations) << ",";
+        os << "group=" << group << ",";
+        if (blocked)
+            os << "NCHWc,";
+        os << "input=" << inputs[0]->getGuid() << ",";
+        os << "weight=" << inputs[1]->getGuid() << ",";
+        if (inputs.size() > 2)
+            os << "bias=" << inputs[2]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+} // namespace infini
@@ -17,6 +17,15 @@ namespace infini
         return {{res}};
     }
 
+    vector<int> ElementWiseObj::getInplaceInputs() const
+    {
+        vector<int> ret;
+        for (int i = 0; i < 2; ++i)
+            if (inputs[i]->getDims() == outputs[0]->getDims())
+                ret.emplace_back(i);
+        return ret;
+    }
+
     std::string ElementWiseObj::toString() const
     {
         std::ostringstream os;
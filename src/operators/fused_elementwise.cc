@@ -0,0 +1,373 @@
+#include "operators/fused_elementwise.h"
+#include "utils/operator_utils.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace infini
+{
+    namespace
+    {
+        using Code = ElementwiseExpr::Code;
+
+        const char *codeName(Code code)
+        {
+            switch (code)
+            {
+            case Code::Input:
+                return "i";
+            case Code::Const:
+                return "c";
+            case Code::Add:
+                return "add";
+            case Code::Sub:
+                return "sub";
+            case Code::Mul:
+                return "mul";
+            case Code::Div:
+                return "div";
+            case Code::Max:
+                return "max";
+            case Code::Min:
+                return "min";
+            case Code::Relu:
+                return "relu";
+            case Code::Exp:
+                return "exp";
+            case Code::Sqrt:
+                return "sqrt";
+            }
+            IT_TODO_HALT();
+            return "";
+        }
+
+        bool isBinary(Code code)
+        {
+            return code >= Code::Add && code <= Code::Min;
+        }
+
+        string floatLiteral(float value)
+        {
+            if (std::isnan(value))
+                return "std::numeric_limits<float>::quiet_NaN()";
+            if (std::isinf(value))
+                return string(value < 0 ? "-" : "") +
+                       "std::numeric_limits<float>::infinity()";
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%af", value);
+            return buffer;
+        }
+    } // namespace
+
+    int ElementwiseExpr::add(const Node &node)
+    {
+        for (size_t i = 0; i < nodes.size(); ++i)
+            if (nodes[i] == node)
+                return i;
+        nodes.emplace_back(node);
+        return nodes.size() - 1;
+    }
+
+    int ElementwiseExpr::numInputs() const
+    {
+        int ret = 0;
+        for (const auto &node : nodes)
+            if (node.code == Code::Input)
+                ret = std::max(ret, node.a + 1);
+        return ret;
+    }
+
+    bool ElementwiseExpr::isValid(int inputs) const
+    {
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            const auto &node = nodes[i];
+            if (node.code == Code::Input)
+            {
+                if (node.a < 0 || node.a >= inputs)
+                    return false;
+            }
+            else if (node.code != Code::Const &&
+                     (node.code > Code::Sqrt || node.a < 0 ||
+                      node.a >= (int)i ||
+                      (isBinary(node.code) &&
+                       (node.b < 0 || node.b >= (int)i))))
+                return false;
+        }
+        return !nodes.empty();
+    }
+
+    string ElementwiseExpr::signature() const
+    {
+        std::ostringstream os;
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            const auto &node = nodes[i];
+            os << (i ? " " : "") << codeName(node.code);
+            if (node.code == Code::Input)
+                os << node.a;
+            else if (node.code == Code::Const)
+                os << floatLiteral(node.value);
+            else if (isBinary(node.code))
+                os << "(" << node.a << "," << node.b << ")";
+            else
+                os << "(" << node.a << ")";
+        }
+        return os.str();
+    }
+
+    string ElementwiseExpr::toCpp(const vector<string> &inputs,
+                                  const string &exp) const
+    {
+        std::ostringstream os;
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            const auto &node = nodes[i];
+            const string a = "v" + std::to_string(node.a),
+                         b = "v" + std::to_string(node.b);
+            os << "float v" << i << " = ";
+            switch (node.code)
+            {
+            case Code::Input:
+                os << inputs.at(node.a);
+                break;
+            case Code::Const:
+                os << floatLiteral(node.value);
+                break;
+            case Code::Add:
+                os << a << " + " << b;
+                break;
+            case Code::Sub:
+                os << a << " - " << b;
+                break;
+            case Code::Mul:
+                os << a << " * " << b;
+                break;
+            case Code::Div:
+                os << a << " / " << b;
+                break;
+            case Code::Max:
+                os << a << " < " << b << " ? " << b << " : " << a;
+                break;
+            case Code::Min:
+                os << b << " < " << a << " ? " << b << " : " << a;
+                break;
+            case Code::Relu:
+                os << "0.f < " << a << " ? " << a << " : 0.f";
+                break;
+            case Code::Exp:
+                os << exp << "(" << a << ")";
+                break;
+            case Code::Sqrt:
+                os << "std::sqrt(" << a << ")";
+                break;
+            }
+            os << "; ";
+        }
+        return os.str();
+    }
+
+    float ElementwiseExpr::fastExp(float x)
+    {
+        // exp(x) = 2^n * e^r, the exponent capped so that 2^n stays finite.
+        constexpr float kMax = 88.7228394f, kMin = -87.3365479f;
+        float c = x > kMin ? x : kMin; // NaN becomes kMin
+        c = c < kMax ? c : kMax;
+        float n = c * 1.44269504f + 12582912.f;
+        n -= 12582912.f;
+        n = n < 127.f ? n : 127.f;
+        float r = c - n * 0.693359375f + n * 2.12194440e-4f;
+        float p = 1.9875691500e-4f;
+        p = p * r + 1.3981999507e-3f;
+        p = p * r + 8.3334519073e-3f;
+        p = p * r + 4.1665795894e-2f;
+        p = p * r + 1.6666665459e-1f;
+        p = p * r + 5.0000001201e-1f;
+        p = p * r * r + r + 1.f;
+        uint32_t bits = (static_cast<int32_t>(n) + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        float y = p * scale;
+        y = x > kMax ? std::numeric_limits<float>::infinity() : y;
+        y = x < kMin ? 0.f : y;
+        return x != x ? x : y;
+    }
+
+    void ElementwiseExpr::evaluate(const float *const *inputs,
+                                   const ptrdiff_t *steps, float *output,
+                                   size_t n) const
+    {
+        // Node by node over blocks, so that each loop is a simple vectorized
+        // one. Inputs read with step 1 are used in place.
+        constexpr size_t kBlock = 256;
+        thread_local vector<float> scratch;
+        thread_local vector<const float *> values;
+        scratch.resize(nodes.size() * kBlock);
+        values.resize(nodes.size());
+        for (size_t begin = 0; begin < n; begin += kBlock)
+        {
+            const size_t len = std::min(kBlock, n - begin);
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                const auto &node = nodes[i];
+                float *y = i + 1 == nodes.size() ? output + begin
+                                                 : scratch.data() + i * kBlock;
+                const bool leaf =
+                    node.code == Code::Input || node.code == Code::Const;
+                const float *a = leaf ? nullptr : values[node.a];
+                const float *b = isBinary(node.code) ? values[node.b] : nullptr;
+                switch (node.code)
+                {
+                case Code::Input:
+                {
+                    const float *x = inputs[node.a];
+                    const ptrdiff_t step = steps[node.a];
+                    if (step == 1 && i + 1 < nodes.size())
+                    {
+                        values[i] = x + begin;
+                        continue;
+                    }
+                    for (size_t j = 0; j < len; ++j)
+                        y[j] = x[(begin + j) * step];
+                    break;
+                }
+                case Code::Const:
+                    std::fill(y, y + len, node.value);
+                    break;
+                case Code::Add:
+                    for (size_t j = 0; j < len; ++j)
+                        y[j] = a[j] + b[j];
+                    break;
+                case Code::Sub:
+                    for (size_t j = 0; j < len; ++j)
+                        y[j] = a[j] - b[j];
+                    break;
+                case Code::Mul:
+                    for (size_t j = 0; j < len; ++j)
+                        y[j] = a[j] * b[j];
+                    break;
+                case Code::Div:
+                    for (size_t j = 0; j < len; ++j)
+                        y[j] = a[j] / b[j];
+                    break;
+                case Code::Max:
+                    for (size_t j = 0; j < len; ++j)
+                        y[j] = a[j] < b[j] ? b[j] : a[j];
+                    break;
+                case Code::Min:
+                    for (size_t j = 0; j < len; ++j)
+                        y[j] = b[j] < a[j] ? b[j] : a[j];
+                    break;
+                case Code::Relu:
+                    for (size_t j = 0; j < len; ++j)
+                        y[j] = 0.f < a[j] ? a[j] : 0.f;
+                    break;
+                case Code::Exp:
+                    for (size_t j = 0; j < len; ++j)
+                        y[j] = fastExp(a[j]);
+                    break;
+                case Code::Sqrt:
+                    for (size_t j = 0; j < len; ++j)
+                        y[j] = std::sqrt(a[j]);
+                    break;
+                }
+                values[i] = y;
+            }
+        }
+    }
+
+    FusedElementwiseObj::FusedElementwiseObj(GraphObj *graph, TensorVec inputs,
+                                             Tensor output,
+                                             ElementwiseExpr expr)
+        : OperatorObj(OpType::FusedElementwise, inputs, {output}),
+          expr(std::move(expr))
+    {
+        IT_ASSERT(this->expr.isValid(inputs.size()),
+                  "Invalid expression " + this->expr.signature());
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>>
+    FusedElementwiseObj::inferShape(const TensorVec &inputs)
+    {
+        if (inputs.empty())
+            return std::nullopt;
+        Shape ret = inputs[0]->getDims();
+        for (const auto &input : inputs)
+        {
+            if (!(input->getDType() == DataType::Float32))
+                return std::nullopt;
+            ret = infer_broadcast(ret, input->getDims());
+        }
+        return {{ret}};
+    }
+
+    vector<int> FusedElementwiseObj::getInplaceInputs() const
+    {
+        vector<int> ret;
+        for (size_t i = 0; i < inputs.size(); ++i)
+            if (inputs[i]->getDims() == outputs[0]->getDims())
+                ret.emplace_back(i);
+        return ret;
+    }
+
+    FusedElementwiseObj::Rows FusedElementwiseObj::getRows() const
+    {
+        const auto &dims = outputs[0]->getDims();
+        const size_t rank = dims.size();
+        // Built from the innermost dim, reversed at the end.
+        Rows ret{{}, vector<Shape>(inputs.size())};
+        for (size_t d = rank; d-- > 0;)
+        {
+            if (dims[d] == 1)
+                continue;
+            Shape stride(inputs.size(), 0);
+            for (size_t k = 0; k < inputs.size(); ++k)
+            {
+                const auto &t = inputs[k];
+                size_t shift = rank - t->getRank();
+                if (d >= shift && t->getDims()[d - shift] != 1)
+                    stride[k] = t->getStride()[d - shift];
+            }
+            bool merge = !ret.dims.empty();
+            for (size_t k = 0; k < inputs.size() && merge; ++k)
+                merge = stride[k] ==
+                        ret.strides[k].back() * ret.dims.back();
+            if (merge)
+            {
+                ret.dims.back() *= dims[d];
+                continue;
+            }
+            ret.dims.emplace_back(dims[d]);
+            for (size_t k = 0; k < inputs.size(); ++k)
+                ret.strides[k].emplace_back(stride[k]);
+        }
+        if (ret.dims.empty())
+        {
+            ret.dims = {1};
+            for (auto &stride : ret.strides)
+                stride = {0};
+        }
+        std::reverse(ret.dims.begin(), ret.dims.end());
+        for (auto &stride : ret.strides)
+            std::reverse(stride.begin(), stride.end());
+        return ret;
+    }
+
+    std::string FusedElementwiseObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        for (const auto &input : inputs)
+            os << vecToString(input->getDims()) << ",";
+        os << "expr=\"" << expr.signature() << "\",";
+        os << "input=";
+        for (const auto &input : inputs)
+            os << input->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+} // namespace infini
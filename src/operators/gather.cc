@@ -0,0 +1,86 @@
+#include "operators/gather.h"
+#include "utils/operator_utils.h"
+
+namespace infini
+{
+    namespace
+    {
+        bool isIndexType(const Tensor &t)
+        {
+            return t->getDType() == DataType::Int32 ||
+                   t->getDType() == DataType::Int64;
+        }
+    } // namespace
+
+    GatherObj::GatherObj(GraphObj *graph, Tensor data, Tensor indices,
+                         Tensor output, int axis)
+        : OperatorObj(OpType::Gather, {data, indices}, {output}),
+          axis(get_real_axis(axis, data->getRank()))
+    {
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> GatherObj::inferShape(const TensorVec &inputs)
+    {
+        if (!isIndexType(inputs[1]))
+            return std::nullopt;
+        const auto &data = inputs[0]->getDims();
+        const auto &indices = inputs[1]->getDims();
+        Shape ret(data.begin(), data.begin() + axis);
+        ret.insert(ret.end(), indices.begin(), indices.end());
+        ret.insert(ret.end(), data.begin() + axis + 1, data.end());
+        return {{ret}};
+    }
+
+    std::string GatherObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << vecToString(inputs[1]->getDims()) << ",";
+        os << "axis=" << axis << ",";
+        os << "data=" << inputs[0]->getGuid() << ",";
+        os << "indices=" << inputs[1]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+    EmbeddingBagObj::EmbeddingBagObj(GraphObj *graph, Tensor table,
+                                     Tensor indices, Tensor output,
+                                     bool keepDims)
+        : OperatorObj(OpType::EmbeddingBag, {table, indices}, {output}),
+          keepDims(keepDims)
+    {
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>>
+    EmbeddingBagObj::inferShape(const TensorVec &inputs)
+    {
+        const auto &table = inputs[0]->getDims();
+        const auto &indices = inputs[1]->getDims();
+        if (table.size() != 2 || indices.empty() || !isIndexType(inputs[1]))
+            return std::nullopt;
+        Shape ret(indices.begin(), indices.end() - 1);
+        if (keepDims)
+            ret.emplace_back(1);
+        ret.emplace_back(table[1]);
+        return {{ret}};
+    }
+
+    std::string EmbeddingBagObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << vecToString(inputs[1]->getDims()) << ",";
+        os << "keepDims=" << keepDims << ",";
+        os << "table=" << inputs[0]->getGuid() << ",";
+        os << "indices=" << inputs[1]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+} // namespace infini
@@ -0,0 +1,54 @@
+#include "operators/layer_norm.h"
+#include "utils/operator_utils.h"
+
+namespace infini
+{
+    NormObj::NormObj(OpType type, TensorVec inputs, Tensor output, int axis,
+                     float eps)
+        : OperatorObj(type, inputs, {output}),
+          axis(get_real_axis(axis, inputs[0]->getRank())), eps(eps) {}
+
+    optional<vector<Shape>> NormObj::inferShape(const TensorVec &inputs)
+    {
+        const auto &dims = inputs[0]->getDims();
+        Shape normalized(dims.begin() + axis, dims.end());
+        for (size_t i = 1; i < inputs.size(); ++i)
+            if (inputs[i]->getDims() != normalized)
+                return std::nullopt;
+        return {{dims}};
+    }
+
+    std::string NormObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << "axis=" << axis << ",";
+        os << "eps=" << eps << ",";
+        os << "input=" << inputs[0]->getGuid() << ",";
+        os << "scale=" << inputs[1]->getGuid() << ",";
+        if (inputs.size() > 2)
+            os << "bias=" << inputs[2]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+    LayerNormObj::LayerNormObj(GraphObj *graph, Tensor input, Tensor scale,
+                               Tensor bias, Tensor output, int axis, float eps)
+        : NormObj(OpType::LayerNorm,
+                  bias ? TensorVec{input, scale, bias}
+                       : TensorVec{input, scale},
+                  output, axis, eps)
+    {
+        IT_ASSERT(checkValid(graph));
+    }
+
+    RMSNormObj::RMSNormObj(GraphObj *graph, Tensor input, Tensor scale,
+                           Tensor output, int axis, float eps)
+        : NormObj(OpType::RMSNorm, {input, scale}, output, axis, eps)
+    {
+        IT_ASSERT(checkValid(graph));
+    }
+
+} // namespace infini
@@ -49,33 +49,24 @@ namespace infini
         size_t bSecondLastDim = shapeB[shapeB.size() - 2];
         IT_ASSERT(aLastDim == bSecondLastDim, "Inner dimensions must match for MatMul");
 
-        // 确定广播形状
-        Shape batchShape;
-        auto aBatchDims = shapeA.begin(), bBatchDims = shapeB.begin();
-        while (aBatchDims != shapeA.end() - 2 && bBatchDims != shapeB.end() - 2)
+        // Batch dimensions broadcast from the right, as in numpy.
+        size_t aBatch = shapeA.size() - 2, bBatch = shapeB.size() - 2;
+        size_t rank = std::max(aBatch, bBatch);
+        Shape batchShape(rank);
+        for (size_t i = 0; i < rank; ++i)
         {
-            if (*aBatchDims == *bBatchDims)
-            {
-                batchShape.push_back(*aBatchDims);
-            }
-            else if (*aBatchDims == 1)
-            {
-                batchShape.push_back(*bBatchDims);
-            }
-            else if (*bBatchDims == 1)
-            {
-                batchShape.push_back(*aBatchDims);
-            }
-            else
-            {
-                IT_ASSERT(false, "Incompatible batch dimensions for MatMul");
-            }
-            ++aBatchDims;
-            ++bBatchDims;
+            int a = i + aBatch >= rank ? shapeA[i + aBatch - rank] : 1;
+            int b = i + bBatch >= rank ? shapeB[i + bBatch - rank] : 1;
+            IT_ASSERT(a == b || a == 1 || b == 1,
+                      "Incompatible batch dimensions for MatMul");
+            batchShape[i] = std::max(a, b);
         }
 
         // Append the final M and N dimensions
         batchShape.insert(batchShape.end(), {shapeA[shapeA.size() - 2], shapeB[shapeB.size() - 1]});
+        m = shapeA[shapeA.size() - 2];
+        n = shapeB[shapeB.size() - 1];
+        k = aLastDim;
 
         return {{batchShape}};
     }
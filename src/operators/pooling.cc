@@ -0,0 +1,68 @@
+#include "operators/pooling.h"
+#include "operators/reorder.h"
+
+namespace infini
+{
+    PoolingObj::PoolingObj(OpType type, GraphObj *graph, Tensor input,
+                           Tensor output, vector<int> kernel, vector<int> pads,
+                           vector<int> strides, bool countIncludePad,
+                           bool blocked)
+        : OperatorObj(type, {input}, {output}), kernel(std::move(kernel)),
+          pads(std::move(pads)), strides(std::move(strides)),
+          countIncludePad(countIncludePad), blocked(blocked)
+    {
+        IT_ASSERT(type == OpType::MaxPool || type == OpType::AveragePool ||
+                  type == OpType::GlobalAveragePool);
+        IT_ASSERT((type == OpType::GlobalAveragePool) == this->kernel.empty());
+        IT_ASSERT(this->pads.size() == 4 && this->strides.size() == 2 &&
+                  (isGlobal() || this->kernel.size() == 2));
+        IT_ASSERT(checkValid(graph));
+    }
+
+    vector<int> PoolingObj::getKernel() const
+    {
+        if (!isGlobal())
+            return kernel;
+        const auto &dims = inputs[0]->getDims();
+        return {dims[2], dims[3]};
+    }
+
+    optional<vector<Shape>> PoolingObj::inferShape(const TensorVec &inputs)
+    {
+        auto x = inputs[0]->getDims();
+        if (x.size() != (blocked ? 5u : 4u) ||
+            (blocked && x[4] != kChannelBlock))
+            return std::nullopt;
+        auto k = isGlobal() ? vector<int>{x[2], x[3]} : kernel;
+        for (int d = 0; d < 2; ++d)
+        {
+            if (k[d] <= 0 || strides[d] <= 0 || pads[d] >= k[d] ||
+                pads[d + 2] >= k[d])
+                return std::nullopt;
+            x[2 + d] = (x[2 + d] + pads[d] + pads[d + 2] - k[d]) / strides[d] +
+                       1;
+            if (x[2 + d] <= 0)
+                return std::nullopt;
+        }
+        return {{x}};
+    }
+
+    std::string PoolingObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << "kernel=" << vecToString(getKernel()) << ",";
+        os << "pads=" << vecToString(pads) << ",";
+        os << "strides=" << vecToString(strides) << ",";
+        if (countIncludePad)
+            os << "countIncludePad,";
+        if (blocked)
+            os << "NCHWc,";
+        os << "input=" << inputs[0]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+} // namespace infini
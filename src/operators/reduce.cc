@@ -0,0 +1,53 @@
+#include "operators/reduce.h"
+#include "utils/operator_utils.h"
+
+namespace infini
+{
+    ReduceObj::ReduceObj(OpType type, GraphObj *graph, Tensor input,
+                         Tensor output, vector<int> axes, bool keepDims)
+        : OperatorObj(type, {input}, {output}), keepDims(keepDims)
+    {
+        int rank = input->getRank();
+        if (axes.empty())
+            for (int i = 0; i < rank; ++i)
+                this->axes.emplace_back(i);
+        else
+            for (auto axis : axes)
+                this->axes.emplace_back(get_real_axis(axis, rank));
+        std::sort(this->axes.begin(), this->axes.end());
+        this->axes.erase(std::unique(this->axes.begin(), this->axes.end()),
+                         this->axes.end());
+        IT_ASSERT(checkValid(graph));
+    }
+
+    bool ReduceObj::isReduced(int axis) const
+    {
+        return std::binary_search(axes.begin(), axes.end(), axis);
+    }
+
+    optional<vector<Shape>> ReduceObj::inferShape(const TensorVec &inputs)
+    {
+        const auto &dims = inputs[0]->getDims();
+        Shape ret;
+        for (int i = 0; i < (int)dims.size(); ++i)
+            if (!isReduced(i))
+                ret.emplace_back(dims[i]);
+            else if (keepDims)
+                ret.emplace_back(1);
+        return {{ret}};
+    }
+
+    std::string ReduceObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << "axes=" << vecToString(axes) << ",";
+        os << "keepDims=" << keepDims << ",";
+        os << "input=" << inputs[0]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+} // namespace infini
@@ -0,0 +1,39 @@
+#include "operators/reorder.h"
+
+namespace infini
+{
+    ReorderObj::ReorderObj(GraphObj *graph, Tensor input, Tensor output,
+                           bool toBlocked)
+        : OperatorObj(OpType::Reorder, {input}, {output}), toBlocked(toBlocked)
+    {
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> ReorderObj::inferShape(const TensorVec &inputs)
+    {
+        auto dims = inputs[0]->getDims();
+        if (toBlocked)
+        {
+            if (dims.size() != 4 || dims[1] % kChannelBlock != 0)
+                return std::nullopt;
+            return {{Shape{dims[0], dims[1] / kChannelBlock, dims[2], dims[3],
+                           kChannelBlock}}};
+        }
+        if (dims.size() != 5 || dims[4] != kChannelBlock)
+            return std::nullopt;
+        return {{Shape{dims[0], dims[1] * kChannelBlock, dims[2], dims[3]}}};
+    }
+
+    std::string ReorderObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << (toBlocked ? "NCHW->NCHWc" : "NCHWc->NCHW") << ",";
+        os << "input=" << inputs[0]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+} // namespace infini
@@ -0,0 +1,140 @@
+#include "operators/reshape.h"
+#include "utils/operator_utils.h"
+
+namespace infini
+{
+    std::string ShapeOnlyObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << vecToString(outputs[0]->getDims()) << ",";
+        os << "input=" << inputs[0]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+    optional<pair<Shape, size_t>> ShapeOnlyObj::inferView() const
+    {
+        auto stride = reshape_strides(inputs[0]->getDims(),
+                                      inputs[0]->getStride(),
+                                      outputs[0]->getDims());
+        if (!stride)
+            return std::nullopt;
+        return {{*stride, inputs[0]->getOffset()}};
+    }
+
+    ReshapeObj::ReshapeObj(GraphObj *graph, Tensor input, Tensor output,
+                           Shape dims)
+        : ShapeOnlyObj(OpType::Reshape, input, output), dims(std::move(dims))
+    {
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> ReshapeObj::inferShape(const TensorVec &inputs)
+    {
+        const auto &inDims = inputs[0]->getDims();
+        Shape ret = dims;
+        int inferred = -1;
+        size_t size = 1;
+        for (size_t i = 0; i < ret.size(); ++i)
+        {
+            if (ret[i] == 0)
+            {
+                IT_ASSERT(i < inDims.size());
+                ret[i] = inDims[i];
+            }
+            if (ret[i] == -1)
+            {
+                IT_ASSERT(inferred == -1, "Reshape infers at most one dim");
+                inferred = i;
+                continue;
+            }
+            IT_ASSERT(ret[i] > 0);
+            size *= ret[i];
+        }
+        if (inferred >= 0)
+        {
+            IT_ASSERT(inputs[0]->size() % size == 0);
+            ret[inferred] = inputs[0]->size() / size;
+        }
+        else if (size != inputs[0]->size())
+            return std::nullopt;
+        return {{ret}};
+    }
+
+    FlattenObj::FlattenObj(GraphObj *graph, Tensor input, Tensor output,
+                           int axis)
+        : ShapeOnlyObj(OpType::Flatten, input, output)
+    {
+        int rank = input->getRank();
+        IT_ASSERT(axis >= -rank && axis <= rank);
+        this->axis = axis < 0 ? axis + rank : axis;
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> FlattenObj::inferShape(const TensorVec &inputs)
+    {
+        const auto &dims = inputs[0]->getDims();
+        int rows = std::accumulate(dims.begin(), dims.begin() + axis, 1,
+                                   std::multiplies{});
+        int cols = std::accumulate(dims.begin() + axis, dims.end(), 1,
+                                   std::multiplies{});
+        return {{Shape{rows, cols}}};
+    }
+
+    SqueezeObj::SqueezeObj(GraphObj *graph, Tensor input, Tensor output,
+                           vector<int> axes)
+        : ShapeOnlyObj(OpType::Squeeze, input, output)
+    {
+        int rank = input->getRank();
+        for (auto axis : axes)
+            this->axes.emplace_back(get_real_axis(axis, rank));
+        std::sort(this->axes.begin(), this->axes.end());
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> SqueezeObj::inferShape(const TensorVec &inputs)
+    {
+        const auto &dims = inputs[0]->getDims();
+        Shape ret;
+        for (int i = 0; i < (int)dims.size(); ++i)
+        {
+            bool listed =
+                std::binary_search(axes.begin(), axes.end(), i);
+            if (listed && dims[i] != 1)
+                return std::nullopt;
+            if (!listed && (!axes.empty() || dims[i] != 1))
+                ret.emplace_back(dims[i]);
+        }
+        return {{ret}};
+    }
+
+    UnsqueezeObj::UnsqueezeObj(GraphObj *graph, Tensor input, Tensor output,
+                               vector<int> axes)
+        : ShapeOnlyObj(OpType::Unsqueeze, input, output)
+    {
+        int rank = input->getRank() + axes.size();
+        for (auto axis : axes)
+            this->axes.emplace_back(get_real_axis(axis, rank));
+        std::sort(this->axes.begin(), this->axes.end());
+        IT_ASSERT(std::adjacent_find(this->axes.begin(), this->axes.end()) ==
+                  this->axes.end());
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> UnsqueezeObj::inferShape(const TensorVec &inputs)
+    {
+        const auto &dims = inputs[0]->getDims();
+        Shape ret;
+        auto it = dims.begin();
+        for (int i = 0; i < (int)(dims.size() + axes.size()); ++i)
+            if (std::binary_search(axes.begin(), axes.end(), i))
+                ret.emplace_back(1);
+            else
+                ret.emplace_back(*it++);
+        return {{ret}};
+    }
+
+} // namespace infini
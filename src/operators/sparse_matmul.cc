@@ -0,0 +1,95 @@
+#include "operators/sparse_matmul.h"
+
+namespace infini
+{
+    BlockSparse BlockSparse::encode(const float *w, int k, int n,
+                                    bool transposed, int blockRows,
+                                    int blockCols)
+    {
+        IT_ASSERT(k % blockRows == 0 && n % blockCols == 0,
+                  "Blocks of " + std::to_string(blockRows) + "x" +
+                      std::to_string(blockCols) + " do not tile " +
+                      std::to_string(k) + "x" + std::to_string(n));
+        BlockSparse ret{blockRows, blockCols, {}, {}, {0}};
+        auto at = [&](int r, int c)
+        { return transposed ? w[(size_t)c * k + r] : w[(size_t)r * n + c]; };
+        for (int j = 0; j < n; j += blockCols)
+        {
+            for (int i = 0; i < k; i += blockRows)
+            {
+                bool zero = true;
+                for (int r = i; r < i + blockRows && zero; ++r)
+                    for (int c = j; c < j + blockCols && zero; ++c)
+                        zero = at(r, c) == 0;
+                if (zero)
+                    continue;
+                ret.index.emplace_back(i / blockRows);
+                for (int r = i; r < i + blockRows; ++r)
+                    for (int c = j; c < j + blockCols; ++c)
+                        ret.values.emplace_back(at(r, c));
+            }
+            ret.offsets.emplace_back(ret.index.size());
+        }
+        return ret;
+    }
+
+    double BlockSparse::cost() const
+    {
+        return double(blocks()) * blockRows * (2 + (blockCols + 3) / 4);
+    }
+
+    SparseMatmulObj::SparseMatmulObj(GraphObj *graph, Tensor A, Tensor values,
+                                     Tensor index, Tensor offsets, Tensor C,
+                                     int blockRows, int blockCols)
+        : OperatorObj(OpType::SparseMatmul, {A, values, index, offsets}, {C}),
+          blockRows(blockRows), blockCols(blockCols)
+    {
+        IT_ASSERT(isSupported(blockRows, blockCols),
+                  "Unsupported block shape " + std::to_string(blockRows) +
+                      "x" + std::to_string(blockCols));
+        IT_ASSERT(checkValid(graph));
+    }
+
+    bool SparseMatmulObj::isSupported(int blockRows, int blockCols)
+    {
+        return (blockRows == 1 && (blockCols == 1 || blockCols == 8)) ||
+               (blockRows == 4 && blockCols == 4);
+    }
+
+    optional<vector<Shape>>
+    SparseMatmulObj::inferShape(const TensorVec &inputs)
+    {
+        const auto &a = inputs[0]->getDims();
+        const auto &values = inputs[1]->getDims();
+        if (a.size() < 2 || !(inputs[0]->getDType() == DataType::Float32) ||
+            !(inputs[1]->getDType() == DataType::Float32) ||
+            !(inputs[2]->getDType() == DataType::Int32) ||
+            !(inputs[3]->getDType() == DataType::Int32) ||
+            values != Shape{(int)inputs[2]->size(), blockRows, blockCols} ||
+            inputs[3]->getRank() != 1 || inputs[3]->size() == 0 ||
+            a.back() % blockRows != 0)
+            return std::nullopt;
+        m = a[a.size() - 2];
+        k = a.back();
+        n = (inputs[3]->size() - 1) * blockCols;
+        Shape ret(a.begin(), a.end() - 1);
+        ret.emplace_back(n);
+        return {{ret}};
+    }
+
+    std::string SparseMatmulObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << "block=" << blockRows << "x" << blockCols << ",";
+        os << "blocks=" << inputs[2]->size() << ",";
+        os << "mnk=[" << m << "," << n << "," << k << "],";
+        os << "A=" << inputs[0]->getGuid() << ",";
+        os << "values=" << inputs[1]->getGuid() << ",";
+        os << "C=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+} // namespace infini
@@ -1,4 +1,5 @@
 #include "operators/transpose.h"
+#include <numeric>
 
 namespace infini
 {
@@ -9,14 +10,21 @@ namespace infini
         auto rank = input->getRank();
         if (permute.empty())
         {
-            for (size_t i = 0; i < rank; ++i)
-            {
-                transposePermute[i] = i;
-            }
+            transposePermute.resize(rank);
+            std::iota(transposePermute.begin(), transposePermute.end(), 0);
         }
         else
         {
             IT_ASSERT(rank == permute.size());
+            // Read from model files, and indexes the input's dims.
+            vector<bool> seen(rank, false);
+            for (int axis : permute)
+            {
+                IT_ASSERT(0 <= axis && axis < (int)rank && !seen[axis],
+                          "Transpose perm " + vecToString(permute) +
+                              " is not a permutation of the input's axes");
+                seen[axis] = true;
+            }
             transposePermute = std::move(permute);
         }
         IT_ASSERT(checkValid(graph));
@@ -46,6 +54,15 @@ namespace infini
         return {{output_dim}};
     }
 
+    optional<pair<Shape, size_t>> TransposeObj::inferView() const
+    {
+        const auto &inStride = inputs[0]->getStride();
+        Shape stride(inStride.size());
+        for (size_t i = 0; i < stride.size(); ++i)
+            stride[i] = inStride[transposePermute[i]];
+        return {{stride, inputs[0]->getOffset()}};
+    }
+
     std::string TransposeObj::toString() const
     {
         std::ostringstream os;
@@ -90,6 +90,13 @@ namespace infini
         return os.str();
     }
 
+    vector<int> CastObj::getInplaceInputs() const
+    {
+        if (inputs[0]->getDType().getSize() == getOutputDataType().getSize())
+            return {0};
+        return {};
+    }
+
     DataType CastObj::getOutputDataType() const
     {
         switch (castType)
@@ -0,0 +1,75 @@
+#include "utils/hash.h"
+#include <cstring>
+
+namespace infini {
+
+namespace {
+
+constexpr int kLanes = 8;
+constexpr size_t kStripe = kLanes * sizeof(uint64_t);
+// Stripes between scrambles, which keep the accumulators' high bits mixed.
+constexpr size_t kStripesPerScramble = 16;
+constexpr uint64_t kPrime32 = 0x9e3779b1u;
+constexpr uint64_t kPrime64 = 0x9e3779b185ebca87ull;
+
+// Fractional parts of the square roots of the first eight primes.
+alignas(64) constexpr uint64_t kSecret[kLanes] = {
+    0x6a09e667f3bcc908ull, 0xbb67ae8584caa73bull, 0x3c6ef372fe94f82bull,
+    0xa54ff53a5f1d36f1ull, 0x510e527fade682d1ull, 0x9b05688c2b3e6c1full,
+    0x1f83d9abfb41bd6bull, 0x5be0cd19137e2179ull};
+
+void accumulate(uint64_t *acc, const unsigned char *stripe) {
+    uint64_t value[kLanes], product[kLanes];
+    std::memcpy(value, stripe, kStripe);
+#pragma omp simd
+    for (int i = 0; i < kLanes; ++i) {
+        uint64_t key = value[i] ^ kSecret[i];
+        product[i] = uint64_t(uint32_t(key)) * uint32_t(key >> 32);
+    }
+    // Adding the neighbour's raw value keeps inputs whose product is zero.
+#pragma omp simd
+    for (int i = 0; i < kLanes; i += 2) {
+        acc[i] += product[i] + value[i + 1];
+        acc[i + 1] += product[i + 1] + value[i];
+    }
+}
+
+void scramble(uint64_t *acc) {
+#pragma omp simd
+    for (int i = 0; i < kLanes; ++i)
+        acc[i] = (acc[i] ^ (acc[i] >> 47) ^ kSecret[i]) * kPrime32;
+}
+
+uint64_t mix(uint64_t a, uint64_t b) {
+    auto product = static_cast<unsigned __int128>(a) * b;
+    return uint64_t(product) ^ uint64_t(product >> 64);
+}
+
+} // namespace
+
+uint64_t hashBytes(const void *data, size_t bytes, uint64_t seed) {
+    auto p = static_cast<const unsigned char *>(data);
+    uint64_t acc[kLanes];
+    for (int i = 0; i < kLanes; ++i)
+        acc[i] = kSecret[kLanes - 1 - i] + seed;
+    size_t stripes = 0, i = 0;
+    for (; i + kStripe <= bytes; i += kStripe) {
+        accumulate(acc, p + i);
+        if (++stripes % kStripesPerScramble == 0)
+            scramble(acc);
+    }
+    // The last partial stripe, zero padded: the length tells it apart.
+    if (i < bytes) {
+        unsigned char last[kStripe] = {};
+        std::memcpy(last, p + i, bytes - i);
+        accumulate(acc, last);
+    }
+    uint64_t h = bytes * kPrime64 ^ seed;
+    for (int k = 0; k < kLanes; k += 2)
+        h += mix(acc[k] ^ kSecret[k], acc[k + 1] ^ kSecret[k + 1]);
+    h ^= h >> 37;
+    h *= 0x165667919e3779f9ull;
+    return h ^ (h >> 32);
+}
+
+} // namespace infini
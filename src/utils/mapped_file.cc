@@ -0,0 +1,32 @@
+#include "utils/mapped_file.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace infini {
+
+MappedFile::MappedFile(const string &path) : addr(MAP_FAILED) {
+    int fd = open(path.c_str(), O_RDONLY);
+    IT_ASSERT(fd >= 0, "Cannot open file " + path);
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        length = st.st_size;
+        addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    IT_ASSERT(addr != MAP_FAILED, "Cannot map file " + path);
+}
+
+MappedFile::~MappedFile() { munmap(addr, length); }
+
+void MappedFile::release(size_t offset, size_t len) const {
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t begin = (offset + page - 1) / page * page;
+    size_t end = std::min(offset + len, length) / page * page;
+    if (begin < end)
+        madvise(static_cast<char *>(addr) + begin, end - begin,
+                MADV_DONTNEED);
+}
+
+} // namespace infini
@@ -72,6 +72,42 @@ Shape locate_index(size_t inputN, const Shape &shape) {
     return ans;
 }
 
+optional<Shape> reshape_strides(const Shape &dims, const Shape &stride,
+                                const Shape &newDims) {
+    // Dims are split into chunks that are contiguous in memory, every chunk
+    // has to be covered by whole output dims.
+    Shape newStride(newDims.size());
+    int viewD = (int)newDims.size() - 1;
+    size_t chunkStride = dims.empty() ? 1 : stride.back();
+    size_t tensorNumel = 1, viewNumel = 1;
+    for (int d = (int)dims.size() - 1; d >= 0; --d) {
+        tensorNumel *= dims[d];
+        if (d == 0 || (dims[d - 1] != 1 &&
+                       (size_t)stride[d - 1] != tensorNumel * chunkStride)) {
+            while (viewD >= 0 &&
+                   (viewNumel < tensorNumel || newDims[viewD] == 1)) {
+                newStride[viewD] = viewNumel * chunkStride;
+                viewNumel *= newDims[viewD];
+                viewD--;
+            }
+            if (viewNumel != tensorNumel)
+                return std::nullopt;
+            if (d > 0) {
+                chunkStride = stride[d - 1];
+                tensorNumel = 1;
+                viewNumel = 1;
+            }
+        }
+    }
+    // Leading dims of size 1.
+    for (; viewD >= 0; --viewD) {
+        if (newDims[viewD] != 1)
+            return std::nullopt;
+        newStride[viewD] = viewNumel * chunkStride;
+    }
+    return newStride;
+}
+
 size_t delocate_index(const Shape &shapeIndex, const Shape &shape,
                       const Shape &stride) {
     size_t ans = 0;
@@ -0,0 +1,121 @@
+#include "utils/perf_counters.h"
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace infini {
+
+namespace {
+
+struct EventSpec {
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t cacheMiss(uint64_t cache) {
+    return cache | PERF_COUNT_HW_CACHE_OP_READ << 8 |
+           PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+}
+
+const EventSpec kSpecs[PerfCounters::kEvents] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_LL)},
+    {PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_DTLB)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+};
+
+int openEvent(int event, int tid, int leader) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = kSpecs[event].type;
+    attr.config = kSpecs[event].config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(SYS_perf_event_open, &attr, tid, -1, leader,
+                   PERF_FLAG_FD_CLOEXEC);
+}
+
+} // namespace
+
+const char *PerfCounters::eventName(int event) {
+    static const char *names[kEvents] = {
+        "cycles",      "instructions",  "llc_misses",
+        "dtlb_misses", "branch_misses", "task_clock_ns"};
+    return names[event];
+}
+
+PerfCounters::PerfCounters(const vector<int> &threads) {
+    vector<int> opened(kEvents, 0), errors(kEvents, 0);
+    for (int tid : threads) {
+        Group hardware, software;
+        for (int event = 0; event < kEvents; ++event) {
+            auto &group =
+                kSpecs[event].type == PERF_TYPE_SOFTWARE ? software : hardware;
+            int fd = openEvent(event, tid,
+                               group.fds.empty() ? -1 : group.fds[0]);
+            if (fd < 0) {
+                errors[event] = errno;
+                continue;
+            }
+            group.fds.emplace_back(fd);
+            group.events.emplace_back(event);
+            ++opened[event];
+        }
+        for (auto *group : {&hardware, &software})
+            if (!group->fds.empty())
+                groups.emplace_back(std::move(*group));
+    }
+    if (threads.empty())
+        return;
+    string missing;
+    int cause = 0;
+    for (int event = 0; event < kEvents; ++event) {
+        if (opened[event] == (int)threads.size()) {
+            available |= 1u << event;
+            continue;
+        }
+        missing += string(missing.empty() ? "" : ", ") + eventName(event);
+        cause = cause ? cause : errors[event];
+    }
+    if (!missing.empty()) {
+        error = "Cannot count " + missing + ": " + std::strerror(cause);
+        if (cause == EACCES || cause == EPERM)
+            error += " (see /proc/sys/kernel/perf_event_paranoid)";
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (auto &group : groups)
+        for (int fd : group.fds)
+            close(fd);
+}
+
+PerfCounters::Values PerfCounters::read() const {
+    Values ret{};
+    uint64_t buffer[3 + kEvents];
+    for (const auto &group : groups) {
+        ssize_t want = (3 + group.fds.size()) * sizeof(uint64_t);
+        if (::read(group.fds[0], buffer, want) != want)
+            continue;
+        uint64_t enabled = buffer[1], running = buffer[2];
+        for (size_t i = 0; i < group.events.size() && i < buffer[0]; ++i) {
+            int event = group.events[i];
+            if (!isAvailable(event))
+                continue;
+            uint64_t value = buffer[3 + i];
+            if (running > 0 && running < enabled)
+                value = (uint64_t)((double)value * enabled / running);
+            ret[event] += value;
+        }
+    }
+    return ret;
+}
+
+} // namespace infini
@@ -0,0 +1,50 @@
+#include "utils/shared_library.h"
+#include <cstdio>
+#include <cstdlib>
+#include <dlfcn.h>
+
+namespace infini {
+
+namespace {
+
+// Quoted for the shell.
+string quote(const string &arg) {
+    string ret = "'";
+    for (char c : arg)
+        ret += c == '\'' ? string("'\\''") : string(1, c);
+    return ret + "'";
+}
+
+} // namespace
+
+SharedLibrary::SharedLibrary(const string &path)
+    : handle(dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL)) {
+    IT_ASSERT(handle != nullptr, "Cannot load " + path + ": " + dlerror());
+}
+
+SharedLibrary::~SharedLibrary() { dlclose(handle); }
+
+void *SharedLibrary::symbol(const string &name) const {
+    void *ret = dlsym(handle, name.c_str());
+    IT_ASSERT(ret != nullptr, "Symbol " + name + " not found");
+    return ret;
+}
+
+void SharedLibrary::compile(const string &source, const string &library,
+                            const string &flags) {
+    const char *cxx = std::getenv("INFINI_CXX");
+    string command = string(cxx && *cxx ? cxx : "c++") +
+                     " -std=c++17 -shared -fPIC " + flags + " -o " +
+                     quote(library) + " " + quote(source) + " 2>&1";
+    FILE *pipe = popen(command.c_str(), "r");
+    IT_ASSERT(pipe != nullptr, "Cannot run " + command);
+    string output;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0)
+        output.append(buffer, n);
+    int status = pclose(pipe);
+    IT_ASSERT(status == 0, "Compiling " + source + " failed:\n" + output);
+}
+
+} // namespace infini
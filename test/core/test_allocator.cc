@@ -25,6 +25,8 @@ namespace infini
         size_t offsetD = allocator.alloc(d->getBytes());
         // expected to be a->d->c
         EXPECT_EQ(offsetB, offsetD);
+        EXPECT_EQ(allocator.getStats().reused, 1u);
+        EXPECT_EQ(allocator.getStats().frees, 1u);
         ASSERT_FALSE(offsetA == 0 && offsetB == 0 && offsetC == 0 && offsetD == 0);
     }
 
@@ -49,6 +51,9 @@ namespace infini
         allocator.info();
         // expected to be a->b->d, with no free block between b and c
         EXPECT_EQ(offsetC, offsetD);
+        EXPECT_EQ(allocator.getStats().allocs, 4u);
+        EXPECT_EQ(allocator.getStats().grownTail, 1u);
+        EXPECT_EQ(allocator.getStats().reused, 0u);
     }
 
     TEST(Allocator, testGetPtr)
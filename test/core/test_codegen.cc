@@ -0,0 +1,175 @@
+#include "core/codegen.h"
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/gather.h"
+#include "operators/layer_norm.h"
+#include "operators/matmul.h"
+#include "operators/reduce.h"
+#include "operators/reshape.h"
+#include "operators/softmax.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include "utils/shared_library.h"
+
+#include "test.h"
+
+namespace infini
+{
+    namespace
+    {
+        // Weights of the graph below, kept alive with it.
+        struct Weights
+        {
+            vector<float> w1, b1, scale, bias, table;
+            Weights()
+            {
+                for (int i = 0; i < 16 * 8; ++i)
+                    w1.emplace_back(float(i % 7 - 3) / 4);
+                for (int i = 0; i < 8; ++i)
+                {
+                    b1.emplace_back(float(i) / 8 - 0.5f);
+                    scale.emplace_back(1 + float(i) / 16);
+                    bias.emplace_back(float(i % 3) / 4);
+                }
+                for (int i = 0; i < 10 * 4; ++i)
+                    table.emplace_back(float(i) / 10);
+            }
+        };
+
+        Tensor weight(const Graph &g, const Shape &dims, vector<float> &data)
+        {
+            auto t = g->addTensor(dims, DataType::Float32);
+            t->setWeight();
+            t->setExternalData(data.data(), data.size() * sizeof(float));
+            return t;
+        }
+
+        // Most op kinds codegen supports, with a broadcast, a view read by
+        // a matmul and an in-place chain.
+        Graph build(Runtime runtime, Weights &w)
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({4, 16}, DataType::Float32);
+            auto idx = g->addTensor({3}, DataType::Int32);
+            auto h = g->addOp<MatmulObj>(x, weight(g, {16, 8}, w.w1), nullptr)
+                         ->getOutput();
+            h = g->addOp<AddObj>(h, weight(g, {8}, w.b1), nullptr)->getOutput();
+            h = g->addOp<ReluObj>(h, nullptr)->getOutput();
+            h = g->addOp<LayerNormObj>(h, weight(g, {8}, w.scale),
+                                       weight(g, {8}, w.bias), nullptr)
+                    ->getOutput();
+            auto t = g->addOp<TransposeObj>(h, nullptr, vector<int>{1, 0})
+                         ->getOutput();
+            auto s = g->addOp<MatmulObj>(h, t, nullptr)->getOutput();
+            s = g->addOp<SoftmaxObj>(s, nullptr)->getOutput();
+            auto e = g->addOp<GatherObj>(weight(g, {10, 4}, w.table), idx,
+                                         nullptr)
+                         ->getOutput();
+            auto c = g->addOp<ConcatObj>(TensorVec{s, e}, nullptr, 0)
+                         ->getOutput();
+            auto r = g->addOp<ReduceMeanObj>(c, nullptr, vector<int>{1})
+                         ->getOutput();
+            g->addOp<ReshapeObj>(r, nullptr, Shape{7});
+            auto d = g->addOp<SubObj>(c, r, nullptr)->getOutput();
+            g->addOp<ClipObj>(d, nullptr, -0.2f, 0.2f);
+            return g;
+        }
+    } // namespace
+
+    TEST(Codegen, MatchesRuntime)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Weights w;
+        Graph g = build(runtime, w);
+        g->dataMalloc();
+
+        auto source = testing::TempDir() + "codegen_test.cc";
+        auto library = testing::TempDir() + "codegen_test.so";
+        saveCpp(g, source, "net");
+        SharedLibrary::compile(source, library);
+        SharedLibrary lib(library);
+        auto run = lib.get<int(const void *const *, void *const *)>("net_run");
+        ASSERT_EQ(*lib.get<const int>("net_num_inputs"), 2);
+        ASSERT_EQ(*lib.get<const int>("net_num_outputs"), 2);
+        EXPECT_EQ(lib.get<const size_t>("net_input_bytes")[0], 4u * 16 * 4);
+        EXPECT_EQ(lib.get<const size_t>("net_output_bytes")[1], 7u * 4 * 4);
+
+        vector<float> x(4 * 16);
+        for (size_t i = 0; i < x.size(); ++i)
+            x[i] = float(int(i * 5 % 11) - 5) / 4;
+        vector<int32_t> idx = {9, -1, 2};
+        auto inputs = g->getInputs();
+        std::copy(x.begin(), x.end(), inputs[0]->getRawDataPtr<float *>());
+        std::copy(idx.begin(), idx.end(), inputs[1]->getRawDataPtr<int32_t *>());
+        runtime->run(g);
+
+        auto outputs = g->getOutputs();
+        ASSERT_EQ(outputs.size(), 2u);
+        vector<float> y0(7), y1(7 * 4);
+        const void *in[] = {x.data(), idx.data()};
+        void *out[] = {y0.data(), y1.data()};
+        ASSERT_EQ(run(in, out), 0);
+        for (size_t i = 0; i < y0.size(); ++i)
+            EXPECT_NEAR(y0[i], outputs[0]->getRawDataPtr<float *>()[i], 1e-5);
+        for (size_t i = 0; i < y1.size(); ++i)
+            EXPECT_NEAR(y1[i], outputs[1]->getRawDataPtr<float *>()[i], 1e-5);
+
+        // The arena is reused between runs.
+        std::fill(y1.begin(), y1.end(), 0.f);
+        ASSERT_EQ(run(in, out), 0);
+        EXPECT_NEAR(y1[5], outputs[1]->getRawDataPtr<float *>()[5], 1e-5);
+        idx[0] = 10;
+        EXPECT_EQ(run(in, out), 1);
+    }
+
+    TEST(Codegen, FusedElementwise)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({3, 5}, DataType::Float32);
+        auto b = g->addTensor({5}, DataType::Float32);
+        auto h = g->addOp<AddObj>(x, b, nullptr)->getOutput();
+        h = g->addOp<ClipObj>(h, nullptr, -0.5f, 1.f)->getOutput();
+        g->addOp<ExpObj>(h, nullptr);
+        g->optimize();
+        ASSERT_EQ(g->getOperators().size(), 1u);
+        g->dataMalloc();
+
+        auto source = testing::TempDir() + "codegen_fused_test.cc";
+        auto library = testing::TempDir() + "codegen_fused_test.so";
+        saveCpp(g, source, "net");
+        SharedLibrary::compile(source, library);
+        SharedLibrary lib(library);
+        auto run = lib.get<int(const void *const *, void *const *)>("net_run");
+
+        vector<float> xs(15), bs(5), y(15);
+        for (size_t i = 0; i < xs.size(); ++i)
+            xs[i] = float(i) / 8 - 1;
+        for (size_t i = 0; i < bs.size(); ++i)
+            bs[i] = float(i) / 4;
+        std::copy(xs.begin(), xs.end(), x->getRawDataPtr<float *>());
+        std::copy(bs.begin(), bs.end(), b->getRawDataPtr<float *>());
+        runtime->run(g);
+        const void *in[] = {xs.data(), bs.data()};
+        void *out[] = {y.data()};
+        ASSERT_EQ(run(in, out), 0);
+        auto expect = g->getOutputs()[0]->getRawDataPtr<float *>();
+        for (size_t i = 0; i < y.size(); ++i)
+            EXPECT_NEAR(y[i], expect[i], 1e-5);
+    }
+
+    TEST(Codegen, Errors)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Weights w;
+        Graph g = build(runtime, w);
+        // Not planned yet.
+        EXPECT_THROW(generateCpp(g), Exception);
+        g->dataMalloc();
+        EXPECT_THROW(generateCpp(g, "not an identifier"), Exception);
+        EXPECT_NE(generateCpp(g).find("int model_run("), string::npos);
+    }
+
+} // namespace infini
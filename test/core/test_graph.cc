@@ -1,8 +1,16 @@
 #include "core/graph.h"
 #include "core/kernel.h"
 #include "core/runtime.h"
+#include "operators/conv.h"
+#include "operators/element_wise.h"
+#include "operators/fused_elementwise.h"
+#include "operators/gather.h"
 #include "operators/matmul.h"
+#include "operators/pooling.h"
+#include "operators/reduce.h"
+#include "operators/sparse_matmul.h"
 #include "operators/transpose.h"
+#include "operators/unary.h"
 
 #include "test.h"
 
@@ -37,4 +45,484 @@ namespace infini
         EXPECT_EQ(op->getTransA(), false);
         EXPECT_EQ(op->getTransB(), true);
     }
-}
\ No newline at end of file
+
+    TEST(Graph, InplaceDataMalloc)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 3}, DataType::Float32);
+        auto bias = g->addTensor({3}, DataType::Float32);
+        auto a = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        auto b = g->addOp<ClipObj>(a, nullptr, 0.f, 4.f)->getOutput();
+        auto c = g->addOp<AddObj>(b, bias, nullptr)->getOutput();
+        auto d = g->addOp<ReluObj>(c, nullptr)->getOutput();
+        g->dataMalloc();
+
+        // The activation chain runs in one buffer, graph inputs are kept.
+        auto ptr = a->getRawDataPtr<float *>();
+        EXPECT_EQ(b->getRawDataPtr<float *>(), ptr);
+        EXPECT_EQ(c->getRawDataPtr<float *>(), ptr);
+        EXPECT_EQ(d->getRawDataPtr<float *>(), ptr);
+        EXPECT_NE(x->getRawDataPtr<float *>(), ptr);
+        EXPECT_NE(bias->getRawDataPtr<float *>(), ptr);
+
+        x->setData(IncrementalGenerator());
+        bias->setData(OneGenerator());
+        runtime->run(g);
+        EXPECT_TRUE(d->equalData(vector<float>{1, 2, 3, 4, 5, 5}));
+        EXPECT_TRUE(x->equalData(vector<float>{0, 1, 2, 3, 4, 5}));
+    }
+
+    TEST(Graph, InplaceKeepsLiveInputs)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({4}, DataType::Float32);
+        auto a = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        auto b = g->addOp<ClipObj>(a, nullptr, 0.f, 2.f)->getOutput();
+        auto c = g->addOp<AddObj>(a, b, nullptr)->getOutput();
+        auto d = g->addOp<ReluObj>(c, nullptr)->getOutput();
+        // Consumed by two ops, so it needs a buffer of its own.
+        auto e = g->addOp<MulObj>(d, d, nullptr)->getOutput();
+        auto f = g->addOp<SubObj>(d, e, nullptr)->getOutput();
+        g->dataMalloc();
+
+        // `a` is read again by Add, so Clip cannot overwrite it.
+        EXPECT_NE(b->getRawDataPtr<float *>(), a->getRawDataPtr<float *>());
+        EXPECT_NE(e->getRawDataPtr<float *>(), d->getRawDataPtr<float *>());
+        auto cPtr = c->getRawDataPtr<float *>();
+        EXPECT_TRUE(cPtr == a->getRawDataPtr<float *>() ||
+                    cPtr == b->getRawDataPtr<float *>());
+        EXPECT_EQ(d->getRawDataPtr<float *>(), cPtr);
+
+        x->setData(IncrementalGenerator());
+        runtime->run(g);
+        // c = {0, 2, 4, 5}, f = c - c * c
+        EXPECT_TRUE(f->equalData(vector<float>{0, -2, -12, -20}));
+    }
+
+    TEST(Graph, InplaceSkipsStridedAliases)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({3, 3}, DataType::Float32);
+        auto a = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        auto t = g->addOp<TransposeObj>(a, nullptr, vector<int>{1, 0})
+                     ->getOutput();
+        auto c = g->addOp<AddObj>(a, t, nullptr)->getOutput();
+        g->dataMalloc();
+
+        // The transpose reads `a` in place, so the sum cannot overwrite it.
+        EXPECT_EQ(t->getRawDataPtr<float *>(), a->getRawDataPtr<float *>());
+        EXPECT_NE(c->getRawDataPtr<float *>(), a->getRawDataPtr<float *>());
+
+        x->setData(IncrementalGenerator());
+        runtime->run(g);
+        EXPECT_TRUE(c->equalData(
+            vector<float>{0, 4, 8, 4, 8, 12, 8, 12, 16}));
+    }
+
+    TEST(Graph, DataMallocReusesDeadBuffers)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 8}, DataType::Float32);
+        auto w = g->addTensor({8, 8}, DataType::Float32);
+        auto t = x;
+        vector<Tensor> hidden;
+        for (int i = 0; i < 4; ++i)
+            hidden.emplace_back(t = g->addOp<MatmulObj>(t, w, nullptr)->getOutput());
+        g->dataMalloc();
+
+        // Matmul is not in place, but two buffers suffice for the chain.
+        EXPECT_NE(hidden[0]->getRawDataPtr<float *>(),
+                  hidden[1]->getRawDataPtr<float *>());
+        EXPECT_EQ(hidden[0]->getRawDataPtr<float *>(),
+                  hidden[2]->getRawDataPtr<float *>());
+    }
+
+    TEST(Graph, MemoryPlan)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 8}, DataType::Float32);
+        auto w = g->addTensor({8, 8}, DataType::Float32);
+        auto t = x;
+        for (int i = 0; i < 4; ++i)
+            t = g->addOp<MatmulObj>(t, w, nullptr)->getOutput();
+        g->dataMalloc();
+
+        const auto &plan = g->getMemoryPlan();
+        ASSERT_EQ(plan.steps.size(), 4u);
+        EXPECT_EQ(plan.steps[0].substr(0, 7), "MatMul[");
+        // x and w, then one buffer per matmul output.
+        ASSERT_EQ(plan.buffers.size(), 6u);
+        EXPECT_EQ(plan.buffers[0].tensors, vector<UidBaseType>{x->getFuid()});
+        EXPECT_EQ(plan.buffers[0].allocStep, -1);
+        EXPECT_EQ(plan.buffers[0].freeStep, 4);
+        EXPECT_EQ(plan.buffers[2].allocStep, 0);
+        EXPECT_EQ(plan.buffers[2].freeStep, 1);
+        // The third output reuses the first, the graph output the second.
+        EXPECT_EQ(plan.buffers[4].offset, plan.buffers[2].offset);
+        EXPECT_EQ(plan.buffers[5].offset, plan.buffers[3].offset);
+        EXPECT_EQ(plan.buffers[5].freeStep, 4);
+
+        EXPECT_EQ(plan.tensorBytes(), 576u);
+        EXPECT_EQ(plan.peak, 448u);
+        EXPECT_EQ(plan.maxLiveStep(), 1);
+        EXPECT_EQ(plan.liveBytes(0), 384u);
+        EXPECT_EQ(plan.fragmentation(), 0);
+        EXPECT_DOUBLE_EQ(plan.reuseRatio(), 576.0 / 448);
+        EXPECT_EQ(plan.allocator.allocs, 6u);
+        EXPECT_EQ(plan.allocator.reused, 2u);
+        EXPECT_EQ(plan.allocator.frees, 3u);
+
+        auto json = plan.toJson();
+        EXPECT_NE(json.find("\"peak\":448"), string::npos);
+        EXPECT_NE(json.find("\"allocStep\":3,\"freeStep\":4"), string::npos);
+        auto csv = plan.toCsv();
+        EXPECT_EQ(std::count(csv.begin(), csv.end(), '\n'), 7);
+        EXPECT_NE(plan.summary().find("Largest live set: 448 bytes at step 1"),
+                  string::npos);
+    }
+
+    TEST(Graph, TransposeView)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto build = [&](bool materialize)
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({2, 3, 4}, DataType::Float32);
+            auto w = g->addTensor({3, 5}, DataType::Float32);
+            auto t = g->addOp<TransposeObj>(x, nullptr, vector<int>{0, 2, 1});
+            auto y = g->addOp<MatmulObj>(t->getOutput(), w, nullptr)->getOutput();
+            // Transpose of a transpose, read by a broadcast Add.
+            auto t2 = g->addOp<TransposeObj>(t->getOutput(), nullptr,
+                                             vector<int>{1, 0, 2});
+            auto b = g->addTensor({3}, DataType::Float32);
+            auto z = g->addOp<AddObj>(t2->getOutput(), b, nullptr)->getOutput();
+            if (materialize)
+                g->addOp<ReluObj>(t->getOutput(), nullptr);
+            g->dataMalloc();
+            x->setData(IncrementalGenerator());
+            w->setData(IncrementalGenerator());
+            b->setData(IncrementalGenerator());
+            runtime->run(g);
+            return std::make_tuple(g, t, t2, y, z);
+        };
+        auto [g, t, t2, y, z] = build(false);
+        auto [gRef, tRef, t2Ref, yRef, zRef] = build(true);
+
+        EXPECT_TRUE(t->isView() && t2->isView());
+        EXPECT_FALSE(t->getOutput()->isContiguous());
+        EXPECT_EQ(t->getOutput()->getRawDataPtr<float *>(),
+                  t->getInputs(0)->getRawDataPtr<float *>());
+        // Relu needs a dense input, so the transpose is materialized.
+        EXPECT_FALSE(tRef->isView());
+        EXPECT_TRUE(tRef->getOutput()->isContiguous());
+        EXPECT_TRUE(t2Ref->isView());
+
+        EXPECT_TRUE(y->equalData(yRef));
+        EXPECT_TRUE(z->equalData(zRef));
+    }
+
+    TEST(Graph, ViewFollowsRebinding)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 2}, DataType::Float32);
+        auto t = g->addOp<TransposeObj>(x, nullptr, vector<int>{1, 0});
+        auto zero = g->addTensor({2}, DataType::Float32);
+        auto y = g->addOp<AddObj>(t->getOutput(), zero, nullptr)->getOutput();
+        g->dataMalloc();
+        zero->setData(ZeroGenerator());
+
+        vector<float> a{1, 2, 3, 4}, b{5, 6, 7, 8};
+        g->bindInput(x, a.data(), a.size() * sizeof(float));
+        runtime->run(g);
+        EXPECT_TRUE(y->equalData(vector<float>{1, 3, 2, 4}));
+        g->bindInput(x, b.data(), b.size() * sizeof(float));
+        runtime->run(g);
+        EXPECT_TRUE(y->equalData(vector<float>{5, 7, 6, 8}));
+    }
+
+    static float kEps = 1e-5f;
+
+    static Tensor addEps(const Graph &g)
+    {
+        auto eps = g->addTensor({1}, DataType::Float32);
+        eps->setWeight();
+        eps->setExternalData(&kEps, sizeof(kEps));
+        return eps;
+    }
+
+    // Builds the decomposed form twice and checks that optimize() replaces it
+    // with the single op `type` computing the same values.
+    static void checkFusion(const std::function<Tensor(Graph, Tensor)> &build,
+                            OpType type)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph ref = make_ref<GraphObj>(runtime);
+        Graph g = make_ref<GraphObj>(runtime);
+        auto yRef = build(ref, ref->addTensor({2, 3, 8}, DataType::Float32));
+        auto y = build(g, g->addTensor({2, 3, 8}, DataType::Float32));
+        g->optimize();
+        ASSERT_EQ(g->getOperators().size(), 1u);
+        EXPECT_EQ(g->getOperators()[0]->getOpType(), type);
+        EXPECT_EQ(g->getOperators()[0]->getOutput(), y);
+
+        for (auto &graph : {ref, g})
+        {
+            graph->dataMalloc();
+            for (auto &input : graph->getInputs())
+                if (!input->isExternal())
+                    input->setData(IncrementalGenerator());
+            runtime->run(graph);
+        }
+        EXPECT_TRUE(y->equalData(yRef, 1e-5));
+    }
+
+    TEST(Graph, FuseSoftmax)
+    {
+        checkFusion(
+            [](Graph g, Tensor x)
+            {
+                auto m = g->addOp<ReduceMaxObj>(x, nullptr, vector<int>{-1});
+                auto d = g->addOp<SubObj>(x, m->getOutput(), nullptr);
+                auto e = g->addOp<ExpObj>(d->getOutput(), nullptr);
+                auto s = g->addOp<ReduceSumObj>(e->getOutput(), nullptr,
+                                                vector<int>{-1});
+                return g->addOp<DivObj>(e->getOutput(), s->getOutput(), nullptr)
+                    ->getOutput();
+            },
+            OpType::Softmax);
+
+        // The exponentials are needed elsewhere, nothing is fused.
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 8}, DataType::Float32);
+        auto e = g->addOp<ExpObj>(x, nullptr)->getOutput();
+        auto s = g->addOp<ReduceSumObj>(e, nullptr, vector<int>{1});
+        g->addOp<DivObj>(e, s->getOutput(), nullptr);
+        g->addOp<ReluObj>(e, nullptr);
+        g->optimize();
+        EXPECT_EQ(g->getOperators().size(), 4u);
+    }
+
+    TEST(Graph, FuseLayerNorm)
+    {
+        checkFusion(
+            [](Graph g, Tensor x)
+            {
+                auto mu = g->addOp<ReduceMeanObj>(x, nullptr, vector<int>{-1});
+                auto d = g->addOp<SubObj>(x, mu->getOutput(), nullptr)
+                             ->getOutput();
+                auto sq = g->addOp<MulObj>(d, d, nullptr);
+                auto v = g->addOp<ReduceMeanObj>(sq->getOutput(), nullptr,
+                                                 vector<int>{-1});
+                auto ve = g->addOp<AddObj>(v->getOutput(), addEps(g), nullptr);
+                auto r = g->addOp<SqrtObj>(ve->getOutput(), nullptr);
+                auto n = g->addOp<DivObj>(d, r->getOutput(), nullptr);
+                auto scale = g->addTensor({8}, DataType::Float32);
+                auto y = g->addOp<MulObj>(n->getOutput(), scale, nullptr);
+                auto bias = g->addTensor({8}, DataType::Float32);
+                return g->addOp<AddObj>(bias, y->getOutput(), nullptr)
+                    ->getOutput();
+            },
+            OpType::LayerNorm);
+    }
+
+    TEST(Graph, FuseRMSNorm)
+    {
+        checkFusion(
+            [](Graph g, Tensor x)
+            {
+                auto sq = g->addOp<MulObj>(x, x, nullptr);
+                auto ms = g->addOp<ReduceMeanObj>(sq->getOutput(), nullptr,
+                                                  vector<int>{1, 2});
+                auto ve = g->addOp<AddObj>(addEps(g), ms->getOutput(), nullptr);
+                auto r = g->addOp<SqrtObj>(ve->getOutput(), nullptr);
+                auto n = g->addOp<DivObj>(x, r->getOutput(), nullptr);
+                auto scale = g->addTensor({3, 8}, DataType::Float32);
+                return g->addOp<MulObj>(scale, n->getOutput(), nullptr)
+                    ->getOutput();
+            },
+            OpType::RMSNorm);
+    }
+
+    TEST(Graph, FuseEmbeddingBag)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto build = [](Graph g)
+        {
+            auto table = g->addTensor({10, 4}, DataType::Float32);
+            auto indices = g->addTensor({3, 5}, DataType::Int32);
+            auto rows = g->addOp<GatherObj>(table, indices, nullptr);
+            return g->addOp<ReduceSumObj>(rows->getOutput(), nullptr,
+                                          vector<int>{1}, false)
+                ->getOutput();
+        };
+        Graph ref = make_ref<GraphObj>(runtime);
+        Graph g = make_ref<GraphObj>(runtime);
+        auto yRef = build(ref);
+        auto y = build(g);
+        g->optimize();
+        ASSERT_EQ(g->getOperators().size(), 1u);
+        EXPECT_EQ(g->getOperators()[0]->getOpType(), OpType::EmbeddingBag);
+        EXPECT_EQ(y->getDims(), (Shape{3, 4}));
+
+        for (auto &graph : {ref, g})
+        {
+            graph->dataMalloc();
+            auto inputs = graph->getInputs();
+            inputs[0]->setData(IncrementalGenerator());
+            auto p = inputs[1]->getRawDataPtr<int32_t *>();
+            for (size_t i = 0; i < inputs[1]->size(); ++i)
+                p[i] = i * 3 % 10;
+            runtime->run(graph);
+        }
+        EXPECT_TRUE(y->equalData(yRef));
+
+        // Summing over the table axis is not a bag.
+        Graph other = make_ref<GraphObj>(runtime);
+        auto table = other->addTensor({10, 4}, DataType::Float32);
+        auto indices = other->addTensor({3, 5}, DataType::Int32);
+        auto rows = other->addOp<GatherObj>(table, indices, nullptr);
+        other->addOp<ReduceSumObj>(rows->getOutput(), nullptr, vector<int>{2});
+        other->optimize();
+        EXPECT_EQ(other->getOperators().size(), 2u);
+    }
+
+    TEST(Graph, FuseElementwise)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({4, 8}, DataType::Float32);
+        auto b = g->addTensor({8}, DataType::Float32);
+        auto p = g->addTensor({1, 8}, DataType::Float32);
+        // a feeds two ops and stays, r and e are computed in the Mul's tree.
+        auto a = g->addOp<AddObj>(x, b, nullptr)->getOutput();
+        auto r = g->addOp<ReluObj>(a, nullptr)->getOutput();
+        auto e = g->addOp<ExpObj>(a, nullptr)->getOutput();
+        auto m = g->addOp<MulObj>(r, e, nullptr)->getOutput();
+        // q has a smaller shape than the Div reading it, and is left to its
+        // own op.
+        auto q = g->addOp<SqrtObj>(p, nullptr)->getOutput();
+        auto y = g->addOp<DivObj>(m, q, nullptr)->getOutput();
+        auto clipped = g->addOp<ClipObj>(y, nullptr, 0.f, std::nullopt);
+        g->optimize();
+
+        ASSERT_EQ(g->getOperators().size(), 3u);
+        EXPECT_EQ(a->getSource()->getOpType(), OpType::Add);
+        EXPECT_EQ(q->getSource()->getOpType(), OpType::Sqrt);
+        auto fused = as<FusedElementwiseObj>(clipped->getOutput()->getSource());
+        ASSERT_EQ(fused->getOpType(), OpType::FusedElementwise);
+        EXPECT_EQ(fused->getInputs(), (TensorVec{a, q}));
+        EXPECT_EQ(fused->getExpr().signature(),
+                  "i0 relu(0) exp(0) mul(1,2) i1 div(3,4) c0x0p+0f max(5,6)");
+        EXPECT_EQ(g->getTensors().size(), 6u);
+        EXPECT_TRUE(g->checkValid());
+    }
+
+    TEST(Graph, BlockConvolutions)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto build = [](Graph g)
+        {
+            auto x = g->addTensor({1, 8, 6, 6}, DataType::Float32);
+            auto w1 = g->addTensor({16, 8, 3, 3}, DataType::Float32);
+            auto w2 = g->addTensor({16, 16, 1, 1}, DataType::Float32);
+            auto c1 = g->addOp<ConvObj>(x, w1, nullptr, nullptr,
+                                        vector<int>{1, 1, 1, 1});
+            auto r = g->addOp<ReluObj>(c1->getOutput(), nullptr)->getOutput();
+            r = g->addOp<MaxPoolObj>(r, nullptr, vector<int>{2, 2},
+                                     vector<int>{0, 0, 0, 0},
+                                     vector<int>{2, 2})
+                    ->getOutput();
+            auto c2 = g->addOp<ConvObj>(r, w2, nullptr, nullptr);
+            return g->addOp<AddObj>(c2->getOutput(), r, nullptr)->getOutput();
+        };
+        Graph ref = make_ref<GraphObj>(runtime);
+        Graph g = make_ref<GraphObj>(runtime);
+        auto yRef = build(ref);
+        auto y = build(g);
+        g->optimize();
+
+        // Only the graph input and output are reordered.
+        int reorders = 0, blocked = 0;
+        for (auto &op : g->getOperators())
+        {
+            reorders += op->getOpType() == OpType::Reorder;
+            blocked += op->getOpType() == OpType::Conv &&
+                       as<ConvObj>(op)->isBlocked();
+        }
+        EXPECT_EQ(reorders, 2);
+        EXPECT_EQ(blocked, 2);
+        EXPECT_EQ(g->getOperators().size(), 7u);
+        EXPECT_EQ(y->getSource()->getOpType(), OpType::Reorder);
+
+        for (auto &graph : {ref, g})
+        {
+            graph->dataMalloc();
+            for (auto &input : graph->getInputs())
+            {
+                auto p = input->getRawDataPtr<float *>();
+                for (size_t i = 0; i < input->size(); ++i)
+                    p[i] = float(int(i % 13) - 6) * 0.125f;
+            }
+            runtime->run(graph);
+        }
+        EXPECT_TRUE(y->equalData(yRef, 1e-5));
+    }
+
+    TEST(Graph, SparsifyMatmuls)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        // Runs of eight nonzeros in every fourth row, and a dense weight.
+        static vector<float> sparse(32 * 24, 0.f), dense(24 * 24, 0.5f);
+        for (int i = 0; i < 32; i += 4)
+            for (int j : {0, 16})
+                for (int c = 0; c < 8; ++c)
+                    sparse[i * 24 + j + c] = float(i - c);
+        auto build = [](Graph g, bool transB)
+        {
+            auto x = g->addTensor({2, 5, 32}, DataType::Float32);
+            Shape dims = transB ? Shape{24, 32} : Shape{32, 24};
+            auto w1 = g->addTensor(dims, DataType::Float32);
+            w1->setWeight();
+            w1->setExternalData(sparse.data(), sparse.size() * sizeof(float));
+            auto w2 = g->addTensor({24, 24}, DataType::Float32);
+            w2->setWeight();
+            w2->setExternalData(dense.data(), dense.size() * sizeof(float));
+            auto y = g->addOp<MatmulObj>(x, w1, nullptr, false, transB);
+            return g->addOp<MatmulObj>(y->getOutput(), w2, nullptr)
+                ->getOutput();
+        };
+        for (bool transB : {false, true})
+        {
+            Graph ref = make_ref<GraphObj>(runtime);
+            Graph g = make_ref<GraphObj>(runtime);
+            auto yRef = build(ref, transB);
+            auto y = build(g, transB);
+            g->optimize();
+            ASSERT_EQ(g->getOperators().size(), 2u);
+            EXPECT_EQ(y->getSource()->getOpType(), OpType::MatMul);
+            auto op = y->getSource()->getInputs(0)->getSource();
+            ASSERT_EQ(op->getOpType(), OpType::SparseMatmul);
+            if (!transB)
+            {
+                EXPECT_EQ(as<SparseMatmulObj>(op)->getBlockRows(), 1);
+                EXPECT_EQ(as<SparseMatmulObj>(op)->getBlockCols(), 8);
+            }
+            EXPECT_EQ(g->getTensors().size(), 7u);
+
+            for (auto &graph : {ref, g})
+            {
+                graph->dataMalloc();
+                graph->getInputs()[0]->setData(IncrementalGenerator());
+                runtime->run(graph);
+            }
+            EXPECT_TRUE(y->equalData(yRef));
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+
+#include "test.h"
+
+namespace infini
+{
+    class NopKernel : public CpuKernelWithoutConfig
+    {
+        void compute(const Operator &op,
+                     const RuntimeObj *context) const override {}
+    };
+
+    TEST(KernelRegistry, Candidates)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({1, 8}, DataType::Float32);
+        auto b = g->addTensor({8, 4}, DataType::Float32);
+        auto row = g->addOp<MatmulObj>(a, b, nullptr);
+        auto c = g->addTensor({4, 8}, DataType::Float32);
+        auto square = g->addOp<MatmulObj>(c, b, nullptr);
+
+        // Registered out of priority order.
+        KernelRegistry registry;
+        KernelAttrs key{Device::CPU, OpType::MatMul};
+        auto oneRow = [](const OperatorObj &op)
+        { return static_cast<const MatmulObj &>(op).getM() == 1; };
+        auto never = [](const OperatorObj &op) { return false; };
+        auto general = new NopKernel(), gemv = new NopKernel(),
+             unused = new NopKernel();
+        registry.registerKernel(key, general, "general");
+        registry.registerKernel(key, unused, "unused", 2, never);
+        registry.registerKernel(key, gemv, "gemv", 1, oneRow);
+        ASSERT_EQ(registry.getCandidates(key).size(), 3u);
+        EXPECT_EQ(registry.getCandidates(key)[0].name, "unused");
+        EXPECT_EQ(registry.getCandidates(key)[2].name, "general");
+
+        EXPECT_EQ(registry.select(key, *row)->name, "gemv");
+        EXPECT_EQ(registry.getKernel(key, *square), general);
+        EXPECT_EQ(registry.getKernel(key), general);
+        EXPECT_EQ(registry.getKernelItem(key).name, "general");
+
+        // Names and priorities are unique per key.
+        EXPECT_THROW(registry.registerKernel(key, nullptr, "general", 3),
+                     Exception);
+        EXPECT_THROW(registry.registerKernel(key, nullptr, "other", 1),
+                     Exception);
+
+        // Keys without a kernel, or none that applies.
+        KernelAttrs other{Device::CPU, OpType::Add};
+        EXPECT_EQ(registry.select(other, *row), nullptr);
+        EXPECT_THROW(registry.getKernel(other), Exception);
+        registry.registerKernel(other, new NopKernel(), "add", 0, never);
+        EXPECT_THROW(registry.getKernel(other, *row), Exception);
+        EXPECT_THROW(registry.getKernel(other), Exception);
+    }
+
+} // namespace infini
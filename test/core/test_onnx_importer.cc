@@ -0,0 +1,180 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/onnx_importer.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    namespace
+    {
+        // Hand-rolled protobuf encoding of the few onnx.proto messages used
+        // below, so that the test does not depend on the onnx package.
+        struct Proto
+        {
+            string buf;
+
+            Proto &varint(uint64_t v)
+            {
+                do
+                {
+                    buf += char((v & 0x7f) | (v > 0x7f ? 0x80 : 0));
+                    v >>= 7;
+                } while (v);
+                return *this;
+            }
+            Proto &key(int field, int wire) { return varint(field << 3 | wire); }
+            Proto &i(int field, int64_t v) { return key(field, 0).varint(v); }
+            Proto &f(int field, float v)
+            {
+                key(field, 5);
+                buf.append(reinterpret_cast<char *>(&v), 4);
+                return *this;
+            }
+            Proto &s(int field, const string &v)
+            {
+                key(field, 2).varint(v.size());
+                buf += v;
+                return *this;
+            }
+            Proto &m(int field, const Proto &v) { return s(field, v.buf); }
+        };
+
+        Proto tensor(const string &name, vector<int64_t> dims,
+                     vector<float> data)
+        {
+            Proto t;
+            for (auto d : dims)
+                t.i(1, d);
+            t.i(2, 1).s(8, name);
+            t.s(9, string(reinterpret_cast<char *>(data.data()),
+                          data.size() * sizeof(float)));
+            return t;
+        }
+
+        Proto valueInfo(const string &name, int dtype, vector<int64_t> dims)
+        {
+            Proto shape, tensorType, type;
+            for (auto d : dims)
+                shape.m(1, Proto().i(1, d));
+            tensorType.i(1, dtype).m(2, shape);
+            type.m(1, tensorType);
+            return Proto().s(1, name).m(2, type);
+        }
+
+        Proto node(const string &type, vector<string> inputs,
+                   vector<string> outputs, vector<Proto> attrs = {})
+        {
+            Proto n;
+            for (auto &s : inputs)
+                n.s(1, s);
+            for (auto &s : outputs)
+                n.s(2, s);
+            n.s(4, type);
+            for (auto &a : attrs)
+                n.m(5, a);
+            return n;
+        }
+
+        string writeModel(const Proto &graph)
+        {
+            Proto model;
+            model.i(1, 8).m(8, Proto().i(2, 13)).m(7, graph);
+            string path = testing::TempDir() + "onnx_importer_test.onnx";
+            std::ofstream(path, std::ios::binary) << model.buf;
+            return path;
+        }
+    } // namespace
+
+    TEST(OnnxImporter, Import)
+    {
+        // y = Relu(Gemm(x, w, b, transB=1)), z = Transpose(Clip(y, 0, 6))
+        // c = Cast(z -> int32)
+        Proto graph;
+        graph.m(1, node("Gemm", {"x", "w", "b"}, {"g"},
+                        {Proto().s(1, "transB").i(3, 1)}))
+            .m(1, node("Relu", {"g"}, {"y"}))
+            .m(1, node("Clip", {"y", "lo", "hi"}, {"clip"}))
+            .m(1, node("Transpose", {"clip"}, {"z"},
+                       {Proto().s(1, "perm").i(8, 1).i(8, 0)}))
+            .m(1, node("Cast", {"z"}, {"c"}, {Proto().s(1, "to").i(3, 6)}))
+            .s(2, "test")
+            .m(5, tensor("w", {3, 4}, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12}))
+            .m(5, tensor("b", {3}, {0.5, 1.5, 2.5}))
+            .m(5, tensor("lo", {}, {0}))
+            .m(5, tensor("hi", {}, {6}))
+            .m(11, valueInfo("x", 1, {-1, 4}))
+            .m(11, valueInfo("w", 1, {3, 4}))
+            .m(12, valueInfo("c", 6, {3, 2}));
+        auto path = writeModel(graph);
+
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        EXPECT_THROW(importOnnx(runtime, path), Exception); // symbolic dim
+        Graph g = importOnnx(runtime, path, {{"x", {2, 4}}});
+
+        auto inputs = g->getInputs();
+        ASSERT_EQ(inputs.size(), 3u);
+        EXPECT_EQ(inputs[0]->getDims(), (Shape{2, 4}));
+        EXPECT_FALSE(inputs[0]->isWeight());
+        EXPECT_TRUE(inputs[1]->isWeight() && inputs[2]->isWeight());
+        EXPECT_TRUE(inputs[2]->equalData(vector<float>{0.5, 1.5, 2.5}));
+
+        auto &ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 6u);
+        auto matmul = as<MatmulObj>(ops[0]);
+        EXPECT_TRUE(matmul->getTransB());
+        EXPECT_EQ(ops[1]->getOpType(), OpType::Add);
+        auto clip = as<ClipObj>(ops[3]);
+        EXPECT_EQ(clip->getMin(), std::optional<float>(0));
+        EXPECT_EQ(clip->getMax(), std::optional<float>(6));
+        EXPECT_EQ(as<TransposeObj>(ops[4])->getPermute(), (vector<int>{1, 0}));
+        EXPECT_EQ(as<CastObj>(ops[5])->getType(), CastType::Float2Int32);
+        auto outputs = g->getOutputs();
+        ASSERT_EQ(outputs.size(), 1u);
+        EXPECT_EQ(outputs[0]->getDims(), (Shape{3, 2}));
+        EXPECT_EQ(outputs[0]->getDType(), DataType::Int32);
+        EXPECT_TRUE(g->checkValid());
+    }
+
+    TEST(OnnxImporter, GemmSharedBias)
+    {
+        // Two Gemms with beta = 2 share b, also read by an Add: b is scaled
+        // once per Gemm and left unchanged for the Add.
+        Proto graph;
+        graph.m(1, node("Gemm", {"x", "w", "b"}, {"g1"},
+                        {Proto().s(1, "beta").i(20, 1).f(2, 2.f)}))
+            .m(1, node("Gemm", {"x", "w", "b"}, {"g2"},
+                       {Proto().s(1, "beta").i(20, 1).f(2, 2.f)}))
+            .m(1, node("Add", {"g1", "g2"}, {"s"}))
+            .m(1, node("Add", {"s", "b"}, {"y"}))
+            .s(2, "test")
+            .m(5, tensor("w", {2, 2}, {1, 0, 0, 1}))
+            .m(5, tensor("b", {2}, {1, 2}))
+            .m(11, valueInfo("x", 1, {1, 2}))
+            .m(12, valueInfo("y", 1, {1, 2}));
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = importOnnx(runtime, writeModel(graph));
+        g->dataMalloc();
+        auto x = g->getInputs()[0];
+        ASSERT_FALSE(x->isWeight());
+        x->getRawDataPtr<float *>()[0] = 3;
+        x->getRawDataPtr<float *>()[1] = 4;
+        runtime->run(g);
+        // 2 * (x + 2b) + b
+        EXPECT_TRUE(g->getOutputs()[0]->equalData(vector<float>{11, 18}));
+    }
+
+    TEST(OnnxImporter, UnsupportedOperator)
+    {
+        Proto graph;
+        graph.m(1, node("Softsign", {"x"}, {"y"}))
+            .m(11, valueInfo("x", 1, {2}));
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        EXPECT_THROW(importOnnx(runtime, writeModel(graph)), Exception);
+    }
+
+} // namespace infini
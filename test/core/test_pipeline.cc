@@ -0,0 +1,124 @@
+#include "core/graph.h"
+#include "core/pipeline.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/gather.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    // Three dense layers with a residual from the first layer to the last,
+    // which crosses every cut.
+    static Tensor buildLayers(const Graph &g, const Tensor &x,
+                              const vector<float> &weight)
+    {
+        auto h = x, first = Tensor();
+        for (int i = 0; i < 3; ++i)
+        {
+            auto w = g->addTensor({16, 16}, DataType::Float32);
+            w->setWeight();
+            w->setExternalData(const_cast<float *>(weight.data()),
+                               weight.size() * sizeof(float));
+            h = g->addOp<MatmulObj>(h, w, nullptr)->getOutput();
+            h = g->addOp<ReluObj>(h, nullptr)->getOutput();
+            if (i == 0)
+                first = h;
+        }
+        return g->addOp<AddObj>(h, first, nullptr)->getOutput();
+    }
+
+    TEST(Pipeline, Partition)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({64, 64}, DataType::Float32);
+        auto w = g->addTensor({64, 64}, DataType::Float32);
+        // Matmuls cost 64 times as much as the relus in between.
+        for (int i = 0; i < 4; ++i)
+        {
+            x = g->addOp<MatmulObj>(x, w, nullptr)->getOutput();
+            x = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        }
+        ASSERT_TRUE(g->topo_sort());
+        const auto &ops = g->getOperators();
+        EXPECT_EQ(Pipeline::estimateCost(ops[0]), 64.0 * 64 * 64);
+        EXPECT_EQ(Pipeline::estimateCost(ops[1]), 2.0 * 64 * 64);
+
+        auto parts = Pipeline::partition(ops, 2);
+        ASSERT_EQ(parts.size(), 2u);
+        EXPECT_EQ(parts[0].size(), 4u);
+        EXPECT_EQ(parts[1].size(), 4u);
+        parts = Pipeline::partition(ops, 4);
+        ASSERT_EQ(parts.size(), 4u);
+        for (auto &part : parts)
+            EXPECT_EQ(part[0]->getOpType(), OpType::MatMul);
+        EXPECT_EQ(Pipeline::partition(ops, 100).size(), 8u);
+        EXPECT_EQ(Pipeline::partition(ops, 1).size(), 1u);
+    }
+
+    TEST(Pipeline, Run)
+    {
+        vector<float> weight(16 * 16);
+        for (size_t i = 0; i < weight.size(); ++i)
+            weight[i] = float(int(i % 7) - 3) / 8;
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph ref = make_ref<GraphObj>(runtime);
+        auto yRef = buildLayers(ref, ref->addTensor({4, 16}), weight);
+        ref->dataMalloc();
+        Graph g = make_ref<GraphObj>(runtime);
+        buildLayers(g, g->addTensor({4, 16}), weight);
+
+        for (int stages : {1, 3, 4})
+        {
+            Pipeline pipeline(g, Pipeline::threadGroups(stages));
+            EXPECT_EQ((int)pipeline.getStages().size(), stages);
+            ASSERT_EQ(pipeline.getInputs().size(), 1u);
+            ASSERT_EQ(pipeline.getOutputs().size(), 1u);
+
+            const int n = 10;
+            vector<vector<float>> xs(n, vector<float>(64)),
+                ys(n, vector<float>(64));
+            vector<std::future<void>> done;
+            for (int b = 0; b < n; ++b)
+            {
+                for (int i = 0; i < 64; ++i)
+                    xs[b][i] = float((i * 5 + b) % 11) - 5;
+                done.emplace_back(pipeline.submit({xs[b].data()},
+                                                  {ys[b].data()}));
+            }
+            for (int b = 0; b < n; ++b)
+            {
+                done[b].get();
+                std::copy(xs[b].begin(), xs[b].end(),
+                          ref->getInputs()[0]->getRawDataPtr<float *>());
+                runtime->run(ref);
+                EXPECT_TRUE(yRef->equalData(ys[b]));
+            }
+        }
+    }
+
+    TEST(Pipeline, Errors)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto data = g->addTensor({5, 3}, DataType::Float32);
+        auto indices = g->addTensor({2}, DataType::Int32);
+        auto rows = g->addOp<GatherObj>(data, indices, nullptr)->getOutput();
+        g->addOp<ReluObj>(rows, nullptr);
+
+        Pipeline pipeline(g, Pipeline::threadGroups(2));
+        ASSERT_EQ(pipeline.getStages().size(), 2u);
+        vector<float> table(15, 1.f), out(6);
+        int32_t good[2] = {4, 1}, bad[2] = {0, 5};
+        auto failed = pipeline.submit({table.data(), bad}, {out.data()});
+        auto ok = pipeline.submit({table.data(), good}, {out.data()});
+        EXPECT_THROW(failed.get(), Exception);
+        ok.get();
+        EXPECT_EQ(out, vector<float>(6, 1.f));
+        pipeline.wait();
+    }
+
+} // namespace infini
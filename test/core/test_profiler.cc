@@ -0,0 +1,81 @@
+#include "core/graph.h"
+#include "core/profiler.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(Profiler, PerfCounters)
+    {
+        PerfCounters counters({0});
+        // The task clock is a software event, available without permission
+        // to count hardware events.
+        ASSERT_TRUE(counters.isAvailable(PerfCounters::TaskClock))
+            << counters.getError();
+        if (counters.getAvailable() != (1u << PerfCounters::kEvents) - 1)
+        {
+            EXPECT_FALSE(counters.getError().empty());
+        }
+        auto before = counters.read();
+        volatile double x = 0;
+        for (int i = 0; i < 1000000; ++i)
+            x = x + i;
+        auto after = counters.read();
+        EXPECT_GT(after[PerfCounters::TaskClock],
+                  before[PerfCounters::TaskClock]);
+        if (counters.isAvailable(PerfCounters::Instructions))
+        {
+            EXPECT_GT(after[PerfCounters::Instructions] -
+                          before[PerfCounters::Instructions],
+                      1000000u);
+        }
+    }
+
+    TEST(Profiler, Run)
+    {
+        auto runtime = make_ref<NativeCpuRuntimeObj>(CpuConfig{2});
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({64, 64}, DataType::Float32);
+        auto w = g->addTensor({64, 64}, DataType::Float32);
+        auto y = g->addOp<MatmulObj>(x, w, nullptr)->getOutput();
+        g->addOp<ReluObj>(y, nullptr);
+        g->dataMalloc();
+
+        runtime->run(g);
+        EXPECT_EQ(runtime->getProfiler(), nullptr);
+        runtime->setProfiling(true);
+        auto profiler = runtime->getProfiler();
+        ASSERT_NE(profiler, nullptr);
+        for (int i = 0; i < 3; ++i)
+            runtime->run(g);
+
+        auto entries = profiler->getEntries();
+        ASSERT_EQ(entries.size(), 2u);
+        EXPECT_EQ(entries[0].guid, g->getOperators()[0]->getGuid());
+        EXPECT_EQ(entries[0].type, OpType::MatMul);
+        EXPECT_EQ(entries[1].type, OpType::Relu);
+        for (const auto &entry : entries)
+        {
+            EXPECT_EQ(entry.calls, 3u);
+            EXPECT_GT(entry.seconds, 0);
+        }
+        ASSERT_TRUE(profiler->isAvailable(PerfCounters::TaskClock));
+        EXPECT_GT(entries[0].counters[PerfCounters::TaskClock], 0u);
+        if (!profiler->isAvailable(PerfCounters::Cycles))
+        {
+            EXPECT_EQ(entries[0].counters[PerfCounters::Cycles], 0u);
+        }
+        auto summary = profiler->summary();
+        EXPECT_NE(summary.find("MatMul"), string::npos);
+        EXPECT_NE(summary.find("task_clock_ns"), string::npos);
+
+        profiler->reset();
+        EXPECT_TRUE(profiler->getEntries().empty());
+        runtime->setProfiling(false);
+        EXPECT_EQ(runtime->getProfiler(), nullptr);
+    }
+
+} // namespace infini
@@ -0,0 +1,108 @@
+#include "core/data_type.h"
+#include "core/result_cache.h"
+#include "utils/hash.h"
+
+#include "test.h"
+#include <cstring>
+#include <set>
+
+namespace infini
+{
+    TEST(ResultCache, Hash)
+    {
+        // Every length around the stripe and scramble boundaries, and every
+        // single-bit flip of a buffer, hash differently.
+        vector<unsigned char> data(2 * 64 * 16 + 3);
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = i * 31 % 251;
+        std::set<uint64_t> hashes;
+        for (size_t n = 0; n <= data.size(); ++n)
+            hashes.insert(hashBytes(data.data(), n));
+        EXPECT_EQ(hashes.size(), data.size() + 1);
+        for (size_t i = 0; i < data.size(); i += 37)
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                data[i] ^= 1 << bit;
+                hashes.insert(hashBytes(data.data(), data.size()));
+                data[i] ^= 1 << bit;
+            }
+        EXPECT_EQ(hashes.size(), data.size() + 1 + (data.size() + 36) / 37 * 8);
+        EXPECT_EQ(hashBytes(data.data(), 100), hashBytes(data.data(), 100));
+        EXPECT_NE(hashBytes(data.data(), 100, 1), hashBytes(data.data(), 100));
+
+        // Zeros of different lengths, and bytes moved between buffers.
+        vector<char> zeros(128);
+        EXPECT_NE(hashBytes(zeros.data(), 64), hashBytes(zeros.data(), 128));
+        const void *p = data.data(), *q = data.data() + 10;
+        EXPECT_NE(ResultCache::hash({p, q}, {10, 20}),
+                  ResultCache::hash({p, q}, {10, 19}));
+        EXPECT_NE(ResultCache::hash({p, q}, {10, 20}),
+                  ResultCache::hash({p}, {30}));
+    }
+
+    TEST(ResultCache, Lru)
+    {
+        ResultCache cache(100);
+        vector<char> x(10), y(30);
+        auto insert = [&](char value)
+        {
+            std::fill(x.begin(), x.end(), value);
+            std::fill(y.begin(), y.end(), value);
+            cache.insert(ResultCache::hash({x.data()}, {10}), {x.data()},
+                         {10}, {y.data()}, {30});
+        };
+        auto find = [&](char value)
+        {
+            std::fill(x.begin(), x.end(), value);
+            return cache.find(ResultCache::hash({x.data()}, {10}), {x.data()},
+                              {10});
+        };
+        insert(1);
+        insert(2);
+        auto entry = find(1);
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(entry->outputs, (vector<vector<char>>{vector<char>(30, 1)}));
+        // 2 is the least recently used, evicted by 3.
+        insert(3);
+        EXPECT_EQ(find(2), nullptr);
+        EXPECT_NE(find(1), nullptr);
+        EXPECT_NE(find(3), nullptr);
+        auto stats = cache.getStats();
+        EXPECT_EQ(stats.hits, 3u);
+        EXPECT_EQ(stats.misses, 1u);
+        EXPECT_EQ(stats.evictions, 1u);
+        EXPECT_EQ(stats.entries, 2u);
+        EXPECT_EQ(stats.bytes, 80u);
+
+        // Inserted twice, stored once; larger than the budget, not stored.
+        insert(3);
+        EXPECT_EQ(cache.getStats().entries, 2u);
+        vector<char> big(101);
+        cache.insert(0, {big.data()}, {101}, {}, {});
+        EXPECT_EQ(cache.getStats().evictions, 1u);
+        EXPECT_EQ(cache.find(0, {big.data()}, {101}), nullptr);
+
+        cache.clear();
+        EXPECT_EQ(find(1), nullptr);
+        EXPECT_EQ(cache.getStats().entries, 0u);
+        EXPECT_EQ(cache.getStats().misses, 1u);
+    }
+
+    TEST(ResultCache, Collision)
+    {
+        // Entries under the same hash are told apart by their inputs.
+        ResultCache cache(1000);
+        int a = 1, b = 2, ya = 10, yb = 20;
+        cache.insert(7, {&a}, {sizeof a}, {&ya}, {sizeof ya});
+        cache.insert(7, {&b}, {sizeof b}, {&yb}, {sizeof yb});
+        EXPECT_EQ(cache.getStats().entries, 2u);
+        auto entry = cache.find(7, {&b}, {sizeof b});
+        ASSERT_NE(entry, nullptr);
+        int y;
+        std::memcpy(&y, entry->outputs[0].data(), sizeof y);
+        EXPECT_EQ(y, 20);
+        int c = 3;
+        EXPECT_EQ(cache.find(7, {&c}, {sizeof c}), nullptr);
+    }
+
+} // namespace infini
@@ -0,0 +1,59 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+
+#include "test.h"
+#include <algorithm>
+#include <sched.h>
+
+namespace infini
+{
+    TEST(Runtime, PinnedRun)
+    {
+        auto runtime = make_ref<NativeCpuRuntimeObj>(CpuConfig{1, {0}});
+        EXPECT_EQ(runtime->getConfig().threads, 1);
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({256, 256}, DataType::Float32);
+        auto b = g->addTensor({256, 256}, DataType::Float32);
+        auto c = g->addOp<AddObj>(a, b, nullptr)->getOutput();
+        g->dataMalloc();
+        a->setData(OneGenerator());
+        b->setData(IncrementalGenerator());
+        cpu_set_t before, after;
+        ASSERT_EQ(sched_getaffinity(0, sizeof(before), &before), 0);
+        runtime->run(g);
+        EXPECT_EQ(c->getRawDataPtr<float *>()[5], 6);
+
+        // The calling thread, part of the team during the run, keeps its
+        // own CPUs afterwards.
+        ASSERT_EQ(sched_getaffinity(0, sizeof(after), &after), 0);
+        EXPECT_TRUE(CPU_EQUAL(&before, &after));
+    }
+
+    TEST(Runtime, MappedAlloc)
+    {
+        for (auto &runtime : NativeCpuRuntimeObj::perNumaNode())
+        {
+            auto &config = runtime->getConfig();
+            EXPECT_TRUE(config.numaNode < 0 || !config.cpus.empty());
+            for (size_t bytes : {size_t(100), size_t(1) << 20})
+            {
+                auto p = static_cast<char *>(runtime->alloc(bytes));
+                ASSERT_NE(p, nullptr);
+                EXPECT_EQ(std::count(p, p + bytes, 0), (long)bytes);
+                p[bytes - 1] = 1;
+                runtime->dealloc(p);
+            }
+        }
+    }
+
+    TEST(Runtime, NodeRuntime)
+    {
+        auto runtime = make_ref<NativeCpuRuntimeObj>(CpuConfig{0, {}, 0});
+        EXPECT_EQ(runtime->getConfig().threads,
+                  (int)runtime->getConfig().cpus.size());
+        EXPECT_EQ(runtime->toString(), "CPU Runtime (node 0)");
+        EXPECT_THROW(make_ref<NativeCpuRuntimeObj>(CpuConfig{0, {}, 1 << 20}),
+                     Exception);
+    }
+} // namespace infini
@@ -0,0 +1,171 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "core/serializer.h"
+#include "operators/element_wise.h"
+#include "operators/fused_elementwise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace infini
+{
+    TEST(Serializer, SaveAndLoad)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        string path = testing::TempDir() + "serializer_test.itm";
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({2, 3}, DataType::Float32);
+            auto w = g->addTensor({2, 3}, DataType::Float32);
+            w->setWeight();
+            auto y = g->addOp<AddObj>(x, w, nullptr)->getOutput();
+            auto z = g->addOp<ClipObj>(y, nullptr, 2.f, std::nullopt)->getOutput();
+            auto b = g->addTensor({4, 3}, DataType::Float32);
+            g->addOp<MatmulObj>(z, b, nullptr, false, true);
+            g->dataMalloc();
+            w->setData(IncrementalGenerator());
+            saveGraph(g, path);
+        }
+
+        Graph g = loadGraph(runtime, path);
+        ASSERT_EQ(g->getOperators().size(), 3u);
+        ASSERT_EQ(g->getTensors().size(), 6u);
+        auto w = g->getTensors()[1];
+        EXPECT_TRUE(w->isWeight() && w->isExternal());
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(w->getRawDataPtr<void *>()) %
+                      kModelAlignment,
+                  0u);
+        EXPECT_TRUE(w->equalData(vector<float>{0, 1, 2, 3, 4, 5}));
+
+        auto clip = as<ClipObj>(g->getOperators()[1]);
+        EXPECT_EQ(clip->getMin(), std::optional<float>(2.f));
+        EXPECT_FALSE(clip->getMax().has_value());
+        auto matmul = as<MatmulObj>(g->getOperators()[2]);
+        EXPECT_FALSE(matmul->getTransA());
+        EXPECT_TRUE(matmul->getTransB());
+        EXPECT_EQ(matmul->getOutput()->getDims(), (Shape{2, 4}));
+
+        // Weights stay in the mapping, only activations go to the arena.
+        auto x = g->getInputs()[0];
+        g->dataMalloc();
+        x->setData(OneGenerator());
+        g->removeOperator(matmul);
+        runtime->run(g);
+        EXPECT_TRUE(clip->getOutput()->equalData(vector<float>{2, 2, 3, 4, 5, 6}));
+    }
+
+    TEST(Serializer, FusedElementwise)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        string path = testing::TempDir() + "serializer_fused_test.itm";
+        string signature;
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({2, 3}, DataType::Float32);
+            auto b = g->addTensor({3}, DataType::Float32);
+            auto y = g->addOp<AddObj>(x, b, nullptr)->getOutput();
+            y = g->addOp<ClipObj>(y, nullptr, -1.f, 2.5f)->getOutput();
+            g->addOp<ExpObj>(y, nullptr);
+            g->optimize();
+            ASSERT_EQ(g->getOperators().size(), 1u);
+            signature = as<FusedElementwiseObj>(g->getOperators()[0])
+                            ->getExpr()
+                            .signature();
+            g->dataMalloc();
+            saveGraph(g, path);
+        }
+
+        Graph g = loadGraph(runtime, path);
+        ASSERT_EQ(g->getOperators().size(), 1u);
+        auto fused = as<FusedElementwiseObj>(g->getOperators()[0]);
+        EXPECT_EQ(fused->getExpr().signature(), signature);
+        EXPECT_EQ(fused->getOutput()->getDims(), (Shape{2, 3}));
+    }
+
+    TEST(Serializer, RejectsInvalidFile)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        string path = testing::TempDir() + "serializer_invalid.itm";
+        std::ofstream(path) << "not a model file, definitely not one";
+        EXPECT_THROW(loadGraph(runtime, path), Exception);
+        EXPECT_THROW(loadGraph(runtime, path + ".missing"), Exception);
+    }
+
+    TEST(Serializer, RejectsCorruptedFile)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        string path = testing::TempDir() + "serializer_valid.itm",
+               corrupted = testing::TempDir() + "serializer_corrupted.itm";
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            g->addOp<ReluObj>(g->addTensor({4}, DataType::Float32), nullptr);
+            saveGraph(g, path);
+        }
+        // Copies the file with the value at `offset` replaced.
+        auto corrupt = [&](size_t offset, auto value)
+        {
+            std::ifstream in(path, std::ios::binary);
+            string bytes((std::istreambuf_iterator<char>(in)), {});
+            std::memcpy(&bytes[offset], &value, sizeof(value));
+            std::ofstream(corrupted, std::ios::binary) << bytes;
+        };
+        // The 40-byte header ends with the weight offset and size, followed
+        // by two 16-byte tensor records (dtype, flags, rank and one dim),
+        // then by the op's type.
+        const size_t weightOffset = 24, weightBytes = 32, rank = 48,
+                     opType = 72;
+        corrupt(rank, uint32_t(1));
+        ASSERT_NO_THROW(loadGraph(runtime, corrupted));
+
+        corrupt(weightOffset, uint64_t(0));
+        EXPECT_THROW(loadGraph(runtime, corrupted), Exception);
+        // Wraps around with the weight offset.
+        corrupt(weightBytes, ~uint64_t(0) - 63);
+        EXPECT_THROW(loadGraph(runtime, corrupted), Exception);
+        corrupt(rank, ~uint32_t(0));
+        EXPECT_THROW(loadGraph(runtime, corrupted), Exception);
+        // An Add with the Relu's single input.
+        corrupt(opType, uint16_t(OpType::Add));
+        EXPECT_THROW(loadGraph(runtime, corrupted), Exception);
+        std::remove(path.c_str());
+        std::remove(corrupted.c_str());
+    }
+
+    TEST(Serializer, RejectsInvalidPermutation)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        string path = testing::TempDir() + "serializer_transpose.itm";
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            g->addOp<TransposeObj>(g->addTensor({2, 3}, DataType::Float32),
+                                   nullptr, vector<int>{1, 0});
+            saveGraph(g, path);
+        }
+        // Two 20-byte tensor records follow the 40-byte header. The op's
+        // type, tensor counts and indices take 18 bytes, then come the sizes
+        // of its attributes and of the perm.
+        const size_t perm = 40 + 2 * 20 + 18 + 2 * 4;
+        auto setFirstAxis = [&](int32_t axis)
+        {
+            std::fstream file(path,
+                              std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(perm);
+            file.write(reinterpret_cast<const char *>(&axis), sizeof(axis));
+        };
+        setFirstAxis(1);
+        ASSERT_NO_THROW(loadGraph(runtime, path));
+        for (int32_t axis : {7, -1, 0})
+        {
+            setFirstAxis(axis);
+            EXPECT_THROW(loadGraph(runtime, path), Exception) << axis;
+        }
+        std::remove(path.c_str());
+    }
+
+} // namespace infini
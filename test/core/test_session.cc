@@ -0,0 +1,157 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "core/session.h"
+#include "operators/element_wise.h"
+#include "operators/gather.h"
+
+#include "test.h"
+#include <atomic>
+
+namespace infini
+{
+    TEST(Session, Submit)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({4, 256}, DataType::Float32);
+        auto b = g->addTensor({4, 256}, DataType::Float32);
+        auto c = g->addOp<AddObj>(a, b, nullptr)->getOutput();
+        g->addOp<MulObj>(c, b, nullptr);
+        g->dataMalloc();
+        Session session(g);
+        ASSERT_EQ(session.getInputs(), (TensorVec{a, b}));
+        ASSERT_EQ(session.getOutputs().size(), 1u);
+
+        // More requests than input buffer sets, all in flight at once.
+        const int n = 6, size = 4 * 256;
+        vector<vector<float>> xs(n, vector<float>(size)),
+            ys(n, vector<float>(size));
+        vector<std::future<void>> done;
+        for (int r = 0; r < n; ++r)
+        {
+            for (int i = 0; i < size; ++i)
+                xs[r][i] = r + i % 3;
+            done.emplace_back(
+                session.submit({xs[r].data(), xs[r].data()}, {ys[r].data()}));
+            // The request is copied in, the buffer can be reused.
+            std::fill(xs[r].begin(), xs[r].end(), -1.f);
+        }
+        for (int r = 0; r < n; ++r)
+        {
+            done[r].get();
+            for (int i = 0; i < size; i += 97)
+            {
+                float x = r + i % 3;
+                EXPECT_EQ(ys[r][i], 2 * x * x);
+            }
+        }
+        EXPECT_THROW(session.submit({xs[0].data()}, {ys[0].data()}),
+                     Exception);
+    }
+
+    TEST(Session, GraphOutlivesSession)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({256}, DataType::Float32);
+        auto c = g->addOp<MulObj>(a, a, nullptr)->getOutput();
+        g->dataMalloc();
+        auto own = c->getRawDataPtr<float *>();
+        {
+            Session session(g);
+            vector<float> x(256, 3.f), y(256);
+            session.submit({x.data()}, {y.data()}).get();
+            EXPECT_EQ(y[0], 9);
+        }
+
+        // Writes to the graph's own buffer, not the freed `y`.
+        runtime->run(g);
+        EXPECT_EQ(c->getRawDataPtr<float *>(), own);
+        EXPECT_EQ(own[0], 9);
+    }
+
+    TEST(Session, CallbackAndErrors)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto data = g->addTensor({5, 3}, DataType::Float32);
+        auto indices = g->addTensor({2}, DataType::Int32);
+        g->addOp<GatherObj>(data, indices, nullptr);
+        EXPECT_THROW(Session(g, 1), Exception);
+        g->dataMalloc();
+
+        vector<float> table(15);
+        for (int i = 0; i < 15; ++i)
+            table[i] = i;
+        int32_t good[2] = {4, 1}, bad[2] = {0, 5};
+        vector<float> out(6), other(6);
+        std::atomic<int> calls{0};
+        std::exception_ptr error;
+        {
+            Session session(g, 1);
+            session.submit({table.data(), good}, {out.data()},
+                           [&](std::exception_ptr e) { ++calls; });
+            auto failed = session.submit({table.data(), bad}, {other.data()});
+            EXPECT_THROW(failed.get(), Exception);
+            session.submit({table.data(), good}, {other.data()},
+                           [&](std::exception_ptr e)
+                           {
+                               error = e;
+                               ++calls;
+                           });
+            session.wait();
+            EXPECT_EQ(calls, 2);
+            EXPECT_FALSE(error);
+        }
+        EXPECT_EQ(out, (vector<float>{12, 13, 14, 3, 4, 5}));
+        EXPECT_EQ(other, out);
+    }
+
+    TEST(Session, ResultCache)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({64}, DataType::Float32);
+        auto b = g->addTensor({64}, DataType::Float32);
+        g->addOp<MulObj>(a, b, nullptr);
+        g->dataMalloc();
+        Session session(g);
+        EXPECT_EQ(session.getResultCache(), nullptr);
+        // Room for two requests of three 256-byte buffers.
+        session.setResultCache(2 * 3 * 256);
+        auto cache = session.getResultCache();
+        ASSERT_NE(cache, nullptr);
+
+        vector<vector<float>> xs(3, vector<float>(64));
+        for (int r = 0; r < 3; ++r)
+            for (int i = 0; i < 64; ++i)
+                xs[r][i] = r + i;
+        // x0 and x2 hit; x2 evicts x1, x1 then evicts x0 and x0 evicts x2.
+        vector<int> order = {0, 1, 0, 2, 2, 1, 0};
+        vector<vector<float>> ys(order.size(), vector<float>(64));
+        vector<std::future<void>> done;
+        for (size_t k = 0; k < order.size(); ++k)
+        {
+            done.emplace_back(session.submit(
+                {xs[order[k]].data(), xs[order[k]].data()}, {ys[k].data()}));
+            // Lets each request finish, so that the next one can hit.
+            done.back().wait();
+        }
+        for (size_t k = 0; k < order.size(); ++k)
+        {
+            done[k].get();
+            for (int i = 0; i < 64; ++i)
+                EXPECT_EQ(ys[k][i], xs[order[k]][i] * xs[order[k]][i]);
+        }
+        auto stats = cache->getStats();
+        EXPECT_EQ(stats.hits, 2u);
+        EXPECT_EQ(stats.misses, 5u);
+        EXPECT_EQ(stats.evictions, 3u);
+        EXPECT_EQ(stats.entries, 2u);
+        EXPECT_EQ(stats.bytes, 2 * 3 * 256u);
+
+        session.setResultCache(0);
+        EXPECT_EQ(session.getResultCache(), nullptr);
+    }
+
+} // namespace infini
@@ -0,0 +1,58 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(Tensor, BindExternalData)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({2, 3}, DataType::Float32);
+        auto b = g->addTensor({2, 3}, DataType::Float32);
+        auto op = g->addOp<AddObj>(a, b, nullptr);
+        auto c = op->getOutput();
+
+        vector<float> bufA{0, 1, 2, 3, 4, 5}, bufB(6, 1), bufC(6, 0);
+        g->bindInput(a, bufA.data(), bufA.size() * sizeof(float));
+        g->bindInput(b, bufB.data(), bufB.size() * sizeof(float));
+        g->bindOutput(c, bufC.data(), bufC.size() * sizeof(float));
+        EXPECT_TRUE(a->isExternal() && b->isExternal() && c->isExternal());
+        g->dataMalloc();
+        EXPECT_EQ(c->getRawDataPtr<float *>(), bufC.data());
+
+        runtime->run(g);
+        EXPECT_EQ(bufC, (vector<float>{1, 2, 3, 4, 5, 6}));
+
+        // Rebinding for the next request does not copy either.
+        vector<float> bufA2(6, 10);
+        g->bindInput(a, bufA2.data(), bufA2.size() * sizeof(float));
+        runtime->run(g);
+        EXPECT_EQ(bufC, (vector<float>(6, 11)));
+    }
+
+    TEST(Tensor, BindExternalDataValidation)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({2, 3}, DataType::Float32);
+        auto b = g->addTensor({2, 3}, DataType::Float32);
+        auto c = g->addOp<AddObj>(a, b, nullptr)->getOutput();
+
+        vector<float> buf(8);
+        // Too small
+        EXPECT_THROW(g->bindInput(a, buf.data(), 5 * sizeof(float)), Exception);
+        // Misaligned
+        EXPECT_THROW(g->bindInput(a, reinterpret_cast<char *>(buf.data()) + 1,
+                                  6 * sizeof(float)),
+                     Exception);
+        // Not an input / not an output
+        EXPECT_THROW(g->bindInput(c, buf.data(), 6 * sizeof(float)), Exception);
+        EXPECT_THROW(g->bindOutput(a, buf.data(), 6 * sizeof(float)), Exception);
+        EXPECT_FALSE(a->isExternal());
+    }
+
+} // namespace infini
@@ -0,0 +1,122 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "core/thread_pool.h"
+#include "operators/matmul.h"
+#include "operators/reduce.h"
+
+#include "test.h"
+#include <atomic>
+#include <chrono>
+
+namespace infini
+{
+    TEST(ThreadPool, ParallelForCoversRange)
+    {
+        ThreadPool pool(4, {}, 1);
+        ThreadPool::Scope scope(pool);
+        for (size_t n : {0, 1, 3, 4, 1000})
+        {
+            vector<int> hits(n, 0);
+            parallelFor(n, 1, [&](size_t i) { ++hits[i]; });
+            EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), (long)n);
+        }
+    }
+
+    TEST(ThreadPool, Threads)
+    {
+        ThreadPool pool(4, {}, 100);
+        EXPECT_EQ(pool.size(), 4);
+        EXPECT_EQ(pool.threadsFor(10, 1), 1);
+        EXPECT_EQ(pool.threadsFor(250, 1), 2);
+        EXPECT_EQ(pool.threadsFor(3, 1000), 3);
+        EXPECT_EQ(pool.threadsFor(1000, 1000), 4);
+
+        std::atomic<int> mask{0};
+        pool.parallel(4, [&](int t, int threads)
+                      {
+                          EXPECT_EQ(threads, 4);
+                          mask |= 1 << t;
+                      });
+        EXPECT_EQ(mask, 0xf);
+    }
+
+    TEST(ThreadPool, NestedRunsInline)
+    {
+        ThreadPool pool(3, {}, 1);
+        ThreadPool::Scope scope(pool);
+        std::atomic<int> total{0};
+        parallelFor(3, 1, [&](size_t)
+                    { parallelFor(5, 1, [&](size_t) { ++total; }); });
+        EXPECT_EQ(total, 15);
+    }
+
+    TEST(ThreadPool, Exceptions)
+    {
+        ThreadPool pool(4);
+        EXPECT_THROW(pool.parallel(4,
+                                   [](int t, int)
+                                   {
+                                       if (t == 2)
+                                           IT_ASSERT(false);
+                                   }),
+                     Exception);
+        // The pool is usable afterwards.
+        std::atomic<int> count{0};
+        pool.parallel(4, [&](int, int) { ++count; });
+        EXPECT_EQ(count, 4);
+    }
+
+    TEST(ThreadPool, ConcurrentCallers)
+    {
+        ThreadPool pool(2, {}, 1);
+        std::atomic<long> total{0};
+        auto worker = [&]
+        {
+            ThreadPool::Scope scope(pool);
+            for (int i = 0; i < 200; ++i)
+                parallelFor(10, 1, [&](size_t j) { total += j; });
+        };
+        std::thread a(worker), b(worker);
+        a.join();
+        b.join();
+        EXPECT_EQ(total, 2 * 200 * 45);
+    }
+
+    // Jobs handed to workers that are parking or parked, with pauses around
+    // the spin time, are never lost.
+    TEST(ThreadPool, WakesParkedWorkers)
+    {
+        ThreadPool pool(4, {}, 1);
+        std::atomic<int> count{0};
+        for (int i = 0; i < 500; ++i)
+        {
+            pool.parallel(4, [&](int, int) { ++count; });
+            std::this_thread::sleep_for(std::chrono::microseconds(i % 7 * 40));
+        }
+        EXPECT_EQ(count, 4 * 500);
+    }
+
+    // Kernels give the same results on a multi-threaded runtime, including
+    // the per-thread partials of reductions.
+    TEST(ThreadPool, Kernels)
+    {
+        auto runtime =
+            make_ref<NativeCpuRuntimeObj>(CpuConfig{4, {}, -1, 64});
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({64, 96}, DataType::Float32);
+        auto b = g->addTensor({96, 80}, DataType::Float32);
+        auto c = g->addOp<MatmulObj>(a, b, nullptr)->getOutput();
+        auto all = g->addOp<ReduceSumObj>(c, nullptr, vector<int>{},
+                                          false)
+                       ->getOutput();
+        auto rows = g->addOp<ReduceSumObj>(c, nullptr, vector<int>{0},
+                                           false)
+                        ->getOutput();
+        g->dataMalloc();
+        a->setData(OneGenerator());
+        b->setData(OneGenerator());
+        runtime->run(g);
+        EXPECT_EQ(all->getRawDataPtr<float *>()[0], 64 * 96 * 80);
+        EXPECT_TRUE(rows->equalData(vector<float>(80, 64 * 96)));
+    }
+} // namespace infini
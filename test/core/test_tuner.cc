@@ -0,0 +1,136 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "core/tuner.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+
+#include "test.h"
+#include <cstdio>
+#include <thread>
+
+namespace infini
+{
+    // Every candidate of the search space produces the same output as the
+    // default configuration.
+    void checkCandidates(const Graph &g, const Operator &op)
+    {
+        auto runtime = g->getRuntime();
+        auto kernel = dynamic_cast<CpuKernelWithConfig *>(
+            KernelRegistry::getInstance().getKernel(
+                KernelAttrs{Device::CPU, op->getOpType().underlying()}));
+        ASSERT_NE(kernel, nullptr);
+        auto space = kernel->getSearchSpace(op);
+        ASSERT_FALSE(space.empty());
+
+        auto output = op->getOutput();
+        kernel->computeWithConfig(op, space[0], runtime.get());
+        vector<float> expected(output->getRawDataPtr<float *>(),
+                               output->getRawDataPtr<float *>() +
+                                   output->size());
+        for (auto &config : space)
+        {
+            output->setData(ZeroGenerator());
+            kernel->computeWithConfig(op, config, runtime.get());
+            EXPECT_TRUE(output->equalData(expected)) << vecToString(config);
+        }
+    }
+
+    TEST(Tuner, CandidatesAgree)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({2, 37, 53}, DataType::Float32);
+        auto b = g->addTensor({29, 53}, DataType::Float32);
+        auto matmul = g->addOp<MatmulObj>(a, b, nullptr, false, true);
+        auto transpose = g->addOp<TransposeObj>(
+            a, nullptr, vector<int>{2, 0, 1});
+        auto add = g->addOp<AddObj>(a, g->addTensor({53}, DataType::Float32),
+                                    nullptr);
+        g->dataMalloc();
+        for (auto &t : g->getInputs())
+            t->setData(IncrementalGenerator());
+
+        checkCandidates(g, matmul);
+        checkCandidates(g, transpose);
+        checkCandidates(g, add);
+    }
+
+    TEST(Tuner, CacheRoundTrip)
+    {
+        auto &tuner = Tuner::getInstance();
+        tuner.clear();
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({64, 48}, DataType::Float32);
+        auto b = g->addTensor({48, 40}, DataType::Float32);
+        auto op = g->addOp<MatmulObj>(a, b, nullptr);
+        g->dataMalloc();
+        a->setData(IncrementalGenerator());
+        b->setData(OneGenerator());
+        runtime->run(g);
+        // Row i of A sums to 48 * (48 * i + 23.5).
+        EXPECT_FLOAT_EQ(op->getOutput()->getRawDataPtr<float *>()[40],
+                        48 * 47 / 2 + 48 * 48);
+
+        auto kernel = dynamic_cast<CpuKernelWithConfig *>(
+            KernelRegistry::getInstance().getKernel(
+                KernelAttrs{Device::CPU, OpType::MatMul}));
+        auto key = Tuner::getKey(*kernel, op);
+        auto record = tuner.lookup(key);
+        ASSERT_TRUE(record.has_value());
+
+        const string path = "test_tuner_cache.txt";
+        tuner.save(path);
+        tuner.clear();
+        EXPECT_FALSE(tuner.lookup(key).has_value());
+        tuner.load(path);
+        ASSERT_TRUE(tuner.lookup(key).has_value());
+        EXPECT_EQ(tuner.lookup(key)->config, record->config);
+
+        // Tuning a new shape appends it to the loaded cache file.
+        Graph g2 = make_ref<GraphObj>(runtime);
+        auto c = g2->addTensor({16, 48}, DataType::Float32);
+        auto d = g2->addTensor({48, 40}, DataType::Float32);
+        auto op2 = g2->addOp<MatmulObj>(c, d, nullptr);
+        g2->dataMalloc();
+        runtime->run(g2);
+        tuner.clear();
+        tuner.load(path);
+        EXPECT_TRUE(tuner.lookup(Tuner::getKey(*kernel, op2)).has_value());
+        EXPECT_EQ(tuner.size(), 2u);
+
+        tuner.clear();
+        std::remove(path.c_str());
+    }
+
+    TEST(Tuner, ConcurrentFirstRuns)
+    {
+        auto &tuner = Tuner::getInstance();
+        tuner.clear();
+        vector<float> results(4);
+        vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i)
+            threads.emplace_back(
+                [&results, i]
+                {
+                    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+                    Graph g = make_ref<GraphObj>(runtime);
+                    auto a = g->addTensor({32, 24}, DataType::Float32);
+                    auto b = g->addTensor({24, 16}, DataType::Float32);
+                    auto c = g->addOp<MatmulObj>(a, b, nullptr)->getOutput();
+                    g->dataMalloc();
+                    a->setData(OneGenerator());
+                    b->setData(OneGenerator());
+                    runtime->run(g);
+                    results[i] = c->getRawDataPtr<float *>()[0];
+                });
+        for (auto &thread : threads)
+            thread.join();
+        EXPECT_EQ(results, vector<float>(4, 24));
+        // One shape, one record, whichever thread tuned it.
+        EXPECT_EQ(tuner.size(), 1u);
+        tuner.clear();
+    }
+
+} // namespace infini
@@ -0,0 +1,32 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini {
+
+TEST(Cast, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+
+    auto x = g->addTensor({2, 3}, DataType::Float32);
+    auto relu = g->addOp<ReluObj>(x, nullptr);
+    auto toInt =
+        g->addOp<CastObj>(relu->getOutput(), nullptr, CastType::Float2Int32);
+    auto toFloat =
+        g->addOp<CastObj>(toInt->getOutput(), nullptr, CastType::Int322Float);
+    g->dataMalloc();
+    // Same-width casts run in place on the dying Relu output.
+    EXPECT_EQ(toInt->getOutput()->getRawDataPtr<void *>(),
+              relu->getOutput()->getRawDataPtr<void *>());
+    EXPECT_EQ(toFloat->getOutput()->getRawDataPtr<void *>(),
+              relu->getOutput()->getRawDataPtr<void *>());
+
+    vector<float> data{-1.5, 0.25, 1.75, 2, -3, 7.5};
+    std::copy(data.begin(), data.end(), x->getRawDataPtr<float *>());
+    runtime->run(g);
+    EXPECT_TRUE(toFloat->getOutput()->equalData(vector<float>{0, 0, 1, 2, 0, 7}));
+}
+
+} // namespace infini
@@ -0,0 +1,125 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/conv.h"
+#include "operators/reorder.h"
+
+#include "test.h"
+
+namespace infini {
+
+struct ConvCase {
+    Shape x, w;
+    vector<int> pads = {0, 0, 0, 0}, strides = {1, 1}, dilations = {1, 1};
+    int group = 1;
+    bool bias = true;
+};
+
+static void fill(const Tensor &t, int seed) {
+    auto p = t->getRawDataPtr<float *>();
+    for (size_t i = 0; i < t->size(); ++i)
+        p[i] = float(int((i * 37 + seed) % 17) - 8) * 0.125f;
+}
+
+static vector<float> reference(const ConvCase &c, const float *x,
+                               const float *w, const float *b) {
+    int n = c.x[0], ch = c.x[1], h = c.x[2], wd = c.x[3];
+    int m = c.w[0], cg = c.w[1], kh = c.w[2], kw = c.w[3], mg = m / c.group;
+    int oh = (h + c.pads[0] + c.pads[2] - c.dilations[0] * (kh - 1) - 1) /
+                 c.strides[0] + 1;
+    int ow = (wd + c.pads[1] + c.pads[3] - c.dilations[1] * (kw - 1) - 1) /
+                 c.strides[1] + 1;
+    vector<float> y(n * m * oh * ow);
+    for (int in = 0; in < n; ++in)
+        for (int o = 0; o < m; ++o)
+            for (int py = 0; py < oh; ++py)
+                for (int px = 0; px < ow; ++px) {
+                    float acc = b ? b[o] : 0.f;
+                    for (int ci = 0; ci < cg; ++ci)
+                        for (int i = 0; i < kh; ++i)
+                            for (int j = 0; j < kw; ++j) {
+                                int iy = py * c.strides[0] - c.pads[0] +
+                                         i * c.dilations[0];
+                                int ix = px * c.strides[1] - c.pads[1] +
+                                         j * c.dilations[1];
+                                if (iy < 0 || iy >= h || ix < 0 || ix >= wd)
+                                    continue;
+                                int cin = o / mg * cg + ci;
+                                acc += x[((in * ch + cin) * h + iy) * wd + ix] *
+                                       w[((o * cg + ci) * kh + i) * kw + j];
+                            }
+                    y[((in * m + o) * oh + py) * ow + px] = acc;
+                }
+    return y;
+}
+
+static void testConv(const ConvCase &c, bool blocked) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor(c.x, DataType::Float32);
+    auto w = g->addTensor(c.w, DataType::Float32);
+    auto b = c.bias ? g->addTensor({c.w[0]}, DataType::Float32) : nullptr;
+    Tensor y;
+    if (blocked) {
+        auto xb = g->addOp<ReorderObj>(x, nullptr, true)->getOutput();
+        auto conv = g->addOp<ConvObj>(xb, w, b, nullptr, c.pads, c.strides,
+                                      c.dilations, c.group, true);
+        ASSERT_TRUE(conv->hasBlockedKernel());
+        y = g->addOp<ReorderObj>(conv->getOutput(), nullptr, false)
+                ->getOutput();
+    } else {
+        y = g->addOp<ConvObj>(x, w, b, nullptr, c.pads, c.strides,
+                              c.dilations, c.group)
+                ->getOutput();
+    }
+    g->dataMalloc();
+    fill(x, 1);
+    fill(w, 5);
+    if (b)
+        fill(b, 3);
+    runtime->run(g);
+
+    auto expect = reference(c, x->getRawDataPtr<float *>(),
+                            w->getRawDataPtr<float *>(),
+                            b ? b->getRawDataPtr<float *>() : nullptr);
+    ASSERT_EQ(y->size(), expect.size());
+    auto out = y->getRawDataPtr<float *>();
+    for (size_t i = 0; i < expect.size(); ++i)
+        ASSERT_NEAR(out[i], expect[i], 1e-4 * (1 + std::abs(expect[i])));
+}
+
+TEST(Conv, NativeCpu) {
+    testConv({{1, 3, 7, 6}, {4, 3, 3, 3}}, false);
+    testConv({{2, 3, 7, 6}, {4, 3, 3, 2}, {1, 0, 2, 1}, {2, 1}}, false);
+    testConv({{1, 4, 9, 9}, {6, 2, 3, 3}, {2, 2, 2, 2}, {1, 2}, {2, 2}, 2},
+             false);
+    // Unpadded 1x1 convolutions multiply the input directly.
+    ConvCase pointwise{{2, 5, 4, 3}, {7, 5, 1, 1}};
+    pointwise.bias = false;
+    testConv(pointwise, false);
+}
+
+TEST(Conv, NativeCpuBlocked) {
+    testConv({{1, 8, 6, 7}, {16, 8, 3, 3}, {1, 1, 1, 1}}, true);
+    testConv({{2, 16, 9, 9}, {8, 16, 3, 3}, {0, 1, 1, 0}, {2, 2}}, true);
+    testConv({{1, 16, 5, 6}, {8, 16, 1, 1}}, true);
+    testConv({{1, 8, 7, 7}, {8, 8, 1, 1}, {0, 0, 0, 0}, {2, 1}}, true);
+}
+
+TEST(Reorder, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({2, 16, 3, 5}, DataType::UInt32);
+    auto xb = g->addOp<ReorderObj>(x, nullptr, true)->getOutput();
+    auto y = g->addOp<ReorderObj>(xb, nullptr, false)->getOutput();
+    g->dataMalloc();
+    x->setData(IncrementalGenerator());
+    runtime->run(g);
+    // [n][cb][h][w][c] holds channel cb * 8 + c.
+    auto pb = xb->getRawDataPtr<uint32_t *>();
+    EXPECT_EQ(pb[1], 15u);
+    EXPECT_EQ(pb[8], 1u);
+    EXPECT_EQ(pb[15 * 8], 120u);
+    EXPECT_TRUE(y->equalData(x));
+}
+
+} // namespace infini
@@ -0,0 +1,179 @@
+#include "core/elementwise_jit.h"
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include <cstdlib>
+#include <limits>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include "test.h"
+
+namespace infini {
+
+using Code = ElementwiseExpr::Code;
+
+// Div(Sub(Clip(Mul(Relu(Add(x, b)), s), -1, 2), Exp(Sqrt(Mul(z, z)))), d)
+// of [rows, cols], with b broadcast along rows, s along columns and d a
+// scalar. x is read through a transpose if `transposed`.
+static Graph build(Runtime runtime, int rows, int cols, bool transposed) {
+    Graph g = make_ref<GraphObj>(runtime);
+    Tensor x;
+    if (transposed)
+        x = g->addOp<TransposeObj>(
+                 g->addTensor({cols, rows}, DataType::Float32), nullptr,
+                 vector<int>{1, 0})
+                ->getOutput();
+    else
+        x = g->addTensor({rows, cols}, DataType::Float32);
+    auto b = g->addTensor({cols}, DataType::Float32);
+    auto s = g->addTensor({rows, 1}, DataType::Float32);
+    auto z = g->addTensor({rows, cols}, DataType::Float32);
+    auto d = g->addTensor({1}, DataType::Float32);
+    auto h = g->addOp<AddObj>(x, b, nullptr)->getOutput();
+    h = g->addOp<ReluObj>(h, nullptr)->getOutput();
+    h = g->addOp<MulObj>(h, s, nullptr)->getOutput();
+    h = g->addOp<ClipObj>(h, nullptr, -1.f, 2.f)->getOutput();
+    auto e = g->addOp<MulObj>(z, z, nullptr)->getOutput();
+    e = g->addOp<SqrtObj>(e, nullptr)->getOutput();
+    e = g->addOp<ExpObj>(e, nullptr)->getOutput();
+    h = g->addOp<SubObj>(h, e, nullptr)->getOutput();
+    g->addOp<DivObj>(h, d, nullptr);
+    return g;
+}
+
+static void fill(const Graph &g) {
+    auto inputs = g->getInputs();
+    for (size_t k = 0; k < inputs.size(); ++k) {
+        float *data = inputs[k]->getRawDataPtr<float *>();
+        for (size_t i = 0; i < inputs[k]->size(); ++i)
+            data[i] = float(int((i * 7 + k * 3) % 11) - 4) / 4;
+    }
+}
+
+// Compiled kernels compute exp to 2e-7.
+static void expectNear(const Tensor &a, const Tensor &b) {
+    ASSERT_EQ(a->size(), b->size());
+    const float *pa = a->getRawDataPtr<float *>();
+    const float *pb = b->getRawDataPtr<float *>();
+    for (size_t i = 0; i < a->size(); ++i)
+        EXPECT_NEAR(pa[i], pb[i], 1e-5 * (1 + std::abs(pb[i]))) << i;
+}
+
+static void testFusedElementwise(int rows, int cols, bool transposed) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph ref = build(runtime, rows, cols, transposed);
+    Graph g = build(runtime, rows, cols, transposed);
+    g->optimize();
+    ASSERT_EQ(g->getOperators().size(), transposed ? 2u : 1u);
+    EXPECT_EQ(g->getOperators().back()->getOpType(),
+              OpType::FusedElementwise);
+    ref->dataMalloc();
+    g->dataMalloc();
+    fill(ref);
+    fill(g);
+    runtime->run(ref);
+
+    // Compiled, unless a transposed x is read with a step of rows, then
+    // interpreted.
+    auto &jit = ElementwiseJit::getInstance();
+    const bool saved = jit.isEnabled();
+    for (bool enabled : {true, false}) {
+        jit.setEnabled(enabled);
+        runtime->run(g);
+        expectNear(g->getOutputs()[0], ref->getOutputs()[0]);
+    }
+    jit.setEnabled(saved);
+}
+
+TEST(FusedElementwise, NativeCpu) {
+    // Rows not a multiple of the block, with and without full blocks.
+    testFusedElementwise(5, 37, false);
+    testFusedElementwise(3, 7, false);
+    testFusedElementwise(64, 256, false);
+    testFusedElementwise(6, 9, true);
+}
+
+TEST(ElementwiseJit, Cache) {
+    auto &jit = ElementwiseJit::getInstance();
+    const auto savedDir = jit.getCacheDir();
+    const bool saved = jit.isEnabled();
+    jit.setEnabled(true);
+    const auto dir = testing::TempDir() + "infini-jit-" +
+                     std::to_string(getpid());
+    jit.setCacheDir(dir);
+    jit.clear();
+
+    // exp(x0 * x1) with x1 a scalar.
+    ElementwiseExpr expr;
+    expr.add({Code::Exp, expr.add({Code::Mul, expr.add({Code::Input, 0}),
+                                   expr.add({Code::Input, 1})})});
+    auto kernel = jit.get(expr, {1, 0});
+    ASSERT_NE(kernel, nullptr) << jit.getError();
+    EXPECT_EQ(jit.getCompiles(), 1u);
+    EXPECT_EQ(jit.get(expr, {1, 0}), kernel);
+    EXPECT_EQ(jit.size(), 1u);
+    vector<float> x(37), y(37);
+    for (size_t i = 0; i < x.size(); ++i)
+        x[i] = float(i) / 8 - 2;
+    float scale = 1.5f;
+    const float *inputs[] = {x.data(), &scale};
+    kernel(inputs, y.data(), y.size());
+    for (size_t i = 0; i < y.size(); ++i)
+        EXPECT_NEAR(y[i], std::exp(x[i] * scale), 1e-6 * std::exp(x[i] * scale));
+    // Special values as interpreted.
+    const float inf = std::numeric_limits<float>::infinity();
+    x = {NAN, inf, -inf, 60.f, -60.f};
+    scale = 1.f;
+    inputs[0] = x.data();
+    kernel(inputs, y.data(), x.size());
+    EXPECT_TRUE(std::isnan(y[0]));
+    for (size_t i = 1; i < x.size(); ++i)
+        EXPECT_FLOAT_EQ(y[i], ElementwiseExpr::fastExp(x[i])) << x[i];
+
+    // Loaded back from the directory without compiling.
+    jit.clear();
+    EXPECT_NE(jit.get(expr, {1, 0}), nullptr);
+    EXPECT_EQ(jit.getCompiles(), 0u);
+
+    // Threads asking for the same new kernel share one compile.
+    vector<ElementwiseJit::Kernel> kernels(4);
+    vector<std::thread> threads;
+    for (auto &k : kernels)
+        threads.emplace_back([&] { k = jit.get(expr, {0, 1}); });
+    for (auto &t : threads)
+        t.join();
+    EXPECT_NE(kernels[0], nullptr);
+    EXPECT_EQ(std::count(kernels.begin(), kernels.end(), kernels[0]), 4);
+    EXPECT_EQ(jit.getCompiles(), 1u);
+
+    // Without a working compiler, kernels are interpreted.
+    const char *cxx = std::getenv("INFINI_CXX");
+    const string savedCxx = cxx ? cxx : "";
+    setenv("INFINI_CXX", "false", 1);
+    EXPECT_EQ(jit.get(expr, {1, 1}), nullptr);
+    EXPECT_FALSE(jit.getError().empty());
+    EXPECT_EQ(jit.get(expr, {1, 1}), nullptr);
+    if (cxx)
+        setenv("INFINI_CXX", savedCxx.c_str(), 1);
+    else
+        unsetenv("INFINI_CXX");
+
+    // Nor if others could write to the cache directory.
+    jit.clear();
+    chmod(dir.c_str(), 0777);
+    EXPECT_EQ(jit.get(expr, {1, 0}), nullptr);
+    EXPECT_NE(jit.getError().find("not writable by others"), string::npos);
+    chmod(dir.c_str(), 0700);
+
+    jit.setEnabled(false);
+    EXPECT_EQ(jit.get(expr, {1, 0}), nullptr);
+    jit.setEnabled(saved);
+    jit.setCacheDir(savedDir);
+    jit.clear();
+}
+
+} // namespace infini
@@ -0,0 +1,99 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/gather.h"
+
+#include "test.h"
+
+namespace infini {
+
+template <typename I>
+static void setIndices(const Tensor &t, const vector<int> &values) {
+    std::copy(values.begin(), values.end(),
+              t->template getRawDataPtr<I *>());
+}
+
+TEST(Gather, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    {
+        // Rows of a table, with a negative index.
+        Graph g = make_ref<GraphObj>(runtime);
+        auto data = g->addTensor({5, 3}, DataType::Float32);
+        auto indices = g->addTensor({2, 2}, DataType::Int64);
+        auto y = g->addOp<GatherObj>(data, indices, nullptr)->getOutput();
+        g->dataMalloc();
+        data->setData(IncrementalGenerator());
+        setIndices<int64_t>(indices, {4, 0, -1, 2});
+        runtime->run(g);
+        EXPECT_TRUE(y->equalData(
+            vector<float>{12, 13, 14, 0, 1, 2, 12, 13, 14, 6, 7, 8}));
+    }
+    {
+        // Inner axis, every output row gathering from its own slice.
+        Graph g = make_ref<GraphObj>(runtime);
+        auto data = g->addTensor({2, 4, 2}, DataType::UInt32);
+        auto indices = g->addTensor({3}, DataType::Int32);
+        auto y = g->addOp<GatherObj>(data, indices, nullptr, 1)->getOutput();
+        g->dataMalloc();
+        data->setData(IncrementalGenerator());
+        setIndices<int32_t>(indices, {3, 1, 1});
+        runtime->run(g);
+        EXPECT_TRUE(y->equalData(
+            vector<uint32_t>{6, 7, 2, 3, 2, 3, 14, 15, 10, 11, 10, 11}));
+    }
+    {
+        // More indices than the prefetch distance.
+        Graph g = make_ref<GraphObj>(runtime);
+        auto data = g->addTensor({50, 7}, DataType::Float32);
+        auto indices = g->addTensor({40}, DataType::Int32);
+        auto y = g->addOp<GatherObj>(data, indices, nullptr)->getOutput();
+        g->dataMalloc();
+        data->setData(IncrementalGenerator());
+        vector<int> rows;
+        for (int i = 0; i < 40; ++i)
+            rows.emplace_back(i * 17 % 50);
+        setIndices<int32_t>(indices, rows);
+        runtime->run(g);
+        vector<float> expect;
+        for (int r : rows)
+            for (int j = 0; j < 7; ++j)
+                expect.emplace_back(r * 7 + j);
+        EXPECT_TRUE(y->equalData(expect));
+    }
+}
+
+TEST(Gather, NativeCpuOutOfRange) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto data = g->addTensor({5, 3}, DataType::Float32);
+    auto indices = g->addTensor({1}, DataType::Int32);
+    g->addOp<GatherObj>(data, indices, nullptr);
+    g->dataMalloc();
+    setIndices<int32_t>(indices, {5});
+    EXPECT_THROW(runtime->run(g), Exception);
+}
+
+TEST(EmbeddingBag, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto table = g->addTensor({30, 5}, DataType::Float32);
+    auto indices = g->addTensor({4, 9}, DataType::Int64);
+    auto y = g->addOp<EmbeddingBagObj>(table, indices, nullptr)->getOutput();
+    g->dataMalloc();
+    table->setData(IncrementalGenerator());
+    vector<int> rows;
+    for (int i = 0; i < 36; ++i)
+        rows.emplace_back(i * 11 % 30 - (i % 4 == 0 ? 30 : 0));
+    setIndices<int64_t>(indices, rows);
+    runtime->run(g);
+
+    vector<float> expect(4 * 5, 0);
+    for (int b = 0; b < 4; ++b)
+        for (int l = 0; l < 9; ++l) {
+            int r = (rows[b * 9 + l] + 30) % 30;
+            for (int j = 0; j < 5; ++j)
+                expect[b * 5 + j] += r * 5 + j;
+        }
+    EXPECT_TRUE(y->equalData(expect));
+}
+
+} // namespace infini
@@ -0,0 +1,63 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/layer_norm.h"
+
+#include "test.h"
+
+namespace infini {
+
+static void testNorm(bool rms, bool bias, size_t rows, size_t cols) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({(int)rows, (int)cols}, DataType::Float32);
+    auto scale = g->addTensor({(int)cols}, DataType::Float32);
+    auto b = bias ? g->addTensor({(int)cols}, DataType::Float32) : nullptr;
+    const float eps = 1e-3f;
+    Operator op;
+    if (rms)
+        op = g->addOp<RMSNormObj>(x, scale, nullptr, -1, eps);
+    else
+        op = g->addOp<LayerNormObj>(x, scale, b, nullptr, -1, eps);
+    g->dataMalloc();
+    vector<float> in(rows * cols);
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = float((i * 7) % 23) * 0.5f + 100.f;
+    std::copy(in.begin(), in.end(), x->getRawDataPtr<float *>());
+    scale->setData(IncrementalGenerator());
+    if (b)
+        b->setData(OneGenerator());
+    runtime->run(g);
+
+    auto out = op->getOutput()->getRawDataPtr<float *>();
+    for (size_t r = 0; r < rows; ++r) {
+        const float *row = in.data() + r * cols;
+        double mean = 0, var = 0;
+        if (!rms) {
+            for (size_t j = 0; j < cols; ++j)
+                mean += row[j];
+            mean /= cols;
+        }
+        for (size_t j = 0; j < cols; ++j)
+            var += (row[j] - mean) * (row[j] - mean);
+        double rstd = 1 / std::sqrt(var / cols + eps);
+        for (size_t j = 0; j < cols; ++j) {
+            double expect = (row[j] - mean) * rstd * j + (b ? 1 : 0);
+            EXPECT_NEAR(out[r * cols + j], expect, 1e-4 * (1 + std::abs(expect)));
+        }
+    }
+}
+
+TEST(LayerNorm, NativeCpu) {
+    testNorm(false, true, 4, 5);    // Fewer columns than lanes.
+    testNorm(false, true, 3, 64);
+    testNorm(false, false, 5, 77);  // Lanes and a tail.
+    testNorm(false, true, 0, 5);    // No rows.
+    testNorm(false, true, 3, 0);    // No columns.
+}
+
+TEST(RMSNorm, NativeCpu) {
+    testNorm(true, false, 4, 5);
+    testNorm(true, false, 5, 77);
+}
+
+} // namespace infini
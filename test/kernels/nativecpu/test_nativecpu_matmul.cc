@@ -0,0 +1,81 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+
+#include "test.h"
+
+namespace infini {
+
+using ExpectOutput = vector<float>;
+void testMatmulNativeCpu(const Shape &shapeA, const Shape &shapeB, bool transA,
+                         bool transB, const ExpectOutput &ansVec) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto a = g->addTensor(shapeA, DataType::Float32);
+    auto b = g->addTensor(shapeB, DataType::Float32);
+
+    auto op = g->addOp<MatmulObj>(a, b, nullptr, transA, transB);
+    g->dataMalloc();
+    a->setData(IncrementalGenerator());
+    b->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput()->equalData(ansVec));
+}
+
+TEST(Matmul, NativeCpu) {
+    // [[0,1,2],[3,4,5]] x [[0,1],[2,3],[4,5]]
+    testMatmulNativeCpu(Shape{2, 3}, Shape{3, 2}, false, false,
+                        ExpectOutput{10, 13, 28, 40});
+    // A^T: [[0,2,4],[1,3,5]] x [[0,1],[2,3],[4,5]]
+    testMatmulNativeCpu(Shape{3, 2}, Shape{3, 2}, true, false,
+                        ExpectOutput{20, 26, 26, 35});
+    // B^T: [[0,1,2],[3,4,5]] x [[0,3],[1,4],[2,5]]
+    testMatmulNativeCpu(Shape{2, 3}, Shape{2, 3}, false, true,
+                        ExpectOutput{5, 14, 14, 50});
+    // Batch broadcast of B
+    testMatmulNativeCpu(Shape{2, 1, 2}, Shape{1, 2, 2}, false, false,
+                        ExpectOutput{2, 3, 6, 11});
+    // Empty M, then empty K summing to zeros
+    testMatmulNativeCpu(Shape{0, 3}, Shape{3, 2}, false, false,
+                        ExpectOutput{});
+    testMatmulNativeCpu(Shape{2, 0}, Shape{0, 2}, false, false,
+                        ExpectOutput{0, 0, 0, 0});
+}
+
+// A single row of A runs the GEMV candidate, matching the blocked GEMM.
+void testGemv(const Shape &shapeA, const Shape &shapeB, bool transB,
+              bool expectGemv) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto a = g->addTensor(shapeA, DataType::Float32);
+    auto b = g->addTensor(shapeB, DataType::Float32);
+    auto op = g->addOp<MatmulObj>(a, b, nullptr, false, transB);
+    g->dataMalloc();
+    a->setData(IncrementalGenerator());
+    b->setData(IncrementalGenerator());
+
+    auto &registry = KernelRegistry::getInstance();
+    KernelAttrs key{Device::CPU, OpType::MatMul};
+    EXPECT_EQ(registry.select(key, *op)->name,
+              expectGemv ? "MatmulGemv_CPU" : "MatmulBlocked_CPU");
+    EXPECT_EQ(op->getKernel(), registry.select(key, *op)->kernel);
+    runtime->run(g);
+    auto output = op->getOutput();
+    vector<float> gemv(output->getRawDataPtr<float *>(),
+                       output->getRawDataPtr<float *>() + output->size());
+    registry.getKernel(key)->compute(op, runtime.get());
+    EXPECT_TRUE(output->equalData(gemv));
+}
+
+TEST(Matmul, NativeCpuGemv) {
+    // Rows of B contiguous, then columns.
+    testGemv(Shape{1, 37}, Shape{37, 53}, false, true);
+    testGemv(Shape{1, 1, 37}, Shape{53, 37}, true, true);
+    // Batched or several rows: blocked.
+    testGemv(Shape{2, 1, 37}, Shape{37, 53}, false, false);
+    testGemv(Shape{3, 37}, Shape{37, 53}, false, false);
+}
+
+} // namespace infini
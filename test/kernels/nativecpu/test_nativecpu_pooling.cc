@@ -0,0 +1,104 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/pooling.h"
+#include "operators/reorder.h"
+
+#include "test.h"
+
+namespace infini {
+
+struct PoolCase {
+    OpType type;
+    Shape x;
+    vector<int> kernel, pads = {0, 0, 0, 0}, strides = {1, 1};
+    bool countIncludePad = false;
+};
+
+static vector<float> reference(const PoolCase &c, const float *x) {
+    int planes = c.x[0] * c.x[1], h = c.x[2], w = c.x[3];
+    auto k = c.kernel.empty() ? vector<int>{h, w} : c.kernel;
+    int oh = (h + c.pads[0] + c.pads[2] - k[0]) / c.strides[0] + 1;
+    int ow = (w + c.pads[1] + c.pads[3] - k[1]) / c.strides[1] + 1;
+    vector<float> y;
+    for (int p = 0; p < planes; ++p)
+        for (int py = 0; py < oh; ++py)
+            for (int px = 0; px < ow; ++px) {
+                float max = -INFINITY, sum = 0;
+                int count = 0;
+                for (int i = 0; i < k[0]; ++i)
+                    for (int j = 0; j < k[1]; ++j) {
+                        int iy = py * c.strides[0] - c.pads[0] + i;
+                        int ix = px * c.strides[1] - c.pads[1] + j;
+                        if (iy < 0 || iy >= h || ix < 0 || ix >= w)
+                            continue;
+                        float v = x[(p * h + iy) * w + ix];
+                        max = std::max(max, v);
+                        sum += v;
+                        ++count;
+                    }
+                if (c.countIncludePad)
+                    count = k[0] * k[1];
+                y.push_back(c.type == OpType::MaxPool ? max : sum / count);
+            }
+    return y;
+}
+
+static void testPool(const PoolCase &c, bool blocked) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor(c.x, DataType::Float32);
+    auto in = blocked ? g->addOp<ReorderObj>(x, nullptr, true)->getOutput() : x;
+    Operator pool;
+    if (c.type == OpType::MaxPool)
+        pool = g->addOp<MaxPoolObj>(in, nullptr, c.kernel, c.pads, c.strides,
+                                    blocked);
+    else if (c.type == OpType::AveragePool)
+        pool = g->addOp<AvgPoolObj>(in, nullptr, c.kernel, c.pads, c.strides,
+                                    c.countIncludePad, blocked);
+    else
+        pool = g->addOp<GlobalAvgPoolObj>(in, nullptr, blocked);
+    auto y = blocked ? g->addOp<ReorderObj>(pool->getOutput(), nullptr, false)
+                           ->getOutput()
+                     : pool->getOutput();
+    g->dataMalloc();
+    auto px = x->getRawDataPtr<float *>();
+    for (size_t i = 0; i < x->size(); ++i)
+        px[i] = float(int((i * 29) % 31) - 15) * 0.25f;
+    runtime->run(g);
+
+    auto expect = reference(c, px);
+    ASSERT_EQ(y->size(), expect.size());
+    auto out = y->getRawDataPtr<float *>();
+    for (size_t i = 0; i < expect.size(); ++i)
+        ASSERT_NEAR(out[i], expect[i], 1e-5 * (1 + std::abs(expect[i])));
+}
+
+static void testBothLayouts(const PoolCase &c) {
+    testPool(c, false);
+    if (c.x[1] % kChannelBlock == 0)
+        testPool(c, true);
+}
+
+TEST(MaxPool, NativeCpu) {
+    testBothLayouts({OpType::MaxPool, {2, 3, 7, 9}, {3, 3}});
+    testBothLayouts({OpType::MaxPool, {1, 8, 9, 8}, {3, 3}, {1, 1, 1, 1},
+                     {2, 2}});
+    testBothLayouts({OpType::MaxPool, {1, 16, 6, 7}, {2, 3}, {1, 0, 0, 2},
+                     {1, 3}});
+}
+
+TEST(AveragePool, NativeCpu) {
+    testBothLayouts({OpType::AveragePool, {2, 3, 7, 9}, {2, 2}, {0, 0, 0, 0},
+                     {2, 2}});
+    testBothLayouts({OpType::AveragePool, {1, 8, 9, 8}, {3, 3}, {1, 1, 1, 1},
+                     {2, 1}});
+    testBothLayouts({OpType::AveragePool, {1, 8, 5, 6}, {3, 3}, {1, 2, 1, 2},
+                     {1, 1}, true});
+}
+
+TEST(GlobalAveragePool, NativeCpu) {
+    testBothLayouts({OpType::GlobalAveragePool, {2, 3, 7, 9}, {}});
+    testBothLayouts({OpType::GlobalAveragePool, {2, 16, 5, 3}, {}});
+}
+
+} // namespace infini
@@ -0,0 +1,138 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/reduce.h"
+
+#include "test.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace infini {
+
+// Naive reference: accumulates every input element into its output slot.
+template <typename T, typename F>
+static vector<T> reduceRef(const vector<T> &in, const Shape &dims,
+                           const vector<int> &axes, T init, F f) {
+    auto reduced = [&](int d) {
+        return std::find(axes.begin(), axes.end(), d) != axes.end();
+    };
+    size_t outSize = 1;
+    for (int d = 0; d < (int)dims.size(); ++d)
+        if (!reduced(d))
+            outSize *= dims[d];
+    vector<T> out(outSize, init);
+    for (size_t i = 0; i < in.size(); ++i) {
+        size_t o = 0, rest = i, scale = 1;
+        for (int d = dims.size() - 1; d >= 0; --d) {
+            size_t idx = rest % dims[d];
+            rest /= dims[d];
+            if (!reduced(d)) {
+                o += idx * scale;
+                scale *= dims[d];
+            }
+        }
+        out[o] = f(out[o], in[i]);
+    }
+    return out;
+}
+
+template <typename Op>
+static void testReduce(const Shape &dims, const vector<int> &axes) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor(dims, DataType::Float32);
+    auto op = g->addOp<Op>(x, nullptr, axes, false);
+    g->dataMalloc();
+    size_t n = x->size();
+    vector<float> in(n);
+    for (size_t i = 0; i < n; ++i)
+        in[i] = float((i * 7) % 13) / 8 + 0.5f;
+    std::copy(in.begin(), in.end(), x->getRawDataPtr<float *>());
+    runtime->run(g);
+
+    vector<float> expect;
+    switch (op->getOpType().underlying()) {
+    case OpType::ReduceSum:
+    case OpType::ReduceMean:
+        expect = reduceRef(in, dims, axes, 0.f, std::plus<float>{});
+        if (op->getOpType() == OpType::ReduceMean)
+            for (auto &v : expect)
+                v /= float(n / expect.size());
+        break;
+    case OpType::ReduceMax:
+        expect = reduceRef(in, dims, axes, -1e30f,
+                           [](float a, float b) { return std::max(a, b); });
+        break;
+    case OpType::ReduceMin:
+        expect = reduceRef(in, dims, axes, 1e30f,
+                           [](float a, float b) { return std::min(a, b); });
+        break;
+    default:
+        expect = reduceRef(in, dims, axes, 1.f, std::multiplies<float>{});
+    }
+    auto out = op->getOutput()->template getRawDataPtr<float *>();
+    ASSERT_EQ(op->getOutput()->size(), expect.size());
+    for (size_t i = 0; i < expect.size(); ++i)
+        EXPECT_NEAR(out[i], expect[i], 1e-3f * std::abs(expect[i]) + 1e-4f);
+}
+
+template <typename Op> static void testAllLayouts() {
+    testReduce<Op>({4, 5, 6}, {2});          // Inner, contiguous runs.
+    testReduce<Op>({4, 5, 6}, {0});          // Outer, strided rows.
+    testReduce<Op>({4, 5, 6}, {1});          // Middle.
+    testReduce<Op>({4, 5, 6}, {0, 2});       // Non-adjacent axes.
+    testReduce<Op>({2, 3, 1, 4, 5}, {1, 2, 4});
+    testReduce<Op>({4, 5, 6}, {0, 1, 2});    // Everything.
+}
+
+TEST(Reduce, NativeCpu) {
+    testAllLayouts<ReduceSumObj>();
+    testAllLayouts<ReduceMeanObj>();
+    testAllLayouts<ReduceMaxObj>();
+    testAllLayouts<ReduceMinObj>();
+    testAllLayouts<ReduceProdObj>();
+}
+
+TEST(Reduce, NativeCpuPartials) {
+    // Few outputs over a long reduced range take the per-thread partial path.
+#ifdef _OPENMP
+    int threads = omp_get_max_threads();
+    omp_set_num_threads(4);
+#endif
+    testReduce<ReduceSumObj>({3, 20000}, {1});
+    testReduce<ReduceMaxObj>({20000, 3}, {0});
+    testReduce<ReduceMeanObj>({50000}, {0});
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#endif
+}
+
+TEST(Reduce, NativeCpuEmpty) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({0, 4}, DataType::Float32);
+    auto rows = g->addOp<ReduceMeanObj>(x, nullptr, vector<int>{1}, false);
+    auto sum = g->addOp<ReduceSumObj>(x, nullptr, vector<int>{0}, false);
+    auto mean = g->addOp<ReduceMeanObj>(x, nullptr, vector<int>{0}, false);
+    g->dataMalloc();
+    runtime->run(g);
+    EXPECT_EQ(rows->getOutput()->size(), 0u);
+    EXPECT_TRUE(sum->getOutput()->equalData(vector<float>{0, 0, 0, 0}));
+    EXPECT_TRUE(std::isnan(mean->getOutput()->getRawDataPtr<float *>()[0]));
+}
+
+TEST(Reduce, NativeCpuUInt32) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({2, 3}, DataType::UInt32);
+    auto sum = g->addOp<ReduceSumObj>(x, nullptr, vector<int>{1});
+    auto max = g->addOp<ReduceMaxObj>(x, nullptr, vector<int>{0}, false);
+    g->dataMalloc();
+    x->setData(IncrementalGenerator());
+    runtime->run(g);
+    EXPECT_EQ(sum->getOutput()->getDims(), (Shape{2, 1}));
+    EXPECT_TRUE(sum->getOutput()->equalData(vector<uint32_t>{3, 12}));
+    EXPECT_TRUE(max->getOutput()->equalData(vector<uint32_t>{3, 4, 5}));
+}
+
+} // namespace infini
@@ -0,0 +1,59 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/reshape.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini {
+
+TEST(Reshape, NativeCpuView) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({2, 3, 2}, DataType::Float32);
+    auto relu = g->addOp<ReluObj>(x, nullptr);
+    auto flatten = g->addOp<FlattenObj>(relu->getOutput(), nullptr, 2);
+    auto unsqueeze =
+        g->addOp<UnsqueezeObj>(flatten->getOutput(), nullptr, vector<int>{0});
+    auto w = g->addTensor({2, 1}, DataType::Float32);
+    auto matmul = g->addOp<MatmulObj>(unsqueeze->getOutput(), w, nullptr);
+    // A graph output, so it is materialized by a copy.
+    auto reshape =
+        g->addOp<ReshapeObj>(matmul->getOutput(), nullptr, Shape{2, -1});
+    g->dataMalloc();
+
+    EXPECT_TRUE(flatten->isView() && unsqueeze->isView());
+    EXPECT_FALSE(reshape->isView());
+    EXPECT_EQ(unsqueeze->getOutput()->getRawDataPtr<float *>(),
+              relu->getOutput()->getRawDataPtr<float *>());
+    EXPECT_NE(reshape->getOutput()->getRawDataPtr<float *>(),
+              matmul->getOutput()->getRawDataPtr<float *>());
+
+    x->setData(IncrementalGenerator());
+    w->setData(OneGenerator());
+    runtime->run(g);
+    EXPECT_EQ(reshape->getOutput()->getDims(), (Shape{2, 3}));
+    EXPECT_TRUE(reshape->getOutput()->equalData(vector<float>{1, 5, 9, 13, 17, 21}));
+}
+
+TEST(Reshape, NativeCpuStridedInput) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({2, 3}, DataType::Float32);
+    auto transpose = g->addOp<TransposeObj>(x, nullptr, vector<int>{1, 0});
+    // Flattening a transposed matrix is not a strided view, so it copies.
+    auto reshape =
+        g->addOp<ReshapeObj>(transpose->getOutput(), nullptr, Shape{6});
+    auto relu = g->addOp<ReluObj>(reshape->getOutput(), nullptr);
+    g->dataMalloc();
+
+    EXPECT_TRUE(transpose->isView());
+    EXPECT_FALSE(reshape->isView());
+    x->setData(IncrementalGenerator());
+    runtime->run(g);
+    EXPECT_TRUE(relu->getOutput()->equalData(vector<float>{0, 3, 1, 4, 2, 5}));
+}
+
+} // namespace infini
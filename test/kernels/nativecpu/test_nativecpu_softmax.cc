@@ -0,0 +1,61 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/softmax.h"
+
+#include "test.h"
+
+namespace infini {
+
+static void testSoftmax(const Shape &dims, int axis) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor(dims, DataType::Float32);
+    auto op = g->addOp<SoftmaxObj>(x, nullptr, axis);
+    g->dataMalloc();
+    size_t n = x->size();
+    vector<float> in(n);
+    for (size_t i = 0; i < n; ++i)
+        in[i] = float((i * 7) % 23) - 11.f;
+    std::copy(in.begin(), in.end(), x->getRawDataPtr<float *>());
+    runtime->run(g);
+
+    axis = op->getAxis();
+    size_t len = dims[axis], inner = 1;
+    for (size_t i = axis + 1; i < dims.size(); ++i)
+        inner *= dims[i];
+    auto out = op->getOutput()->getRawDataPtr<float *>();
+    for (size_t o = 0; o < n / len / inner; ++o)
+        for (size_t j = 0; j < inner; ++j) {
+            auto at = [&](size_t a) { return (o * len + a) * inner + j; };
+            float max = -INFINITY, sum = 0;
+            for (size_t a = 0; a < len; ++a)
+                max = std::max(max, in[at(a)]);
+            for (size_t a = 0; a < len; ++a)
+                sum += std::exp(in[at(a)] - max);
+            for (size_t a = 0; a < len; ++a)
+                EXPECT_NEAR(out[at(a)], std::exp(in[at(a)] - max) / sum, 1e-6);
+        }
+}
+
+TEST(Softmax, NativeCpu) {
+    testSoftmax({4, 7}, -1);     // Shorter than a block of lanes.
+    testSoftmax({3, 100}, 1);    // Blocks and a tail.
+    testSoftmax({2, 9, 5}, 1);   // Strided axis.
+    testSoftmax({9, 300}, 0);    // Strided axis over several column blocks.
+}
+
+TEST(Softmax, NativeCpuLargeInputs) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({1, 4}, DataType::Float32);
+    auto op = g->addOp<SoftmaxObj>(x, nullptr);
+    g->dataMalloc();
+    vector<float> in{1000.f, 1000.f, -1000.f, 1000.f};
+    std::copy(in.begin(), in.end(), x->getRawDataPtr<float *>());
+    runtime->run(g);
+    auto out = op->getOutput()->getRawDataPtr<float *>();
+    EXPECT_NEAR(out[0], 1.f / 3, 1e-6);
+    EXPECT_NEAR(out[2], 0.f, 1e-6);
+}
+
+} // namespace infini
@@ -0,0 +1,61 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/sparse_matmul.h"
+
+#include "test.h"
+
+namespace infini {
+
+template <typename T>
+static void copyTo(const Tensor &t, const vector<T> &values) {
+    std::copy(values.begin(), values.end(), t->getRawDataPtr<T *>());
+}
+
+// C = A * W with W [k, n] keeping every element whose index is a multiple of
+// `stride`, so that some blocks are empty and others partly filled.
+static void testSparseMatmul(const Shape &shapeA, int n, int blockRows,
+                             int blockCols, int stride) {
+    const int k = shapeA.back();
+    vector<float> w(k * n);
+    for (int i = 0; i < k * n; ++i)
+        w[i] = i % stride ? 0 : float(i % 7 - 3);
+    auto sparse = BlockSparse::encode(w.data(), k, n, false, blockRows,
+                                      blockCols);
+
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto a = g->addTensor(shapeA, DataType::Float32);
+    auto values = g->addTensor(
+        {int(sparse.blocks()), blockRows, blockCols}, DataType::Float32);
+    auto index = g->addTensor({int(sparse.blocks())}, DataType::Int32);
+    auto offsets = g->addTensor({n / blockCols + 1}, DataType::Int32);
+    auto c = g->addOp<SparseMatmulObj>(a, values, index, offsets, nullptr,
+                                       blockRows, blockCols)
+                 ->getOutput();
+    g->dataMalloc();
+    a->setData(IncrementalGenerator());
+    copyTo(values, sparse.values);
+    copyTo(index, sparse.index);
+    copyTo(offsets, sparse.offsets);
+    runtime->run(g);
+
+    const size_t m = a->size() / k;
+    vector<float> expect(m * n, 0);
+    for (size_t i = 0; i < m; ++i)
+        for (int kk = 0; kk < k; ++kk)
+            for (int j = 0; j < n; ++j)
+                expect[i * n + j] += float(i * k + kk) * w[kk * n + j];
+    EXPECT_TRUE(c->equalData(expect));
+}
+
+TEST(SparseMatmul, NativeCpu) {
+    // Rows not a multiple of the row tile, and leading dims.
+    testSparseMatmul(Shape{7, 16}, 24, 1, 8, 5);
+    testSparseMatmul(Shape{2, 3, 16}, 24, 1, 8, 37);
+    testSparseMatmul(Shape{5, 12}, 8, 4, 4, 11);
+    testSparseMatmul(Shape{9, 6}, 5, 1, 1, 3);
+    // No nonzero at all.
+    testSparseMatmul(Shape{4, 8}, 8, 1, 8, 1000);
+}
+
+} // namespace infini
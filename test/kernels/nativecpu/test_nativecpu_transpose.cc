@@ -24,4 +24,20 @@ TEST(Transpose, NativeCpu) {
                                                           8, 9, 10, 11, 20, 21, 22, 23}));
 }
 
+TEST(Transpose, NativeCpuEmpty) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+
+    auto flat = g->addTensor({0}, DataType::Float32);
+    auto op1 = g->addOp<TransposeObj>(flat, nullptr, Shape{0});
+    auto input = g->addTensor({2, 3, 0}, DataType::Float32);
+    auto op2 = g->addOp<TransposeObj>(input, nullptr, Shape{1, 0, 2});
+    g->dataMalloc();
+
+    runtime->run(g);
+
+    EXPECT_EQ(op1->getOutput()->size(), 0u);
+    EXPECT_EQ(op2->getOutput()->getDims(), (Shape{3, 2, 0}));
+}
+
 } // namespace infini
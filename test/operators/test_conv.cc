@@ -0,0 +1,65 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/conv.h"
+#include "operators/reorder.h"
+
+#include "test.h"
+
+namespace infini {
+
+TEST(Conv, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({1, 3, 5, 7}, DataType::Float32);
+        Tensor w = g->addTensor({4, 3, 3, 3}, DataType::Float32);
+        auto op = g->addOp<ConvObj>(x, w, nullptr, nullptr);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{1, 4, 3, 5}));
+    }
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({2, 4, 10, 9}, DataType::Float32);
+        Tensor w = g->addTensor({6, 2, 3, 3}, DataType::Float32);
+        Tensor b = g->addTensor({6}, DataType::Float32);
+        auto op = g->addOp<ConvObj>(x, w, b, nullptr, vector<int>{1, 0, 1, 2},
+                                    vector<int>{2, 1}, vector<int>{1, 2}, 2);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 6, 5, 7}));
+        EXPECT_FALSE(op->hasBlockedKernel());
+    }
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({1, 3, 5, 5}, DataType::Float32);
+        Tensor w = g->addTensor({4, 2, 3, 3}, DataType::Float32);
+        Tensor b = g->addTensor({3}, DataType::Float32);
+        EXPECT_THROW(g->addOp<ConvObj>(x, w, nullptr, nullptr), Exception);
+        Tensor w2 = g->addTensor({4, 3, 7, 7}, DataType::Float32);
+        EXPECT_THROW(g->addOp<ConvObj>(x, w2, nullptr, nullptr), Exception);
+        Tensor w3 = g->addTensor({4, 3, 3, 3}, DataType::Float32);
+        EXPECT_THROW(g->addOp<ConvObj>(x, w3, b, nullptr), Exception);
+    }
+}
+
+TEST(Conv, BlockedShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    Tensor x = g->addTensor({1, 16, 6, 6}, DataType::Float32);
+    Tensor w = g->addTensor({24, 16, 3, 3}, DataType::Float32);
+    auto plain = g->addOp<ConvObj>(x, w, nullptr, nullptr,
+                                   vector<int>{1, 1, 1, 1}, vector<int>{2, 2});
+    EXPECT_TRUE(plain->hasBlockedKernel());
+
+    auto xb = g->addOp<ReorderObj>(x, nullptr, true)->getOutput();
+    EXPECT_EQ(xb->getDims(), (Shape{1, 2, 6, 6, 8}));
+    auto op = g->addOp<ConvObj>(xb, w, nullptr, nullptr,
+                                vector<int>{1, 1, 1, 1}, vector<int>{2, 2},
+                                vector<int>{1, 1}, 1, true);
+    EXPECT_EQ(op->getOutput()->getDims(), (Shape{1, 3, 3, 3, 8}));
+    auto y = g->addOp<ReorderObj>(op->getOutput(), nullptr, false);
+    EXPECT_EQ(y->getOutput()->getDims(), (Shape{1, 24, 3, 3}));
+
+    Tensor odd = g->addTensor({1, 12, 6, 6}, DataType::Float32);
+    EXPECT_THROW(g->addOp<ReorderObj>(odd, nullptr, true), Exception);
+}
+
+} // namespace infini
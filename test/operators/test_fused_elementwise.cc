@@ -0,0 +1,95 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/fused_elementwise.h"
+#include "operators/transpose.h"
+
+#include "test.h"
+#include <cmath>
+#include <limits>
+
+namespace infini
+{
+    using Code = ElementwiseExpr::Code;
+
+    TEST(FusedElementwise, Expr)
+    {
+        ElementwiseExpr expr;
+        int x = expr.add({Code::Input, 0});
+        int b = expr.add({Code::Input, 1});
+        int sum = expr.add({Code::Add, x, b});
+        EXPECT_EQ(expr.add({Code::Input, 1}), b);
+        EXPECT_EQ(expr.add({Code::Add, x, b}), sum);
+        int relu = expr.add({Code::Relu, sum});
+        expr.add({Code::Min, relu, expr.add({Code::Const, 0, 0, 0.5f})});
+        EXPECT_EQ(expr.nodes.size(), 6u);
+        EXPECT_EQ(expr.numInputs(), 2);
+        EXPECT_EQ(expr.signature(),
+                  "i0 i1 add(0,1) relu(2) c0x1p-1f min(3,4)");
+        EXPECT_TRUE(expr.isValid(2));
+        EXPECT_FALSE(expr.isValid(1));
+        EXPECT_FALSE(ElementwiseExpr().isValid(0));
+
+        // Nodes may only read earlier ones.
+        ElementwiseExpr forward;
+        forward.nodes = {{Code::Input, 0}, {Code::Exp, 2}, {Code::Input, 1}};
+        EXPECT_FALSE(forward.isValid(2));
+
+        float x0[] = {-1, 2, 3}, x1[] = {0.25f}, y[3];
+        const float *inputs[] = {x0, x1};
+        ptrdiff_t steps[] = {1, 0};
+        expr.evaluate(inputs, steps, y, 3);
+        EXPECT_EQ(y[0], 0.f);
+        EXPECT_EQ(y[1], 0.5f);
+        EXPECT_EQ(y[2], 0.5f);
+
+        // exp keeps the special values of std::exp.
+        const float inf = std::numeric_limits<float>::infinity();
+        EXPECT_TRUE(std::isnan(ElementwiseExpr::fastExp(NAN)));
+        EXPECT_EQ(ElementwiseExpr::fastExp(inf), inf);
+        EXPECT_EQ(ElementwiseExpr::fastExp(-inf), 0.f);
+        EXPECT_EQ(ElementwiseExpr::fastExp(89.f), inf);
+        EXPECT_EQ(ElementwiseExpr::fastExp(-88.f), 0.f);
+        for (float x = -87.f; x < 88.7f; x += 0.37f)
+            EXPECT_NEAR(ElementwiseExpr::fastExp(x), std::exp(x),
+                        3e-7 * std::exp(x))
+                << x;
+    }
+
+    TEST(FusedElementwise, ShapeInference)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 3, 4}, DataType::Float32);
+        auto b = g->addTensor({4}, DataType::Float32);
+        auto c = g->addTensor({2, 1, 1}, DataType::Float32);
+        ElementwiseExpr expr;
+        expr.add({Code::Mul, expr.add({Code::Add, expr.add({Code::Input, 0}),
+                                       expr.add({Code::Input, 1})}),
+                  expr.add({Code::Input, 2})});
+        auto op = g->addOp<FusedElementwiseObj>(TensorVec{x, b, c}, nullptr,
+                                                expr);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 4}));
+        EXPECT_EQ(op->getInplaceInputs(), vector<int>{0});
+
+        // x is read contiguously, b restarts every row of 4 and c is
+        // constant over rows of 12.
+        auto rows = op->getRows();
+        EXPECT_EQ(rows.dims, (Shape{2, 3, 4}));
+        EXPECT_EQ(rows.strides[0], (Shape{12, 4, 1}));
+        EXPECT_EQ(rows.strides[1], (Shape{0, 0, 1}));
+        EXPECT_EQ(rows.strides[2], (Shape{1, 0, 0}));
+        auto same = g->addOp<FusedElementwiseObj>(TensorVec{x, x, x}, nullptr,
+                                                  expr);
+        EXPECT_EQ(same->getRows().dims, (Shape{24}));
+
+        // Inputs missing from the expression's view, or not Float32.
+        EXPECT_THROW(g->addOp<FusedElementwiseObj>(TensorVec{x, b}, nullptr,
+                                                   expr),
+                     Exception);
+        auto idx = g->addTensor({4}, DataType::Int32);
+        EXPECT_THROW(g->addOp<FusedElementwiseObj>(TensorVec{x, idx, c},
+                                                   nullptr, expr),
+                     Exception);
+    }
+
+} // namespace infini
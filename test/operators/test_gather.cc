@@ -0,0 +1,46 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/gather.h"
+
+#include "test.h"
+
+namespace infini {
+
+TEST(Gather, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    Tensor data = g->addTensor({4, 5, 6}, DataType::Float32);
+    Tensor indices = g->addTensor({2, 3}, DataType::Int64);
+    EXPECT_EQ(g->addOp<GatherObj>(data, indices, nullptr)
+                  ->getOutput()
+                  ->getDims(),
+              (Shape{2, 3, 5, 6}));
+    auto op = g->addOp<GatherObj>(data, indices, nullptr, -2);
+    EXPECT_EQ(op->getAxis(), 1);
+    EXPECT_EQ(op->getOutput()->getDims(), (Shape{4, 2, 3, 6}));
+    EXPECT_EQ(op->getOutput()->getDType(), DataType::Float32);
+
+    Tensor floats = g->addTensor({3}, DataType::Float32);
+    EXPECT_THROW(g->addOp<GatherObj>(data, floats, nullptr), Exception);
+}
+
+TEST(EmbeddingBag, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    Tensor table = g->addTensor({100, 16}, DataType::Float32);
+    Tensor indices = g->addTensor({2, 4, 3}, DataType::Int32);
+    EXPECT_EQ(g->addOp<EmbeddingBagObj>(table, indices, nullptr)
+                  ->getOutput()
+                  ->getDims(),
+              (Shape{2, 4, 16}));
+    EXPECT_EQ(g->addOp<EmbeddingBagObj>(table, indices, nullptr, true)
+                  ->getOutput()
+                  ->getDims(),
+              (Shape{2, 4, 1, 16}));
+    Tensor cube = g->addTensor({4, 4, 4}, DataType::Float32);
+    EXPECT_THROW(g->addOp<EmbeddingBagObj>(cube, indices, nullptr),
+                 Exception);
+}
+
+} // namespace infini
@@ -0,0 +1,44 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/layer_norm.h"
+
+#include "test.h"
+
+namespace infini {
+
+TEST(LayerNorm, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i = g->addTensor({2, 3, 4}, DataType::Float32);
+        Tensor scale = g->addTensor({4}, DataType::Float32);
+        auto op = g->addOp<LayerNormObj>(i, scale, scale, nullptr);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 4}));
+        EXPECT_EQ(op->numInputs(), 3);
+    }
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i = g->addTensor({2, 3, 4}, DataType::Float32);
+        Tensor scale = g->addTensor({3, 4}, DataType::Float32);
+        auto op = g->addOp<LayerNormObj>(i, scale, nullptr, nullptr, 1);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 4}));
+        EXPECT_EQ(op->numInputs(), 2);
+        EXPECT_THROW(g->addOp<LayerNormObj>(i, scale, nullptr, nullptr),
+                     Exception);
+    }
+}
+
+TEST(RMSNorm, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    Tensor i = g->addTensor({2, 3, 4}, DataType::Float32);
+    auto op =
+        g->addOp<RMSNormObj>(i, g->addTensor({4}, DataType::Float32), nullptr);
+    EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 4}));
+    EXPECT_THROW(g->addOp<RMSNormObj>(i, g->addTensor({3}, DataType::Float32),
+                                      nullptr),
+                 Exception);
+}
+
+} // namespace infini
@@ -0,0 +1,48 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/pooling.h"
+#include "operators/reorder.h"
+
+#include "test.h"
+
+namespace infini {
+
+TEST(Pooling, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    Tensor x = g->addTensor({2, 3, 7, 8}, DataType::Float32);
+    auto max = g->addOp<MaxPoolObj>(x, nullptr, vector<int>{3, 3},
+                                    vector<int>{1, 1, 1, 1},
+                                    vector<int>{2, 2});
+    EXPECT_EQ(max->getOutput()->getDims(), (Shape{2, 3, 4, 4}));
+    auto avg = g->addOp<AvgPoolObj>(x, nullptr, vector<int>{2, 3},
+                                    vector<int>{0, 1, 0, 0});
+    EXPECT_EQ(avg->getOutput()->getDims(), (Shape{2, 3, 6, 7}));
+    auto global = g->addOp<GlobalAvgPoolObj>(x, nullptr);
+    EXPECT_EQ(global->getOutput()->getDims(), (Shape{2, 3, 1, 1}));
+    EXPECT_EQ(global->getKernel(), (vector<int>{7, 8}));
+
+    // Windows larger than the padded image, or made only of padding.
+    EXPECT_THROW(g->addOp<MaxPoolObj>(x, nullptr, vector<int>{9, 9}),
+                 Exception);
+    EXPECT_THROW(g->addOp<MaxPoolObj>(x, nullptr, vector<int>{2, 2},
+                                      vector<int>{2, 0, 0, 0}),
+                 Exception);
+}
+
+TEST(Pooling, BlockedShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    Tensor x = g->addTensor({1, 16, 6, 6}, DataType::Float32);
+    auto xb = g->addOp<ReorderObj>(x, nullptr, true)->getOutput();
+    auto max = g->addOp<MaxPoolObj>(xb, nullptr, vector<int>{2, 2},
+                                    vector<int>{0, 0, 0, 0},
+                                    vector<int>{2, 2}, true);
+    EXPECT_EQ(max->getOutput()->getDims(), (Shape{1, 2, 3, 3, 8}));
+    auto global = g->addOp<GlobalAvgPoolObj>(xb, nullptr, true);
+    EXPECT_EQ(global->getOutput()->getDims(), (Shape{1, 2, 1, 1, 8}));
+    EXPECT_THROW(g->addOp<GlobalAvgPoolObj>(x, nullptr, true), Exception);
+}
+
+} // namespace infini
@@ -0,0 +1,42 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/reduce.h"
+
+#include "test.h"
+
+namespace infini {
+
+TEST(Reduce, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i = g->addTensor({2, 3, 4}, DataType::Float32);
+        auto op = g->addOp<ReduceSumObj>(i, nullptr, vector<int>{1});
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 1, 4}));
+    }
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i = g->addTensor({2, 3, 4}, DataType::Float32);
+        auto op = g->addOp<ReduceMeanObj>(i, nullptr, vector<int>{-1, 0},
+                                          false);
+        EXPECT_EQ(op->getAxes(), (vector<int>{0, 2}));
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{3}));
+    }
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i = g->addTensor({2, 3, 4}, DataType::Float32);
+        auto op = g->addOp<ReduceMaxObj>(i, nullptr);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{1, 1, 1}));
+        auto op2 = g->addOp<ReduceMinObj>(i, nullptr, vector<int>{}, false);
+        EXPECT_EQ(op2->getOutput()->getDims(), (Shape{}));
+    }
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i = g->addTensor({2, 3, 4}, DataType::Float32);
+        EXPECT_THROW(g->addOp<ReduceProdObj>(i, nullptr, vector<int>{3}),
+                     Exception);
+    }
+}
+
+} // namespace infini
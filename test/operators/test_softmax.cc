@@ -0,0 +1,21 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/softmax.h"
+
+#include "test.h"
+
+namespace infini {
+
+TEST(Softmax, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    Tensor i = g->addTensor({2, 3, 4}, DataType::Float32);
+    auto op = g->addOp<SoftmaxObj>(i, nullptr);
+    EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 4}));
+    EXPECT_EQ(op->getAxis(), 2);
+    EXPECT_EQ(g->addOp<SoftmaxObj>(i, nullptr, -3)->getAxis(), 0);
+    EXPECT_THROW(g->addOp<SoftmaxObj>(i, nullptr, 3), Exception);
+}
+
+} // namespace infini
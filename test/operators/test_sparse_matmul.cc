@@ -0,0 +1,58 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/sparse_matmul.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(SparseMatmul, Encode)
+    {
+        // [[1, 0, 0, 0],
+        //  [0, 0, 0, 0],
+        //  [0, 2, 0, 0],
+        //  [0, 0, 0, 3]]
+        vector<float> w{1, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 3};
+        auto csr = BlockSparse::encode(w.data(), 4, 4, false, 1, 1);
+        EXPECT_EQ(csr.values, (vector<float>{1, 2, 3}));
+        EXPECT_EQ(csr.index, (vector<int32_t>{0, 2, 3}));
+        EXPECT_EQ(csr.offsets, (vector<int32_t>{0, 1, 2, 2, 3}));
+
+        // Stored as W^T, the same matrix as above.
+        vector<float> wt{1, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 3};
+        auto blocked = BlockSparse::encode(wt.data(), 4, 4, true, 2, 2);
+        EXPECT_EQ(blocked.values,
+                  (vector<float>{1, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 3}));
+        EXPECT_EQ(blocked.index, (vector<int32_t>{0, 1, 1}));
+        EXPECT_EQ(blocked.offsets, (vector<int32_t>{0, 2, 3}));
+        EXPECT_THROW(BlockSparse::encode(w.data(), 4, 4, false, 3, 1),
+                     Exception);
+    }
+
+    TEST(SparseMatmul, ShapeInference)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({2, 3, 16}, DataType::Float32);
+        auto values = g->addTensor({5, 1, 8}, DataType::Float32);
+        auto index = g->addTensor({5}, DataType::Int32);
+        auto offsets = g->addTensor({4}, DataType::Int32);
+        auto op = g->addOp<SparseMatmulObj>(a, values, index, offsets,
+                                            nullptr, 1, 8);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 24}));
+        EXPECT_EQ(op->getM(), 3);
+        EXPECT_EQ(op->getN(), 24);
+        EXPECT_EQ(op->getK(), 16);
+
+        // Blocks of the wrong shape, and a shape without a kernel.
+        EXPECT_THROW(g->addOp<SparseMatmulObj>(a, values, index, offsets,
+                                               nullptr, 4, 4),
+                     Exception);
+        auto odd = g->addTensor({5, 2, 8}, DataType::Float32);
+        EXPECT_THROW(g->addOp<SparseMatmulObj>(a, odd, index, offsets,
+                                               nullptr, 2, 8),
+                     Exception);
+    }
+
+} // namespace infini
@@ -27,6 +27,16 @@ TEST(Transpose, ShapeInference) {
         auto op = g->addOp<TransposeObj>(i, nullptr, Shape{0, 2, 1});
         EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 4, 3}));
     }
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i = g->addTensor({2, 3, 4}, DataType::Float32);
+        auto op = g->addOp<TransposeObj>(i, nullptr, Shape{});
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 4}));
+        EXPECT_THROW(g->addOp<TransposeObj>(i, nullptr, Shape{0, 3, 1}),
+                     Exception);
+        EXPECT_THROW(g->addOp<TransposeObj>(i, nullptr, Shape{0, 1, 1}),
+                     Exception);
+    }
 }
 
 } // namespace infini
@@ -0,0 +1,216 @@
+import array
+import ctypes
+import json
+import os
+import tempfile
+import threading
+import unittest
+
+import infinitensor as it
+
+
+def floats(values):
+    return array.array("f", values)
+
+
+class PyBuffer(ctypes.Structure):
+    _fields_ = [("buf", ctypes.c_void_p), ("obj", ctypes.c_void_p),
+                ("len", ctypes.c_ssize_t), ("itemsize", ctypes.c_ssize_t),
+                ("readonly", ctypes.c_int), ("ndim", ctypes.c_int),
+                ("format", ctypes.c_char_p), ("shape", ctypes.c_void_p),
+                ("strides", ctypes.c_void_p), ("suboffsets", ctypes.c_void_p),
+                ("internal", ctypes.c_void_p)]
+
+
+PyBUF_STRIDES = 0x18
+PyBUF_C_CONTIGUOUS = 0x38
+PyBUF_F_CONTIGUOUS = 0x58
+PyBUF_ANY_CONTIGUOUS = 0x98
+
+
+def get_buffer(obj, flags):
+    """Requests a buffer with exact flags, which memoryview cannot."""
+    get = ctypes.pythonapi.PyObject_GetBuffer
+    get.argtypes = [ctypes.py_object, ctypes.POINTER(PyBuffer), ctypes.c_int]
+    view = PyBuffer()
+    get(obj, ctypes.byref(view), flags)
+    ctypes.pythonapi.PyBuffer_Release(ctypes.byref(view))
+
+
+class TestGraph(unittest.TestCase):
+    def test_build_and_run(self):
+        g = it.Graph()
+        a = g.tensor([2, 3])
+        b = g.tensor([2, 3])
+        c = g.relu(g.sub(a, b))
+        self.assertEqual(c.shape, (2, 3))
+        self.assertEqual(c.dtype, "float32")
+        self.assertEqual(len(g.inputs), 2)
+        self.assertEqual(len(g.outputs), 1)
+        g.data_malloc()
+
+        x = floats([1, 2, 3, 4, 5, 6])
+        y = floats([2, 2, 2, 2, 2, 2])
+        a.bind(x)
+        b.bind(y)
+        g.run()
+        self.assertEqual(memoryview(c).tolist(), [[0, 0, 1], [2, 3, 4]])
+
+        # Inputs are read in place: no rebinding needed between runs.
+        x[0] = 10
+        g.run()
+        self.assertEqual(memoryview(c).tolist()[0][0], 8)
+
+    def test_bind_output(self):
+        g = it.Graph()
+        a = g.tensor([4])
+        c = g.exp(a)
+        g.data_malloc()
+        a.bind(floats([0, 0, 0, 0]))
+        out = floats([0, 0, 0, 0])
+        c.bind(out)
+        g.run()
+        self.assertEqual(list(out), [1, 1, 1, 1])
+
+    def test_zero_copy_view(self):
+        g = it.Graph()
+        a = g.tensor([2, 2])
+        g.relu(a)
+        g.data_malloc()
+        view = memoryview(a)
+        self.assertEqual(view.format, "f")
+        self.assertEqual(view.shape, (2, 2))
+        view[1, 1] = 7.0
+        self.assertEqual(memoryview(a)[1, 1], 7.0)
+        # Reallocating would leave the view dangling.
+        with self.assertRaises(BufferError):
+            g.data_malloc()
+
+    def test_strided_view(self):
+        # The transpose reads the relu output in place.
+        g = it.Graph()
+        a = g.tensor([2, 3])
+        t = g.transpose(g.relu(a), [1, 0])
+        g.matmul(t, g.tensor([2, 2]))
+        g.data_malloc()
+        view = memoryview(t)
+        self.assertEqual(view.shape, (3, 2))
+        self.assertFalse(view.c_contiguous)
+        view.release()
+        get_buffer(t, PyBUF_STRIDES)
+        for flags in (PyBUF_C_CONTIGUOUS, PyBUF_F_CONTIGUOUS,
+                      PyBUF_ANY_CONTIGUOUS):
+            with self.assertRaises(BufferError):
+                get_buffer(t, flags)
+        get_buffer(a, PyBUF_C_CONTIGUOUS)
+        get_buffer(a, PyBUF_ANY_CONTIGUOUS)
+        with self.assertRaises(BufferError):
+            get_buffer(a, PyBUF_F_CONTIGUOUS)
+
+    def test_weight(self):
+        g = it.Graph()
+        w = g.weight(memoryview(floats([1, 2, 3, 4, 5, 6])).cast("B").cast(
+            "f", [3, 2]))
+        self.assertEqual(w.shape, (3, 2))
+        with self.assertRaises(TypeError):
+            memoryview(w)[0, 0] = 1.0
+        a = g.tensor([1, 3])
+        c = g.matmul(a, w)
+        g.optimize()
+        g.data_malloc()
+        a.bind(floats([1, 1, 1]))
+        g.run()
+        self.assertEqual(memoryview(c).tolist(), [[9, 12]])
+
+    def test_errors(self):
+        g, h = it.Graph(), it.Graph()
+        a = g.tensor([2])
+        with self.assertRaises(ValueError):
+            h.relu(a)
+        with self.assertRaises(RuntimeError):
+            g.add(a, g.tensor([3]))
+        with self.assertRaises(TypeError):
+            g.tensor([2], "complex64")
+        with self.assertRaises(BufferError):
+            memoryview(a)
+        g.data_malloc()
+        with self.assertRaises(TypeError):
+            a.bind(array.array("d", [1, 2]))
+
+    def test_save_and_load(self):
+        g = it.Graph()
+        a = g.tensor([1, 2])
+        w = g.weight(floats([3, 4]))
+        g.mul(a, w)
+        with tempfile.TemporaryDirectory() as d:
+            path = os.path.join(d, "model.it")
+            g.save(path)
+            h = it.load(path)
+        # Weights have no source either.
+        (x,) = [t for t in h.inputs if t.shape == (1, 2)]
+        (y,) = h.outputs
+        h.data_malloc()
+        x.bind(floats([1, 2]))
+        h.run()
+        self.assertEqual(memoryview(y).tolist(), [[3, 8]])
+
+    def test_memory_plan(self):
+        g = it.Graph()
+        a = g.tensor([4])
+        g.relu(g.relu(a))
+        g.data_malloc()
+        plan = json.loads(g.memory_plan())
+        self.assertEqual(len(plan["steps"]), 2)
+        # The second relu runs in place.
+        self.assertEqual([b["allocStep"] for b in plan["buffers"]], [-1, 0])
+        self.assertEqual(len(plan["buffers"][1]["tensors"]), 2)
+        self.assertGreater(plan["peak"], 0)
+
+    def test_threads(self):
+        def worker(results, i):
+            g = it.Graph()
+            a = g.tensor([256])
+            c = g.mul(a, a)
+            g.data_malloc()
+            a.bind(floats([i] * 256))
+            for _ in range(20):
+                g.run()
+            results[i] = memoryview(c)[0]
+
+        results = [None] * 4
+        threads = [threading.Thread(target=worker, args=(results, i))
+                   for i in range(4)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertEqual(results, [0, 1, 4, 9])
+
+    def test_changes_wait_for_runs(self):
+        # Rebinding on one thread, which frees the previous buffer, never
+        # overlaps a run reading it on another.
+        g = it.Graph()
+        a = g.tensor([4096])
+        c = g.exp(g.relu(a))
+        g.data_malloc()
+        a.bind(floats([0] * 4096))
+        stop = threading.Event()
+
+        def runner():
+            while not stop.is_set():
+                g.run()
+
+        t = threading.Thread(target=runner)
+        t.start()
+        try:
+            for i in range(200):
+                a.bind(floats([-i] * 4096))
+                g.tensor([1])
+        finally:
+            stop.set()
+            t.join()
+        g.run()
+        self.assertEqual(memoryview(c)[0], 1.0)
+
+if __name__ == "__main__":
+    unittest.main()